@@ -0,0 +1,127 @@
+/*
+ * Generated by tools/generator for PHP 8.4 (darwin-arm64-nts, release) - DO NOT EDIT.
+ * Slice 'compiler': only valid appended to engine.values.h + engine.classes.h + engine.executor.h.
+ * Regenerate with `composer gen-headers`.
+ */
+typedef struct __sFILE FILE;
+struct __sFILE;
+typedef uint16_t zend_ast_kind;
+typedef uint16_t zend_ast_attr;
+struct _zend_ast {
+ zend_ast_kind kind;
+ zend_ast_attr attr;
+ uint32_t lineno;
+ zend_ast *child[1];
+};
+typedef struct _zend_ast_list {
+ zend_ast_kind kind;
+ zend_ast_attr attr;
+ uint32_t lineno;
+ uint32_t children;
+ zend_ast *child[1];
+} zend_ast_list;
+typedef struct _zend_ast_zval {
+ zend_ast_kind kind;
+ zend_ast_attr attr;
+ zval val;
+} zend_ast_zval;
+typedef struct _zend_ast_decl {
+ zend_ast_kind kind;
+ zend_ast_attr attr;
+ uint32_t start_lineno;
+ uint32_t end_lineno;
+ uint32_t flags;
+ zend_string *doc_comment;
+ zend_string *name;
+ zend_ast *child[5];
+} zend_ast_decl;
+typedef void (*zend_ast_process_t)(zend_ast *ast);
+typedef size_t (*zend_stream_fsizer_t)(void* handle);
+typedef ssize_t (*zend_stream_reader_t)(void* handle, char *buf, size_t len);
+typedef void (*zend_stream_closer_t)(void* handle);
+typedef struct _zend_stream {
+ void *handle;
+ int isatty;
+ zend_stream_reader_t reader;
+ zend_stream_fsizer_t fsizer;
+ zend_stream_closer_t closer;
+} zend_stream;
+typedef struct _zend_file_handle {
+ union {
+  FILE *fp;
+  zend_stream stream;
+ } handle;
+ zend_string *filename;
+ zend_string *opened_path;
+ uint8_t type;
+ _Bool primary_script;
+ _Bool in_list;
+ char *buf;
+ size_t len;
+} zend_file_handle;
+typedef struct _zend_ptr_stack {
+ int top, max;
+ void **elements;
+ void **top_element;
+ _Bool persistent;
+} zend_ptr_stack;
+typedef size_t (*zend_encoding_filter)(unsigned char **str, size_t *str_length, const unsigned char *buf, size_t length);
+struct _zend_arena {
+ char *ptr;
+ char *end;
+ zend_arena *prev;
+};
+typedef enum {
+ ON_TOKEN,
+ ON_FEEDBACK,
+ ON_STOP
+} zend_php_scanner_event;
+typedef struct _zend_lex_state {
+ unsigned int yy_leng;
+ unsigned char *yy_start;
+ unsigned char *yy_text;
+ unsigned char *yy_cursor;
+ unsigned char *yy_marker;
+ unsigned char *yy_limit;
+ int yy_state;
+ zend_stack state_stack;
+ zend_ptr_stack heredoc_label_stack;
+ zend_stack nest_location_stack;
+ zend_file_handle *in;
+ uint32_t lineno;
+ zend_string *filename;
+ unsigned char *script_org;
+ size_t script_org_size;
+ unsigned char *script_filtered;
+ size_t script_filtered_size;
+ zend_encoding_filter input_filter;
+ zend_encoding_filter output_filter;
+ const zend_encoding *script_encoding;
+ void (*on_event)(
+  zend_php_scanner_event event, int token, int line,
+  const char *text, size_t length, void *context);
+ void *on_event_context;
+ zend_ast *ast;
+ zend_arena *ast_arena;
+} zend_lex_state;
+
+/* Imported functions */
+extern void zend_save_lexical_state(zend_lex_state *);
+extern void zend_restore_lexical_state(zend_lex_state *);
+extern void zend_prepare_string_for_scanning(zval *, zend_string *);
+extern zend_result zend_lex_tstring(zval *, unsigned char *);
+extern int zendparse(void);
+extern void zend_ast_destroy(zend_ast *);
+extern zend_ast * zend_ast_create_list_0(zend_ast_kind);
+extern zend_ast * zend_ast_list_add(zend_ast *, zend_ast *);
+extern zend_ast * zend_ast_create_zval_ex(zval *, zend_ast_attr);
+extern zend_ast * zend_ast_create_0(zend_ast_kind);
+extern zend_ast * zend_ast_create_1(zend_ast_kind, zend_ast *);
+extern zend_ast * zend_ast_create_2(zend_ast_kind, zend_ast *, zend_ast *);
+extern zend_ast * zend_ast_create_3(zend_ast_kind, zend_ast *, zend_ast *, zend_ast *);
+extern zend_ast * zend_ast_create_4(zend_ast_kind, zend_ast *, zend_ast *, zend_ast *, zend_ast *);
+extern zend_ast * zend_ast_create_5(zend_ast_kind, zend_ast *, zend_ast *, zend_ast *, zend_ast *, zend_ast *);
+extern zend_ast * zend_ast_create_decl(zend_ast_kind, uint32_t, uint32_t, zend_string *, zend_string *, zend_ast *, zend_ast *, zend_ast *, zend_ast *, zend_ast *);
+
+/* Imported globals */
+extern zend_ast_process_t zend_ast_process;
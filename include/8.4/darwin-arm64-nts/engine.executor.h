@@ -0,0 +1,304 @@
+/*
+ * Generated by tools/generator for PHP 8.4 (darwin-arm64-nts, release) - DO NOT EDIT.
+ * Slice 'executor': only valid appended to engine.values.h + engine.classes.h.
+ * Regenerate with `composer gen-headers`.
+ */
+struct exception {
+    int type;
+    char *name;
+    double arg1;
+    double arg2;
+    double retval;
+};
+struct _zend_ast;
+typedef struct _zend_ast zend_ast;
+typedef uint32_t HashPosition;
+typedef struct _HashTableIterator {
+ HashTable *ht;
+ HashPosition pos;
+ uint32_t next_copy;
+} HashTableIterator;
+typedef struct _zend_llist_element {
+ struct _zend_llist_element *next;
+ struct _zend_llist_element *prev;
+ char data[1];
+} zend_llist_element;
+typedef void (*llist_dtor_func_t)(void *);
+typedef struct _zend_llist {
+ zend_llist_element *head;
+ zend_llist_element *tail;
+ size_t count;
+ size_t size;
+ llist_dtor_func_t dtor;
+ unsigned char persistent;
+ zend_llist_element *traverse_ptr;
+} zend_llist;
+typedef struct {
+ zval *cur;
+ zval *end;
+ zval *start;
+} zend_get_gc_buffer;
+typedef struct _zend_error_info {
+ int type;
+ uint32_t lineno;
+ zend_string *filename;
+ zend_string *message;
+} zend_error_info;
+typedef enum {
+ EH_NORMAL = 0,
+ EH_THROW
+} zend_error_handling_t;
+typedef enum {
+ ZEND_PROPERTY_HOOK_GET = 0,
+ ZEND_PROPERTY_HOOK_SET = 1,
+} zend_property_hook_kind;
+typedef struct _zend_lazy_objects_store {
+ HashTable infos;
+} zend_lazy_objects_store;
+struct _zend_strtod_bigint;
+typedef struct _zend_strtod_bigint zend_strtod_bigint;
+typedef struct _zend_strtod_state {
+ zend_strtod_bigint *freelist[7 +1];
+ zend_strtod_bigint *p5s;
+ char *result;
+} zend_strtod_state;
+typedef struct _zend_declarables {
+ zend_long ticks;
+} zend_declarables;
+typedef struct _zend_file_context {
+ zend_declarables declarables;
+ zend_string *current_namespace;
+ _Bool in_namespace;
+ _Bool has_bracketed_namespaces;
+ HashTable *imports;
+ HashTable *imports_function;
+ HashTable *imports_const;
+ HashTable seen_symbols;
+} zend_file_context;
+typedef int (*user_opcode_handler_t) (zend_execute_data *execute_data);
+typedef struct _zend_brk_cont_element {
+ int start;
+ int cont;
+ int brk;
+ int parent;
+ _Bool is_switch;
+} zend_brk_cont_element;
+typedef struct _zend_oparray_context {
+ struct _zend_oparray_context *prev;
+ zend_op_array *op_array;
+ uint32_t opcodes_size;
+ int vars_size;
+ int literals_size;
+ uint32_t fast_call_var;
+ uint32_t try_catch_offset;
+ int current_brk_cont;
+ int last_brk_cont;
+ zend_brk_cont_element *brk_cont_array;
+ HashTable *labels;
+ const zend_property_info *active_property_info;
+ zend_property_hook_kind active_property_hook_kind;
+ _Bool in_jmp_frameless_branch;
+} zend_oparray_context;
+struct _zend_execute_data {
+ const zend_op *opline;
+ zend_execute_data *call;
+ zval *return_value;
+ zend_function *func;
+ zval This;
+ zend_execute_data *prev_execute_data;
+ zend_array *symbol_table;
+ void **run_time_cache;
+ zend_array *extra_named_params;
+};
+typedef int sigjmp_buf[((14 + 8 + 2) * 2) + 1];
+typedef struct _zend_compiler_globals zend_compiler_globals;
+typedef struct _zend_executor_globals zend_executor_globals;
+typedef struct zend_atomic_bool_s {
+ _Bool value;
+} zend_atomic_bool;
+typedef struct _zend_stack {
+ int size, top, max;
+ void *elements;
+} zend_stack;
+typedef struct _zend_objects_store {
+ zend_object **object_buckets;
+ uint32_t top;
+ uint32_t size;
+ int free_list_head;
+} zend_objects_store;
+struct _zend_encoding;
+typedef struct _zend_encoding zend_encoding;
+struct _zend_arena;
+typedef struct _zend_arena zend_arena;
+typedef struct _zend_call_stack {
+ void *base;
+ size_t max_size;
+} zend_call_stack;
+struct _zend_vm_stack;
+typedef struct _zend_vm_stack *zend_vm_stack;
+struct _zend_ini_entry;
+typedef struct _zend_ini_entry zend_ini_entry;
+struct _zend_fiber_context;
+typedef struct _zend_fiber_context zend_fiber_context;
+struct _zend_fiber;
+typedef struct _zend_fiber zend_fiber;
+typedef enum {
+ ZEND_MEMOIZE_NONE,
+ ZEND_MEMOIZE_COMPILE,
+ ZEND_MEMOIZE_FETCH,
+} zend_memoize_mode;
+struct _zend_ini_parser_param;
+struct _zend_compiler_globals {
+ zend_stack loop_var_stack;
+ zend_class_entry *active_class_entry;
+ zend_string *compiled_filename;
+ int zend_lineno;
+ zend_op_array *active_op_array;
+ HashTable *function_table;
+ HashTable *class_table;
+ HashTable *auto_globals;
+ uint8_t parse_error;
+ _Bool in_compilation;
+ _Bool short_tags;
+ _Bool unclean_shutdown;
+ _Bool ini_parser_unbuffered_errors;
+ zend_llist open_files;
+ struct _zend_ini_parser_param *ini_parser_param;
+ _Bool skip_shebang;
+ _Bool increment_lineno;
+ _Bool variable_width_locale;
+ _Bool ascii_compatible_locale;
+ zend_string *doc_comment;
+ uint32_t extra_fn_flags;
+ uint32_t compiler_options;
+ zend_oparray_context context;
+ zend_file_context file_context;
+ zend_arena *arena;
+ HashTable interned_strings;
+ const zend_encoding **script_encoding_list;
+ size_t script_encoding_list_size;
+ _Bool multibyte;
+ _Bool detect_unicode;
+ _Bool encoding_declared;
+ zend_ast *ast;
+ zend_arena *ast_arena;
+ zend_stack delayed_oplines_stack;
+ HashTable *memoized_exprs;
+ zend_memoize_mode memoize_mode;
+ void *map_ptr_real_base;
+ void *map_ptr_base;
+ size_t map_ptr_size;
+ size_t map_ptr_last;
+ HashTable *delayed_variance_obligations;
+ HashTable *delayed_autoloads;
+ HashTable *unlinked_uses;
+ zend_class_entry *current_linking_class;
+ uint32_t rtd_key_counter;
+ void *internal_run_time_cache;
+ uint32_t internal_run_time_cache_size;
+ zend_stack short_circuiting_opnums;
+};
+struct _zend_executor_globals {
+ zval uninitialized_zval;
+ zval error_zval;
+ zend_array *symtable_cache[32];
+ zend_array **symtable_cache_limit;
+ zend_array **symtable_cache_ptr;
+ zend_array symbol_table;
+ HashTable included_files;
+ sigjmp_buf *bailout;
+ int error_reporting;
+ int exit_status;
+ HashTable *function_table;
+ HashTable *class_table;
+ HashTable *zend_constants;
+ zval *vm_stack_top;
+ zval *vm_stack_end;
+ zend_vm_stack vm_stack;
+ size_t vm_stack_page_size;
+ struct _zend_execute_data *current_execute_data;
+ zend_class_entry *fake_scope;
+ uint32_t jit_trace_num;
+ zend_execute_data *current_observed_frame;
+ int ticks_count;
+ zend_long precision;
+ uint32_t persistent_constants_count;
+ uint32_t persistent_functions_count;
+ uint32_t persistent_classes_count;
+ _Bool no_extensions;
+ _Bool full_tables_cleanup;
+ zend_atomic_bool vm_interrupt;
+ zend_atomic_bool timed_out;
+ HashTable *in_autoload;
+ zend_long hard_timeout;
+ void *stack_base;
+ void *stack_limit;
+ HashTable regular_list;
+ HashTable persistent_list;
+ int user_error_handler_error_reporting;
+ _Bool exception_ignore_args;
+ zval user_error_handler;
+ zval user_exception_handler;
+ zend_stack user_error_handlers_error_reporting;
+ zend_stack user_error_handlers;
+ zend_stack user_exception_handlers;
+ zend_class_entry *exception_class;
+ zend_error_handling_t error_handling;
+ int capture_warnings_during_sccp;
+ zend_long timeout_seconds;
+ HashTable *ini_directives;
+ HashTable *modified_ini_directives;
+ zend_ini_entry *error_reporting_ini_entry;
+ zend_objects_store objects_store;
+ zend_lazy_objects_store lazy_objects_store;
+ zend_object *exception, *prev_exception;
+ const zend_op *opline_before_exception;
+ zend_op exception_op[3];
+ struct _zend_module_entry *current_module;
+ _Bool active;
+ uint8_t flags;
+ zend_long assertions;
+ uint32_t ht_iterators_count;
+ uint32_t ht_iterators_used;
+ HashTableIterator *ht_iterators;
+ HashTableIterator ht_iterators_slots[16];
+ void *saved_fpu_cw_ptr;
+ zend_function trampoline;
+ zend_op call_trampoline_op;
+ HashTable weakrefs;
+ zend_long exception_string_param_max_len;
+ zend_get_gc_buffer get_gc_buffer;
+ zend_fiber_context *main_fiber_context;
+ zend_fiber_context *current_fiber_context;
+ zend_fiber *active_fiber;
+ size_t fiber_stack_size;
+ _Bool record_errors;
+ uint32_t num_errors;
+ zend_error_info **errors;
+ zend_string *filename_override;
+ zend_long lineno_override;
+ zend_call_stack call_stack;
+ zend_long max_allowed_stack_size;
+ zend_ulong reserved_stack_size;
+ zend_strtod_state strtod_state;
+ void *reserved[6];
+};
+
+/* Imported functions */
+extern zend_result zend_set_user_opcode_handler(uint8_t, user_opcode_handler_t);
+extern user_opcode_handler_t zend_get_user_opcode_handler(uint8_t);
+extern void zend_vm_set_opcode_handler(zend_op *);
+extern void zend_objects_store_put(zend_object *);
+extern void zend_clear_exception(void);
+
+/* Imported globals */
+extern zend_executor_globals executor_globals;
+extern struct _zend_compiler_globals compiler_globals;
+extern HashTable module_registry;
+extern const zend_object_handlers std_object_handlers;
+extern void (*zend_error_cb)(int, zend_string *, const uint32_t, zend_string *);
+extern void (*zend_throw_exception_hook)(zend_object *);
+extern void (*zend_interrupt_function)(zend_execute_data *);
+extern zend_class_entry * (*zend_inheritance_cache_get)(zend_class_entry *, zend_class_entry *, zend_class_entry **);
+extern zend_class_entry * (*zend_inheritance_cache_add)(zend_class_entry *, zend_class_entry *, zend_class_entry *, zend_class_entry **, HashTable *);
+extern char zend_system_id[32];
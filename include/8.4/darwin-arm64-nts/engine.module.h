@@ -0,0 +1,46 @@
+/*
+ * Generated by tools/generator for PHP 8.4 (darwin-arm64-nts, release) - DO NOT EDIT.
+ * Slice 'module': only valid appended to engine.values.h + engine.classes.h + engine.executor.h.
+ * Regenerate with `composer gen-headers`.
+ */
+typedef struct _zend_module_entry zend_module_entry;
+typedef struct _zend_module_dep zend_module_dep;
+struct _zend_module_entry {
+ unsigned short size;
+ unsigned int zend_api;
+ unsigned char zend_debug;
+ unsigned char zts;
+ const struct _zend_ini_entry *ini_entry;
+ const struct _zend_module_dep *deps;
+ const char *name;
+ const struct _zend_function_entry *functions;
+ zend_result (*module_startup_func)(int type, int module_number);
+ zend_result (*module_shutdown_func)(int type, int module_number);
+ zend_result (*request_startup_func)(int type, int module_number);
+ zend_result (*request_shutdown_func)(int type, int module_number);
+ void (*info_func)(zend_module_entry *zend_module);
+ const char *version;
+ size_t globals_size;
+ void* globals_ptr;
+ void (*globals_ctor)(void *global);
+ void (*globals_dtor)(void *global);
+ zend_result (*post_deactivate_func)(void);
+ int module_started;
+ unsigned char type;
+ void *handle;
+ int module_number;
+ const char *build_id;
+};
+struct _zend_module_dep {
+ const char *name;
+ const char *rel;
+ const char *version;
+ unsigned char type;
+};
+
+/* Imported functions */
+extern zend_module_entry * zend_register_module_ex(zend_module_entry *, int);
+extern zend_result zend_startup_module_ex(zend_module_entry *);
+
+/* Imported globals */
+
@@ -0,0 +1,214 @@
+/*
+ * Generated by tools/generator for PHP 8.4 (darwin-arm64-nts, release) - DO NOT EDIT.
+ * Regenerate with `composer gen-headers`.
+ */
+typedef int64_t zend_long;
+typedef uint64_t zend_ulong;
+typedef enum {
+  SUCCESS = 0,
+  FAILURE = -1,
+} ZEND_RESULT_CODE;
+typedef ZEND_RESULT_CODE zend_result;
+typedef struct _zend_object_handlers zend_object_handlers;
+struct _zend_class_entry;
+typedef struct _zend_class_entry zend_class_entry;
+union _zend_function;
+typedef union _zend_function zend_function;
+typedef struct _zval_struct zval;
+typedef struct _zend_refcounted zend_refcounted;
+typedef struct _zend_string zend_string;
+typedef struct _zend_array zend_array;
+typedef struct _zend_object zend_object;
+typedef struct _zend_resource zend_resource;
+typedef struct _zend_reference zend_reference;
+typedef struct _zend_ast_ref zend_ast_ref;
+typedef void (*dtor_func_t)(zval *pDest);
+typedef union _zend_value {
+ zend_long lval;
+ double dval;
+ zend_refcounted *counted;
+ zend_string *str;
+ zend_array *arr;
+ zend_object *obj;
+ zend_resource *res;
+ zend_reference *ref;
+ zend_ast_ref *ast;
+ zval *zv;
+ void *ptr;
+ zend_class_entry *ce;
+ zend_function *func;
+ struct {
+  uint32_t w1;
+  uint32_t w2;
+ } ww;
+} zend_value;
+struct _zval_struct {
+ zend_value value;
+ union {
+  uint32_t type_info;
+  struct {
+   uint8_t type; uint8_t type_flags; union { uint16_t extra; } u;
+  } v;
+ } u1;
+ union {
+  uint32_t next;
+  uint32_t cache_slot;
+  uint32_t opline_num;
+  uint32_t lineno;
+  uint32_t num_args;
+  uint32_t fe_pos;
+  uint32_t fe_iter_idx;
+  uint32_t guard;
+  uint32_t constant_flags;
+  uint32_t extra;
+ } u2;
+};
+typedef struct _zend_refcounted_h {
+ uint32_t refcount;
+ union {
+  uint32_t type_info;
+ } u;
+} zend_refcounted_h;
+struct _zend_refcounted {
+ zend_refcounted_h gc;
+};
+struct _zend_string {
+ zend_refcounted_h gc;
+ zend_ulong h;
+ size_t len;
+ char val[1];
+};
+typedef struct _Bucket {
+ zval val;
+ zend_ulong h;
+ zend_string *key;
+} Bucket;
+typedef struct _zend_array HashTable;
+struct _zend_array {
+ zend_refcounted_h gc;
+ union {
+  struct {
+   uint8_t flags; uint8_t _unused; uint8_t nIteratorsCount; uint8_t _unused2;
+  } v;
+  uint32_t flags;
+ } u;
+ uint32_t nTableMask;
+ union {
+  uint32_t *arHash;
+  Bucket *arData;
+  zval *arPacked;
+ };
+ uint32_t nNumUsed;
+ uint32_t nNumOfElements;
+ uint32_t nTableSize;
+ uint32_t nInternalPointer;
+ zend_long nNextFreeElement;
+ dtor_func_t pDestructor;
+};
+struct _zend_object {
+ zend_refcounted_h gc;
+ uint32_t handle;
+ uint32_t extra_flags;
+ zend_class_entry *ce;
+ const zend_object_handlers *handlers;
+ HashTable *properties;
+ zval properties_table[1];
+};
+struct _zend_resource {
+ zend_refcounted_h gc;
+ zend_long handle;
+ int type;
+ void *ptr;
+};
+typedef union {
+ struct _zend_property_info *ptr;
+ uintptr_t list;
+} zend_property_info_source_list;
+struct _zend_reference {
+ zend_refcounted_h gc;
+ zval val;
+ zend_property_info_source_list sources;
+};
+struct _zend_ast_ref {
+ zend_refcounted_h gc;
+};
+struct _zend_property_info;
+typedef zval *(*zend_object_read_property_t)(zend_object *object, zend_string *member, int type, void **cache_slot, zval *rv);
+typedef zval *(*zend_object_read_dimension_t)(zend_object *object, zval *offset, int type, zval *rv);
+typedef zval *(*zend_object_write_property_t)(zend_object *object, zend_string *member, zval *value, void **cache_slot);
+typedef void (*zend_object_write_dimension_t)(zend_object *object, zval *offset, zval *value);
+typedef zval *(*zend_object_get_property_ptr_ptr_t)(zend_object *object, zend_string *member, int type, void **cache_slot);
+typedef int (*zend_object_has_property_t)(zend_object *object, zend_string *member, int has_set_exists, void **cache_slot);
+typedef int (*zend_object_has_dimension_t)(zend_object *object, zval *member, int check_empty);
+typedef void (*zend_object_unset_property_t)(zend_object *object, zend_string *member, void **cache_slot);
+typedef void (*zend_object_unset_dimension_t)(zend_object *object, zval *offset);
+typedef HashTable *(*zend_object_get_properties_t)(zend_object *object);
+typedef HashTable *(*zend_object_get_debug_info_t)(zend_object *object, int *is_temp);
+typedef enum _zend_prop_purpose {
+ ZEND_PROP_PURPOSE_DEBUG,
+ ZEND_PROP_PURPOSE_ARRAY_CAST,
+ ZEND_PROP_PURPOSE_SERIALIZE,
+ ZEND_PROP_PURPOSE_VAR_EXPORT,
+ ZEND_PROP_PURPOSE_JSON,
+ ZEND_PROP_PURPOSE_GET_OBJECT_VARS,
+ _ZEND_PROP_PURPOSE_NON_EXHAUSTIVE_ENUM
+} zend_prop_purpose;
+typedef zend_array *(*zend_object_get_properties_for_t)(zend_object *object, zend_prop_purpose purpose);
+typedef zend_function *(*zend_object_get_method_t)(zend_object **object, zend_string *method, const zval *key);
+typedef zend_function *(*zend_object_get_constructor_t)(zend_object *object);
+typedef void (*zend_object_free_obj_t)(zend_object *object);
+typedef void (*zend_object_dtor_obj_t)(zend_object *object);
+typedef zend_object* (*zend_object_clone_obj_t)(zend_object *object);
+typedef zend_string *(*zend_object_get_class_name_t)(const zend_object *object);
+typedef int (*zend_object_compare_t)(zval *object1, zval *object2);
+typedef zend_result (*zend_object_cast_t)(zend_object *readobj, zval *retval, int type);
+typedef zend_result (*zend_object_count_elements_t)(zend_object *object, zend_long *count);
+typedef zend_result (*zend_object_get_closure_t)(zend_object *obj, zend_class_entry **ce_ptr, zend_function **fptr_ptr, zend_object **obj_ptr, _Bool check_only);
+typedef HashTable *(*zend_object_get_gc_t)(zend_object *object, zval **table, int *n);
+typedef zend_result (*zend_object_do_operation_t)(uint8_t opcode, zval *result, zval *op1, zval *op2);
+struct _zend_object_handlers {
+ int offset;
+ zend_object_free_obj_t free_obj;
+ zend_object_dtor_obj_t dtor_obj;
+ zend_object_clone_obj_t clone_obj;
+ zend_object_read_property_t read_property;
+ zend_object_write_property_t write_property;
+ zend_object_read_dimension_t read_dimension;
+ zend_object_write_dimension_t write_dimension;
+ zend_object_get_property_ptr_ptr_t get_property_ptr_ptr;
+ zend_object_has_property_t has_property;
+ zend_object_unset_property_t unset_property;
+ zend_object_has_dimension_t has_dimension;
+ zend_object_unset_dimension_t unset_dimension;
+ zend_object_get_properties_t get_properties;
+ zend_object_get_method_t get_method;
+ zend_object_get_constructor_t get_constructor;
+ zend_object_get_class_name_t get_class_name;
+ zend_object_cast_t cast_object;
+ zend_object_count_elements_t count_elements;
+ zend_object_get_debug_info_t get_debug_info;
+ zend_object_get_closure_t get_closure;
+ zend_object_get_gc_t get_gc;
+ zend_object_do_operation_t do_operation;
+ zend_object_compare_t compare;
+ zend_object_get_properties_for_t get_properties_for;
+};
+
+/* Imported functions */
+extern zend_result zend_hash_del(HashTable *, zend_string *);
+extern zend_result zend_hash_index_del(HashTable *, zend_ulong);
+extern zval * zend_hash_find(const HashTable *, zend_string *);
+extern zval * zend_hash_add_or_update(HashTable *, zend_string *, zval *, uint32_t);
+extern zval * zend_hash_index_add_or_update(HashTable *, zend_ulong, zval *, uint32_t);
+extern zval * zend_hash_index_find(const HashTable *, zend_ulong);
+extern void zend_hash_destroy(HashTable *);
+extern HashTable * zend_array_dup(HashTable *);
+extern void zval_ptr_dtor(zval *);
+extern void zval_add_ref(zval *);
+extern void rc_dtor_func(zend_refcounted *);
+extern zend_string * zend_string_concat2(const char *, size_t, const char *, size_t);
+extern zend_ulong zend_string_hash_func(zend_string *);
+extern void free(void *);
+
+/* Imported globals */
+
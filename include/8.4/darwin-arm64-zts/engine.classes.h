@@ -0,0 +1,332 @@
+/*
+ * Generated by tools/generator for PHP 8.4 (darwin-arm64-zts, release) - DO NOT EDIT.
+ * Slice 'classes': only valid appended to engine.values.h.
+ * Regenerate with `composer gen-headers`.
+ */
+struct _zend_execute_data;
+typedef struct _zend_execute_data zend_execute_data;
+typedef struct {
+ void *ptr;
+ uint32_t type_mask;
+} zend_type;
+typedef struct {
+ uint32_t num_types;
+ zend_type types[1];
+} zend_type_list;
+typedef struct _zend_object_iterator zend_object_iterator;
+typedef struct _zend_object_iterator_funcs {
+ void (*dtor)(zend_object_iterator *iter);
+ zend_result (*valid)(zend_object_iterator *iter);
+ zval *(*get_current_data)(zend_object_iterator *iter);
+ void (*get_current_key)(zend_object_iterator *iter, zval *key);
+ void (*move_forward)(zend_object_iterator *iter);
+ void (*rewind)(zend_object_iterator *iter);
+ void (*invalidate_current)(zend_object_iterator *iter);
+ HashTable *(*get_gc)(zend_object_iterator *iter, zval **table, int *n);
+} zend_object_iterator_funcs;
+struct _zend_object_iterator {
+ zend_object std;
+ zval data;
+ const zend_object_iterator_funcs *funcs;
+ zend_ulong index;
+};
+typedef struct _zend_class_iterator_funcs {
+ zend_function *zf_new_iterator;
+ zend_function *zf_valid;
+ zend_function *zf_current;
+ zend_function *zf_key;
+ zend_function *zf_next;
+ zend_function *zf_rewind;
+} zend_class_iterator_funcs;
+typedef struct _zend_class_arrayaccess_funcs {
+ zend_function *zf_offsetget;
+ zend_function *zf_offsetexists;
+ zend_function *zf_offsetset;
+ zend_function *zf_offsetunset;
+} zend_class_arrayaccess_funcs;
+struct _zend_serialize_data;
+struct _zend_unserialize_data;
+typedef struct _zend_serialize_data zend_serialize_data;
+typedef struct _zend_unserialize_data zend_unserialize_data;
+typedef struct _zend_class_name {
+ zend_string *name;
+ zend_string *lc_name;
+} zend_class_name;
+typedef struct _zend_trait_method_reference {
+ zend_string *method_name;
+ zend_string *class_name;
+} zend_trait_method_reference;
+typedef struct _zend_trait_precedence {
+ zend_trait_method_reference trait_method;
+ uint32_t num_excludes;
+ zend_string *exclude_class_names[1];
+} zend_trait_precedence;
+typedef struct _zend_trait_alias {
+ zend_trait_method_reference trait_method;
+ zend_string *alias;
+ uint32_t modifiers;
+} zend_trait_alias;
+typedef struct _zend_class_mutable_data {
+ zval *default_properties_table;
+ HashTable *constants_table;
+ uint32_t ce_flags;
+ HashTable *backed_enum_table;
+} zend_class_mutable_data;
+struct _zend_inheritance_cache_entry;
+typedef struct _zend_inheritance_cache_entry zend_inheritance_cache_entry;
+struct _zend_module_entry;
+struct _zend_function_entry;
+struct _zend_class_entry {
+ char type;
+ zend_string *name;
+ union {
+  zend_class_entry *parent;
+  zend_string *parent_name;
+ };
+ int refcount;
+ uint32_t ce_flags;
+ int default_properties_count;
+ int default_static_members_count;
+ zval *default_properties_table;
+ zval *default_static_members_table;
+ zval * static_members_table__ptr;
+ HashTable function_table;
+ HashTable properties_info;
+ HashTable constants_table;
+ zend_class_mutable_data* mutable_data__ptr;
+ zend_inheritance_cache_entry *inheritance_cache;
+ struct _zend_property_info **properties_info_table;
+ zend_function *constructor;
+ zend_function *destructor;
+ zend_function *clone;
+ zend_function *__get;
+ zend_function *__set;
+ zend_function *__unset;
+ zend_function *__isset;
+ zend_function *__call;
+ zend_function *__callstatic;
+ zend_function *__tostring;
+ zend_function *__debugInfo;
+ zend_function *__serialize;
+ zend_function *__unserialize;
+ const zend_object_handlers *default_object_handlers;
+ zend_class_iterator_funcs *iterator_funcs_ptr;
+ zend_class_arrayaccess_funcs *arrayaccess_funcs_ptr;
+ union {
+  zend_object* (*create_object)(zend_class_entry *class_type);
+  int (*interface_gets_implemented)(zend_class_entry *iface, zend_class_entry *class_type);
+ };
+ zend_object_iterator *(*get_iterator)(zend_class_entry *ce, zval *object, int by_ref);
+ zend_function *(*get_static_method)(zend_class_entry *ce, zend_string* method);
+ int (*serialize)(zval *object, unsigned char **buffer, size_t *buf_len, zend_serialize_data *data);
+ int (*unserialize)(zval *object, zend_class_entry *ce, const unsigned char *buf, size_t buf_len, zend_unserialize_data *data);
+ uint32_t num_interfaces;
+ uint32_t num_traits;
+ uint32_t num_hooked_props;
+ uint32_t num_hooked_prop_variance_checks;
+ union {
+  zend_class_entry **interfaces;
+  zend_class_name *interface_names;
+ };
+ zend_class_name *trait_names;
+ zend_trait_alias **trait_aliases;
+ zend_trait_precedence **trait_precedences;
+ HashTable *attributes;
+ uint32_t enum_backing_type;
+ HashTable *backed_enum_table;
+ zend_string *doc_comment;
+ union {
+  struct {
+   zend_string *filename;
+   uint32_t line_start;
+   uint32_t line_end;
+  } user;
+  struct {
+   const struct _zend_function_entry *builtin_functions;
+   struct _zend_module_entry *module;
+  } internal;
+ } info;
+};
+typedef struct _zend_property_info zend_property_info;
+typedef struct _zend_op zend_op;
+typedef struct {
+ void *handler;
+ uint32_t num_args;
+} zend_frameless_function_info;
+typedef struct _zend_op_array zend_op_array;
+typedef union _znode_op {
+ uint32_t constant;
+ uint32_t var;
+ uint32_t num;
+ uint32_t opline_num;
+ uint32_t jmp_offset;
+} znode_op;
+struct _zend_op {
+ const void *handler;
+ znode_op op1;
+ znode_op op2;
+ znode_op result;
+ uint32_t extended_value;
+ uint32_t lineno;
+ uint8_t opcode;
+ uint8_t op1_type;
+ uint8_t op2_type;
+ uint8_t result_type;
+};
+typedef struct _zend_try_catch_element {
+ uint32_t try_op;
+ uint32_t catch_op;
+ uint32_t finally_op;
+ uint32_t finally_end;
+} zend_try_catch_element;
+typedef struct _zend_live_range {
+ uint32_t var;
+ uint32_t start;
+ uint32_t end;
+} zend_live_range;
+struct _zend_property_info {
+ uint32_t offset;
+ uint32_t flags;
+ zend_string *name;
+ zend_string *doc_comment;
+ HashTable *attributes;
+ zend_class_entry *ce;
+ zend_type type;
+ const zend_property_info *prototype;
+ zend_function **hooks;
+};
+typedef struct _zend_class_constant {
+ zval value;
+ zend_string *doc_comment;
+ HashTable *attributes;
+ zend_class_entry *ce;
+ zend_type type;
+} zend_class_constant;
+typedef struct _zend_internal_arg_info {
+ const char *name;
+ zend_type type;
+ const char *default_value;
+} zend_internal_arg_info;
+typedef struct _zend_arg_info {
+ zend_string *name;
+ zend_type type;
+ zend_string *default_value;
+} zend_arg_info;
+struct _zend_op_array {
+ uint8_t type;
+ uint8_t arg_flags[3];
+ uint32_t fn_flags;
+ zend_string *function_name;
+ zend_class_entry *scope;
+ zend_function *prototype;
+ uint32_t num_args;
+ uint32_t required_num_args;
+ zend_arg_info *arg_info;
+ HashTable *attributes;
+ void ** run_time_cache__ptr;
+ zend_string *doc_comment;
+ uint32_t T;
+ const zend_property_info *prop_info;
+ int cache_size;
+ int last_var;
+ uint32_t last;
+ zend_op *opcodes;
+ HashTable * static_variables_ptr__ptr;
+ HashTable *static_variables;
+ zend_string **vars;
+ uint32_t *refcount;
+ int last_live_range;
+ int last_try_catch;
+ zend_live_range *live_range;
+ zend_try_catch_element *try_catch_array;
+ zend_string *filename;
+ uint32_t line_start;
+ uint32_t line_end;
+ int last_literal;
+ uint32_t num_dynamic_func_defs;
+ zval *literals;
+ zend_op_array **dynamic_func_defs;
+ void *reserved[6];
+};
+typedef void ( *zif_handler)(zend_execute_data *execute_data, zval *return_value);
+typedef struct _zend_internal_function {
+ uint8_t type;
+ uint8_t arg_flags[3];
+ uint32_t fn_flags;
+ zend_string* function_name;
+ zend_class_entry *scope;
+ zend_function *prototype;
+ uint32_t num_args;
+ uint32_t required_num_args;
+ zend_internal_arg_info *arg_info;
+ HashTable *attributes;
+ void ** run_time_cache__ptr;
+ zend_string *doc_comment;
+ uint32_t T;
+ const zend_property_info *prop_info;
+ zif_handler handler;
+ struct _zend_module_entry *module;
+ const zend_frameless_function_info *frameless_function_infos;
+ void *reserved[6];
+} zend_internal_function;
+union _zend_function {
+ uint8_t type;
+ uint32_t quick_arg_flags;
+ struct {
+  uint8_t type;
+  uint8_t arg_flags[3];
+  uint32_t fn_flags;
+  zend_string *function_name;
+  zend_class_entry *scope;
+  zend_function *prototype;
+  uint32_t num_args;
+  uint32_t required_num_args;
+  zend_arg_info *arg_info;
+  HashTable *attributes;
+  void ** run_time_cache__ptr;
+  zend_string *doc_comment;
+  uint32_t T;
+  const zend_property_info *prop_info;
+ } common;
+ zend_op_array op_array;
+ zend_internal_function internal_function;
+};
+typedef struct _zend_constant {
+ zval value;
+ zend_string *name;
+} zend_constant;
+typedef struct {
+ zend_string *name;
+ zval value;
+} zend_attribute_arg;
+typedef struct _zend_attribute {
+ zend_string *name;
+ zend_string *lcname;
+ uint32_t flags;
+ uint32_t lineno;
+ uint32_t offset;
+ uint32_t argc;
+ zend_attribute_arg args[1];
+} zend_attribute;
+typedef struct _zend_closure {
+ zend_object std;
+ zend_function func;
+ zval this_ptr;
+ zend_class_entry *called_scope;
+ zif_handler orig_internal_handler;
+} zend_closure;
+
+/* Imported functions */
+extern void zend_do_inheritance_ex(zend_class_entry *, zend_class_entry *, _Bool);
+extern zend_object * zend_objects_new(zend_class_entry *);
+extern void zend_object_std_init(zend_object *, zend_class_entry *);
+extern void object_properties_init(zend_object *, zend_class_entry *);
+extern HashTable * zend_std_get_properties_for(zend_object *, zend_prop_purpose);
+extern void destroy_op_array(zend_op_array *);
+extern void zend_destroy_static_vars(zend_op_array *);
+extern void destroy_zend_class(zval *);
+extern void zend_iterator_init(zend_object_iterator *);
+extern zend_result zend_register_constant(zend_constant *);
+
+/* Imported globals */
+
@@ -1013,12 +1013,14 @@ extern zval * zend_hash_index_find(const HashTable *, zend_ulong);
 extern void zend_hash_destroy(HashTable *);
 extern zend_result zend_set_user_opcode_handler(uint8_t, user_opcode_handler_t);
 extern user_opcode_handler_t zend_get_user_opcode_handler(uint8_t);
+extern void zend_vm_set_opcode_handler(zend_op *);
 extern void zend_deserialize_opcode_handler(zend_op *);
 extern void zend_do_inheritance_ex(zend_class_entry *, zend_class_entry *, _Bool);
 extern zend_object * zend_objects_new(zend_class_entry *);
 extern void zend_object_std_init(zend_object *, zend_class_entry *);
 extern void object_properties_init(zend_object *, zend_class_entry *);
 extern void zend_objects_store_put(zend_object *);
+extern HashTable * zend_std_get_properties_for(zend_object *, zend_prop_purpose);
 extern void zend_save_lexical_state(zend_lex_state *);
 extern void zend_restore_lexical_state(zend_lex_state *);
 extern void zend_prepare_string_for_scanning(zval *, zend_string *);
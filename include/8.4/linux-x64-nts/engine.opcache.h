@@ -0,0 +1,56 @@
+/*
+ * Generated by tools/generator for PHP 8.4 (linux-x64-nts, release) - DO NOT EDIT.
+ * Slice 'opcache': only valid appended to engine.values.h + engine.classes.h + engine.executor.h.
+ * Regenerate with `composer gen-headers`.
+ */
+typedef long int __time_t;
+typedef __time_t time_t;
+typedef struct _zend_script {
+ zend_string *filename;
+ zend_op_array main_op_array;
+ HashTable function_table;
+ HashTable class_table;
+} zend_script;
+typedef time_t accel_time_t;
+typedef struct _zend_early_binding {
+ zend_string *lcname;
+ zend_string *rtd_key;
+ zend_string *lc_parent_name;
+ uint32_t cache_slot;
+} zend_early_binding;
+typedef struct _zend_persistent_script {
+ zend_script script;
+ zend_long compiler_halt_offset;
+ int ping_auto_globals_mask;
+ accel_time_t timestamp;
+ _Bool corrupted;
+ _Bool is_phar;
+ _Bool empty;
+ uint32_t num_warnings;
+ uint32_t num_early_bindings;
+ zend_error_info **warnings;
+ zend_early_binding *early_bindings;
+ void *mem;
+ size_t size;
+ struct zend_persistent_script_dynamic_members {
+  time_t last_used;
+  zend_ulong hits;
+  unsigned int memory_consumption;
+  time_t revalidate;
+ } dynamic_members;
+} zend_persistent_script;
+typedef struct _zend_file_cache_metainfo {
+ char magic[8];
+ char system_id[32];
+ size_t mem_size;
+ size_t str_size;
+ size_t script_offset;
+ accel_time_t timestamp;
+ uint32_t checksum;
+} zend_file_cache_metainfo;
+
+/* Imported functions */
+extern void zend_deserialize_opcode_handler(zend_op *);
+
+/* Imported globals */
+
@@ -0,0 +1,122 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Analysis;
+
+/**
+ * A maximal run of oplines entered only at its first one and left only after its last one
+ *
+ * Edges are block indexes of the owning ControlFlowGraph. Normal successors are the ones the
+ * last opline transfers control to; handler successors are the catch and finally blocks any
+ * opline of the block reaches by throwing.
+ */
+final class BasicBlock
+{
+    /**
+     * Blocks control flows to after the last opline, jump targets first, fall-through last
+     *
+     * @var list<int>
+     */
+    public private(set) array $successors = [];
+
+    /**
+     * Catch and finally blocks an exception thrown inside this block unwinds to
+     *
+     * @var list<int>
+     */
+    public private(set) array $handlers = [];
+
+    /**
+     * Blocks with an edge of either kind to this one
+     *
+     * @var list<int>
+     */
+    public private(set) array $predecessors = [];
+
+    /**
+     * Whether the entry reaches this block, through normal or exception edges
+     */
+    public private(set) bool $reachable = false;
+
+    /**
+     * @param int $index Position of the block in ControlFlowGraph::getBlocks()
+     * @param int $start First opline
+     * @param int $end   Opline after the last one
+     */
+    public function __construct(
+        public readonly int $index,
+        public readonly int $start,
+        public readonly int $end,
+    ) {}
+
+    /**
+     * Returns the number of oplines of the block
+     */
+    public function getLength(): int
+    {
+        return $this->end - $this->start;
+    }
+
+    /**
+     * Returns the last opline
+     */
+    public function getLast(): int
+    {
+        return $this->end - 1;
+    }
+
+    /**
+     * @internal edges are wired by ControlFlowGraph
+     */
+    public function addSuccessor(self $successor): void
+    {
+        if (!\in_array($successor->index, $this->successors, true)) {
+            $this->successors[] = $successor->index;
+            if (!\in_array($this->index, $successor->predecessors, true)) {
+                $successor->predecessors[] = $this->index;
+            }
+        }
+    }
+
+    /**
+     * @internal edges are wired by ControlFlowGraph
+     */
+    public function addHandler(self $handler): void
+    {
+        if (!\in_array($handler->index, $this->handlers, true)) {
+            $this->handlers[] = $handler->index;
+            if (!\in_array($this->index, $handler->predecessors, true)) {
+                $handler->predecessors[] = $this->index;
+            }
+        }
+    }
+
+    /**
+     * @internal computed by ControlFlowGraph
+     */
+    public function markReachable(): void
+    {
+        $this->reachable = true;
+    }
+
+    public function __debugInfo(): array
+    {
+        return [
+            'oplines'      => [$this->start, $this->end],
+            'successors'   => $this->successors,
+            'handlers'     => $this->handlers,
+            'predecessors' => $this->predecessors,
+            'reachable'    => $this->reachable,
+        ];
+    }
+}
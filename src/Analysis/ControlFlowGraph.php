@@ -0,0 +1,460 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Analysis;
+
+use ZEngine\Core;
+use ZEngine\Generated\zend_op;
+use ZEngine\Generated\zend_op_array;
+use ZEngine\OpCache\ReflectionOpcacheFile;
+use ZEngine\Reflection\OpArrayRewriter;
+use ZEngine\Reflection\ReflectionFunction;
+use ZEngine\Reflection\ReflectionMethod;
+use ZEngine\Reflection\ReflectionValue;
+use ZEngine\System\OpCode;
+use ZEngine\Type\LiveRange;
+use ZEngine\Type\OpLine;
+use ZEngine\Type\TryCatchElement;
+
+/**
+ * Basic blocks of one op_array, with normal and exception edges and loop back-edges
+ *
+ * The oplines are read in one copy of the opcodes block and decoded in PHP, so building a graph
+ * costs one FFI crossing per function plus one per SWITCH/MATCH jump table - whole cache images
+ * are analysed in seconds. Operands are position-relative on 64-bit builds both in memory and
+ * in opcache file images, which is why the same decoding works for live functions and for
+ * relocated images from ReflectionOpcacheFile:
+ *
+ *     foreach (ControlFlowGraph::allOf($cacheFile->getReflection()) as $name => $graph) {
+ *         $unreachable = $graph->getUnreachableBlocks();
+ *         $liveness    = Liveness::of($graph);
+ *     }
+ *
+ * Edges follow the VM: jumps and jump tables, fall-through, FAST_CALL into a finally block and
+ * FAST_RET back to the oplines after every FAST_CALL of that block. Exception edges lead from
+ * every block of a try region to its catch block, and from a try or catch region to the
+ * finally block; exceptions leaving the function have no edge.
+ */
+final class ControlFlowGraph
+{
+    /**
+     * Oplines after which control never falls through
+     */
+    private const array NO_FALL_THROUGH = [
+        OpCode::JMP               => true,
+        OpCode::FAST_CALL         => true,
+        OpCode::FAST_RET          => true,
+        OpCode::MATCH             => true,
+        OpCode::RETURN            => true,
+        OpCode::RETURN_BY_REF     => true,
+        OpCode::GENERATOR_RETURN  => true,
+        OpCode::THROW             => true,
+        OpCode::MATCH_ERROR       => true,
+        OpCode::VERIFY_NEVER_TYPE => true,
+    ];
+
+    /**
+     * Opcodes whose op2 literal is a jump table of opline-relative offsets
+     */
+    private const array JUMP_TABLE_OPCODES = [
+        OpCode::SWITCH_LONG   => true,
+        OpCode::SWITCH_STRING => true,
+        OpCode::MATCH         => true,
+    ];
+
+    /**
+     * unpack() format of one zend_op, built from the engine layout on first use
+     */
+    private static ?string $oplineFormat = null;
+
+    /**
+     * @var list<BasicBlock>
+     */
+    private array $blocks = [];
+
+    /**
+     * Block index keyed by its first opline
+     *
+     * @var array<int, int>
+     */
+    private array $blockStarts = [];
+
+    /**
+     * [from block, to block] pairs, computed on first use
+     *
+     * @var list<array{int, int}>|null
+     */
+    private ?array $backEdges = null;
+
+    /**
+     * @param list<array{opcode: int, op1_type: int, op1: int, op2_type: int, op2: int, result_type: int, result: int, extended_value: int, lineno: int}> $oplines
+     * @param array<int, list<int>> $jumpTargets Target oplines keyed by jumping opline
+     * @param list<TryCatchElement> $tryCatch
+     * @param list<LiveRange>       $liveRanges
+     */
+    private function __construct(
+        public readonly string $name,
+        private readonly array $oplines,
+        array $jumpTargets,
+        private readonly array $tryCatch,
+        private readonly array $liveRanges,
+    ) {
+        $this->buildBlocks($jumpTargets);
+    }
+
+    /**
+     * Builds the graph of a user function or method, live or from a cache image
+     */
+    public static function fromFunction(ReflectionFunction|ReflectionMethod $function, string $name = ''): self
+    {
+        if (!$function->isUserDefined()) {
+            throw new \LogicException('Control flow is available only for user-defined functions');
+        }
+        [$oplines, $jumpTargets] = self::decode($function->getOpArrayPointer());
+
+        return new self($name, $oplines, $jumpTargets, $function->getTryCatchElements(), $function->getLiveRanges());
+    }
+
+    /**
+     * Builds the graphs of every op_array of a cache image: the script, its functions and the
+     * methods of its classes, keyed by "{main}", function name and "Class::method"
+     *
+     * @return array<string, self>
+     */
+    public static function allOf(ReflectionOpcacheFile $file): array
+    {
+        $graphs = ['{main}' => self::fromFunction($file->getScriptFunction(), '{main}')];
+        foreach ($file->getFunctions() as $functionName => $function) {
+            $graphs[$functionName] = self::fromFunction($function, $functionName);
+        }
+        foreach ($file->getClasses() as $class) {
+            foreach ($class->getMethodTable() as $methodName => $methodValue) {
+                $method = ReflectionMethod::fromRawEntry($methodValue->getRawFunction());
+                if ($method->isUserDefined()) {
+                    $name          = $class->getName() . '::' . $methodName;
+                    $graphs[$name] = self::fromFunction($method, $name);
+                }
+            }
+        }
+
+        return $graphs;
+    }
+
+    /**
+     * @return list<BasicBlock>
+     */
+    public function getBlocks(): array
+    {
+        return $this->blocks;
+    }
+
+    public function getBlock(int $index): BasicBlock
+    {
+        return $this->blocks[$index];
+    }
+
+    /**
+     * Returns the block holding the given opline
+     */
+    public function getBlockOf(int $opline): BasicBlock
+    {
+        if ($opline < 0 || $opline >= \count($this->oplines)) {
+            throw new \OutOfRangeException("Opline #{$opline} is outside of the op_array");
+        }
+        $low  = 0;
+        $high = \count($this->blocks) - 1;
+        while ($low < $high) {
+            $middle = ($low + $high + 1) >> 1;
+            if ($this->blocks[$middle]->start <= $opline) {
+                $low = $middle;
+            } else {
+                $high = $middle - 1;
+            }
+        }
+
+        return $this->blocks[$low];
+    }
+
+    /**
+     * Returns the decoded oplines: opcode, operand types, raw operands (CONST operands and
+     * jumps are opline-relative byte offsets, variables are frame offsets) and line numbers
+     *
+     * @return list<array{opcode: int, op1_type: int, op1: int, op2_type: int, op2: int, result_type: int, result: int, extended_value: int, lineno: int}>
+     */
+    public function getOplines(): array
+    {
+        return $this->oplines;
+    }
+
+    public function getOplineCount(): int
+    {
+        return \count($this->oplines);
+    }
+
+    /**
+     * @return list<TryCatchElement>
+     */
+    public function getTryCatchElements(): array
+    {
+        return $this->tryCatch;
+    }
+
+    /**
+     * @return list<LiveRange>
+     */
+    public function getLiveRanges(): array
+    {
+        return $this->liveRanges;
+    }
+
+    /**
+     * Returns the normal edges closing a loop: [from block, to block], where the target is still
+     * on the depth-first path from the entry when the edge is walked
+     *
+     * @return list<array{int, int}>
+     */
+    public function getBackEdges(): array
+    {
+        if ($this->backEdges !== null) {
+            return $this->backEdges;
+        }
+        $backEdges = [];
+        if ($this->blocks === []) {
+            return $this->backEdges = $backEdges;
+        }
+        // 1 - on the depth-first stack, 2 - finished
+        $state = [0 => 1];
+        $stack = [[0, 0]];
+        while ($stack !== []) {
+            $top                   = \count($stack) - 1;
+            [$block, $successorAt] = $stack[$top];
+            $successors            = $this->blocks[$block]->successors;
+            if ($successorAt === \count($successors)) {
+                $state[$block] = 2;
+                array_pop($stack);
+                continue;
+            }
+            $stack[$top][1]++;
+            $successor = $successors[$successorAt];
+            if (!isset($state[$successor])) {
+                $state[$successor] = 1;
+                $stack[]           = [$successor, 0];
+            } elseif ($state[$successor] === 1) {
+                $backEdges[] = [$block, $successor];
+            }
+        }
+
+        return $this->backEdges = $backEdges;
+    }
+
+    /**
+     * Returns the first blocks of loops (targets of back-edges)
+     *
+     * @return list<int>
+     */
+    public function getLoopHeaders(): array
+    {
+        return array_values(array_unique(array_column($this->getBackEdges(), 1)));
+    }
+
+    /**
+     * Returns the blocks the entry never reaches: dead code
+     *
+     * @return list<BasicBlock>
+     */
+    public function getUnreachableBlocks(): array
+    {
+        return array_values(array_filter($this->blocks, static fn(BasicBlock $block): bool => !$block->reachable));
+    }
+
+    /**
+     * @param array<int, list<int>> $jumpTargets
+     */
+    private function buildBlocks(array $jumpTargets): void
+    {
+        $total = \count($this->oplines);
+        if ($total === 0) {
+            return;
+        }
+
+        $leaders = [0 => true];
+        foreach ($jumpTargets as $targets) {
+            foreach ($targets as $target) {
+                $leaders[$target] = true;
+            }
+        }
+        foreach ($this->oplines as $index => $opline) {
+            if (isset($jumpTargets[$index]) || isset(self::NO_FALL_THROUGH[$opline['opcode']])) {
+                $leaders[$index + 1] = true;
+            }
+        }
+        foreach ($this->tryCatch as $element) {
+            $leaders[$element->getTryOp()] = true;
+            foreach ([$element->getCatchOp(), $element->getFinallyOp(), $element->getFinallyEnd()] as $boundary) {
+                if ($boundary !== 0) {
+                    $leaders[$boundary] = true;
+                }
+            }
+        }
+        unset($leaders[$total]);
+        ksort($leaders);
+
+        $starts = array_keys($leaders);
+        foreach ($starts as $position => $start) {
+            $this->blocks[]            = new BasicBlock($position, $start, $starts[$position + 1] ?? $total);
+            $this->blockStarts[$start] = $position;
+        }
+
+        // FAST_RET returns to the opline after the FAST_CALL that entered its finally block
+        $returnPoints = [];
+        foreach ($this->oplines as $index => $opline) {
+            if ($opline['opcode'] === OpCode::FAST_CALL) {
+                $returnPoints[$jumpTargets[$index][0]][] = $index + 1;
+            }
+        }
+
+        foreach ($this->blocks as $block) {
+            $last   = $block->getLast();
+            $opcode = $this->oplines[$last]['opcode'];
+            foreach ($jumpTargets[$last] ?? [] as $target) {
+                $block->addSuccessor($this->blocks[$this->blockStarts[$target]]);
+            }
+            if ($opcode === OpCode::FAST_RET) {
+                foreach ($this->tryCatch as $element) {
+                    if ($element->getFinallyOp() !== 0 && $last >= $element->getFinallyOp() && $last <= $element->getFinallyEnd()) {
+                        foreach ($returnPoints[$element->getFinallyOp()] ?? [] as $returnPoint) {
+                            $block->addSuccessor($this->blocks[$this->blockStarts[$returnPoint]]);
+                        }
+                    }
+                }
+            }
+            if (!isset(self::NO_FALL_THROUGH[$opcode]) && $block->end < $total) {
+                $block->addSuccessor($this->blocks[$this->blockStarts[$block->end]]);
+            }
+            foreach ($this->tryCatch as $element) {
+                $tryOp     = $element->getTryOp();
+                $catchOp   = $element->getCatchOp();
+                $finallyOp = $element->getFinallyOp();
+                if ($catchOp !== 0 && $block->start >= $tryOp && $block->start < $catchOp) {
+                    $block->addHandler($this->blocks[$this->blockStarts[$catchOp]]);
+                }
+                // The catch blocks precede the finally block: both regions unwind into it
+                if ($finallyOp !== 0 && $block->start >= $tryOp && $block->start < $finallyOp) {
+                    $block->addHandler($this->blocks[$this->blockStarts[$finallyOp]]);
+                }
+            }
+        }
+
+        $pending = [0];
+        $this->blocks[0]->markReachable();
+        while ($pending !== []) {
+            $block = $this->blocks[array_pop($pending)];
+            foreach ([...$block->successors, ...$block->handlers] as $next) {
+                if (!$this->blocks[$next]->reachable) {
+                    $this->blocks[$next]->markReachable();
+                    $pending[] = $next;
+                }
+            }
+        }
+    }
+
+    /**
+     * Copies the opcodes block out in one read and decodes it, resolving every jump
+     *
+     * @param zend_op_array $opArray
+     *
+     * @return array{list<array{opcode: int, op1_type: int, op1: int, op2_type: int, op2: int, result_type: int, result: int, extended_value: int, lineno: int}>, array<int, list<int>>}
+     */
+    private static function decode(object $opArray): array
+    {
+        $total = $opArray->last;
+        if ($total === 0 || $opArray->opcodes === null) {
+            return [[], []];
+        }
+        $opcodeSize = Core::sizeOfType(zend_op::class);
+        $format     = self::$oplineFormat ??= self::buildOplineFormat();
+        $bytes      = \FFI::string(Core::cast('char *', $opArray->opcodes), $total * $opcodeSize);
+        $base       = Core::addressOf($opArray->opcodes);
+
+        $oplines     = [];
+        $jumpTargets = [];
+        for ($index = 0; $index < $total; $index++) {
+            $opline = unpack($format, $bytes, $index * $opcodeSize);
+            assert(\is_array($opline));
+            $oplines[] = $opline;
+
+            $targets = [];
+            foreach (OpArrayRewriter::jumpFieldsOf($opline['opcode'], $opline['extended_value']) as $field) {
+                $targets[] = $index + intdiv(self::signed($opline[$field]), $opcodeSize);
+            }
+            if (isset(self::JUMP_TABLE_OPCODES[$opline['opcode']]) && $opline['op2_type'] === OpLine::IS_CONST) {
+                $table = null;
+                ReflectionValue::fromValueEntry(Core::pointerAtAddress(
+                    'zval *',
+                    $base + $index * $opcodeSize + self::signed($opline['op2']),
+                ))->getNativeValue($table);
+                foreach ($table as $offset) {
+                    $targets[] = $index + intdiv($offset, $opcodeSize);
+                }
+            }
+            if ($targets !== []) {
+                $jumpTargets[$index] = array_values(array_unique($targets));
+            }
+        }
+
+        return [$oplines, $jumpTargets];
+    }
+
+    /**
+     * Lays the unpack() codes out at the field offsets of the engine's zend_op
+     */
+    private static function buildOplineFormat(): string
+    {
+        $fields = [
+            'op1'            => 'L',
+            'op2'            => 'L',
+            'result'         => 'L',
+            'extended_value' => 'L',
+            'lineno'         => 'L',
+            'opcode'         => 'C',
+            'op1_type'       => 'C',
+            'op2_type'       => 'C',
+            'result_type'    => 'C',
+        ];
+        $offsets = [];
+        foreach ($fields as $field => $code) {
+            $offsets[$field] = Core::offsetOfField(zend_op::class, $field);
+        }
+        asort($offsets);
+
+        $format   = [];
+        $position = 0;
+        foreach ($offsets as $field => $offset) {
+            if ($offset > $position) {
+                $format[] = 'x' . ($offset - $position);
+            }
+            $format[] = $fields[$field] . $field;
+            $position = $offset + ($fields[$field] === 'L' ? 4 : 1);
+        }
+
+        return implode('/', $format);
+    }
+
+    /**
+     * znode_op offsets are uint32_t holding signed values
+     */
+    private static function signed(int $unsigned): int
+    {
+        return $unsigned >= 0x80000000 ? $unsigned - 0x100000000 : $unsigned;
+    }
+}
@@ -0,0 +1,200 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Analysis;
+
+use ZEngine\System\OpCode;
+use ZEngine\Type\OpLine;
+
+/**
+ * Live compiled variables and temporaries of a ControlFlowGraph, per block and per opline
+ *
+ * Variables are identified by their frame offset, the raw operand value the oplines carry, so
+ * CVs and TMP/VAR slots share one numbering. A temporary is defined by the opline naming it as
+ * its result; a CV only by ASSIGN, ASSIGN_REF and UNSET_CV - every other CV operand counts as
+ * a read, which keeps the result conservative for by-reference and compound writes.
+ *
+ * Exception edges are followed too: whatever a catch or finally block reads is live in the
+ * whole protected region, since any opline there may throw. Variables are not tracked through
+ * references or dynamic access ($$name, compact(), extract()), so a CV that is not live may
+ * still be observed that way.
+ */
+final class Liveness
+{
+    private const int VARIABLE = OpLine::IS_TMP_VAR | OpLine::IS_VAR | OpLine::IS_CV;
+
+    /**
+     * Opcodes that overwrite their op1 CV without reading it for the result
+     */
+    private const array CV_DEFINITIONS = [
+        OpCode::ASSIGN     => true,
+        OpCode::ASSIGN_REF => true,
+        OpCode::UNSET_CV   => true,
+    ];
+
+    /**
+     * IS_SMART_BRANCH_JMPZ | IS_SMART_BRANCH_JMPNZ: a fused comparison stores no result
+     */
+    private const int SMART_BRANCH_MASK = (1 << 4) | (1 << 5);
+
+    /**
+     * @param list<array<int, true>> $liveIn  Variables live at the start of each block
+     * @param list<array<int, true>> $liveOut Variables live at the end of each block
+     */
+    private function __construct(
+        private readonly ControlFlowGraph $graph,
+        private readonly array $liveIn,
+        private readonly array $liveOut,
+    ) {}
+
+    /**
+     * Solves the backward dataflow problem over the graph
+     */
+    public static function of(ControlFlowGraph $graph): self
+    {
+        $blocks  = $graph->getBlocks();
+        $oplines = $graph->getOplines();
+        $uses    = $definitions = [];
+        foreach ($blocks as $index => $block) {
+            $used = $defined = [];
+            for ($position = $block->start; $position < $block->end; $position++) {
+                foreach (self::readsOf($oplines[$position]) as $variable) {
+                    if (!isset($defined[$variable])) {
+                        $used[$variable] = true;
+                    }
+                }
+                foreach (self::writesOf($oplines[$position]) as $variable) {
+                    $defined[$variable] = true;
+                }
+            }
+            $uses[$index]        = $used;
+            $definitions[$index] = $defined;
+        }
+
+        $liveIn  = array_fill(0, \count($blocks), []);
+        $liveOut = array_fill(0, \count($blocks), []);
+        $pending = array_fill_keys(array_keys($blocks), true);
+        while ($pending !== []) {
+            $index = array_key_last($pending);
+            unset($pending[$index]);
+            $block = $blocks[$index];
+
+            $out = [];
+            foreach ([...$block->successors, ...$block->handlers] as $successor) {
+                $out += $liveIn[$successor];
+            }
+            $in = $uses[$index] + array_diff_key($out, $definitions[$index]);
+            foreach ($block->handlers as $handler) {
+                $in += $liveIn[$handler];
+            }
+            $liveOut[$index] = $out;
+            if (\count($in) !== \count($liveIn[$index])) {
+                $liveIn[$index] = $in;
+                foreach ($block->predecessors as $predecessor) {
+                    $pending[$predecessor] = true;
+                }
+            }
+        }
+
+        return new self($graph, $liveIn, $liveOut);
+    }
+
+    /**
+     * @return list<int> Frame offsets of the variables live when the block is entered
+     */
+    public function getLiveIn(int $block): array
+    {
+        return array_keys($this->liveIn[$block]);
+    }
+
+    /**
+     * @return list<int> Frame offsets of the variables live when the block is left
+     */
+    public function getLiveOut(int $block): array
+    {
+        return array_keys($this->liveOut[$block]);
+    }
+
+    /**
+     * Returns the variables live right after the given opline executed
+     *
+     * Temporaries covered by one of the op_array's live ranges at the next opline are included
+     * as well: the engine releases them from there if an exception unwinds the frame.
+     *
+     * @return list<int> Frame offsets
+     */
+    public function getLiveAfter(int $opline): array
+    {
+        $block   = $this->graph->getBlockOf($opline);
+        $oplines = $this->graph->getOplines();
+        $live    = $this->liveOut[$block->index];
+        for ($position = $block->getLast(); $position > $opline; $position--) {
+            foreach (self::writesOf($oplines[$position]) as $variable) {
+                unset($live[$variable]);
+            }
+            foreach (self::readsOf($oplines[$position]) as $variable) {
+                $live[$variable] = true;
+            }
+        }
+        foreach ($this->graph->getLiveRanges() as $range) {
+            if ($range->getStart() <= $opline + 1 && $opline + 1 < $range->getEnd()) {
+                $live[$range->getVariableOffset()] = true;
+            }
+        }
+
+        return array_keys($live);
+    }
+
+    public function isLiveAfter(int $opline, int $variable): bool
+    {
+        return \in_array($variable, $this->getLiveAfter($opline), true);
+    }
+
+    /**
+     * @param array{opcode: int, op1_type: int, op1: int, op2_type: int, op2: int, result_type: int, result: int} $opline
+     *
+     * @return list<int>
+     */
+    private static function readsOf(array $opline): array
+    {
+        $reads = [];
+        if (($opline['op1_type'] & self::VARIABLE) !== 0
+            && !($opline['op1_type'] === OpLine::IS_CV && isset(self::CV_DEFINITIONS[$opline['opcode']]))
+        ) {
+            $reads[] = $opline['op1'];
+        }
+        if (($opline['op2_type'] & self::VARIABLE) !== 0) {
+            $reads[] = $opline['op2'];
+        }
+
+        return $reads;
+    }
+
+    /**
+     * @param array{opcode: int, op1_type: int, op1: int, op2_type: int, op2: int, result_type: int, result: int} $opline
+     *
+     * @return list<int>
+     */
+    private static function writesOf(array $opline): array
+    {
+        $writes = [];
+        if ($opline['op1_type'] === OpLine::IS_CV && isset(self::CV_DEFINITIONS[$opline['opcode']])) {
+            $writes[] = $opline['op1'];
+        }
+        if (($opline['result_type'] & self::VARIABLE) !== 0 && ($opline['result_type'] & self::SMART_BRANCH_MASK) === 0) {
+            $writes[] = $opline['result'];
+        }
+
+        return $writes;
+    }
+}
@@ -0,0 +1,24 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\ClassExtension\Hook;
+
+/**
+ * Native count_elements stub (count($object) answered without entering PHP)
+ */
+final class CountElementsStubHook extends NativeStubHook
+{
+    protected const string HOOK_FIELD = 'count_elements';
+
+    protected const string STUB_TYPE = 'zend_object_count_elements_t';
+}
@@ -0,0 +1,70 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\ClassExtension\Hook;
+
+use FFI\CData;
+use ZEngine\ClassExtension\Native\NativeStubs;
+use ZEngine\Core;
+use ZEngine\Hook\AbstractHook;
+
+/**
+ * Hook whose handler is a generated machine-code stub instead of a PHP callback
+ *
+ * The engine calls the stub directly: no libffi trampoline, no PHP frame, so handle() is
+ * never reached. Everything else is the ordinary AbstractHook lifecycle - install() captures
+ * the original pointer and registers the hook, uninstall() and Core::shutdown() restore it.
+ *
+ * @see NativeStubs
+ */
+abstract class NativeStubHook extends AbstractHook
+{
+    /**
+     * Function pointer type of the hooked field, the stub address is cast to it
+     */
+    protected const string STUB_TYPE = 'void *';
+
+    /**
+     * @param int   $stubAddress  Entry point of a stub from NativeStubs
+     * @param CData $rawStructure Handlers block that holds the field
+     */
+    public function __construct(private readonly int $stubAddress, $rawStructure)
+    {
+        parent::__construct(static fn() => null, $rawStructure);
+    }
+
+    /**
+     * Never called: the engine runs the stub itself
+     *
+     * @inheritDoc
+     */
+    #[\Override]
+    final public function handle(...$rawArguments)
+    {
+        throw new \LogicException('Native stub hooks are executed by the engine directly');
+    }
+
+    /**
+     * Returns the entry point of the installed stub
+     */
+    final public function getStubAddress(): int
+    {
+        return $this->stubAddress;
+    }
+
+    #[\Override]
+    final protected function createTrampoline(): CData
+    {
+        return Core::pointerAtAddress(static::STUB_TYPE, $this->stubAddress);
+    }
+}
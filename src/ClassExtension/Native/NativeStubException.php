@@ -0,0 +1,45 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\ClassExtension\Native;
+
+/**
+ * Raised when native handler stubs cannot be generated or installed in the current process
+ */
+final class NativeStubException extends \RuntimeException
+{
+    public static function unsupportedPlatform(string $platformKey): self
+    {
+        return new self(sprintf(
+            'Native handler stubs are generated for linux-x64 NTS builds only, this process is %s; '
+            . 'install the equivalent PHP hooks instead',
+            $platformKey,
+        ));
+    }
+
+    public static function mappingFailed(string $operation): self
+    {
+        return new self(sprintf(
+            '%s refused the executable stub region (a W^X policy such as SELinux deny_execmem?)',
+            $operation,
+        ));
+    }
+
+    public static function multiplexedClass(string $className): self
+    {
+        return new self(sprintf(
+            'Class %s shares the multiplexed handlers block; a native stub would apply to every class in it',
+            $className,
+        ));
+    }
+}
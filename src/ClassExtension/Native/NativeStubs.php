@@ -0,0 +1,268 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\ClassExtension\Native;
+
+use Closure;
+use FFI;
+use ZEngine\Core;
+
+/**
+ * Generator of tiny x86-64 object handlers for patterns that need no PHP at call time
+ *
+ * A hook installed through Path A (docs/memory-model.md) pays a libffi crossing into PHP and
+ * back on every call. Some handlers are so fixed that PHP has nothing to decide: rejecting
+ * a property write, reporting a constant count. For those a few dozen bytes of machine code
+ * do the job at C speed. Each stub is assembled here from a fixed template, with the engine
+ * addresses it needs (zend_throw_error(), zend_std_write_property(), &EG(error_zval)) baked
+ * in as 64-bit immediates, and written into its own anonymous page that is sealed read+exec
+ * before the engine can see it - no page is ever writable and executable at the same time.
+ *
+ * Stubs are immutable and shared: one per pattern (and per count value), generated on first
+ * use, alive for the process lifetime like the libffi trampolines they replace. Installation
+ * goes through the AbstractHook machinery (NativeStubHook), so install/uninstall/shutdown
+ * keep their usual guarantees.
+ *
+ * Only linux-x64 NTS builds are supported: the stubs follow the System V calling convention,
+ * and EG(error_zval) has a fixed address only without thread-local executor globals.
+ */
+final class NativeStubs
+{
+    private const int PAGE_SIZE = 4096;
+
+    private const int PROT_READ  = 0x1;
+    private const int PROT_WRITE = 0x2;
+    private const int PROT_EXEC  = 0x4;
+
+    private const int MAP_PRIVATE   = 0x02;
+    private const int MAP_ANONYMOUS = 0x20;
+
+    /**
+     * has_set_exists argument of has_property: "is the property there, even if null"
+     */
+    private const int ZEND_PROPERTY_EXISTS = 0x2;
+
+    /**
+     * Process-image symbols the generator needs: the mapping primitives and the engine
+     * functions whose addresses are baked into the stubs (never called through FFI)
+     */
+    private const string NATIVE_DEFINITION = <<<'C'
+        void *mmap(void *addr, size_t length, int prot, int flags, int fd, long offset);
+        int mprotect(void *addr, size_t len, int prot);
+        void zend_throw_error(void *exception_ce, const char *format, ...);
+        void *zend_std_write_property(void *zobj, void *name, void *value, void **cache_slot);
+        int zend_std_has_property(void *zobj, void *name, int has_set_exists, void **cache_slot);
+        C;
+
+    private static ?FFI $native = null;
+
+    /**
+     * Generated stub addresses keyed by pattern
+     *
+     * @var array<string, int>
+     */
+    private static array $stubs = [];
+
+    /**
+     * Checks whether this process can run the generated stubs (linux-x64 NTS)
+     */
+    public static function isAvailable(): bool
+    {
+        return str_ends_with(Core::platformKey(), '/linux-x64-nts');
+    }
+
+    /**
+     * Returns the write_property stub that throws on every write
+     *
+     * Constructors cannot initialize such objects either: fit for classes populated before
+     * the stub is installed, or for sealing every instance at once.
+     */
+    public static function denyPropertyWrite(): int
+    {
+        return self::$stubs['deny-write'] ??= self::emit(
+            'Cannot modify property $%s of an immutable object',
+            static fn(int $message): string => "\x53"    // push rbx (re-aligns the stack)
+                . self::loadNameValue()                 // lea rdx, [rsi + val]
+                . "\x48\xBE" . pack('P', $message)      // mov rsi, message
+                . self::throwError()
+                . self::loadErrorZval()                 // mov rax, &EG(error_zval)
+                . "\x5B"                                // pop rbx
+                . "\xC3",                               // ret
+        );
+    }
+
+    /**
+     * Returns the write_property stub that lets the first write of each property through
+     *
+     * Readonly semantics for whole classes: a write goes to zend_std_write_property() while the
+     * property does not exist yet (a typed property without default before its constructor
+     * assignment), and throws once it does. The runtime cache slot is never passed on, so the
+     * VM cannot warm up its direct-write fast path and skip the handler on later writes.
+     */
+    public static function writeOnceProperty(): int
+    {
+        return self::$stubs['write-once'] ??= self::emit(
+            'Cannot modify initialized property $%s of an immutable object',
+            static function (int $message): string {
+                $write = "\x48\x89\xDF"                 // mov rdi, rbx
+                    . "\x4C\x89\xE6"                    // mov rsi, r12
+                    . "\x4C\x89\xEA"                    // mov rdx, r13
+                    . "\x31\xC9"                        // xor ecx, ecx (no cache slot)
+                    . "\x41\x5D\x41\x5C\x5B"            // pop r13; pop r12; pop rbx
+                    . "\x48\xB8" . pack('P', self::symbolAddress('zend_std_write_property'))
+                    . "\xFF\xE0";                       // jmp rax (tail call)
+
+                return "\x53\x41\x54\x41\x55"           // push rbx; push r12; push r13
+                    . "\x48\x89\xFB"                    // mov rbx, rdi (object)
+                    . "\x49\x89\xF4"                    // mov r12, rsi (name)
+                    . "\x49\x89\xD5"                    // mov r13, rdx (value)
+                    . "\xBA" . pack('V', self::ZEND_PROPERTY_EXISTS) // mov edx, ZEND_PROPERTY_EXISTS
+                    . "\x31\xC9"                        // xor ecx, ecx (no cache slot)
+                    . "\x48\xB8" . pack('P', self::symbolAddress('zend_std_has_property'))
+                    . "\xFF\xD0"                        // call rax
+                    . "\x85\xC0"                        // test eax, eax
+                    . "\x75" . \chr(\strlen($write))    // jnz deny
+                    . $write
+                    // deny:
+                    . "\x49\x8D\x54\x24" . \chr(self::nameValueOffset()) // lea rdx, [r12 + val]
+                    . "\x48\xBE" . pack('P', $message)  // mov rsi, message
+                    . self::throwError()
+                    . self::loadErrorZval()             // mov rax, &EG(error_zval)
+                    . "\x41\x5D\x41\x5C\x5B"            // pop r13; pop r12; pop rbx
+                    . "\xC3";                          // ret
+            },
+        );
+    }
+
+    /**
+     * Returns the unset_property stub that throws on every unset
+     */
+    public static function denyPropertyUnset(): int
+    {
+        return self::$stubs['deny-unset'] ??= self::emit(
+            'Cannot unset property $%s of an immutable object',
+            static fn(int $message): string => "\x53"    // push rbx (re-aligns the stack)
+                . self::loadNameValue()                 // lea rdx, [rsi + val]
+                . "\x48\xBE" . pack('P', $message)      // mov rsi, message
+                . self::throwError()
+                . "\x5B"                                // pop rbx
+                . "\xC3",                               // ret
+        );
+    }
+
+    /**
+     * Returns the count_elements stub that reports the given count
+     */
+    public static function fixedCount(int $count): int
+    {
+        return self::$stubs['count:' . $count] ??= self::emit(
+            '',
+            static fn(int $unused): string => "\x48\xB8" . pack('q', $count) // mov rax, count
+                . "\x48\x89\x06"                       // mov [rsi], rax
+                . "\x31\xC0"                           // xor eax, eax (SUCCESS)
+                . "\xC3",                               // ret
+        );
+    }
+
+    /**
+     * Returns the number of stubs generated so far (each occupies one page)
+     */
+    public static function getStubCount(): int
+    {
+        return \count(self::$stubs);
+    }
+
+    /**
+     * Writes one stub (and its NUL-terminated message) into a fresh page and seals it
+     *
+     * @param string               $message  printf() format the stub throws with ('' for none)
+     * @param Closure(int): string $assemble Builds the code given the address of the message,
+     *                                       the message is placed right after the code
+     *
+     * @return int Address of the first instruction
+     */
+    private static function emit(string $message, Closure $assemble): int
+    {
+        if (!self::isAvailable()) {
+            throw NativeStubException::unsupportedPlatform(Core::platformKey());
+        }
+        $native = self::$native ??= FFI::cdef(self::NATIVE_DEFINITION);
+
+        $page = $native->mmap(
+            null,
+            self::PAGE_SIZE,
+            self::PROT_READ | self::PROT_WRITE,
+            self::MAP_PRIVATE | self::MAP_ANONYMOUS,
+            -1,
+            0,
+        );
+        // MAP_FAILED is (void *) -1, a NULL result arrives as PHP null
+        $address = $page === null ? 0 : $native->cast('intptr_t', $page)->cdata;
+        if ($address === -1 || $address === 0) {
+            throw NativeStubException::mappingFailed('mmap()');
+        }
+        // The code length does not depend on the immediates: assemble once to place the message
+        $codeLength = \strlen($assemble(0));
+        $image      = $assemble($address + $codeLength) . $message . "\0";
+        assert(\strlen($image) <= self::PAGE_SIZE);
+
+        FFI::memcpy($native->cast('unsigned char *', $page), $image, \strlen($image));
+        if ($native->mprotect($page, self::PAGE_SIZE, self::PROT_READ | self::PROT_EXEC) !== 0) {
+            throw NativeStubException::mappingFailed('mprotect()');
+        }
+
+        return $address;
+    }
+
+    /**
+     * xor edi, edi; xor eax, eax; mov r11, zend_throw_error; call r11
+     *
+     * zend_throw_error(NULL, message, name) throws an Error; eax = 0 vector registers for the
+     * variadic call.
+     */
+    private static function throwError(): string
+    {
+        return "\x31\xFF\x31\xC0\x49\xBB" . pack('P', self::symbolAddress('zend_throw_error')) . "\x41\xFF\xD3";
+    }
+
+    /**
+     * lea rdx, [rsi + offsetof(zend_string, val)]: the property name as a C string
+     */
+    private static function loadNameValue(): string
+    {
+        return "\x48\x8D\x56" . \chr(self::nameValueOffset());
+    }
+
+    /**
+     * mov rax, &EG(error_zval): what write_property returns after throwing
+     */
+    private static function loadErrorZval(): string
+    {
+        return "\x48\xB8" . pack('P', Core::$executor->getErrorZvalAddress());
+    }
+
+    private static function nameValueOffset(): int
+    {
+        $offset = Core::offsetOfField('zend_string', 'val');
+        assert($offset < 0x80, 'disp8 addressing');
+
+        return $offset;
+    }
+
+    private static function symbolAddress(string $symbol): int
+    {
+        $native = self::$native ??= FFI::cdef(self::NATIVE_DEFINITION);
+
+        return $native->cast('intptr_t', $native->{$symbol})->cdata;
+    }
+}
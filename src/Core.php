@@ -21,6 +21,7 @@ use RecursiveDirectoryIterator;
 use RecursiveIteratorIterator;
 use RuntimeException;
 use ZEngine\Hook\HookInterface;
+use ZEngine\Hook\HookStatistics;
 use ZEngine\System\Compiler;
 use ZEngine\System\Executor;
 use ZEngine\System\Hook\AstProcessHook;
@@ -194,11 +195,62 @@ class Core
      */
     private const SUPPORTED_PHP_VERSION_ID = [80400, 80500];
 
+    /**
+     * Outcomes of the layout check of one init(), as reported by getBootProfile()
+     *
+     *  - full: every struct of layouts.json was verified (ZENGINE_STRICT_LAYOUT_CHECK=1, or
+     *    =stamp on the first boot of a build);
+     *  - stamp-hit: =stamp found the verified-binding stamp of this exact build and layout
+     *    set, nothing was re-walked;
+     *  - stamp-recorded: =stamp verified in full and recorded the stamp for the next boots;
+     *  - off: no check requested;
+     *  - reused: a re-init that kept the process-wide binding verified by the first boot.
+     */
+    private const string LAYOUT_CHECK_FULL     = 'full';
+    private const string LAYOUT_CHECK_STAMP    = 'stamp-hit';
+    private const string LAYOUT_CHECK_RECORDED = 'stamp-recorded';
+    private const string LAYOUT_CHECK_OFF      = 'off';
+    private const string LAYOUT_CHECK_REUSED   = 'reused';
+
+    /**
+     * Header slices every sliced binding concatenates first, in this order (see engineDefinition())
+     */
+    private const array BASE_HEADER_SLICES = ['values', 'classes', 'executor'];
+
     /**
      * Stores an internal instance of low-level FFI binding
      */
     private static FFI $engine;
 
+    /**
+     * Optional header slices bound after the base slices, or null when the full engine.h is bound
+     *
+     * Selected once per process by ZENGINE_HEADER_SLICES (see engineDefinition()) and kept for
+     * the lifetime of self::$engine: a slice cannot be added to a live binding later, because
+     * a second FFI::cdef() mints its own, incompatible copies of every shared type.
+     *
+     * @var list<string>|null
+     */
+    private static ?array $headerSlices = null;
+
+    /**
+     * Per-process cache of resolved engine types, keyed by the requested type string
+     *
+     * Every cast()/new()/type() used to hand a string to FFI, which runs the C declaration
+     * parser on each call - for "zend_string *" that even allocates a fresh pointer type.
+     * The resolved CType is valid for as long as self::$engine is, which is the lifetime of
+     * the process. Pointer-form entries (cast()/pointerAtAddress() semantics) are kept apart
+     * from plain ones because a stub class means a different C type in each.
+     *
+     * @var array<string, CType>
+     */
+    private static array $resolvedTypes = [];
+
+    /**
+     * @var array<string, CType>
+     */
+    private static array $resolvedPointerTypes = [];
+
     /**
      * Windows only: binding to the C runtime that owns the malloc heap, for persistentFree()
      *
@@ -239,6 +291,11 @@ class Core
      */
     private static array $installedHooks = [];
 
+    /**
+     * Collector of per-field hook figures, null while hook statistics are disabled
+     */
+    private static ?HookStatistics $hookStatistics = null;
+
     /**
      * Names (lowercased) of global functions generated via ReflectionFunction::addFunction()
      *
@@ -282,6 +339,13 @@ class Core
      */
     private static bool $shutdownRegistered = false;
 
+    /**
+     * Cost breakdown of the most recent init(), see getBootProfile()
+     *
+     * @var array{parse?: float, verify?: float, globals?: float, classes?: float, hooks?: float, total?: float, layoutCheck?: string}
+     */
+    private static array $bootProfile = [];
+
     /**
      * Whether Core::init() has completed for this process/thread
      *
@@ -300,13 +364,19 @@ class Core
      * together with the old FFI object, which turns every CData minted against it
      * (module entries, hooks, heap anchors) invalid by the time the exit handlers touch
      * them (issue #108).
+     *
+     * The cost of every phase is recorded for getBootProfile().
      */
     public static function init(): void
     {
+        $bootStart = hrtime(true);
         self::assertSupportedEnvironment();
 
+        $phaseStart  = hrtime(true);
+        $layoutCheck = self::LAYOUT_CHECK_REUSED;
         if (isset(self::$engine)) {
             $engine = self::$engine;
+            $parsed = $phaseStart;
         } else {
             try {
                 $engine = FFI::scope('ZEngine');
@@ -315,18 +385,18 @@ class Core
                     throw new RuntimeException('Preload mode requires that you call Core::preload before');
                 }
                 // If not, then load definitions by hand
-                $definition = file_get_contents(self::resolveArtifact('engine.h'));
-                if ($definition === false) {
-                    throw new RuntimeException('Unable to read the engine definition file');
-                }
-                $engine = FFI::cdef($definition, self::engineLibrary());
+                $engine = FFI::cdef(self::engineDefinition(), self::engineLibrary());
             }
             self::$engine = $engine;
+            $parsed       = hrtime(true);
 
-            if (getenv('ZENGINE_STRICT_LAYOUT_CHECK') === '1') {
-                self::verifyEngineLayouts($engine);
-            }
+            $layoutCheck = match (getenv('ZENGINE_STRICT_LAYOUT_CHECK')) {
+                '1'     => self::verifyEngineLayouts($engine),
+                'stamp' => self::verifyEngineLayoutsOnce($engine),
+                default => self::LAYOUT_CHECK_OFF,
+            };
         }
+        $verified = hrtime(true);
 
         if (\ZEND_THREAD_SAFE) {
             // ZTS: executor_globals/compiler_globals are not linkable symbols - the
@@ -341,6 +411,7 @@ class Core
             self::$compiler  = new Compiler($compilerGlobals);
         }
         self::$modules = HashTable::fromCData(Core::addr($engine->module_registry));
+        $globalsBound  = hrtime(true);
 
         // Deterministic teardown: user shutdown functions run before object destructors and
         // before ext/ffi RSHUTDOWN frees the callback trampolines, so every hooked engine
@@ -355,11 +426,43 @@ class Core
 
         self::preloadFrameworkClasses();
         self::loadEngineConstants();
-        self::installInheritanceCacheInterception();
+        $classesLoaded = hrtime(true);
 
+        self::installInheritanceCacheInterception();
+        $hooksInstalled = hrtime(true);
+
+        self::$bootProfile = [
+            'parse'       => ($parsed - $phaseStart) / 1e9,
+            'verify'      => ($verified - $parsed) / 1e9,
+            'globals'     => ($globalsBound - $verified) / 1e9,
+            'classes'     => ($classesLoaded - $globalsBound) / 1e9,
+            'hooks'       => ($hooksInstalled - $classesLoaded) / 1e9,
+            'total'       => ($hooksInstalled - $bootStart) / 1e9,
+            'layoutCheck' => $layoutCheck,
+        ];
         self::$initialized = true;
     }
 
+    /**
+     * Returns the cost breakdown of the most recent init() of this process/thread
+     *
+     * Phases, in seconds: "parse" binds the engine definitions (FFI::scope() when they were
+     * preloaded, FFI::cdef() over engine.h otherwise - zero on a re-init that reuses the
+     * binding), "verify" is the layout check selected by ZENGINE_STRICT_LAYOUT_CHECK,
+     * "globals" wraps EG/CG and the module registry, "classes" preloads the framework
+     * classes and the constants table, "hooks" installs the engine interceptors; "total"
+     * spans the whole call. "layoutCheck" names what the verify phase actually did (one of
+     * the LAYOUT_CHECK_* outcomes: "full", "stamp-hit", "stamp-recorded", "off", "reused").
+     *
+     * Empty until init() has completed.
+     *
+     * @return array{parse?: float, verify?: float, globals?: float, classes?: float, hooks?: float, total?: float, layoutCheck?: string}
+     */
+    public static function getBootProfile(): array
+    {
+        return self::$bootProfile;
+    }
+
     /**
      * Installs the interceptor over opcache's zend_inheritance_cache_add callback (idempotent)
      *
@@ -632,6 +735,109 @@ class Core
         );
     }
 
+    /**
+     * Reads the engine definitions FFI::cdef() binds when nothing was preloaded
+     *
+     * By default that is the whole engine.h. ZENGINE_HEADER_SLICES trims it for requests that
+     * never reach some subsystems: it names the optional slices to bind ("compiler", "module",
+     * "opcache", comma-separated; "none" for the base slices only), and the base slices
+     * (values and hashtables, classes and functions, executor) plus the named
+     * engine.<slice>.h fragments are concatenated into one definition - less C to parse on
+     * every boot of an FPM worker without preload.
+     *
+     * The slices are composed up front rather than bound on first use: ext/ffi types belong to
+     * the FFI object that parsed them, so a zval* minted by one binding is rejected as an
+     * incompatible argument by the functions of another, and dropping a binding frees its
+     * types under the CData still pointing at them (issue #108). Entry points of an unbound
+     * subsystem fail fast through requireHeaderSlice() instead.
+     *
+     * Artifacts generated before the split carry no slices.json: the full engine.h is bound
+     * then, whatever the variable says.
+     */
+    private static function engineDefinition(): string
+    {
+        $requested = getenv('ZENGINE_HEADER_SLICES');
+        if ($requested === false || $requested === '' || !is_file(self::resolveArtifact('slices.json', false))) {
+            $definition = file_get_contents(self::resolveArtifact('engine.h'));
+            if ($definition === false) {
+                throw new RuntimeException('Unable to read the engine definition file');
+            }
+            self::$headerSlices = null;
+
+            return $definition;
+        }
+
+        $named = $requested === 'none' ? [] : array_map('trim', explode(',', $requested));
+        // The base slices are always bound, naming them changes nothing
+        $slices     = array_values(array_unique(array_diff($named, self::BASE_HEADER_SLICES)));
+        $definition = '';
+        foreach (self::BASE_HEADER_SLICES as $slice) {
+            $definition .= file_get_contents(self::resolveArtifact("engine.{$slice}.h"));
+        }
+        foreach ($slices as $slice) {
+            $fragment = self::resolveArtifact("engine.{$slice}.h", false);
+            if (!is_file($fragment)) {
+                throw new RuntimeException(
+                    "Unknown engine header slice \"{$slice}\" in ZENGINE_HEADER_SLICES (available: "
+                    . implode(', ', self::availableHeaderSlices()) . ')',
+                );
+            }
+            $definition .= file_get_contents($fragment);
+        }
+        self::$headerSlices = $slices;
+
+        return $definition;
+    }
+
+    /**
+     * Names of the optional header slices generated for the current platform
+     *
+     * @return list<string>
+     */
+    private static function availableHeaderSlices(): array
+    {
+        $slices = [];
+        foreach (glob(self::resolveArtifact('engine.*.h', false)) ?: [] as $fragment) {
+            $slice = substr(basename($fragment, '.h'), strlen('engine.'));
+            if (!in_array($slice, self::BASE_HEADER_SLICES, true)) {
+                $slices[] = $slice;
+            }
+        }
+
+        return $slices;
+    }
+
+    /**
+     * Checks whether the engine binding declares the given header slice
+     *
+     * Always true for a base slice, and for a binding of the full engine.h (preloaded or
+     * cdef()'d without ZENGINE_HEADER_SLICES).
+     */
+    public static function hasHeaderSlice(string $slice): bool
+    {
+        return self::$headerSlices === null
+            || in_array($slice, self::BASE_HEADER_SLICES, true)
+            || in_array($slice, self::$headerSlices, true);
+    }
+
+    /**
+     * Guards the entry point of a subsystem whose declarations live in an optional header slice
+     *
+     * Turns what would otherwise surface as an FFI "undefined C type" error deep inside the
+     * subsystem into an actionable one.
+     *
+     * @throws RuntimeException if the slice was left out of ZENGINE_HEADER_SLICES
+     */
+    public static function requireHeaderSlice(string $slice): void
+    {
+        if (!self::hasHeaderSlice($slice)) {
+            throw new RuntimeException(
+                "This feature needs the \"{$slice}\" engine header slice, which ZENGINE_HEADER_SLICES left out "
+                . '(bound: ' . implode(', ', [...self::BASE_HEADER_SLICES, ...(self::$headerSlices ?? [])]) . ')',
+            );
+        }
+    }
+
     /**
      * Library FFI::cdef() must bind the engine definitions to, or null for the process image
      *
@@ -685,15 +891,38 @@ class Core
      * ground truth recorded by the generator (layouts.json). This is the
      * anti-segfault airbag: any silent ABI drift aborts the boot instead of
      * corrupting engine memory later.
+     *
+     * A sliced binding skips the structs slices.json assigns to a slice it left out, and
+     * nothing else: a struct of a bound slice that does not resolve fails the boot like a
+     * mismatch, and so does a struct no slice defines.
      */
-    private static function verifyEngineLayouts(FFI $engine): void
+    private static function verifyEngineLayouts(FFI $engine, ?string $layoutsJson = null): string
     {
-        $layoutsFile = self::resolveArtifact('layouts.json');
-        $layouts     = json_decode((string) file_get_contents($layoutsFile), true, 16, JSON_THROW_ON_ERROR);
+        $layoutsJson ??= (string) file_get_contents(self::resolveArtifact('layouts.json'));
+        $layouts       = json_decode($layoutsJson, true, 16, JSON_THROW_ON_ERROR);
         assert(is_array($layouts) && is_array($layouts['structs']));
 
+        $sliceOf = [];
+        if (self::$headerSlices !== null) {
+            $sliceMap = json_decode((string) file_get_contents(self::resolveArtifact('slices.json')), true, 16, JSON_THROW_ON_ERROR);
+            assert(is_array($sliceMap));
+            foreach ($sliceMap as $slice => $structs) {
+                foreach ($structs as $struct) {
+                    $sliceOf[$struct] = $slice;
+                }
+            }
+        }
+
         $mismatches = [];
         foreach ($layouts['structs'] as $struct => $layout) {
+            if (self::$headerSlices !== null) {
+                $slice = $sliceOf[$struct] ?? throw new RuntimeException(
+                    "No engine header slice defines {$struct} (slices.json), regenerate the engine artifacts",
+                );
+                if (!self::hasHeaderSlice($slice)) {
+                    continue;
+                }
+            }
             $type = $engine->type($struct);
             if ($type->getSize() !== $layout['size']) {
                 $mismatches[] = sprintf('sizeof(%s): FFI=%d C=%d', $struct, $type->getSize(), $layout['size']);
@@ -711,6 +940,88 @@ class Core
                 . implode("\n", $mismatches),
             );
         }
+
+        return self::LAYOUT_CHECK_FULL;
+    }
+
+    /**
+     * Verifies the engine layouts once per build and layout set, recording a stamp on success
+     * (ZENGINE_STRICT_LAYOUT_CHECK=stamp)
+     *
+     * Without a preload script every FPM request boots the bridge from scratch, and walking
+     * every struct of layouts.json through FFI type lookups is the dominant share of a strict
+     * boot. The verdict of that walk depends on three inputs only: the engine build (its
+     * zend_system_id), the header slices bound (see engineDefinition()) and the ground truth
+     * it is compared against (the layouts.json bytes).
+     * Once a boot has verified that exact triple, a stamp file named after its fingerprint is
+     * written into the stamp directory (see layoutStampDirectory()), and later boots that find
+     * it skip the walk.
+     *
+     * A PHP upgrade, a regenerated layouts.json or a different thread-safety mode all change
+     * the fingerprint and trigger one full verification again. The stamp is best-effort: an
+     * unwritable or untrusted directory just means every boot verifies in full, exactly like =1.
+     */
+    private static function verifyEngineLayoutsOnce(FFI $engine): string
+    {
+        $layoutsJson = (string) file_get_contents(self::resolveArtifact('layouts.json'));
+        $slices      = self::$headerSlices === null ? '*' : implode(',', self::$headerSlices);
+        $fingerprint = hash('xxh128', self::systemId() . "\0" . $slices . "\0" . $layoutsJson);
+
+        $stampDirectory = self::layoutStampDirectory();
+        if ($stampDirectory === null) {
+            return self::verifyEngineLayouts($engine, $layoutsJson);
+        }
+        $stampFile = $stampDirectory . DIRECTORY_SEPARATOR . "z-engine-layouts-{$fingerprint}.stamp";
+        if (is_file($stampFile)) {
+            return self::LAYOUT_CHECK_STAMP;
+        }
+
+        self::verifyEngineLayouts($engine, $layoutsJson);
+
+        // Publish atomically: a concurrent boot sees either no stamp or a complete one
+        $pendingFile = @tempnam($stampDirectory, 'z-engine-layouts-');
+        if ($pendingFile === false) {
+            return self::LAYOUT_CHECK_FULL;
+        }
+        if (@file_put_contents($pendingFile, self::platformKey() . "\n") === false || !@rename($pendingFile, $stampFile)) {
+            @unlink($pendingFile);
+
+            return self::LAYOUT_CHECK_FULL;
+        }
+
+        return self::LAYOUT_CHECK_RECORDED;
+    }
+
+    /**
+     * Directory of the verified-binding stamps, or null when it cannot be trusted
+     *
+     * A stamp vouches for the layouts of the running binding, so whoever can write one can make
+     * later boots skip the check. Stamps therefore never go straight into the shared temp
+     * directory: the default is a per-user directory under it, created 0700, and both that and
+     * a ZENGINE_LAYOUT_STAMP_DIR must belong to the user running PHP and be writable by nobody
+     * else. Windows temp directories are per-user already.
+     */
+    private static function layoutStampDirectory(): ?string
+    {
+        $user      = \function_exists('posix_geteuid') ? posix_geteuid() : getmyuid();
+        $directory = getenv('ZENGINE_LAYOUT_STAMP_DIR');
+        if ($directory === false || $directory === '') {
+            $directory = sys_get_temp_dir() . DIRECTORY_SEPARATOR . "z-engine-{$user}";
+            if (!is_dir($directory) && !@mkdir($directory, 0700) && !is_dir($directory)) {
+                return null;
+            }
+        }
+        if (\DIRECTORY_SEPARATOR === '\\') {
+            return $directory;
+        }
+
+        clearstatcache(true, $directory);
+        $permissions = @fileperms($directory);
+        if (!is_dir($directory) || @fileowner($directory) !== $user || $permissions === false || ($permissions & 0o022) !== 0) {
+            return null;
+        }
+
+        return $directory;
     }
 
     /**
@@ -744,6 +1055,36 @@ class Core
         return $asPointer ? "{$cName} *" : $cName;
     }
 
+    /**
+     * Resolves a type string (C type name or stub class) to a cached engine CType
+     *
+     * Array types ("char[{$size}]" and the like) bypass the cache: their names embed run-time
+     * lengths, so caching them would grow the table without bound for no reuse.
+     */
+    private static function resolveType(string $type, bool $asPointer = false): CType|string
+    {
+        if ($asPointer) {
+            if (isset(self::$resolvedPointerTypes[$type])) {
+                return self::$resolvedPointerTypes[$type];
+            }
+            $cName = self::resolveCName($type, asPointer: true);
+            if (str_contains($cName, '[')) {
+                return $cName;
+            }
+
+            return self::$resolvedPointerTypes[$type] = self::$engine->type($cName);
+        }
+        if (isset(self::$resolvedTypes[$type])) {
+            return self::$resolvedTypes[$type];
+        }
+        $cName = self::resolveCName($type);
+        if (str_contains($cName, '[')) {
+            return $cName;
+        }
+
+        return self::$resolvedTypes[$type] = self::$engine->type($cName);
+    }
+
     /**
      * Runtime boundary check behind the object-widened entry points: values typed as
      * generated struct stubs for the analyser are always FFI\CData handles at runtime,
@@ -796,7 +1137,27 @@ class Core
             // Not an array: cast directly
         }
 
-        return self::$engine->cast(self::resolveCName($type, asPointer: true), $pointer);
+        return self::$engine->cast(self::resolveType($type, asPointer: true), $pointer);
+    }
+
+    /**
+     * Casts a pointer to another pointer type, without cast()'s array-decay probe
+     *
+     * cast() has to find out whether it was handed a C array, and the only leak-free way to
+     * ask is a count() that throws for everything else - an exception per call on paths that
+     * already know they hold a pointer (frame and opline arithmetic, Core::addr() results).
+     * Passing a C array here reinterprets its leading bytes as the pointer value, exactly the
+     * PHP 8.3+ FFI::cast() behaviour cast() protects against.
+     *
+     * @template T of object
+     * @param class-string<T>|string $type    Same forms as cast()
+     * @param CData|object           $pointer Pointer CData (never a C array); statically
+     *                                        stub-typed views are accepted
+     * @return ($type is class-string<T> ? T : CData)
+     */
+    public static function castPointer(string $type, object $pointer): object
+    {
+        return self::$engine->cast(self::resolveType($type, asPointer: true), self::toCData($pointer));
     }
 
     /**
@@ -819,7 +1180,9 @@ class Core
      */
     public static function sizeOfType(string $type): int
     {
-        return FFI::sizeof(self::$engine->type(self::resolveCName($type)));
+        $cType = self::resolveType($type);
+
+        return FFI::sizeof($cType instanceof CType ? $cType : self::$engine->type($cType));
     }
 
     /**
@@ -893,7 +1256,7 @@ class Core
      */
     public static function pointerAtAddress(string $type, int $address): object
     {
-        return self::$engine->cast(self::resolveCName($type, asPointer: true), $address);
+        return self::$engine->cast(self::resolveType($type, asPointer: true), $address);
     }
 
     /**
@@ -922,7 +1285,7 @@ class Core
      */
     public static function new(string $type, bool $owned = true, bool $persistent = false): object
     {
-        return self::$engine->new(self::resolveCName($type), $owned, $persistent);
+        return self::$engine->new(self::resolveType($type), $owned, $persistent);
     }
 
     /**
@@ -1071,6 +1434,85 @@ class Core
         return $chain === [] ? null : end($chain);
     }
 
+    /**
+     * Returns the callable a hook writes into its engine slot
+     *
+     * That is the hook's own handle() while hook statistics are disabled - no cost at all - and
+     * a wrapper that counts and times every call into the collector while they are enabled.
+     *
+     * @internal called by hooks at install() and refreshTrampoline() time
+     */
+    public static function hookTrampoline(HookInterface $hook): Closure
+    {
+        $handle     = $hook->handle(...);
+        $statistics = self::$hookStatistics;
+        if ($statistics === null) {
+            return $handle;
+        }
+        $fieldKey = $hook->getHookFieldKey();
+        $statistics->label($fieldKey, $hook);
+
+        return static function (...$rawArguments) use ($handle, $statistics, $fieldKey) {
+            $start = hrtime(true);
+            try {
+                return $handle(...$rawArguments);
+            } finally {
+                $statistics->recordCall($fieldKey, hrtime(true) - $start);
+            }
+        };
+    }
+
+    /**
+     * Counts a pass-through of the given hook to its original handler (no-op while disabled)
+     *
+     * @internal called by proceed() paths of the hooks
+     */
+    public static function recordHookProceed(HookInterface $hook): void
+    {
+        self::$hookStatistics?->recordProceed($hook->getHookFieldKey());
+    }
+
+    /**
+     * Starts counting and timing every hook call, returns the collector (idempotent)
+     *
+     * Opt-in because it costs two hrtime() calls and a few array writes per crossing. The
+     * trampolines of already installed hooks are re-minted through reinstallHooks(), so the
+     * engine reaches the instrumented ones right away; with stacked hooks on one field only
+     * the top hook was re-pointed, so enable statistics before installing stacks to see the
+     * lower hooks as well.
+     */
+    public static function enableHookStatistics(): HookStatistics
+    {
+        if (self::$hookStatistics === null) {
+            self::$hookStatistics = new HookStatistics();
+            self::reinstallHooks();
+        }
+
+        return self::$hookStatistics;
+    }
+
+    /**
+     * Stops collecting hook statistics and puts the plain trampolines back (idempotent)
+     */
+    public static function disableHookStatistics(): void
+    {
+        if (self::$hookStatistics === null) {
+            return;
+        }
+        self::$hookStatistics = null;
+        if (!self::$isShutdown) {
+            self::reinstallHooks();
+        }
+    }
+
+    /**
+     * Returns the active hook statistics collector, null while disabled
+     */
+    public static function getHookStatistics(): ?HookStatistics
+    {
+        return self::$hookStatistics;
+    }
+
     /**
      * Records a global function generated via ReflectionFunction::addFunction() so shutdown()
      * can unpublish it from the engine function table before ext/ffi teardown
@@ -1185,7 +1627,7 @@ class Core
      */
     public static function offsetOfField(string $type, string $field): int
     {
-        return self::$engine->type(self::resolveCName($type))->getStructFieldOffset($field);
+        return self::type($type)->getStructFieldOffset($field);
     }
 
     /**
@@ -1200,7 +1642,9 @@ class Core
      */
     public static function type(string $type): CType
     {
-        return self::$engine->type(self::resolveCName($type));
+        $cType = self::resolveType($type);
+
+        return $cType instanceof CType ? $cType : self::$engine->type($cType);
     }
 
     /**
@@ -1323,6 +1767,7 @@ class Core
      */
     public static function setASTProcessHandler(Closure $handler): AstProcessHook
     {
+        self::requireHeaderSlice('compiler');
         $hook = new AstProcessHook($handler, self::$engine);
         $hook->install();
 
@@ -0,0 +1,276 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Coverage;
+
+use ZEngine\Core;
+use ZEngine\System\Compiler;
+use ZEngine\System\ExecutionData;
+use ZEngine\System\Hook\OpArrayGate;
+use ZEngine\System\Hook\OpCodeHook;
+use ZEngine\System\OpCode;
+use ZEngine\System\StatementStrip;
+
+/**
+ * Line coverage collector that removes its own instrumentation as it goes
+ *
+ * Coverage is built on COMPILE_EXTENDED_STMT: every statement compiled while the collector runs
+ * starts with an EXT_STMT opline, and an EXT_STMT opcode hook records it. A per-hit collector
+ * pays the libffi trampoline on every execution of every statement; this one pays it once per
+ * statement. The first execution sets the statement's bit in its op_array bitmap and rewrites
+ * the opline to NOP (StatementStrip::stripOpline()), so all later executions run the native NOP
+ * handler and never leave the VM. On long test suites and canary traffic the steady-state cost
+ * is therefore close to zero - the price is that hit counts are only 0 or 1.
+ *
+ * Scope and limits:
+ *  - only code compiled after start() carries EXT_STMT oplines: start the collector before
+ *    the code under test is included;
+ *  - op_arrays in opcache shared memory are recorded but never patched (their opcodes serve
+ *    every worker), so they keep paying one crossing per execution;
+ *  - while the collector runs, it is the only EXT_STMT consumer that sees a statement more
+ *    than once: a debugger's statement hook chained below it loses the lines it patched.
+ *
+ * The report also lists the statements of functions that never ran, taken from the op_arrays
+ * still reachable through the function and class tables of every file that was seen.
+ */
+final class CoverageCollector
+{
+    private ?OpCodeHook $hook = null;
+
+    /**
+     * Compiler options found at start(), put back by stop()
+     */
+    private int $previousCompilerOptions = 0;
+
+    /**
+     * Statement tables and hit bitmaps keyed by opcodes address
+     *
+     * @var array<int, OpArrayCoverage>
+     */
+    private array $records = [];
+
+    /**
+     * Lines of records whose op_array was destroyed and whose address got reused
+     *
+     * @var array<string, array<int, bool>>
+     */
+    private array $retiredLines = [];
+
+    /**
+     * Number of statements that crossed the trampoline
+     */
+    private int $crossings = 0;
+
+    private int $failedHits = 0;
+
+    /**
+     * Set once the engine definitions turn out unable to re-bake opline handlers
+     */
+    private ?string $selfRemovalFailure = null;
+
+    /**
+     * @param OpArrayGate|null $gate Restricts which op_arrays are covered (eg by file), z-engine's
+     *                               own code is always excluded
+     */
+    public function __construct(private readonly ?OpArrayGate $gate = null) {}
+
+    /**
+     * Turns on EXT_STMT emission for subsequently compiled code and installs the statement hook
+     */
+    public function start(): void
+    {
+        if ($this->hook !== null) {
+            throw new \LogicException('The coverage collector is already running');
+        }
+        $this->previousCompilerOptions = Core::$compiler->getOptions();
+        Core::$compiler->setOptions($this->previousCompilerOptions | Compiler::COMPILE_EXTENDED_STMT);
+        $this->hook = OpCode::setHandler(OpCode::EXT_STMT, $this->onStatement(...), $this->gate);
+    }
+
+    /**
+     * Removes the statement hook and restores the compiler options
+     *
+     * @param bool $restoreStatements Whether to turn the patched NOPs of every seen file back into
+     *                                EXT_STMT, so a later collector (or debugger) observes them again
+     */
+    public function stop(bool $restoreStatements = true): void
+    {
+        if ($this->hook === null) {
+            return;
+        }
+        $this->hook->uninstall();
+        $this->hook = null;
+        Core::$compiler->setOptions($this->previousCompilerOptions);
+
+        if ($restoreStatements) {
+            foreach (array_keys($this->getSeenFiles()) as $fileName) {
+                StatementStrip::restoreFile($fileName);
+            }
+        }
+    }
+
+    public function isRunning(): bool
+    {
+        return $this->hook !== null;
+    }
+
+    /**
+     * Returns the number of statement executions that reached the collector
+     *
+     * With self-removal working, this equals the number of distinct statements executed (plus
+     * every execution of opcache-shared code).
+     */
+    public function getCrossingCount(): int
+    {
+        return $this->crossings;
+    }
+
+    /**
+     * Checks whether executed statements are patched to NOP (false once the engine definitions
+     * turned out to predate the zend_vm_set_opcode_handler export; coverage then costs one
+     * crossing per execution and CoverageReport::$selfRemovalFailure says why)
+     */
+    public function isSelfRemoving(): bool
+    {
+        return $this->selfRemovalFailure === null;
+    }
+
+    /**
+     * Returns the number of hits dropped because recording them failed
+     */
+    public function getFailedHitCount(): int
+    {
+        return $this->failedHits;
+    }
+
+    /**
+     * Builds the line coverage of every file seen so far
+     */
+    public function getReport(): CoverageReport
+    {
+        $files = $this->retiredLines;
+        foreach ($this->records as $record) {
+            $files[$record->fileName] = self::mergeLines($files[$record->fileName] ?? [], $record->getLines());
+        }
+
+        // Functions that never ran have no record: their statements are the uncovered lines
+        foreach (array_keys($files) as $fileName) {
+            foreach (StatementStrip::fileOpArrays((string) $fileName) as $opArray) {
+                if (isset($this->records[Core::pointerAddressOf($opArray->opcodes)])) {
+                    continue;
+                }
+                $files[$fileName] = self::mergeLines($files[$fileName], OpArrayCoverage::fromOpArray($opArray)->getLines());
+            }
+        }
+        foreach ($files as &$lines) {
+            ksort($lines);
+        }
+        unset($lines);
+        ksort($files);
+
+        return new CoverageReport($files, time(), $this->selfRemovalFailure);
+    }
+
+    /**
+     * Forgets everything collected so far (the patched NOPs of the seen files are restored)
+     */
+    public function reset(): void
+    {
+        foreach (array_keys($this->getSeenFiles()) as $fileName) {
+            StatementStrip::restoreFile($fileName);
+        }
+        $this->records      = [];
+        $this->retiredLines = [];
+        $this->crossings    = 0;
+        $this->failedHits   = 0;
+    }
+
+    private function onStatement(ExecutionData $frame): int
+    {
+        $this->crossings++;
+        try {
+            $this->record($frame);
+        } catch (\Throwable) {
+            // Throwing out of the opcode handler trampoline is fatal: the hit is lost, not the process
+            $this->failedHits++;
+        }
+
+        return Core::ZEND_USER_OPCODE_DISPATCH;
+    }
+
+    private function record(ExecutionData $frame): void
+    {
+        $function = $frame->getRawFunction();
+        $index    = $frame->getOplineIndex();
+        if ($function === null || $index < 0) {
+            return;
+        }
+        $opArray        = $function->op_array;
+        $opcodesAddress = Core::pointerAddressOf($opArray->opcodes);
+
+        $record = $this->records[$opcodesAddress] ?? null;
+        if ($record === null || !$record->describes($opArray)) {
+            if ($record !== null) {
+                $this->retiredLines[$record->fileName] = self::mergeLines(
+                    $this->retiredLines[$record->fileName] ?? [],
+                    $record->getLines(),
+                );
+            }
+            $record = $this->records[$opcodesAddress] = OpArrayCoverage::fromOpArray($opArray);
+        }
+        $record->hit($index);
+
+        // The dispatch that follows this handler still runs the opline once; from the next
+        // execution on it is a native NOP and never reaches the trampoline again
+        if ($record->writable && $this->selfRemovalFailure === null) {
+            try {
+                StatementStrip::stripOpline($opArray, $index);
+            } catch (\RuntimeException $e) {
+                // Engine definitions without zend_vm_set_opcode_handler: keep collecting per hit,
+                // the report carries the reason
+                $this->selfRemovalFailure = $e->getMessage();
+            }
+        }
+    }
+
+    /**
+     * @return array<string, true>
+     */
+    private function getSeenFiles(): array
+    {
+        $files = [];
+        foreach ($this->records as $record) {
+            $files[$record->fileName] = true;
+        }
+        foreach (array_keys($this->retiredLines) as $fileName) {
+            $files[(string) $fileName] = true;
+        }
+
+        return $files;
+    }
+
+    /**
+     * @param array<int, bool> $lines
+     * @param array<int, bool> $more
+     *
+     * @return array<int, bool>
+     */
+    private static function mergeLines(array $lines, array $more): array
+    {
+        foreach ($more as $line => $covered) {
+            $lines[$line] = ($lines[$line] ?? false) || $covered;
+        }
+
+        return $lines;
+    }
+}
@@ -0,0 +1,110 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Coverage;
+
+/**
+ * Line coverage snapshot with LCOV and Clover renderers
+ *
+ * Hit counts are 0 or 1: the collector stops observing a statement after its first execution,
+ * so "covered" is all it knows. Both formats accept that - LCOV and Clover consumers (genhtml,
+ * Codecov, CI coverage gates) only compare counts against zero.
+ */
+final readonly class CoverageReport
+{
+    /**
+     * @param array<string, array<int, bool>> $files              Whether each executable line ran, keyed by file and line
+     * @param int                             $generatedAt        Unix timestamp of the snapshot
+     * @param string|null                     $selfRemovalFailure Why executed statements were not patched to NOP, so
+     *                                                            every execution cost a crossing; null when they were
+     */
+    public function __construct(
+        public array $files,
+        public int $generatedAt,
+        public ?string $selfRemovalFailure = null,
+    ) {}
+
+    /**
+     * Returns [covered, executable] line counts over all files
+     *
+     * @return array{int, int}
+     */
+    public function getLineTotals(): array
+    {
+        $covered    = 0;
+        $executable = 0;
+        foreach ($this->files as $lines) {
+            $executable += \count($lines);
+            $covered    += \count(array_filter($lines));
+        }
+
+        return [$covered, $executable];
+    }
+
+    /**
+     * Renders the report as an LCOV tracefile (genhtml, Codecov, most CI coverage gates)
+     */
+    public function toLcov(string $testName = ''): string
+    {
+        $output = '';
+        foreach ($this->files as $fileName => $lines) {
+            $output .= 'TN:' . $testName . "\n" . 'SF:' . $fileName . "\n";
+            foreach ($lines as $line => $covered) {
+                $output .= 'DA:' . $line . ',' . ($covered ? 1 : 0) . "\n";
+            }
+            $output .= 'LF:' . \count($lines) . "\n"
+                . 'LH:' . \count(array_filter($lines)) . "\n"
+                . "end_of_record\n";
+        }
+
+        return $output;
+    }
+
+    /**
+     * Renders the report as Clover XML, the format PHPUnit's --coverage-clover writes
+     */
+    public function toClover(string $projectName = ''): string
+    {
+        $name = $projectName === '' ? '' : ' name="' . self::escape($projectName) . '"';
+        $xml  = '<?xml version="1.0" encoding="UTF-8"?>' . "\n"
+            . \sprintf('<coverage generated="%d">', $this->generatedAt) . "\n"
+            . \sprintf('  <project timestamp="%d"%s>', $this->generatedAt, $name) . "\n";
+        foreach ($this->files as $fileName => $lines) {
+            $xml .= '    <file name="' . self::escape((string) $fileName) . '">' . "\n";
+            foreach ($lines as $line => $covered) {
+                $xml .= \sprintf('      <line num="%d" type="stmt" count="%d"/>', $line, $covered ? 1 : 0) . "\n";
+            }
+            $xml .= \sprintf(
+                '      <metrics loc="%1$d" ncloc="%1$d" statements="%2$d" coveredstatements="%3$d" elements="%2$d" coveredelements="%3$d"/>',
+                $lines === [] ? 0 : max(array_keys($lines)),
+                \count($lines),
+                \count(array_filter($lines)),
+            ) . "\n";
+            $xml .= "    </file>\n";
+        }
+        [$covered, $executable] = $this->getLineTotals();
+        $xml .= \sprintf(
+            '    <metrics files="%1$d" statements="%2$d" coveredstatements="%3$d" elements="%2$d" coveredelements="%3$d"/>',
+            \count($this->files),
+            $executable,
+            $covered,
+        ) . "\n";
+
+        return $xml . "  </project>\n</coverage>\n";
+    }
+
+    private static function escape(string $value): string
+    {
+        return htmlspecialchars($value, \ENT_XML1 | \ENT_QUOTES, 'UTF-8');
+    }
+}
@@ -0,0 +1,130 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Coverage;
+
+use FFI\CData;
+use ZEngine\Core;
+use ZEngine\Generated\zend_op_array;
+use ZEngine\System\OpCode;
+use ZEngine\Type\StructArray;
+
+/**
+ * Statement coverage of one op_array: its EXT_STMT positions and a bitmap of the ones executed
+ *
+ * The statement table is taken from the op_array when it is first seen, because the op_array
+ * itself may be freed long before the report is written (eval()'d and top-level code are
+ * destroyed right after they run). The bitmap is indexed by opline position, one bit per
+ * opline, so marking a hit is a single byte update whatever the function size.
+ *
+ * @internal collected by CoverageCollector
+ */
+final class OpArrayCoverage
+{
+    /**
+     * One bit per opline, set once the opline executed
+     */
+    private string $bitmap;
+
+    /**
+     * @param string          $fileName       File the op_array was compiled from
+     * @param int             $lineStart      First line of the op_array, part of its identity
+     * @param int             $lineEnd        Last line of the op_array, part of its identity
+     * @param int             $last           Number of oplines, part of its identity
+     * @param array<int, int> $statementLines Source line keyed by EXT_STMT opline position
+     * @param bool            $writable       False for opcache-shared op_arrays, which are never patched
+     */
+    private function __construct(
+        public readonly string $fileName,
+        private readonly int $lineStart,
+        private readonly int $lineEnd,
+        private readonly int $last,
+        private readonly array $statementLines,
+        public readonly bool $writable,
+    ) {
+        $this->bitmap = str_repeat("\0", intdiv($last + 7, 8));
+    }
+
+    /**
+     * Takes the statement table of an op_array
+     *
+     * @param CData|zend_op_array $opArray
+     */
+    public static function fromOpArray(object $opArray): self
+    {
+        $statementLines = [];
+        foreach (new StructArray($opArray->opcodes, $opArray->last) as $index => $opline) {
+            if ($opline->opcode === OpCode::EXT_STMT) {
+                $statementLines[$index] = $opline->lineno;
+            }
+        }
+        $fileName = $opArray->filename;
+
+        return new self(
+            fileName: $fileName === null ? '' : \FFI::string($fileName->val, $fileName->len),
+            lineStart: $opArray->line_start,
+            lineEnd: $opArray->line_end,
+            last: $opArray->last,
+            statementLines: $statementLines,
+            writable: ($opArray->fn_flags & Core::ZEND_ACC_IMMUTABLE) === 0,
+        );
+    }
+
+    /**
+     * Checks whether this record still describes the given op_array, whose opcodes address it
+     * was filed under (addresses are reused once an op_array is destroyed)
+     *
+     * @param CData|zend_op_array $opArray
+     */
+    public function describes(object $opArray): bool
+    {
+        return $opArray->line_start === $this->lineStart
+            && $opArray->line_end === $this->lineEnd
+            && $opArray->last === $this->last;
+    }
+
+    /**
+     * Marks the opline at the given position as executed
+     */
+    public function hit(int $index): void
+    {
+        if ($index < 0 || $index >= $this->last) {
+            return;
+        }
+        $byte                = $index >> 3;
+        $this->bitmap[$byte] = \chr(\ord($this->bitmap[$byte]) | 1 << ($index & 7));
+    }
+
+    public function isHit(int $index): bool
+    {
+        return ($index >= 0 && $index < $this->last)
+            && (\ord($this->bitmap[$index >> 3]) & 1 << ($index & 7)) !== 0;
+    }
+
+    /**
+     * Returns whether each statement line ran, keyed by line
+     *
+     * A line holding several statements counts as covered once any of them ran.
+     *
+     * @return array<int, bool>
+     */
+    public function getLines(): array
+    {
+        $lines = [];
+        foreach ($this->statementLines as $index => $line) {
+            $lines[$line] = ($lines[$line] ?? false) || $this->isHit($index);
+        }
+
+        return $lines;
+    }
+}
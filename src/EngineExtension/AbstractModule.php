@@ -130,6 +130,7 @@ abstract class AbstractModule extends ReflectionExtension implements ModuleInter
         if ($this->isModuleRegistered()) {
             throw ModuleRegistrationException::alreadyRegistered($this->moduleName);
         }
+        Core::requireHeaderSlice('module');
 
         // Since PHP 8.4 zend_register_module_ex stores THIS pointer directly in the
         // module registry (zend_hash_add_ptr - the old copying add_mem behaviour is
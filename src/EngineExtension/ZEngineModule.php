@@ -46,7 +46,9 @@ use ZEngine\Type\PersistentHashTable;
  *    docs/long-running.md and docs/persistent-heap.md); both callbacks are
  *    exception-free by construction (issue #50: FFI callbacks must never throw).
  *  - DIAGNOSTICS: phpinfo() renders the module section with live heap statistics
- *    through the standard info_func machinery (ModuleInfoInterface).
+ *    and the boot-cost breakdown of Core::getBootProfile() through the standard
+ *    info_func machinery (ModuleInfoInterface), plus one row per hook field while
+ *    Core::enableHookStatistics() is on.
  *
  * The module depends on ext/ffi - the engine refuses to start it when FFI is absent,
  * which is exactly the environment z-engine cannot run in anyway.
@@ -149,6 +151,31 @@ final class ZEngineModule extends AbstractModule implements ModuleLifecycleInter
             'Z-Engine support' => 'enabled',
             'Persistent heap'  => 'not initialized',
         ];
+        $bootProfile = Core::getBootProfile();
+        if (isset($bootProfile['total'], $bootProfile['layoutCheck'])) {
+            $rows['Boot time (ms)'] = sprintf(
+                '%.3f (parse %.3f, verify %.3f, hooks %.3f)',
+                $bootProfile['total'] * 1e3,
+                ($bootProfile['parse'] ?? 0.0) * 1e3,
+                ($bootProfile['verify'] ?? 0.0) * 1e3,
+                ($bootProfile['hooks'] ?? 0.0) * 1e3,
+            );
+            $rows['Layout check'] = $bootProfile['layoutCheck'];
+        }
+        $hookStatistics          = Core::getHookStatistics();
+        $rows['Hook statistics'] = $hookStatistics === null ? 'disabled' : 'enabled';
+        if ($hookStatistics !== null) {
+            foreach ($hookStatistics->snapshot() as $fieldKey => $figures) {
+                $rows['Hook ' . $figures['hook'] . ' ' . $fieldKey] = sprintf(
+                    '%d calls, %d proceeds, %.3f ms total, p99 < %.1f us, max %.1f us',
+                    $figures['calls'],
+                    $figures['proceeds'],
+                    $figures['totalNanos'] / 1e6,
+                    $hookStatistics->getQuantileBound($fieldKey, 0.99) / 1e3,
+                    $figures['maxNanos'] / 1e3,
+                );
+            }
+        }
         if ($this->heap !== null) {
             try {
                 $stats = $this->heap->stats();
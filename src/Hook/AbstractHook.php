@@ -56,6 +56,16 @@ abstract class AbstractHook implements HookInterface
      */
     private bool $installed = false;
 
+    /**
+     * Shared trampoline this hook is dispatched from instead of owning one (null for a plain hook)
+     */
+    private ?HookMultiplexer $multiplexer = null;
+
+    /**
+     * Route of this hook in the multiplexer table
+     */
+    private int $route = 0;
+
     public function __construct(Closure $userHandler, $rawStructure)
     {
         assert($rawStructure instanceof FFI || $rawStructure instanceof CData, 'Invalid container');
@@ -86,9 +96,15 @@ abstract class AbstractHook implements HookInterface
         if (Core::isShutdown()) {
             throw new \LogicException('Cannot install an engine hook after Core::shutdown()');
         }
+        if ($this->multiplexer !== null) {
+            $this->originalHandler = $this->multiplexer->attach($this->route, $this);
+            $this->installed       = true;
+
+            return;
+        }
         $this->originalHandler = $this->rawStructure->{static::HOOK_FIELD};
 
-        $this->rawStructure->{static::HOOK_FIELD} = $this->handle(...);
+        $this->rawStructure->{static::HOOK_FIELD} = $this->createTrampoline();
         $this->installed                          = true;
         Core::registerHook($this);
     }
@@ -97,7 +113,8 @@ abstract class AbstractHook implements HookInterface
      * Restores the original engine pointer (idempotent)
      *
      * Only the most recently installed hook of a field may be uninstalled: restoring an
-     * older hook first would clobber the newer trampoline with a stale pointer.
+     * older hook first would clobber the newer trampoline with a stale pointer. A routed
+     * hook only leaves the multiplexer table, in any order.
      */
     #[\Override]
     final public function uninstall(): void
@@ -105,6 +122,12 @@ abstract class AbstractHook implements HookInterface
         if (!$this->installed) {
             return;
         }
+        if ($this->multiplexer !== null) {
+            $this->multiplexer->detach($this->route, $this);
+            $this->installed = false;
+
+            return;
+        }
         if (Core::isShutdown()) {
             // The engine already restored/abandoned this pointer during shutdown
             $this->installed = false;
@@ -122,6 +145,38 @@ abstract class AbstractHook implements HookInterface
         Core::unregisterHook($this);
     }
 
+    /**
+     * Makes install() attach this hook to a shared trampoline instead of writing its own
+     *
+     * @param HookMultiplexer $multiplexer Owner of this hook's field in the same container
+     * @param int             $route       Key under which the multiplexer dispatches to this hook
+     *
+     * @internal used by ReflectionClass for classes sharing the multiplexed handlers block
+     */
+    final public function routeThrough(HookMultiplexer $multiplexer, int $route): void
+    {
+        if ($this->installed) {
+            throw new \LogicException('Cannot reroute an installed hook; uninstall it first');
+        }
+        if ($multiplexer->field !== static::HOOK_FIELD) {
+            throw new \LogicException(
+                'Multiplexer of the ' . $multiplexer->field . ' field cannot dispatch a ' . static::HOOK_FIELD . ' hook',
+            );
+        }
+        $this->multiplexer = $multiplexer;
+        $this->route       = $route;
+    }
+
+    /**
+     * Returns the name of the engine field hooks of this kind replace
+     *
+     * @internal used by ReflectionClass to pick the multiplexer of a hook class
+     */
+    final public static function getHookField(): string
+    {
+        return static::HOOK_FIELD;
+    }
+
     /**
      * Re-installs the hook with a freshly minted trampoline (uninstall + install)
      */
@@ -163,10 +218,22 @@ abstract class AbstractHook implements HookInterface
         if (!is_callable($originalHandler)) {
             throw new \LogicException('Original handler is not available');
         }
+        Core::recordHookProceed($this);
 
         return $originalHandler;
     }
 
+    /**
+     * Returns what install() writes into the engine field
+     *
+     * The PHP trampoline of handle() by default; native stub hooks hand out a pointer to
+     * generated machine code instead and never reach PHP at call time.
+     */
+    protected function createTrampoline(): Closure|CData
+    {
+        return Core::hookTrampoline($this);
+    }
+
     /**
      * Type-erasing seam for getOriginalCallable()
      */
@@ -208,10 +275,10 @@ abstract class AbstractHook implements HookInterface
     #[\Override]
     final public function refreshTrampoline(): void
     {
-        if (!$this->installed) {
+        if (!$this->installed || $this->multiplexer !== null) {
             return;
         }
-        $this->rawStructure->{static::HOOK_FIELD} = $this->handle(...);
+        $this->rawStructure->{static::HOOK_FIELD} = $this->createTrampoline();
     }
 
     /**
@@ -0,0 +1,251 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Hook;
+
+use Closure;
+use FFI;
+use FFI\CData;
+use ZEngine\Core;
+
+/**
+ * HookMultiplexer owns one engine field on behalf of many hooks of the same kind
+ *
+ * A plain AbstractHook writes its own libffi trampoline into its own container, so N hooked
+ * containers cost N trampolines. When the containers are interchangeable - many classes
+ * sharing one zend_object_handlers block - the multiplexer writes a single trampoline and
+ * routes every call through a PHP table instead: the route resolver extracts a key from the
+ * raw arguments (eg the class entry address of the subject object) and the call is handed
+ * to the hook attached under that key. Calls without a route go to the original handler,
+ * or to the configured absent handler when the field was empty.
+ *
+ * Attached hooks are never installed themselves; they keep their own user handler and
+ * proceed() semantics (proceed() reaches the field's original handler). Attaching and
+ * detaching is a table write, the trampoline stays in place until uninstall() or
+ * Core::shutdown() unwinds it like any other hook.
+ *
+ * @see AbstractHook::routeThrough()
+ */
+final class HookMultiplexer implements HookInterface
+{
+    /**
+     * Holds an original handler (if present), captured at install() time
+     */
+    private ?CData $originalHandler = null;
+
+    /**
+     * Whether the shared trampoline is currently written into the engine structure
+     */
+    private bool $installed = false;
+
+    /**
+     * Attached hooks keyed by route
+     *
+     * @var array<int, HookInterface>
+     */
+    private array $routes = [];
+
+    /**
+     * @param CData        $container     Engine structure that holds the field
+     * @param string       $field         Name of the function pointer field
+     * @param Closure      $routeResolver Returns the route key for the raw arguments of a call
+     *                                    (null when the call has no subject), signature
+     *                                    fn(array): ?int. It runs inside an engine callback and
+     *                                    must not throw
+     * @param Closure|null $absentHandler Answers unrouted calls when the field was empty with the
+     *                                    engine's default for that field, signature
+     *                                    fn(array): mixed; such calls return null without one
+     */
+    public function __construct(
+        private readonly CData $container,
+        public readonly string $field,
+        private readonly Closure $routeResolver,
+        private readonly ?Closure $absentHandler = null,
+    ) {}
+
+    /**
+     * Dispatches one engine call to the hook attached for its route, or to the original handler
+     *
+     * @inheritDoc
+     */
+    #[\Override]
+    public function handle(...$rawArguments)
+    {
+        $route = ($this->routeResolver)($rawArguments);
+        if ($route !== null && isset($this->routes[$route])) {
+            return $this->routes[$route]->handle(...$rawArguments);
+        }
+        Core::recordHookProceed($this);
+        $originalHandler = $this->getOriginalHandlerErased();
+        if (is_callable($originalHandler)) {
+            return $originalHandler(...$rawArguments);
+        }
+
+        return $this->absentHandler !== null ? ($this->absentHandler)($rawArguments) : null;
+    }
+
+    /**
+     * Attaches a hook under the given route, installing the shared trampoline on first use
+     *
+     * @return CData|null Original handler of the field, for the attached hook's proceed()
+     *
+     * @internal called by AbstractHook::install() for routed hooks
+     */
+    public function attach(int $route, HookInterface $hook): ?CData
+    {
+        $attached = $this->routes[$route] ?? null;
+        if ($attached !== null && $attached !== $hook) {
+            throw new \LogicException(
+                "Another hook is already attached to the multiplexed {$this->field} field for this route; uninstall it first",
+            );
+        }
+        $this->install();
+        $this->routes[$route] = $hook;
+
+        return $this->originalHandler;
+    }
+
+    /**
+     * Detaches the hook of the given route (idempotent), the trampoline stays installed
+     *
+     * @internal called by AbstractHook::uninstall() for routed hooks
+     */
+    public function detach(int $route, HookInterface $hook): void
+    {
+        if (($this->routes[$route] ?? null) === $hook) {
+            unset($this->routes[$route]);
+        }
+    }
+
+    /**
+     * Checks if a hook is attached under the given route
+     */
+    public function hasRoute(int $route): bool
+    {
+        return isset($this->routes[$route]);
+    }
+
+    /**
+     * Returns the number of routes that currently have a hook attached
+     */
+    public function getRouteCount(): int
+    {
+        return \count($this->routes);
+    }
+
+    /**
+     * Writes the shared trampoline into the engine field (idempotent)
+     */
+    #[\Override]
+    public function install(): void
+    {
+        if ($this->installed) {
+            return;
+        }
+        if (Core::isShutdown()) {
+            throw new \LogicException('Cannot install an engine hook after Core::shutdown()');
+        }
+        $this->originalHandler = $this->container->{$this->field};
+
+        $this->container->{$this->field} = Core::hookTrampoline($this);
+        $this->installed                 = true;
+        Core::registerHook($this);
+    }
+
+    /**
+     * Restores the original engine pointer and drops every route (idempotent)
+     */
+    #[\Override]
+    public function uninstall(): void
+    {
+        if (!$this->installed) {
+            return;
+        }
+        $this->routes = [];
+        if (Core::isShutdown()) {
+            // The engine already restored/abandoned this pointer during shutdown
+            $this->installed = false;
+
+            return;
+        }
+        if (!Core::isTopHook($this)) {
+            throw new \LogicException(
+                'Another hook was installed over this one on the same engine field; uninstall it first',
+            );
+        }
+
+        $this->container->{$this->field} = $this->originalHandler;
+        $this->installed                 = false;
+        Core::unregisterHook($this);
+    }
+
+    #[\Override]
+    public function isInstalled(): bool
+    {
+        return $this->installed;
+    }
+
+    #[\Override]
+    public function hasOriginalHandler(): bool
+    {
+        return $this->originalHandler !== null;
+    }
+
+    /**
+     * @inheritDoc
+     */
+    #[\Override]
+    public function getHookFieldKey(): string
+    {
+        $container = $this->container;
+        if (FFI::sizeof($container) !== PHP_INT_SIZE) {
+            $container = FFI::addr($container);
+        }
+
+        return Core::addressOf($container) . '::' . $this->field;
+    }
+
+    /**
+     * @inheritDoc
+     */
+    #[\Override]
+    public function refreshTrampoline(): void
+    {
+        if (!$this->installed) {
+            return;
+        }
+        $this->container->{$this->field} = Core::hookTrampoline($this);
+    }
+
+    /**
+     * Type-erasing seam: FFI\CData function pointers are invocable at runtime
+     *
+     * @see AbstractHook::getOriginalCallable()
+     */
+    private function getOriginalHandlerErased(): mixed
+    {
+        return $this->originalHandler;
+    }
+
+    /**
+     * Internal CData fields could result in segfaults, so let's hide everything
+     */
+    public function __debugInfo(): array
+    {
+        return [
+            'field'     => $this->field,
+            'installed' => $this->installed,
+            'routes'    => \count($this->routes),
+        ];
+    }
+}
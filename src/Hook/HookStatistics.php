@@ -0,0 +1,191 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Hook;
+
+/**
+ * Invocation counters and latency histograms of engine hooks, one record per hook field key
+ *
+ * Filled by the instrumented trampolines Core::hookTrampoline() mints while statistics are
+ * enabled (Core::enableHookStatistics()). A call is timed from the moment the engine enters
+ * the trampoline until it returns, so the time of a stacked hook includes everything it
+ * proceeds to. Pass-throughs - proceed() to the original handler, an opcode hook answering
+ * ZEND_USER_OPCODE_DISPATCH, a multiplexed call without a route - are counted separately:
+ * a field whose proceeds equal its calls is pure overhead.
+ *
+ * Latencies go into power-of-two buckets: bucket N counts calls that took [2^N, 2^(N+1))
+ * nanoseconds, which keeps the histogram small and exact for the orders of magnitude that
+ * matter (a trampoline crossing is ~1us, a slow handler ~1ms).
+ */
+final class HookStatistics
+{
+    /**
+     * Last bucket index, calls of 2^HIGHEST_BUCKET ns (~69s) and more all land there
+     */
+    public const int HIGHEST_BUCKET = 36;
+
+    /**
+     * @var array<string, int>
+     */
+    private array $calls = [];
+
+    /**
+     * @var array<string, int>
+     */
+    private array $proceeds = [];
+
+    /**
+     * @var array<string, int>
+     */
+    private array $totalNanos = [];
+
+    /**
+     * @var array<string, int>
+     */
+    private array $maxNanos = [];
+
+    /**
+     * Sparse bucket counts per field key
+     *
+     * @var array<string, array<int, int>>
+     */
+    private array $histograms = [];
+
+    /**
+     * Short class name of the hook that minted the trampoline, per field key
+     *
+     * @var array<string, string>
+     */
+    private array $labels = [];
+
+    /**
+     * Records one trampoline call
+     *
+     * @internal called by the instrumented trampolines of Core::hookTrampoline()
+     */
+    public function recordCall(string $fieldKey, int $nanos): void
+    {
+        $this->calls[$fieldKey]      = ($this->calls[$fieldKey] ?? 0) + 1;
+        $this->totalNanos[$fieldKey] = ($this->totalNanos[$fieldKey] ?? 0) + $nanos;
+        if ($nanos > ($this->maxNanos[$fieldKey] ?? 0)) {
+            $this->maxNanos[$fieldKey] = $nanos;
+        }
+        $bucket = self::bucketOf($nanos);
+
+        $this->histograms[$fieldKey][$bucket] = ($this->histograms[$fieldKey][$bucket] ?? 0) + 1;
+    }
+
+    /**
+     * Records one pass-through to the original handler
+     *
+     * @internal called through Core::recordHookProceed()
+     */
+    public function recordProceed(string $fieldKey): void
+    {
+        $this->proceeds[$fieldKey] = ($this->proceeds[$fieldKey] ?? 0) + 1;
+    }
+
+    /**
+     * Names the hook behind a field key in snapshots
+     *
+     * @internal called by Core::hookTrampoline()
+     */
+    public function label(string $fieldKey, HookInterface $hook): void
+    {
+        $className = $hook::class;
+
+        $this->labels[$fieldKey] = substr($className, (int) strrpos('\\' . $className, '\\'));
+    }
+
+    /**
+     * Returns the collected figures keyed by hook field key
+     *
+     * "histogram" maps a bucket index N to the number of calls that took [2^N, 2^(N+1)) ns.
+     *
+     * @return array<string, array{hook: string, calls: int, proceeds: int, totalNanos: int, maxNanos: int, histogram: array<int, int>}>
+     */
+    public function snapshot(): array
+    {
+        $snapshot = [];
+        foreach ($this->calls + $this->proceeds as $fieldKey => $unused) {
+            $histogram = $this->histograms[$fieldKey] ?? [];
+            ksort($histogram);
+
+            $snapshot[$fieldKey] = [
+                'hook'       => $this->labels[$fieldKey] ?? '',
+                'calls'      => $this->calls[$fieldKey] ?? 0,
+                'proceeds'   => $this->proceeds[$fieldKey] ?? 0,
+                'totalNanos' => $this->totalNanos[$fieldKey] ?? 0,
+                'maxNanos'   => $this->maxNanos[$fieldKey] ?? 0,
+                'histogram'  => $histogram,
+            ];
+        }
+        ksort($snapshot);
+
+        return $snapshot;
+    }
+
+    /**
+     * Returns the upper bound (ns) below which the given share of a field's calls completed
+     *
+     * Resolution is the bucket width: the answer is the upper edge of the bucket holding the
+     * quantile, eg 0.99 on a field whose slowest percent took 3-4us yields 4096.
+     *
+     * @param float $quantile Between 0 and 1
+     */
+    public function getQuantileBound(string $fieldKey, float $quantile): int
+    {
+        if ($quantile < 0.0 || $quantile > 1.0) {
+            throw new \InvalidArgumentException('Quantile must be between 0 and 1');
+        }
+        $histogram = $this->histograms[$fieldKey] ?? [];
+        if ($histogram === []) {
+            return 0;
+        }
+        ksort($histogram);
+        $threshold = $quantile * ($this->calls[$fieldKey] ?? 0);
+        $seen      = 0;
+        foreach ($histogram as $bucket => $count) {
+            $seen += $count;
+            if ($seen >= $threshold) {
+                return 2 ** ($bucket + 1);
+            }
+        }
+
+        return 2 ** (self::HIGHEST_BUCKET + 1);
+    }
+
+    /**
+     * Forgets everything recorded so far
+     */
+    public function reset(): void
+    {
+        $this->calls      = [];
+        $this->proceeds   = [];
+        $this->totalNanos = [];
+        $this->maxNanos   = [];
+        $this->histograms = [];
+    }
+
+    /**
+     * Returns the histogram bucket of a latency: floor(log2(nanos)), clamped to the bucket range
+     */
+    public static function bucketOf(int $nanos): int
+    {
+        if ($nanos < 2) {
+            return 0;
+        }
+
+        return min(self::HIGHEST_BUCKET, \strlen(decbin($nanos)) - 1);
+    }
+}
@@ -17,6 +17,7 @@ use ZEngine\Core;
 use ZEngine\OpCache\ImageFunctionDonor;
 use ZEngine\OpCache\ReflectionOpcacheFile;
 use ZEngine\OpCache\SharedMemoryException;
+use ZEngine\Optimizer\Inliner;
 use ZEngine\Reflection\FunctionBodySwap;
 use ZEngine\Reflection\PendingBodySwap;
 use ZEngine\Reflection\ReflectionClass;
@@ -183,7 +184,9 @@ final class CacheImageSync
      * group - staged so that a failing swap rolls every already-staged one back.
      * A completed copy-out is NOT undone by that rollback: it is behavior-preserving
      * on its own (the writable copy publishes the same bodies) and the documented
-     * copy-out caveats of docs/hot-swap.md apply from that moment on.
+     * copy-out caveats of docs/hot-swap.md apply from that moment on. Callers that
+     * inlined a swapped body are reverted while the swaps are still staged, the same
+     * way RedefinitionBatch does it.
      *
      * @throws HotSwapException      When the plan contains a refused entry, this sync was
      *                               already applied, or a swap failed and was rolled back
@@ -227,6 +230,8 @@ final class CacheImageSync
         // and any failure rolls all staged entries back to their previous bodies
         /** @var list<PendingBodySwap> $pendingSwaps */
         $pendingSwaps = [];
+        /** @var list<ReflectionFunction|ReflectionMethod> $swappedEntries */
+        $swappedEntries = [];
         try {
             foreach ($functionDonors as $functionName => $donor) {
                 $entryFunction  = $this->changedFunctionEntries[$functionName];
@@ -241,6 +246,7 @@ final class CacheImageSync
                     destroyPrevious: !$this->functionWasShared[$functionName],
                     publishedShares: FunctionBodySwap::countPublishedShares($entryFunction),
                 );
+                $swappedEntries[] = $entryFunction;
             }
             foreach ($methodDonors as $classKey => $donors) {
                 $liveClass   = $this->changedClassEntries[$classKey];
@@ -261,8 +267,15 @@ final class CacheImageSync
                         destroyPrevious: !$this->classWasShared[$classKey],
                         publishedShares: FunctionBodySwap::countPublishedShares($entryMethod),
                     );
+                    // A raw entry carries no class name, the inliner keys callers by it
+                    $swappedEntries[] = ReflectionMethod::fromCData($methodValue->getRawFunction());
                 }
             }
+            // Inlined copies of the previous bodies go once every swap is staged; a caller
+            // with a live frame rolls the whole image back
+            if ($swappedEntries !== []) {
+                Inliner::revertCallersOf(...$swappedEntries);
+            }
         } catch (\Throwable $error) {
             foreach (array_reverse($pendingSwaps) as $pending) {
                 $pending->rollback();
@@ -278,6 +291,13 @@ final class CacheImageSync
         foreach ($pendingSwaps as $pending) {
             $pending->commit();
         }
+        foreach ($swappedEntries as $entry) {
+            Inliner::forgetCaller($entry);
+        }
+        if ($pendingSwaps !== []) {
+            // The swapped-in bodies execute out of the image: a mapped one keeps its lock
+            $this->image->pinMapping();
+        }
         $this->isApplied = true;
         foreach ($functionDonors as $donor) {
             $this->materializedDonors[] = $donor;
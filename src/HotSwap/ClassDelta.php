@@ -15,6 +15,7 @@ namespace ZEngine\HotSwap;
 
 use FFI\CData;
 use ZEngine\Core;
+use ZEngine\Optimizer\Inliner;
 use ZEngine\Reflection\FunctionBodySwap;
 use ZEngine\Reflection\PendingBodySwap;
 use ZEngine\Reflection\ReflectionClass;
@@ -23,6 +24,7 @@ use ZEngine\Reflection\ReflectionFunction;
 use ZEngine\Reflection\ReflectionMethod;
 use ZEngine\Reflection\ReflectionProperty;
 use ZEngine\Reflection\ReflectionValue;
+use ZEngine\Reflection\RunTimeCacheWarmup;
 use ZEngine\Type\HashTable;
 use ZEngine\Type\StringEntry;
 use ZEngine\Type\StructArray;
@@ -287,9 +289,16 @@ final class ClassDelta
      * On failure every already-executed operation is undone in reverse order and the
      * previous class state is fully restored before the exception propagates.
      *
+     * Changed methods start with an empty run-time cache unless $warmup says otherwise; the
+     * copy step is skipped for deltas that add or remove methods, or change constants or
+     * static defaults, since the previous slots may resolve to what was replaced.
+     *
+     * Callers that inlined a changed or removed method get their body from before inlining
+     * back (Inliner::revertCallersOf()); one of them executing rolls the delta back.
+     *
      * @throws HotSwapException When any operation fails (the class was rolled back)
      */
-    public function apply(): void
+    public function apply(RunTimeCacheWarmup $warmup = RunTimeCacheWarmup::Cold): void
     {
         $this->assertUsable();
         if (Core::isShutdown()) {
@@ -304,6 +313,16 @@ final class ClassDelta
         $replacedSnapshots = [];
         /** @var list<\Closure> $undoStack */
         $undoStack = [];
+        /** @var list<ReflectionMethod> $replacedEntries changed and removed entries, previous bodies */
+        $replacedEntries = [];
+
+        // Method, constant and static slots of the previous bodies may point at what the
+        // delta just replaced or shadowed: only prefill then
+        if ($this->addedMethods !== [] || $this->removedMethods !== [] || $this->changedStatics !== []
+            || $this->touchesClassConstants()
+        ) {
+            $warmup = $warmup->withoutCopy();
+        }
 
         try {
             foreach ($this->changedMethods as $lowerName => $donorMethod) {
@@ -318,8 +337,9 @@ final class ClassDelta
                     destroyPrevious: true,
                     publishedShares: FunctionBodySwap::countPublishedShares($entry),
                 );
-                $pendingSwaps[] = $pending;
-                $undoStack[]    = static function () use ($pending): void {
+                $pendingSwaps[]    = $pending;
+                $replacedEntries[] = $entry;
+                $undoStack[]       = static function () use ($pending): void {
                     $pending->rollback();
                 };
             }
@@ -345,7 +365,8 @@ final class ClassDelta
             }
 
             foreach ($this->removedMethods as $lowerName => $fallbackMethod) {
-                $previousMethod = $this->liveClass->getMethod($lowerName);
+                $previousMethod    = $this->liveClass->getMethod($lowerName);
+                $replacedEntries[] = $previousMethod;
                 $methodTable->deleteWithoutDestructor($lowerName);
                 if ($fallbackMethod !== null) {
                     // Restore plain inheritance: the bucket owns one name reference and
@@ -414,6 +435,17 @@ final class ClassDelta
                     $liveClass->restoreFlags($previousFlags);
                 };
             }
+
+            // Last staging step: prefilled slots resolve against the class as the delta left it,
+            // and a warmup failure still rolls every swapped body back
+            foreach ($pendingSwaps as $pending) {
+                $pending->warmRunTimeCache($warmup);
+            }
+            // Inlined copies of changed and removed methods go once every step is staged; a
+            // caller with a live frame rolls the whole delta back
+            if ($replacedEntries !== []) {
+                Inliner::revertCallersOf(...$replacedEntries);
+            }
         } catch (\Throwable $error) {
             foreach (array_reverse($undoStack) as $undoAction) {
                 $undoAction();
@@ -431,6 +463,9 @@ final class ClassDelta
         foreach ($pendingSwaps as $pending) {
             $pending->commit();
         }
+        foreach ($replacedEntries as $entry) {
+            Inliner::forgetCaller($entry);
+        }
         foreach ($replacedSnapshots as $snapshot) {
             $snapshot->destroy();
         }
@@ -177,4 +177,24 @@ class HotSwapException extends \ReflectionException
             $cause,
         );
     }
+
+    public static function duplicateBatchEntry(string $entryName): self
+    {
+        return new self("{$entryName}() is already redefined by this batch - add one body per entry");
+    }
+
+    public static function batchAlreadyCommitted(): self
+    {
+        return new self('This redefinition batch has already been committed');
+    }
+
+    public static function batchFailedAndRolledBack(string $entryName, \Throwable $cause): self
+    {
+        return new self(
+            "Redefining {$entryName}() failed and every staged body swap of the batch was rolled back: "
+            . $cause->getMessage(),
+            0,
+            $cause,
+        );
+    }
 }
@@ -0,0 +1,207 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\HotSwap;
+
+use ZEngine\OpCache\SharedMemoryException;
+use ZEngine\Optimizer\Inliner;
+use ZEngine\Reflection\PendingBodySwap;
+use ZEngine\Reflection\ReflectionFunction;
+use ZEngine\Reflection\ReflectionMethod;
+use ZEngine\Reflection\RunTimeCacheArena;
+use ZEngine\Reflection\RunTimeCacheWarmup;
+use ZEngine\Type\ClosureEntry;
+
+/**
+ * Redefines many functions and methods in one atomic step, the batch form of redefine()
+ *
+ * Every entry follows the redefine() contract (same signature checks, same opcache copy-out,
+ * same in-place FunctionBodySwap), but commit() drives them the way CacheImageSync::apply()
+ * drives an image:
+ *
+ *  - every swap is staged first, and any failure rolls all staged entries back to their
+ *    previous bodies before it is rethrown - the batch either applies whole or not at all;
+ *  - the run-time caches of all new bodies are carved out of one RunTimeCacheArena block
+ *    instead of one allocation per entry;
+ *  - previous bodies are destroyed only once every swap is staged.
+ *
+ * Static-variable defaults duplicates stay separate engine hash tables: the engine destroys
+ * them one by one, so they cannot share a block. commit() reports the time spent on every
+ * entry in a RedefinitionBatchReport.
+ *
+ * The closures must stay alive until commit() returns; the batch holds them until then.
+ */
+final class RedefinitionBatch
+{
+    /**
+     * Staged targets keyed by lowercase entry name
+     *
+     * @var array<string, array{name: string, class: ?string, function: string, code: \Closure}>
+     */
+    private array $targets = [];
+
+    private bool $isCommitted = false;
+
+    /**
+     * @param RunTimeCacheWarmup $warmup How each new body's run-time cache is filled before commit
+     */
+    public function __construct(private readonly RunTimeCacheWarmup $warmup = RunTimeCacheWarmup::Cold) {}
+
+    /**
+     * Adds a new body for a global user function
+     *
+     * @throws HotSwapException When the function already has a body in this batch
+     */
+    public function addFunction(string $functionName, \Closure $newCode): self
+    {
+        return $this->add(null, $functionName, $newCode);
+    }
+
+    /**
+     * Adds a new body for a user method
+     *
+     * @throws HotSwapException When the method already has a body in this batch
+     */
+    public function addMethod(string $className, string $methodName, \Closure $newCode): self
+    {
+        return $this->add($className, $methodName, $newCode);
+    }
+
+    /**
+     * Returns the number of entries added so far
+     */
+    public function count(): int
+    {
+        return count($this->targets);
+    }
+
+    /**
+     * Swaps every added entry to its new body, or none of them
+     *
+     * @throws HotSwapException When a swap fails; every staged swap was rolled back
+     * @throws SharedMemoryException When an opcache-shared target cannot be copied out
+     * @throws \ReflectionException When the first target does not exist, is internal or has
+     *                              an incompatible signature (later ones roll back as above)
+     */
+    public function commit(): RedefinitionBatchReport
+    {
+        if ($this->isCommitted) {
+            throw HotSwapException::batchAlreadyCommitted();
+        }
+        $startedAt = hrtime(true);
+
+        $arenaSize = 0;
+        foreach ($this->targets as $target) {
+            $newFunction = (new ClosureEntry($target['code']))->getRawFunction();
+            $arenaSize  += RunTimeCacheArena::slotSizeOf($newFunction->op_array->cache_size);
+        }
+        $cacheArena = new RunTimeCacheArena($arenaSize);
+
+        // Staging pass: every entry dispatches the new body once its swap is staged,
+        // and any failure rolls all staged entries back to their previous bodies
+        /** @var array<string, PendingBodySwap> $pendingSwaps */
+        $pendingSwaps  = [];
+        $entries       = [];
+        $stagedEntries = [];
+        $stagingTimes  = [];
+        $warmedSlots   = 0;
+        $entryName     = '';
+        try {
+            foreach ($this->targets as $target) {
+                $entryName = $target['name'];
+                $stagedAt  = hrtime(true);
+                // Resolved again per entry: staging an earlier method may have copied the
+                // shared class out of opcache memory, which republishes every method entry
+                $entry = self::resolve($target);
+                if (isset($stagedEntries[$entry->getAddress()])) {
+                    // An inherited method shares the entry structure of its parent
+                    throw HotSwapException::duplicateBatchEntry($entryName);
+                }
+                $pending = $entry->stageRedefinition($target['code'], $cacheArena);
+
+                $stagedEntries[$entry->getAddress()] = true;
+
+                $pendingSwaps[$entryName] = $pending;
+                $entries[$entryName]      = $entry;
+                $warmedSlots             += $pending->warmRunTimeCache($this->warmup);
+                $stagingTimes[$entryName] = hrtime(true) - $stagedAt;
+            }
+            // Inlined copies of the previous bodies go once, after every swap is staged; a
+            // caller with a live frame rolls the whole batch back. Callers that are targets
+            // themselves are skipped, their new bodies replace the inlined ones anyway
+            Inliner::revertCallersOf(...array_values($entries));
+        } catch (\Throwable $error) {
+            foreach (array_reverse($pendingSwaps) as $pending) {
+                $pending->rollback();
+            }
+            $cacheArena->release();
+            if ($error instanceof HotSwapException || $error instanceof SharedMemoryException) {
+                throw $error;
+            }
+            if ($pendingSwaps === []) {
+                throw $error;
+            }
+            throw HotSwapException::batchFailedAndRolledBack($entryName, $error);
+        }
+
+        // Commit: from here on nothing can fail - previous bodies are released
+        // (shared-memory ones stay allocated by contract)
+        $commitTimes = [];
+        foreach ($pendingSwaps as $entryName => $pending) {
+            $committedAt = hrtime(true);
+            $pending->commit();
+            Inliner::forgetCaller($entries[$entryName]);
+            $commitTimes[$entryName] = hrtime(true) - $committedAt;
+        }
+        $this->isCommitted = true;
+        $this->targets     = [];
+
+        return new RedefinitionBatchReport(
+            $stagingTimes,
+            $commitTimes,
+            $cacheArena->size,
+            $warmedSlots,
+            hrtime(true) - $startedAt,
+        );
+    }
+
+    private function add(?string $className, string $functionName, \Closure $newCode): self
+    {
+        if ($this->isCommitted) {
+            throw HotSwapException::batchAlreadyCommitted();
+        }
+        $entryName = $className === null ? $functionName : "{$className}::{$functionName}";
+        $entryKey  = strtolower(ltrim($entryName, '\\'));
+        if (isset($this->targets[$entryKey])) {
+            throw HotSwapException::duplicateBatchEntry($entryName);
+        }
+        $this->targets[$entryKey] = [
+            'name'     => $entryName,
+            'class'    => $className,
+            'function' => $functionName,
+            'code'     => $newCode,
+        ];
+
+        return $this;
+    }
+
+    /**
+     * @param array{name: string, class: ?string, function: string, code: \Closure} $target
+     */
+    private static function resolve(array $target): ReflectionFunction|ReflectionMethod
+    {
+        return $target['class'] === null
+            ? new ReflectionFunction($target['function'])
+            : new ReflectionMethod($target['class'], $target['function']);
+    }
+}
@@ -0,0 +1,70 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\HotSwap;
+
+/**
+ * What one RedefinitionBatch::commit() swapped and how long each entry took
+ *
+ * Entries are keyed by the name they were added under ("function" or "Class::method"), in
+ * the order they were added; all times are hrtime() nanoseconds.
+ */
+final class RedefinitionBatchReport
+{
+    /**
+     * @param array<string, int> $stagingTimes     Copy-out, swap and cache warm-up of each entry
+     * @param array<string, int> $commitTimes      Destruction of each previous body
+     * @param int                $arenaBytes       Size of the block all run-time caches share
+     * @param int                $warmedSlots      Run-time cache slot ranges filled by the warm-up
+     * @param int                $totalNanoseconds Whole commit(), including the inliner revert pass
+     *
+     * @internal built by RedefinitionBatch::commit()
+     */
+    public function __construct(
+        public readonly array $stagingTimes,
+        public readonly array $commitTimes,
+        public readonly int $arenaBytes,
+        public readonly int $warmedSlots,
+        public readonly int $totalNanoseconds,
+    ) {}
+
+    /**
+     * Returns the names of the swapped entries
+     *
+     * @return list<string>
+     */
+    public function getEntries(): array
+    {
+        return array_keys($this->stagingTimes);
+    }
+
+    /**
+     * Returns the staging and commit time of one entry in nanoseconds
+     */
+    public function getSwapTime(string $entryName): int
+    {
+        if (!isset($this->stagingTimes[$entryName])) {
+            throw new \OutOfBoundsException("{$entryName} is not part of this batch");
+        }
+
+        return $this->stagingTimes[$entryName] + $this->commitTimes[$entryName];
+    }
+
+    /**
+     * Checks if the batch swapped nothing (no entry was added)
+     */
+    public function isNoOp(): bool
+    {
+        return $this->stagingTimes === [];
+    }
+}
@@ -24,19 +24,51 @@ use ZEngine\Core;
  * so a modified binary stays loadable with
  * opcache.file_cache_consistency_checks=1.
  *
+ * read() loads a binary into a string; map() maps it into memory instead,
+ * for large binaries and bulk scans.
+ *
  * Path layout on this platform mirrors zend_file_cache_get_bin_file_path():
  * file_cache_dir + '/' + system_id + realpath(script) + '.bin'.
  */
 final class BinaryCacheFile
 {
+    /**
+     * Changed bytes up to which save() updates a verified checksum incrementally; past it
+     * hashing the whole payload in C is cheaper than the per-byte update in PHP
+     */
+    private const int INCREMENTAL_CHECKSUM_LIMIT = 65536;
+
+    /**
+     * Unchanged bytes that still merge two changed ranges into one write
+     */
+    private const int CHANGE_MERGE_GAP = 16;
+
     private ?PayloadRelocator $relocator = null;
 
     private ?ReflectionOpcacheFile $view = null;
 
+    /**
+     * Set for map()ped binaries, whose payload is only copied into a string on demand
+     */
+    private ?CacheBinaryMapping $mapping = null;
+
+    /**
+     * Whether the payload is what binPath holds on disk (true until a save() elsewhere)
+     */
+    private bool $payloadIsOnDisk = true;
+
+    /**
+     * Whether the header checksum is known to match the payload, which lets save()
+     * update it incrementally instead of hashing the whole payload again
+     */
+    private bool $checksumIsVerified = false;
+
+    private int $lastWrittenBytes = 0;
+
     private function __construct(
         private readonly string $binPath,
         private CacheMetaInfo $metaInfo,
-        private string $payload,
+        private ?string $payload,
         private readonly ?string $scriptPath = null,
     ) {}
 
@@ -61,6 +93,128 @@ final class BinaryCacheFile
         return new self($binPath, $metaInfo, $payload, $scriptPath);
     }
 
+    /**
+     * Maps a cache binary into memory instead of reading it (64-bit POSIX only)
+     *
+     * The header is parsed and verifyChecksum() runs straight from the mapping, and
+     * getReflection() relocates the mapped payload in place: pages are copied on write,
+     * only those the relocation touches (a lazy relocation touches few). Scanning a whole
+     * cache directory this way is bounded by page faults rather than by reading and copying
+     * every binary twice. The payload becomes a string only when payload() asks for it or
+     * save() writes an unrelocated binary.
+     *
+     * The mapping lives as long as the returned file, its view and every body swapped out
+     * of it; unmap() ends it early for inspection-only scans.
+     *
+     * @param string|null $scriptPath The source script this binary caches (used by refresh())
+     */
+    public static function map(string $binPath, ?string $scriptPath = null): self
+    {
+        if (!is_readable($binPath)) {
+            throw OpCacheException::binFileNotFound($binPath);
+        }
+        $mapping  = CacheBinaryMapping::open($binPath);
+        $metaInfo = $mapping->metaInfo();
+        if ($mapping->payloadLength() < $metaInfo->memSize() + $metaInfo->strSize()) {
+            $mapping->release();
+            throw OpCacheException::truncatedFile($binPath);
+        }
+        $file          = new self($binPath, $metaInfo, null, $scriptPath);
+        $file->mapping = $mapping;
+
+        return $file;
+    }
+
+    /**
+     * Finds the byte ranges two equally long payloads differ in
+     *
+     * The XOR of both strings is zero wherever they agree; ranges closer than
+     * CHANGE_MERGE_GAP bytes are merged, so an edited 8-byte value that kept some
+     * of its bytes is still written as one range.
+     *
+     * @return array<int, string> New bytes keyed by payload offset
+     */
+    private static function changedRanges(string $previous, string $current): array
+    {
+        $difference = $previous ^ $current;
+        $length     = strlen($difference);
+        $changes    = [];
+        $offset     = strspn($difference, "\0");
+        while ($offset < $length) {
+            $end = $offset + strcspn($difference, "\0", $offset);
+            while ($end < $length) {
+                $gap = strspn($difference, "\0", $end);
+                if ($end + $gap >= $length || $gap >= self::CHANGE_MERGE_GAP) {
+                    break;
+                }
+                $end += $gap + strcspn($difference, "\0", $end + $gap);
+            }
+            $changes[$offset] = substr($current, $offset, $end - $offset);
+            $offset           = $end + strspn($difference, "\0", $end);
+        }
+
+        return $changes;
+    }
+
+    /**
+     * Rewrites the changed payload ranges and then the header of a binary in place
+     *
+     * The header on disk must still be the one the payload was read with; a binary
+     * replaced or rewritten since then (another worker, opcache_invalidate() unlinking
+     * it) is left alone for a full write. So is a binary some process holds a shared lock
+     * on: mapped views (CacheBinaryMapping) keep theirs, and a write into the inode they
+     * map would change the pages they have not copied yet.
+     *
+     * @param array<int, string> $changes New bytes keyed by payload offset
+     *
+     * @return int|null Bytes written, or null when the binary is not the expected one
+     */
+    private static function patchInPlace(string $binPath, CacheMetaInfo $expected, CacheMetaInfo $metaInfo, array $changes): ?int
+    {
+        $handle = @fopen($binPath, 'r+b');
+        if ($handle === false) {
+            return null;
+        }
+
+        try {
+            if (!flock($handle, LOCK_EX | LOCK_NB)) {
+                return null;
+            }
+            $headerSize = CacheMetaInfo::byteSize();
+            $header     = fread($handle, $headerSize);
+            try {
+                $onDisk = CacheMetaInfo::parse($header === false ? '' : $header, $binPath);
+            } catch (OpCacheException) {
+                return null;
+            }
+            if ($onDisk->toBinary() !== $expected->toBinary()) {
+                return null;
+            }
+
+            // Payload first, header last: the checksum only turns valid once every range is in
+            $writtenBytes = 0;
+            foreach ($changes as $offset => $bytes) {
+                if (fseek($handle, $headerSize + $offset) !== 0 || fwrite($handle, $bytes) !== strlen($bytes)) {
+                    throw OpCacheException::writeFailed($binPath);
+                }
+                $writtenBytes += strlen($bytes);
+            }
+            $newHeader = $metaInfo->toBinary();
+            if ($newHeader !== $onDisk->toBinary()) {
+                if (fseek($handle, 0) !== 0 || fwrite($handle, $newHeader) !== $headerSize) {
+                    throw OpCacheException::writeFailed($binPath);
+                }
+                $writtenBytes += $headerSize;
+            }
+            fflush($handle);
+
+            return $writtenBytes;
+        } finally {
+            flock($handle, LOCK_UN);
+            fclose($handle);
+        }
+    }
+
     /**
      * Reads the whole file under a shared advisory lock, so a concurrent
      * writer (another worker refreshing the same binary) cannot be observed
@@ -135,21 +289,7 @@ final class BinaryCacheFile
         // Opcache refuses to boot file_cache_only against a missing directory
         self::ensureDirectory($fileCacheDir, $directoryPermissions);
         $command = [
-            $phpBinary ?? PHP_BINARY,
-            '-d', 'opcache.enable=1',
-            '-d', 'opcache.enable_cli=1',
-            '-d', 'opcache.file_cache=' . $fileCacheDir,
-            '-d', 'opcache.file_cache_only=1',
-            // The file cache refuses to store scripts while the JIT is active
-            '-d', 'opcache.jit=off',
-            '-d', 'opcache.jit_buffer_size=0',
-        ];
-        foreach ($extraDirectives as $directive) {
-            $command[] = '-d';
-            $command[] = $directive;
-        }
-        $command = [
-            ...$command,
+            ...self::compilerCommand($fileCacheDir, $phpBinary, $extraDirectives),
             '-r', 'exit(function_exists("opcache_compile_file") ? (opcache_compile_file($argv[1]) ? 0 : 1) : 2);',
             '--',
             $realPath,
@@ -173,6 +313,38 @@ final class BinaryCacheFile
         return self::read(self::locate($fileCacheDir, $realPath), $realPath);
     }
 
+    /**
+     * The child PHP invocation that compiles scripts into the file cache: opcache
+     * enabled for the CLI, writing to the given directory only, with the JIT off
+     *
+     * The caller appends the code to run (`-r ...`) and its arguments.
+     *
+     * @internal Shared by compile() and FileCacheWarmer
+     *
+     * @param list<string> $extraDirectives Additional `-d name=value` ini directives
+     *
+     * @return list<string>
+     */
+    public static function compilerCommand(string $fileCacheDir, ?string $phpBinary, array $extraDirectives): array
+    {
+        $command = [
+            $phpBinary ?? PHP_BINARY,
+            '-d', 'opcache.enable=1',
+            '-d', 'opcache.enable_cli=1',
+            '-d', 'opcache.file_cache=' . $fileCacheDir,
+            '-d', 'opcache.file_cache_only=1',
+            // The file cache refuses to store scripts while the JIT is active
+            '-d', 'opcache.jit=off',
+            '-d', 'opcache.jit_buffer_size=0',
+        ];
+        foreach ($extraDirectives as $directive) {
+            $command[] = '-d';
+            $command[] = $directive;
+        }
+
+        return $command;
+    }
+
     public function binPath(): string
     {
         return $this->binPath;
@@ -199,7 +371,11 @@ final class BinaryCacheFile
      */
     public function verifyChecksum(): bool
     {
-        return CacheMetaInfo::checksumOf($this->payload) === $this->metaInfo->checksum();
+        if ($this->payload === null && $this->mapping !== null) {
+            return $this->checksumIsVerified = $this->mapping->payloadChecksum() === $this->metaInfo->checksum();
+        }
+
+        return $this->checksumIsVerified = CacheMetaInfo::checksumOf($this->payload()) === $this->metaInfo->checksum();
     }
 
     /**
@@ -208,37 +384,81 @@ final class BinaryCacheFile
      */
     public function payload(): string
     {
+        if ($this->payload === null) {
+            if ($this->mapping === null) {
+                throw OpCacheException::binaryUnmapped($this->binPath);
+            }
+            // The pristine view: relocating the mapped image never changes what this returns
+            $this->payload = $this->mapping->payloadBytes();
+        }
+
         return $this->payload;
     }
 
+    /**
+     * Unmaps a map()ped binary (no-op for read() ones)
+     *
+     * The view and every wrapper it handed out become invalid, so this is only for binaries
+     * that were inspected, never applied to the live process (CacheImageSync). A payload()
+     * already copied out stays available.
+     */
+    public function unmap(): void
+    {
+        if ($this->mapping === null) {
+            return;
+        }
+        $this->mapping->release();
+        $this->mapping   = null;
+        $this->relocator = null;
+        $this->view      = null;
+    }
+
     /**
      * Materializes the payload into a live image and returns a Reflection-style
      * handle over its zend_persistent_script. Mutations made through the
      * returned wrappers are written back by save(). The handle is cached, so
      * repeated calls share one image.
+     *
+     * A lazy image relocates only the script header and the function/class
+     * tables up front; each function or class body is relocated on its first
+     * access through getFunction()/getClass() (the raw tables and the
+     * getFunctions()/getClasses() listings relocate everything). Tooling that
+     * inspects one entry of a large script skips relocating all the others.
+     * An eager call on a lazy image relocates the rest.
      */
-    public function getReflection(): ReflectionOpcacheFile
+    public function getReflection(bool $lazy = false): ReflectionOpcacheFile
     {
         if ($this->view !== null) {
+            if (!$lazy) {
+                $this->relocator?->relocateDeferred();
+            }
+
             return $this->view;
         }
         if (!$this->matchesCurrentBuild()) {
             throw OpCacheException::systemIdMismatch(SystemId::current(), $this->metaInfo->systemId());
         }
-        $length = strlen($this->payload);
+        if ($this->mapping !== null) {
+            // The working view is already writable and private to this process
+            $this->relocator = new PayloadRelocator($this->mapping->workingBuffer(), $this->metaInfo, $this->mapping);
+
+            return $this->view = new ReflectionOpcacheFile($this->relocator->relocate($lazy), $this->relocator);
+        }
+        $payload = $this->payload();
+        $length  = strlen($payload);
         // The relocator needs its own WRITABLE buffer: relocate() rewrites the
         // stored offsets to real addresses in place, and PHP strings are
         // immutable/copy-on-write, so $this->payload cannot be relocated
         // directly. The buffer is kept alive by the relocator it is handed to;
         // the relocated image points into it, so it must outlive the handle.
         $buffer = Core::new("char[{$length}]", false);
-        Core::memcpy($buffer, $this->payload, $length);
+        Core::memcpy($buffer, $payload, $length);
 
         $this->relocator = new PayloadRelocator($buffer, $this->metaInfo);
 
         // The relocator travels with the view as its owner, so the view alone keeps the
         // buffer alive even when this BinaryCacheFile is released by the caller
-        return $this->view = new ReflectionOpcacheFile($this->relocator->relocate(), $this->relocator);
+        return $this->view = new ReflectionOpcacheFile($this->relocator->relocate($lazy), $this->relocator);
     }
 
     /**
@@ -246,17 +466,30 @@ final class BinaryCacheFile
      * pass a timestamp to match the target script's mtime (opcache compares
      * them for equality when opcache.validate_timestamps=1).
      *
-     * The write is atomic: a temporary sibling file is renamed over the
+     * A full write is atomic: a temporary sibling file is renamed over the
      * destination, so a concurrent loader never observes a torn binary.
+     *
+     * Size-preserving edits saved back to the binary they were read from are
+     * written incrementally instead: the re-serialized payload is compared with
+     * the bytes on disk, only the changed ranges and the header are rewritten in
+     * place under an exclusive flock() (the lock opcache takes on load), and a
+     * checksum known to be valid is updated from the changed bytes alone. A graph
+     * that grew, a payload of a different length, another target, or a binary
+     * replaced on disk since it was read take the full write.
      */
     public function save(?string $binPath = null, ?int $timestamp = null, ?int $directoryPermissions = 0o755): void
     {
-        $target = $binPath ?? $this->binPath;
-        if ($this->view !== null && $this->view->isGraphGrown()) {
+        $target          = $binPath ?? $this->binPath;
+        $previousMeta    = $this->metaInfo;
+        $isGraphGrown    = $this->view !== null && $this->view->isGraphGrown();
+        $previousPayload = !$isGraphGrown && $target === $this->binPath && $this->payloadIsOnDisk ? $this->payload() : null;
+        if ($isGraphGrown) {
             // A mutation outgrew the original buffer (added function/method,
             // regrown hashtable): re-emit the whole graph from scratch through
             // the two-pass persist serializer (issue #117). In-place edits keep
-            // taking the exact-inverse derelocate() path below.
+            // taking the exact-inverse derelocate() path below. The serializer
+            // walks the whole graph, so deferred entries are relocated first.
+            $this->relocator?->relocateDeferred();
             $serializer     = new ScriptSerializer($this->view->getRawScript());
             $this->payload  = $serializer->serialize();
             $this->metaInfo = CacheMetaInfo::forPayload(
@@ -274,24 +507,55 @@ final class BinaryCacheFile
             $length         = strlen($this->payload);
             $this->metaInfo = $this->metaInfo->withStrSize($length - $this->metaInfo->memSize());
         }
-        $this->metaInfo = $this->metaInfo
-            ->withChecksum(CacheMetaInfo::checksumOf($this->payload));
+        $payload  = $this->payload();
+        $changes  = null;
+        $checksum = null;
+        if ($previousPayload !== null && strlen($previousPayload) === strlen($payload)) {
+            $changes = self::changedRanges($previousPayload, $payload);
+            if ($this->checksumIsVerified && array_sum(array_map(strlen(...), $changes)) <= self::INCREMENTAL_CHECKSUM_LIMIT) {
+                $checksum = CacheMetaInfo::updateChecksum($previousMeta->checksum(), $previousPayload, $changes);
+            }
+        }
+        $this->metaInfo = $this->metaInfo->withChecksum($checksum ?? CacheMetaInfo::checksumOf($payload));
         if ($timestamp !== null) {
             $this->metaInfo = $this->metaInfo->withTimestamp($timestamp);
         }
+        $this->checksumIsVerified = true;
+        $this->payloadIsOnDisk    = $target === $this->binPath;
+
+        if ($changes !== null) {
+            $writtenBytes = self::patchInPlace($target, $previousMeta, $this->metaInfo, $changes);
+            if ($writtenBytes !== null) {
+                $this->lastWrittenBytes = $writtenBytes;
+
+                return;
+            }
+        }
 
         self::ensureDirectory(dirname($target), $directoryPermissions);
         // Write to a unique sibling under an exclusive lock, then rename over
         // the destination: the rename is atomic, so a concurrent reader (see
         // readLocked()) observes either the old or the new file, never a torn one
         $temporary = $target . '.' . bin2hex(random_bytes(6)) . '.tmp';
-        if (file_put_contents($temporary, $this->metaInfo->toBinary() . $this->payload, LOCK_EX) === false) {
+        if (file_put_contents($temporary, $this->metaInfo->toBinary() . $payload, LOCK_EX) === false) {
             throw OpCacheException::writeFailed($temporary);
         }
         if (!rename($temporary, $target)) {
             @unlink($temporary);
             throw OpCacheException::writeFailed($target);
         }
+        $this->lastWrittenBytes = CacheMetaInfo::byteSize() + strlen($payload);
+    }
+
+    /**
+     * Returns the number of bytes the last save() wrote, the header included
+     *
+     * The whole file for a full write; the changed ranges plus the header for an
+     * incremental one (0 when nothing changed at all).
+     */
+    public function lastWrittenBytes(): int
+    {
+        return $this->lastWrittenBytes;
     }
 
     /**
@@ -299,8 +563,10 @@ final class BinaryCacheFile
      * caller owns directory creation and the directory must already exist; a
      * non-null mask creates it with exactly that mask (umask still applies),
      * never implicitly world-writable.
+     *
+     * @internal Shared with FileCacheWarmer
      */
-    private static function ensureDirectory(string $directory, ?int $permissions): void
+    public static function ensureDirectory(string $directory, ?int $permissions): void
     {
         if (is_dir($directory)) {
             return;
@@ -0,0 +1,275 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\OpCache;
+
+use FFI;
+use FFI\CData;
+use ZEngine\Core;
+
+/**
+ * A cache binary mapped into memory instead of read into a string
+ *
+ * The file is mapped twice, both MAP_PRIVATE: a read-only pristine view the header, the
+ * checksum and payload() are served from, and a writable working view PayloadRelocator
+ * relocates in place. Pages of both views come straight from the page cache; a page is
+ * copied only when the relocator writes to it, and only into the working view, so the
+ * pristine view keeps showing the file as it was mapped. Opening a binary costs two
+ * mmap() calls, not a read and a memcpy of the whole file.
+ *
+ * The views are taken under a shared flock(), the lock opcache itself takes on load, and
+ * refer to the mapped inode: a binary replaced by rename (BinaryCacheFile::save()) later
+ * on leaves them intact. MAP_PRIVATE only isolates the pages already copied, so an
+ * in-place write into the inode would show through every view of every process.
+ * BinaryCacheFile::save() patches in place only when it gets the exclusive lock without
+ * waiting, and takes the full rename write otherwise.
+ *
+ * Like the heap buffers of read() binaries, the views are never unmapped implicitly:
+ * bodies swapped into the live process (CacheImageSync) keep executing out of them.
+ * release() unmaps them for bulk scans that only inspect. The descriptor and its lock are
+ * held until release(), or until the last owner of the mapping goes away - except for a
+ * pinned mapping, whose bodies run in the live process and keep the lock for good. A scan
+ * that never calls release() thus holds one descriptor per binary it still references.
+ *
+ * @internal backing store of BinaryCacheFile::map()
+ */
+final class CacheBinaryMapping
+{
+    private const int PROT_READ  = 0x1;
+    private const int PROT_WRITE = 0x2;
+
+    private const int MAP_PRIVATE = 0x02;
+
+    private const int O_RDONLY = 0x0;
+    private const int SEEK_END = 2;
+    private const int LOCK_SH  = 1;
+
+    /**
+     * Process-image libc symbols; the same on Linux and macOS
+     */
+    private const string LIBC_DEFINITION = <<<'C'
+        void *mmap(void *addr, size_t length, int prot, int flags, int fd, long offset);
+        int munmap(void *addr, size_t length);
+        int open(const char *pathname, int flags, ...);
+        int close(int fd);
+        long lseek(int fd, long offset, int whence);
+        int flock(int fd, int operation);
+        C;
+
+    private static ?FFI $libc = null;
+
+    private bool $isReleased = false;
+
+    private bool $isDescriptorClosed = false;
+
+    private bool $isPinned = false;
+
+    private readonly int $pristineAddress;
+
+    private readonly int $workingAddress;
+
+    /**
+     * @param CData $pristineView Read-only view, as returned by mmap()
+     * @param CData $workingView  Writable copy-on-write view, as returned by mmap()
+     * @param int   $descriptor   Descriptor holding the shared lock, closed by release() or
+     *                            with the last owner of an unpinned mapping
+     */
+    private function __construct(
+        public readonly string $binPath,
+        public readonly int $length,
+        private readonly CData $pristineView,
+        private readonly CData $workingView,
+        private readonly int $descriptor,
+    ) {
+        $this->pristineAddress = self::addressOfView($pristineView);
+        $this->workingAddress  = self::addressOfView($workingView);
+    }
+
+    /**
+     * Drops the lock of a mapping nothing runs out of; the views stay mapped
+     */
+    public function __destruct()
+    {
+        if (!$this->isPinned) {
+            $this->closeDescriptor();
+        }
+    }
+
+    /**
+     * Checks whether binaries can be mapped in this process (64-bit POSIX, like the relocator)
+     */
+    public static function isSupported(): bool
+    {
+        return PayloadRelocator::isSupported();
+    }
+
+    /**
+     * Maps a cache binary
+     *
+     * @throws OpCacheException When the file cannot be opened or mapped, or is shorter than a header
+     */
+    public static function open(string $binPath): self
+    {
+        if (!self::isSupported()) {
+            throw OpCacheException::unsupportedPayload('binaries can be mapped on 64-bit non-Windows builds only');
+        }
+        $libc = self::$libc ??= FFI::cdef(self::LIBC_DEFINITION);
+
+        $descriptor = $libc->open($binPath, self::O_RDONLY);
+        if ($descriptor < 0) {
+            throw OpCacheException::readFailed($binPath);
+        }
+        try {
+            if ($libc->flock($descriptor, self::LOCK_SH) !== 0) {
+                throw OpCacheException::readFailed($binPath);
+            }
+            $length = $libc->lseek($descriptor, 0, self::SEEK_END);
+            if ($length < CacheMetaInfo::byteSize()) {
+                throw OpCacheException::truncatedFile($binPath);
+            }
+            $pristineView = self::mapView($libc, $length, self::PROT_READ, $descriptor, $binPath);
+            try {
+                $workingView = self::mapView($libc, $length, self::PROT_READ | self::PROT_WRITE, $descriptor, $binPath);
+            } catch (OpCacheException $error) {
+                $libc->munmap($pristineView, $length);
+                throw $error;
+            }
+        } catch (\Throwable $error) {
+            // Closing the descriptor also drops the lock
+            $libc->close($descriptor);
+            throw $error;
+        }
+
+        return new self($binPath, $length, $pristineView, $workingView, $descriptor);
+    }
+
+    /**
+     * Parses the header from the pristine view
+     */
+    public function metaInfo(): CacheMetaInfo
+    {
+        return CacheMetaInfo::parseAt($this->pristineAddress(), $this->length, $this->binPath);
+    }
+
+    /**
+     * Returns the number of bytes after the header
+     */
+    public function payloadLength(): int
+    {
+        return $this->length - CacheMetaInfo::byteSize();
+    }
+
+    /**
+     * Copies the payload out of the pristine view, for callers that need it as a string
+     */
+    public function payloadBytes(): string
+    {
+        $payloadLength = $this->payloadLength();
+
+        return FFI::string(Core::pointerAtAddress('char *', $this->pristineAddress() + CacheMetaInfo::byteSize()), $payloadLength);
+    }
+
+    /**
+     * Computes the payload checksum from the pristine view, without copying the payload
+     */
+    public function payloadChecksum(): int
+    {
+        return CacheMetaInfo::checksumOfMemory($this->pristineAddress() + CacheMetaInfo::byteSize(), $this->payloadLength());
+    }
+
+    /**
+     * Returns the payload of the working view as a char[] the relocator rewrites in place
+     */
+    public function workingBuffer(): CData
+    {
+        if ($this->isReleased) {
+            throw OpCacheException::binaryUnmapped($this->binPath);
+        }
+        $payloadLength = $this->payloadLength();
+        $buffer        = Core::pointerAtAddress("char (*)[{$payloadLength}]", $this->workingAddress + CacheMetaInfo::byteSize())[0];
+        assert($buffer instanceof CData);
+
+        return $buffer;
+    }
+
+    /**
+     * Unmaps both views and drops the shared lock: every image relocated in the working view
+     * becomes invalid
+     *
+     * Only for binaries nothing was swapped into the live process from.
+     */
+    public function release(): void
+    {
+        if ($this->isReleased) {
+            return;
+        }
+        $this->isReleased = true;
+        $libc             = self::$libc ??= FFI::cdef(self::LIBC_DEFINITION);
+        $libc->munmap($this->pristineView, $this->length);
+        $libc->munmap($this->workingView, $this->length);
+        $this->closeDescriptor();
+    }
+
+    public function isReleased(): bool
+    {
+        return $this->isReleased;
+    }
+
+    /**
+     * Keeps the descriptor and its lock after the last owner went away
+     *
+     * @internal called by CacheImageSync once bodies of the working view run in the live process
+     */
+    public function pin(): void
+    {
+        $this->isPinned = true;
+    }
+
+    private function closeDescriptor(): void
+    {
+        if ($this->isDescriptorClosed) {
+            return;
+        }
+        $this->isDescriptorClosed = true;
+        $libc                     = self::$libc ??= FFI::cdef(self::LIBC_DEFINITION);
+        // Closing the descriptor also drops the lock
+        $libc->close($this->descriptor);
+    }
+
+    private function pristineAddress(): int
+    {
+        if ($this->isReleased) {
+            throw OpCacheException::binaryUnmapped($this->binPath);
+        }
+
+        return $this->pristineAddress;
+    }
+
+    private static function mapView(FFI $libc, int $length, int $protection, int $descriptor, string $binPath): CData
+    {
+        $view = $libc->mmap(null, $length, $protection, self::MAP_PRIVATE, $descriptor, 0);
+        // MAP_FAILED is (void *) -1, a NULL result arrives as PHP null
+        if (!$view instanceof CData || self::addressOfView($view) === -1) {
+            throw OpCacheException::readFailed($binPath);
+        }
+
+        return $view;
+    }
+
+    private static function addressOfView(CData $view): int
+    {
+        $libc = self::$libc ??= FFI::cdef(self::LIBC_DEFINITION);
+
+        return $libc->cast('intptr_t', $view)->cdata;
+    }
+}
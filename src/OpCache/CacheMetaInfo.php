@@ -37,6 +37,16 @@ final class CacheMetaInfo
      */
     public const string MAGIC = "OPCACHE\0";
 
+    /**
+     * Bytes checksumOfMemory() hashes per step
+     */
+    private const int CHECKSUM_CHUNK_SIZE = 1 << 20;
+
+    /**
+     * Largest prime below 2^16, the adler32 modulus
+     */
+    private const int ADLER32_MODULUS = 65521;
+
     /**
      * The fields are published as public readonly and every reconstruction below passes them by
      * NAME: four of the six are plain ints, so a positional call that transposes two of them
@@ -65,19 +75,24 @@ final class CacheMetaInfo
         }
         $raw = Core::new('zend_file_cache_metainfo[1]');
         Core::memcpy($raw, substr($bytes, 0, self::byteSize()), self::byteSize());
-        $struct = Core::cast(zend_file_cache_metainfo::class, Core::addr($raw));
-        if (FFI::string($struct->magic, strlen(self::MAGIC)) !== self::MAGIC) {
-            throw OpCacheException::invalidMagic($origin);
+
+        return self::fromStruct(Core::cast(zend_file_cache_metainfo::class, Core::addr($raw)), $origin);
+    }
+
+    /**
+     * Parses a header straight from memory (a mapped binary), without copying it into a string
+     *
+     * @param int    $address Address of the first header byte
+     * @param int    $length  Bytes readable from $address
+     * @param string $origin  Human-readable source used in diagnostics
+     */
+    public static function parseAt(int $address, int $length, string $origin = '(in-memory)'): self
+    {
+        if ($length < self::byteSize()) {
+            throw OpCacheException::truncatedFile($origin);
         }
 
-        return new self(
-            systemId: SystemId::fromBinary(FFI::string($struct->system_id, SystemId::LENGTH)),
-            memSize: $struct->mem_size,
-            strSize: $struct->str_size,
-            scriptOffset: $struct->script_offset,
-            timestamp: $struct->timestamp,
-            checksum: $struct->checksum,
-        );
+        return self::fromStruct(Core::pointerAtAddress(zend_file_cache_metainfo::class, $address), $origin);
     }
 
     /**
@@ -109,6 +124,7 @@ final class CacheMetaInfo
      */
     public static function byteSize(): int
     {
+        Core::requireHeaderSlice('opcache');
         $size = Core::sizeOfType(zend_file_cache_metainfo::class);
         if ($size < 1) {
             throw OpCacheException::unsupportedPayload('zend_file_cache_metainfo has no size in the loaded header');
@@ -126,6 +142,54 @@ final class CacheMetaInfo
         return (int) hexdec(hash('adler32', $payloadAndStrings));
     }
 
+    /**
+     * Updates the checksum of a payload whose bytes were replaced in place, in time
+     * proportional to the replaced bytes rather than to the payload
+     *
+     * adler32 keeps A = 1 + sum(d[i]) and B = n + sum((n - i) * d[i]) modulo 65521
+     * over the n payload bytes, so changing d[i] by delta moves A by delta and B by
+     * (n - i) * delta. The result equals checksumOf() of the new payload only when
+     * $checksum was the valid checksum of $previous.
+     *
+     * @param array<int, string> $changes New bytes keyed by payload offset (same length as before)
+     */
+    public static function updateChecksum(int $checksum, string $previous, array $changes): int
+    {
+        $length = strlen($previous);
+        $sumA   = $checksum & 0xFFFF;
+        $sumB   = ($checksum >> 16) & 0xFFFF;
+        foreach ($changes as $offset => $bytes) {
+            $count = strlen($bytes);
+            for ($index = 0; $index < $count; $index++) {
+                $delta = ord($bytes[$index]) - ord($previous[$offset + $index]);
+                if ($delta !== 0) {
+                    $sumA = ($sumA + $delta) % self::ADLER32_MODULUS;
+                    $sumB = ($sumB + ($length - $offset - $index) * $delta) % self::ADLER32_MODULUS;
+                }
+            }
+        }
+        // PHP's % keeps the sign of the dividend
+        $sumA = ($sumA + self::ADLER32_MODULUS) % self::ADLER32_MODULUS;
+        $sumB = ($sumB + self::ADLER32_MODULUS) % self::ADLER32_MODULUS;
+
+        return ($sumB << 16) | $sumA;
+    }
+
+    /**
+     * checksumOf() over memory (a mapped binary): the bytes are hashed in bounded chunks,
+     * never copied into one string
+     */
+    public static function checksumOfMemory(int $address, int $length): int
+    {
+        $context = hash_init('adler32');
+        for ($offset = 0; $offset < $length; $offset += self::CHECKSUM_CHUNK_SIZE) {
+            $chunkSize = min(self::CHECKSUM_CHUNK_SIZE, $length - $offset);
+            hash_update($context, FFI::string(Core::pointerAtAddress('char *', $address + $offset), $chunkSize));
+        }
+
+        return (int) hexdec(hash_final($context));
+    }
+
     /**
      * The accessors below are kept as the established reading API of this value object; each one
      * is a thin delegate to the identically named public readonly property, so both spellings
@@ -222,4 +286,23 @@ final class CacheMetaInfo
 
         return FFI::string(Core::cast('char *', Core::addr($raw)), self::byteSize());
     }
+
+    /**
+     * @param zend_file_cache_metainfo $struct
+     */
+    private static function fromStruct(object $struct, string $origin): self
+    {
+        if (FFI::string($struct->magic, strlen(self::MAGIC)) !== self::MAGIC) {
+            throw OpCacheException::invalidMagic($origin);
+        }
+
+        return new self(
+            systemId: SystemId::fromBinary(FFI::string($struct->system_id, SystemId::LENGTH)),
+            memSize: $struct->mem_size,
+            strSize: $struct->str_size,
+            scriptOffset: $struct->script_offset,
+            timestamp: $struct->timestamp,
+            checksum: $struct->checksum,
+        );
+    }
 }
@@ -0,0 +1,112 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\OpCache;
+
+/**
+ * Record of the binaries a FileCacheWarmer produced, stored as JSON next to them
+ *
+ * One entry per source script (keyed by its real path) holding what the binary header
+ * said when it was written: system id, source timestamp, checksum, plus the binary size.
+ * A later run compares the entry with a stat() of the source and the binary instead of
+ * opening every binary again.
+ *
+ * The manifest is a cache of facts the binaries themselves carry, never the source of
+ * truth: a missing, unreadable or foreign-version manifest loads empty and every binary
+ * is checked by its header instead.
+ */
+final class FileCacheManifest
+{
+    public const string FILE_NAME = 'zengine-manifest.json';
+
+    public const int VERSION = 1;
+
+    /**
+     * @param array<string, array{binPath: string, systemId: string, timestamp: int, checksum: int, size: int}> $entries
+     */
+    private function __construct(private readonly string $path, private array $entries) {}
+
+    /**
+     * Loads the manifest of a file-cache directory, or an empty one when there is none
+     */
+    public static function load(string $fileCacheDir): self
+    {
+        $path    = rtrim($fileCacheDir, '/') . '/' . self::FILE_NAME;
+        $entries = [];
+        if (is_file($path)) {
+            $data = json_decode((string) file_get_contents($path), true);
+            if (is_array($data) && ($data['version'] ?? null) === self::VERSION && is_array($data['entries'] ?? null)) {
+                $entries = $data['entries'];
+            }
+        }
+
+        return new self($path, $entries);
+    }
+
+    public function path(): string
+    {
+        return $this->path;
+    }
+
+    /**
+     * @return array{binPath: string, systemId: string, timestamp: int, checksum: int, size: int}|null
+     */
+    public function get(string $scriptPath): ?array
+    {
+        return $this->entries[$scriptPath] ?? null;
+    }
+
+    /**
+     * @return array<string, array{binPath: string, systemId: string, timestamp: int, checksum: int, size: int}>
+     */
+    public function entries(): array
+    {
+        return $this->entries;
+    }
+
+    /**
+     * Records a binary from its header and on-disk size
+     */
+    public function record(string $scriptPath, string $binPath, CacheMetaInfo $metaInfo, int $size): void
+    {
+        $this->entries[$scriptPath] = [
+            'binPath'   => $binPath,
+            'systemId'  => $metaInfo->systemId()->toHex(),
+            'timestamp' => $metaInfo->timestamp(),
+            'checksum'  => $metaInfo->checksum(),
+            'size'      => $size,
+        ];
+    }
+
+    public function forget(string $scriptPath): void
+    {
+        unset($this->entries[$scriptPath]);
+    }
+
+    /**
+     * Writes the manifest atomically (unique sibling, then rename), like BinaryCacheFile::save()
+     */
+    public function save(): void
+    {
+        ksort($this->entries);
+        $json      = json_encode(['version' => self::VERSION, 'entries' => $this->entries], JSON_PRETTY_PRINT | JSON_UNESCAPED_SLASHES | JSON_THROW_ON_ERROR);
+        $temporary = $this->path . '.' . bin2hex(random_bytes(6)) . '.tmp';
+        if (file_put_contents($temporary, $json, LOCK_EX) === false) {
+            throw OpCacheException::writeFailed($temporary);
+        }
+        if (!rename($temporary, $this->path)) {
+            @unlink($temporary);
+            throw OpCacheException::writeFailed($this->path);
+        }
+    }
+}
@@ -0,0 +1,395 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\OpCache;
+
+/**
+ * Fills a file-cache directory for a whole application with a pool of long-lived compile workers
+ *
+ * BinaryCacheFile::compile() boots one child PHP per script, which dominates the cost of
+ * warming thousands of files. The warmer keeps N children alive instead, each reading script
+ * paths from its stdin and compiling them with opcache_compile_file() one after another, so
+ * the start-up cost is paid once per worker. A worker is recycled after a fixed number of
+ * scripts, because every compiled script stays in its request memory.
+ *
+ * Runs are incremental: a script is skipped when its binary is current - same build, and a
+ * header timestamp equal to the source mtime, which is what opcache.validate_timestamps=1
+ * checks on load. The FileCacheManifest written next to the binaries lets a re-run decide
+ * that from two stat() calls; scripts the manifest does not know yet (a first or interrupted
+ * run) are decided by their binary header. The manifest is checkpointed while the pool runs,
+ * so an interrupted warm-up resumes where it stopped.
+ *
+ * A stale binary is deleted before its script is queued: opcache creates binaries with
+ * O_EXCL and silently keeps an existing file rather than replacing it.
+ */
+final class FileCacheWarmer
+{
+    /**
+     * Completed scripts between two manifest checkpoints
+     */
+    private const int CHECKPOINT_INTERVAL = 256;
+
+    /**
+     * Worker loop: a handshake line, then one status line per path read from stdin -
+     * "1" when compiled, "0<reason>" otherwise. Errors are never displayed, they would
+     * interleave with the status lines on stdout.
+     */
+    private const string WORKER_CODE = <<<'PHP'
+        if (!function_exists('opcache_compile_file')) {
+            exit(2);
+        }
+        fwrite(STDOUT, "ready\n");
+        while (($script = fgets(STDIN)) !== false) {
+            error_clear_last();
+            try {
+                $status = opcache_compile_file(rtrim($script, "\n")) ? '1' : '0' . (error_get_last()['message'] ?? '');
+            } catch (\Throwable $error) {
+                $status = '0' . $error->getMessage();
+            }
+            fwrite(STDOUT, strtr($status, "\r\n", '  ') . "\n");
+        }
+        PHP;
+
+    /**
+     * @param string       $fileCacheDir         The opcache.file_cache directory to fill
+     * @param int          $workers              Number of compile workers running in parallel
+     * @param int          $scriptsPerWorker     Scripts a worker compiles before it is replaced
+     * @param list<string> $extraDirectives      Additional `-d name=value` ini directives for the workers
+     * @param int|null     $directoryPermissions Mask used if the cache directory has to be created;
+     *                                           null requires the directory to already exist
+     */
+    public function __construct(
+        private readonly string $fileCacheDir,
+        private readonly int $workers = 4,
+        private readonly int $scriptsPerWorker = 500,
+        private readonly ?string $phpBinary = null,
+        private readonly array $extraDirectives = [],
+        private readonly ?int $directoryPermissions = 0o755,
+    ) {
+        if ($workers < 1 || $scriptsPerWorker < 1) {
+            throw new \InvalidArgumentException('The warmer needs at least one worker compiling at least one script');
+        }
+    }
+
+    /**
+     * Warms every script below a directory
+     *
+     * @param list<string> $extensions File extensions (without the dot) to compile
+     */
+    public function warmDirectory(string $directory, array $extensions = ['php']): FileCacheWarmupReport
+    {
+        if (!is_dir($directory)) {
+            throw OpCacheException::scriptNotFound($directory);
+        }
+        $iterator = new \RecursiveIteratorIterator(
+            new \RecursiveDirectoryIterator($directory, \FilesystemIterator::SKIP_DOTS),
+        );
+        $scripts = [];
+        foreach ($iterator as $item) {
+            assert($item instanceof \SplFileInfo);
+            if ($item->isFile() && in_array($item->getExtension(), $extensions, true)) {
+                $scripts[] = $item->getPathname();
+            }
+        }
+        sort($scripts);
+
+        return $this->warm($scripts);
+    }
+
+    /**
+     * Warms the scripts of a class map
+     *
+     * @param array<string, string>|string $classMap Class name => path, or the path of a
+     *                                               file returning one (Composer's
+     *                                               vendor/composer/autoload_classmap.php)
+     */
+    public function warmClassMap(array|string $classMap): FileCacheWarmupReport
+    {
+        if (is_string($classMap)) {
+            if (!is_file($classMap)) {
+                throw OpCacheException::scriptNotFound($classMap);
+            }
+            $classMap = (static fn(string $file): mixed => require $file)($classMap);
+            if (!is_array($classMap)) {
+                throw new \InvalidArgumentException('The class map file must return an array of class => path');
+            }
+        }
+
+        return $this->warm(array_values(array_unique($classMap)));
+    }
+
+    /**
+     * Brings the binaries of the given scripts up to date and rewrites the manifest
+     *
+     * Per-script failures (a parse error, a worker crash) are reported, not thrown: one broken
+     * file must not abort the warm-up of all the others.
+     *
+     * @param iterable<string> $scriptPaths
+     *
+     * @throws OpCacheException When the cache directory is missing or no worker can be started
+     */
+    public function warm(iterable $scriptPaths): FileCacheWarmupReport
+    {
+        $startedAt = hrtime(true);
+        // Opcache refuses to boot file_cache_only against a missing directory
+        BinaryCacheFile::ensureDirectory($this->fileCacheDir, $this->directoryPermissions);
+        $manifest = FileCacheManifest::load($this->fileCacheDir);
+        $systemId = SystemId::current();
+
+        /** @var array<string, string> $queue Binary paths keyed by script real path */
+        $queue    = [];
+        $upToDate = [];
+        $failed   = [];
+        $seen     = [];
+        foreach ($scriptPaths as $scriptPath) {
+            $realPath = realpath($scriptPath);
+            if ($realPath === false || !is_file($realPath)) {
+                $failed[$scriptPath] = 'script not found';
+                continue;
+            }
+            if (isset($seen[$realPath])) {
+                continue;
+            }
+            $seen[$realPath] = true;
+            if (str_contains($realPath, "\n")) {
+                // Paths travel to the workers one per line
+                $failed[$realPath] = 'script path contains a line break';
+                continue;
+            }
+            $binPath = BinaryCacheFile::locate($this->fileCacheDir, $realPath, $systemId);
+            if (self::isCurrent($manifest, $realPath, $binPath, $systemId)) {
+                $upToDate[] = $realPath;
+                continue;
+            }
+            $manifest->forget($realPath);
+            if (is_file($binPath) && !unlink($binPath)) {
+                $failed[$realPath] = "stale binary {$binPath} cannot be removed";
+                continue;
+            }
+            $queue[$realPath] = $binPath;
+        }
+        foreach (array_keys($manifest->entries()) as $knownScript) {
+            if (!is_file($knownScript)) {
+                $manifest->forget($knownScript);
+            }
+        }
+
+        $compiled = [];
+        try {
+            $this->compileAll($queue, $manifest, $compiled, $failed);
+        } finally {
+            // Whatever got compiled before a failure is recorded for the next run
+            $manifest->save();
+        }
+
+        return new FileCacheWarmupReport($compiled, $upToDate, $failed, $manifest->path(), hrtime(true) - $startedAt);
+    }
+
+    /**
+     * Runs the queue through the worker pool, refilling the pool as workers retire or die
+     *
+     * @param array<string, string> $queue    Binary paths keyed by script real path
+     * @param list<string>          $compiled
+     * @param array<string, string> $failed
+     */
+    private function compileAll(array $queue, FileCacheManifest $manifest, array &$compiled, array &$failed): void
+    {
+        $scripts         = array_keys($queue);
+        $total           = count($scripts);
+        $next            = 0;
+        $sinceCheckpoint = 0;
+
+        /** @var array<int, array{process: resource, stdin: resource, stdout: resource, script: string, done: int}> $pool */
+        $pool = [];
+        try {
+            while ($next < $total || $pool !== []) {
+                while ($next < $total && count($pool) < $this->workers) {
+                    $worker = $this->spawnWorker();
+                    self::dispatch($worker, $scripts[$next++]);
+                    $pool[] = $worker;
+                }
+
+                $readable = array_map(static fn(array $worker) => $worker['stdout'], $pool);
+                $write    = null;
+                $except   = null;
+                if (stream_select($readable, $write, $except, null) === false) {
+                    throw OpCacheException::cacheWorkerFailed('stream_select() on the worker pipes failed');
+                }
+                foreach (array_keys($readable) as $id) {
+                    $script = $pool[$id]['script'];
+                    $status = fgets($pool[$id]['stdout']);
+                    if ($status === false) {
+                        // The worker died on this script (a fatal error, a crash); the pool refills
+                        $exitCode        = self::stop($pool[$id]);
+                        $failed[$script] = "worker exited with code {$exitCode} while compiling";
+                        unset($pool[$id]);
+                        continue;
+                    }
+                    $status = rtrim($status, "\n");
+                    if ($status === '1') {
+                        $this->recordBinary($script, $queue[$script], $manifest, $compiled, $failed);
+                    } else {
+                        $failed[$script] = substr($status, 1) ?: 'opcache_compile_file() failed';
+                    }
+                    if (++$sinceCheckpoint === self::CHECKPOINT_INTERVAL) {
+                        $manifest->save();
+                        $sinceCheckpoint = 0;
+                    }
+
+                    if ($next < $total && ++$pool[$id]['done'] < $this->scriptsPerWorker) {
+                        self::dispatch($pool[$id], $scripts[$next++]);
+                    } else {
+                        self::stop($pool[$id]);
+                        unset($pool[$id]);
+                    }
+                }
+            }
+        } finally {
+            foreach ($pool as $worker) {
+                self::stop($worker);
+            }
+        }
+    }
+
+    /**
+     * Starts a worker and waits for its handshake
+     *
+     * @return array{process: resource, stdin: resource, stdout: resource, script: string, done: int}
+     */
+    private function spawnWorker(): array
+    {
+        $directives = ['display_errors=0', ...$this->extraDirectives];
+        $command    = [
+            ...BinaryCacheFile::compilerCommand($this->fileCacheDir, $this->phpBinary, $directives),
+            '-r', self::WORKER_CODE,
+        ];
+        $process = proc_open($command, [0 => ['pipe', 'r'], 1 => ['pipe', 'w']], $pipes);
+        if (!is_resource($process)) {
+            throw OpCacheException::cacheWorkerFailed('unable to spawn the worker process');
+        }
+        $worker = ['process' => $process, 'stdin' => $pipes[0], 'stdout' => $pipes[1], 'script' => '', 'done' => 0];
+        if (fgets($worker['stdout']) !== "ready\n") {
+            $exitCode = self::stop($worker);
+            throw OpCacheException::cacheWorkerFailed(
+                $exitCode === 2 ? 'opcache is not available in the worker' : "worker exited with code {$exitCode} on start-up",
+            );
+        }
+
+        return $worker;
+    }
+
+    /**
+     * @param array{process: resource, stdin: resource, stdout: resource, script: string, done: int} $worker
+     */
+    private static function dispatch(array &$worker, string $script): void
+    {
+        $worker['script'] = $script;
+        fwrite($worker['stdin'], $script . "\n");
+    }
+
+    /**
+     * Closes the worker's stdin (its loop ends) and returns its exit code
+     *
+     * @param array{process: resource, stdin: resource, stdout: resource, script: string, done: int} $worker
+     */
+    private static function stop(array $worker): int
+    {
+        if (is_resource($worker['stdin'])) {
+            fclose($worker['stdin']);
+        }
+        if (is_resource($worker['stdout'])) {
+            fclose($worker['stdout']);
+        }
+
+        return proc_close($worker['process']);
+    }
+
+    /**
+     * @param list<string>          $compiled
+     * @param array<string, string> $failed
+     */
+    private function recordBinary(
+        string $script,
+        string $binPath,
+        FileCacheManifest $manifest,
+        array &$compiled,
+        array &$failed,
+    ): void {
+        clearstatcache(true, $binPath);
+        if (!is_file($binPath)) {
+            // opcache.file_update_protection (2 seconds by default) compiles a script modified
+            // that recently without caching it
+            $failed[$script] = 'compiled, but opcache wrote no binary (modified too recently?)';
+
+            return;
+        }
+        try {
+            $manifest->record($script, $binPath, self::readHeader($binPath), (int) filesize($binPath));
+            $compiled[] = $script;
+        } catch (OpCacheException $error) {
+            $failed[$script] = $error->getMessage();
+        }
+    }
+
+    /**
+     * Checks if the script's binary exists, belongs to this build and matches the source mtime
+     */
+    private static function isCurrent(FileCacheManifest $manifest, string $scriptPath, string $binPath, SystemId $systemId): bool
+    {
+        if (!is_file($binPath)) {
+            return false;
+        }
+        $timestamp = filemtime($scriptPath);
+        $binSize   = filesize($binPath);
+        $entry     = $manifest->get($scriptPath);
+        if ($entry !== null
+            && $entry['binPath'] === $binPath
+            && $entry['systemId'] === $systemId->toHex()
+            && $entry['timestamp'] === $timestamp
+            && $entry['size'] === $binSize
+        ) {
+            return true;
+        }
+
+        // Unknown to the manifest, or it disagrees: the binary header decides
+        try {
+            $metaInfo = self::readHeader($binPath);
+        } catch (OpCacheException) {
+            return false;
+        }
+        if (!$metaInfo->systemId()->equals($systemId) || $metaInfo->timestamp() !== $timestamp) {
+            return false;
+        }
+        $manifest->record($scriptPath, $binPath, $metaInfo, (int) $binSize);
+
+        return true;
+    }
+
+    /**
+     * Reads only the header of a binary, not the whole payload
+     */
+    private static function readHeader(string $binPath): CacheMetaInfo
+    {
+        $handle = fopen($binPath, 'rb');
+        if ($handle === false) {
+            throw OpCacheException::readFailed($binPath);
+        }
+        try {
+            $bytes = fread($handle, CacheMetaInfo::byteSize());
+        } finally {
+            fclose($handle);
+        }
+
+        return CacheMetaInfo::parse($bytes === false ? '' : $bytes, $binPath);
+    }
+}
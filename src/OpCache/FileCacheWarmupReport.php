@@ -0,0 +1,48 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\OpCache;
+
+/**
+ * What one FileCacheWarmer run compiled, skipped and failed on
+ *
+ * Scripts are listed by real path, in the order they were handed to the warmer (failed
+ * scripts by the path given when it could not be resolved).
+ */
+final class FileCacheWarmupReport
+{
+    /**
+     * @param list<string>          $compiled         Scripts compiled into a fresh binary
+     * @param list<string>          $upToDate         Scripts whose binary was already current
+     * @param array<string, string> $failed           Failure reason per script
+     * @param string                $manifestPath     Where the manifest was written
+     * @param int                   $totalNanoseconds Whole warm-up, hrtime() nanoseconds
+     *
+     * @internal built by FileCacheWarmer::warm()
+     */
+    public function __construct(
+        public readonly array $compiled,
+        public readonly array $upToDate,
+        public readonly array $failed,
+        public readonly string $manifestPath,
+        public readonly int $totalNanoseconds,
+    ) {}
+
+    /**
+     * Checks if every script has a current binary now
+     */
+    public function isComplete(): bool
+    {
+        return $this->failed === [];
+    }
+}
@@ -104,6 +104,22 @@ class OpCacheException extends \RuntimeException
         );
     }
 
+    /**
+     * A FileCacheWarmer worker could not be started or stopped talking before its handshake
+     */
+    public static function cacheWorkerFailed(string $reason): self
+    {
+        return new self("File-cache warm-up worker failed: {$reason}");
+    }
+
+    /**
+     * A mapped binary was used after BinaryCacheFile::unmap()
+     */
+    public static function binaryUnmapped(string $path): self
+    {
+        return new self("Opcache binary {$path} was unmapped; map or read it again");
+    }
+
     /**
      * The script a cache-binary path was requested for does not exist
      */
@@ -166,6 +182,14 @@ class OpCacheException extends \RuntimeException
         return new self("Cannot graft {$kind} '{$name}': the donor cache image does not contain it");
     }
 
+    /**
+     * The cache image does not contain the requested function/class
+     */
+    public static function entryNotFound(string $kind, string $name): self
+    {
+        return new self("The cache image does not contain the {$kind} '{$name}'");
+    }
+
     /**
      * The graft target hashtable already holds an entry under this key
      */
@@ -115,6 +115,17 @@ final class PayloadRelocator
     /** @var array<int, true> opcodes address => already-serialized guard for shared method bodies */
     private array $sharedOpcodes = [];
 
+    /**
+     * Lazy relocation state: entries of the script tables whose bodies are still stored in
+     * file form, keyed by the address of their zend_class_entry / zend_function
+     *
+     * @var array<int, true>
+     */
+    private array $deferredClasses = [];
+
+    /** @var array<int, true> */
+    private array $deferredFunctions = [];
+
     private readonly int $zendStringHeaderSize;
 
     /**
@@ -130,11 +141,17 @@ final class PayloadRelocator
     }
 
     /**
-     * @param CData         $buffer   char[mem_size + str_size] holding the raw payload
-     * @param CacheMetaInfo $metaInfo Parsed header describing the buffer regions
+     * @param CData                   $buffer   char[mem_size + str_size] holding the raw payload
+     * @param CacheMetaInfo           $metaInfo Parsed header describing the buffer regions
+     * @param CacheBinaryMapping|null $mapping  The mapped binary $buffer is a view of: a view
+     *                                          does not keep its memory alive, the relocator
+     *                                          pins the mapping instead
      */
-    public function __construct(private readonly object $buffer, private readonly CacheMetaInfo $metaInfo)
-    {
+    public function __construct(
+        private readonly object $buffer,
+        private readonly CacheMetaInfo $metaInfo,
+        public readonly ?CacheBinaryMapping $mapping = null,
+    ) {
         if (PHP_INT_SIZE !== 8 || \DIRECTORY_SEPARATOR !== '/') {
             throw OpCacheException::unsupportedPayload('the relocator supports 64-bit non-Windows builds only');
         }
@@ -153,11 +170,19 @@ final class PayloadRelocator
      * Rewrites the buffer in place, converting every stored offset to a real
      * address, and returns a typed pointer to the embedded zend_persistent_script.
      *
+     * A lazy relocation converts only the script header, the main op_array and
+     * the function/class tables themselves (bucket keys, entry pointers and
+     * class names); each entry body stays in file form until
+     * relocateFunction()/relocateClass() is called for it. Bounds validation of
+     * a deferred body happens at that point, not here.
+     *
      * @return zend_persistent_script
      */
-    public function relocate(): object
+    public function relocate(bool $lazy = false): object
     {
-        $this->sharedOpcodes = [];
+        $this->sharedOpcodes     = [];
+        $this->deferredClasses   = [];
+        $this->deferredFunctions = [];
         // The script struct itself must fit inside the mem region before we
         // dereference a single field of it (issue #123)
         $this->requireSpan(
@@ -168,8 +193,13 @@ final class PayloadRelocator
         $script = Core::pointerAtAddress(zend_persistent_script::class, $this->base + $this->metaInfo->scriptOffset());
 
         $this->unStr($script->script, 'filename');
-        $this->unserializeHash($script->script->class_table, $this->unserializeClass(...));
-        $this->unserializeHash($script->script->function_table, $this->unserializeFunc(...));
+        if ($lazy) {
+            $this->unserializeHash($script->script->class_table, $this->deferClass(...));
+            $this->unserializeHash($script->script->function_table, $this->deferFunc(...));
+        } else {
+            $this->unserializeHash($script->script->class_table, $this->unserializeClass(...));
+            $this->unserializeHash($script->script->function_table, $this->unserializeFunc(...));
+        }
         $this->unserializeOpArray($script->script->main_op_array);
         $this->unserializeWarnings($script);
         $this->unserializeEarlyBindings($script);
@@ -187,12 +217,72 @@ final class PayloadRelocator
      */
     public function derelocate(): string
     {
+        // The string section is rebuilt from scratch, so a body still in file
+        // form would keep tagged offsets into the old one: finish it first. The
+        // image comes back fully relocated, and views handed out stay valid.
+        $this->relocateDeferred();
         $bytes = $this->serialize();
         $this->relocate();
 
         return $bytes;
     }
 
+    /**
+     * Checks whether a lazy relocation still has entries in file form
+     */
+    public function hasDeferredEntries(): bool
+    {
+        return $this->deferredClasses !== [] || $this->deferredFunctions !== [];
+    }
+
+    /**
+     * Relocates the body of one function of the script function table (no-op when done)
+     *
+     * @param int $functionAddress Address of the zend_function, as stored in its bucket
+     */
+    public function relocateFunction(int $functionAddress): void
+    {
+        if (!isset($this->deferredFunctions[$functionAddress])) {
+            return;
+        }
+        unset($this->deferredFunctions[$functionAddress]);
+        $func = Core::pointerAtAddress(zend_function::class, $functionAddress);
+        $this->unserializeOpArray($func->op_array);
+    }
+
+    /**
+     * Relocates one class of the script class table, with its parent chain (no-op when done)
+     *
+     * @param int $classAddress Address of the zend_class_entry, as stored in its bucket
+     */
+    public function relocateClass(int $classAddress): void
+    {
+        if (!isset($this->deferredClasses[$classAddress])) {
+            return;
+        }
+        unset($this->deferredClasses[$classAddress]);
+        $ce = Core::pointerAtAddress(zend_class_entry::class, $classAddress);
+        $this->unserializeClassBody($ce);
+        // A linked class points at its parent entry, which wrappers walk (inherited
+        // members, prototypes of overridden methods)
+        if (($ce->ce_flags & self::ZEND_ACC_LINKED) !== 0) {
+            $this->relocateClass($this->ptrValue($ce, 'parent'));
+        }
+    }
+
+    /**
+     * Relocates every entry a lazy relocation deferred
+     */
+    public function relocateDeferred(): void
+    {
+        foreach (array_keys($this->deferredClasses) as $classAddress) {
+            $this->relocateClass($classAddress);
+        }
+        foreach (array_keys($this->deferredFunctions) as $functionAddress) {
+            $this->relocateFunction($functionAddress);
+        }
+    }
+
     /**
      * Walks the (real-pointer) image in place, converting every pointer back to
      * an offset and re-emitting interned strings; returns mem region + strings.
@@ -802,6 +892,15 @@ final class PayloadRelocator
 
     // --- op_array (the executable body) ------------------------------------
 
+    /**
+     * Lazy table pass: relocates the bucket's function pointer, defers the body
+     */
+    private function deferFunc(object $zval): void
+    {
+        /** @var zval $zval Narrowed to the stub view at the boundary; the runtime value is FFI\CData */
+        $this->deferredFunctions[$this->unPtr($zval->value, 'func')] = true;
+    }
+
     private function unserializeFunc(object $zval): void
     {
         /** @var zval $zval Narrowed to the stub view at the boundary; the runtime value is FFI\CData */
@@ -1061,6 +1160,27 @@ final class PayloadRelocator
         /** @var zval $zval Narrowed to the stub view at the boundary; the runtime value is FFI\CData */
         $ce = Core::pointerAtAddress(zend_class_entry::class, $this->unPtr($zval->value, 'ce'));
         $this->unStr($ce, 'name');
+        $this->unserializeClassBody($ce);
+    }
+
+    /**
+     * Lazy table pass: relocates the bucket's class pointer and the class name (class
+     * lookups by name scan every entry), defers the rest of the class
+     */
+    private function deferClass(object $zval): void
+    {
+        /** @var zval $zval Narrowed to the stub view at the boundary; the runtime value is FFI\CData */
+        $classAddress = $this->unPtr($zval->value, 'ce');
+        $this->unStr(Core::pointerAtAddress(zend_class_entry::class, $classAddress), 'name');
+        $this->deferredClasses[$classAddress] = true;
+    }
+
+    /**
+     * Everything of a class entry but its name
+     */
+    private function unserializeClassBody(object $ce): void
+    {
+        /** @var zend_class_entry $ce Narrowed to the stub view at the boundary; the runtime value is FFI\CData */
         if ($this->ptrValue($ce, 'parent') !== 0) {
             if (($ce->ce_flags & self::ZEND_ACC_LINKED) === 0) {
                 $this->unStr($ce, 'parent_name');
@@ -18,6 +18,7 @@ use ZEngine\Core;
 use ZEngine\Generated\Bucket;
 use ZEngine\Generated\HashTable as HashTableStruct;
 use ZEngine\Generated\zend_class_entry;
+use ZEngine\Generated\zend_function;
 use ZEngine\Generated\zend_op_array;
 use ZEngine\Generated\zend_persistent_script;
 use ZEngine\Generated\zend_string;
@@ -49,17 +50,17 @@ final class ReflectionOpcacheFile
 
     /**
      * @param \FFI\CData|zend_persistent_script $script     Relocated zend_persistent_script inside the image buffer
-     * @param object|null                       $imageOwner Owner of the relocated buffer (the PayloadRelocator):
-     *                                                      retained so that holding this view alone provably keeps
-     *                                                      the buffer - which every wrapper this view hands out
-     *                                                      points into - alive (see CacheImageSync, whose swapped-in
-     *                                                      bodies keep executing out of that buffer)
+     * @param PayloadRelocator|null             $imageOwner Owner of the relocated buffer: retained so that holding
+     *                                                      this view alone provably keeps the buffer - which every
+     *                                                      wrapper this view hands out points into - alive (see
+     *                                                      CacheImageSync, whose swapped-in bodies keep executing
+     *                                                      out of that buffer). It also relocates the entries a
+     *                                                      lazy relocation deferred, on first access.
      */
     public function __construct(
         /** @var zend_persistent_script Typed view of the relocated persistent script this handle wraps */
         private readonly object $script,
-        // @phpstan-ignore property.onlyWritten (lifetime pin: held, never read)
-        private readonly ?object $imageOwner = null,
+        private readonly ?PayloadRelocator $imageOwner = null,
     ) {}
 
     /**
@@ -73,6 +74,16 @@ final class ReflectionOpcacheFile
         return $this->script;
     }
 
+    /**
+     * Keeps the lock of a mapped image for good (no-op for read() images)
+     *
+     * @internal called by CacheImageSync once bodies of this image run in the live process
+     */
+    public function pinMapping(): void
+    {
+        $this->imageOwner?->mapping?->pin();
+    }
+
     /** Whether a mutation grew the graph beyond the original buffer */
     public function isGraphGrown(): bool
     {
@@ -114,20 +125,62 @@ final class ReflectionOpcacheFile
 
     /**
      * Borrowed view over the compiled function table
+     *
+     * Every entry is reachable through the raw table, so a lazily relocated image
+     * relocates all of its deferred entries first.
      */
     public function functionTable(): HashTable
     {
+        $this->imageOwner?->relocateDeferred();
+
         return HashTable::fromCData(Core::addr($this->script->script->function_table));
     }
 
     /**
-     * Borrowed view over the compiled class table
+     * Borrowed view over the compiled class table (relocates deferred entries first, like functionTable())
      */
     public function classTable(): HashTable
     {
+        $this->imageOwner?->relocateDeferred();
+
         return HashTable::fromCData(Core::addr($this->script->script->class_table));
     }
 
+    /**
+     * One user function compiled into the script, by name (any case)
+     *
+     * Relocates only this function's body when the image was relocated lazily.
+     *
+     * @throws OpCacheException When the script does not declare the function
+     */
+    public function getFunction(string $functionName): ReflectionFunction
+    {
+        $entry = self::findKeyedEntry($this->script->script->function_table, strtolower($functionName));
+        if ($entry === null) {
+            throw OpCacheException::entryNotFound('function', $functionName);
+        }
+        $this->imageOwner?->relocateFunction($entry[1]);
+
+        return ReflectionFunction::fromCData(Core::pointerAtAddress(zend_function::class, $entry[1]));
+    }
+
+    /**
+     * One class compiled into the script, by name (any case)
+     *
+     * Relocates only this class and its parent chain when the image was relocated lazily.
+     *
+     * @throws OpCacheException When the script does not declare the class
+     */
+    public function getClass(string $className): ReflectionClass
+    {
+        $classEntry = $this->findClassByName($className);
+        if ($classEntry === null) {
+            throw OpCacheException::entryNotFound('class', $className);
+        }
+
+        return ReflectionClass::fromCData($classEntry);
+    }
+
     /**
      * Grafts a function from another cache image into this script (issue #117).
      *
@@ -145,6 +198,8 @@ final class ReflectionOpcacheFile
             throw OpCacheException::graftEntryNotFound('function', $functionName);
         }
         [$keyAddress, $functionAddress] = $entry;
+        // The graph serializer walks the grafted unit as a relocated structure
+        $donor->imageOwner?->relocateFunction($functionAddress);
         $this->insertPtrEntry($this->script->script->function_table, $keyAddress, $functionAddress);
         $this->donors[]   = $donor;
         $this->graphGrown = true;
@@ -173,20 +228,81 @@ final class ReflectionOpcacheFile
         }
         [$keyAddress, $methodAddress] = $entry;
 
-        // Re-point the method's scope at the adopting class
-        $method = Core::pointerAtAddress(zend_op_array::class, $methodAddress);
-        // A grafted method op_array always carries its donor-class scope slot
-        \assert($method->scope !== null);
-        // FFI::addr must stay inline on the pointer-field access to yield the
-        // scope SLOT address (a by-value hop would address a pointer copy).
-        // @phpstan-ignore argument.type (FFI::addr of a zend_class_entry* pointer field)
-        Core::cast('uintptr_t *', FFI::addr($method->scope))[0] = Core::addressOf($targetClass);
-
+        self::repointScope($methodAddress, $targetClass);
         $this->insertPtrEntry($targetClass->function_table, $keyAddress, $methodAddress);
         $this->donors[]   = $donor;
         $this->graphGrown = true;
     }
 
+    /**
+     * Replaces a method of this script with a donor method that wraps it.
+     *
+     * The donor class declares the wrapper under the method's own name, plus a
+     * placeholder method named $aliasName. The original body stays in the image,
+     * renamed to the placeholder's name, made private and keyed under it, so the
+     * wrapper reaches it as self::<alias>(); every method table of this script
+     * that held the original (the target class, and subclasses linked at compile
+     * time) holds the wrapper instead. The wrapper adopts the original's
+     * attributes, doc comment, file name and line span, so reflection of the
+     * woven method still describes the source method.
+     *
+     * Used by the weaving pipeline (ZEngine\Weaving\Weaver).
+     */
+    public function wrapMethodFrom(
+        self $donor,
+        string $donorClassName,
+        string $methodName,
+        string $targetClassName,
+        string $aliasName,
+    ): void {
+        $donorClass = $donor->findClassByName($donorClassName);
+        if ($donorClass === null) {
+            throw OpCacheException::graftEntryNotFound('class', $donorClassName);
+        }
+        $targetClass = $this->findClassByName($targetClassName);
+        if ($targetClass === null) {
+            throw OpCacheException::entryNotFound('class', $targetClassName);
+        }
+        $wrapperEntry = self::findKeyedEntry($donorClass->function_table, strtolower($methodName));
+        if ($wrapperEntry === null) {
+            throw OpCacheException::graftEntryNotFound('method', "{$donorClassName}::{$methodName}");
+        }
+        $aliasEntry = self::findKeyedEntry($donorClass->function_table, strtolower($aliasName));
+        if ($aliasEntry === null) {
+            throw OpCacheException::graftEntryNotFound('method', "{$donorClassName}::{$aliasName}");
+        }
+        $originalEntry = self::findKeyedEntry($targetClass->function_table, strtolower($methodName));
+        if ($originalEntry === null) {
+            throw OpCacheException::entryNotFound('method', "{$targetClassName}::{$methodName}");
+        }
+        [, $wrapperAddress]  = $wrapperEntry;
+        [$aliasKeyAddress, ] = $aliasEntry;
+        [, $originalAddress] = $originalEntry;
+        // Subclass method tables are scanned below
+        $this->imageOwner?->relocateDeferred();
+
+        $wrapper  = Core::pointerAtAddress(zend_op_array::class, $wrapperAddress);
+        $original = Core::pointerAtAddress(zend_op_array::class, $originalAddress);
+        self::repointScope($wrapperAddress, $targetClass);
+        $wrapper->attributes  = $original->attributes;
+        $wrapper->doc_comment = $original->doc_comment;
+        $wrapper->filename    = $original->filename;
+        $wrapper->line_start  = $original->line_start;
+        $wrapper->line_end    = $original->line_end;
+        // file-cache loading derives the run-time cache slots from the flag, so it has to follow the adopting class
+        $wrapper->fn_flags = ($wrapper->fn_flags & ~Core::ZEND_ACC_IMMUTABLE) | ($original->fn_flags & Core::ZEND_ACC_IMMUTABLE);
+
+        $original->function_name = Core::pointerAtAddress(zend_string::class, $aliasKeyAddress);
+        $original->fn_flags      = ($original->fn_flags & ~(Core::ZEND_ACC_PPP_MASK | Core::ZEND_ACC_FINAL)) | Core::ZEND_ACC_PRIVATE;
+
+        foreach ($this->classEntries() as $classEntry) {
+            self::replacePtrValue($classEntry->function_table, $originalAddress, $wrapperAddress);
+        }
+        $this->insertPtrEntry($targetClass->function_table, $aliasKeyAddress, $originalAddress);
+        $this->donors[]   = $donor;
+        $this->graphGrown = true;
+    }
+
     /**
      * Every user function compiled into the script, keyed by lowercase name
      * (parity with ReflectionExtension::getFunctions())
@@ -235,7 +351,32 @@ final class ReflectionOpcacheFile
      */
     private function findClassByName(string $className): ?object
     {
-        $ht         = $this->script->script->class_table;
+        foreach ($this->classEntries() as $classEntry) {
+            // Every compiled class entry carries its own name block
+            \assert($classEntry->name !== null);
+            $name = StringEntry::fromCData($classEntry->name)->getStringValue();
+            if (strcasecmp($name, $className) === 0) {
+                // Class names are relocated by the lazy table pass, the rest on this first access
+                $this->imageOwner?->relocateClass(Core::addressOf($classEntry));
+
+                return $classEntry;
+            }
+        }
+
+        return null;
+    }
+
+    /**
+     * Walks the class entries of the script's class table, rtd-keyed ones included
+     *
+     * @return iterable<zend_class_entry>
+     */
+    private function classEntries(): iterable
+    {
+        $ht = $this->script->script->class_table;
+        if ($ht->nNumUsed === 0) {
+            return;
+        }
         $bucketSize = Core::sizeOfType(Bucket::class);
         // A populated class table always carries a bucket data block
         \assert($ht->arData !== null);
@@ -245,20 +386,58 @@ final class ReflectionOpcacheFile
             if ($bucket->val->u1->v->type === 0) {
                 continue;
             }
-            $classEntry = Core::pointerAtAddress(
+            yield Core::pointerAtAddress(
                 zend_class_entry::class,
                 // IS_PTR bucket: the stored class-entry pointer lives in the value union's long slot
                 $bucket->val->value->lval,
             );
-            // Every compiled class entry carries its own name block
-            \assert($classEntry->name !== null);
-            $name = StringEntry::fromCData($classEntry->name)->getStringValue();
-            if (strcasecmp($name, $className) === 0) {
-                return $classEntry;
+        }
+    }
+
+    /**
+     * Re-points a method's scope at the class that adopts it
+     *
+     * @param zend_class_entry $classEntry
+     */
+    private static function repointScope(int $methodAddress, object $classEntry): void
+    {
+        $method = Core::pointerAtAddress(zend_op_array::class, $methodAddress);
+        // A grafted method op_array always carries its donor-class scope slot
+        \assert($method->scope !== null);
+        // FFI::addr must stay inline on the pointer-field access to yield the
+        // scope SLOT address (a by-value hop would address a pointer copy).
+        // @phpstan-ignore argument.type (FFI::addr of a zend_class_entry* pointer field)
+        Core::cast('uintptr_t *', FFI::addr($method->scope))[0] = Core::addressOf($classEntry);
+    }
+
+    /**
+     * Swaps the pointer stored in every IS_PTR bucket of a keyed image table that holds $oldAddress
+     *
+     * Keys, hashes and chains stay as they are, so the persisted table is rewritten in place.
+     *
+     * @param HashTableStruct $ht HashTable view
+     * @return int Number of buckets rewritten
+     */
+    private static function replacePtrValue(object $ht, int $oldAddress, int $newAddress): int
+    {
+        if (($ht->u->flags & Core::engineConstant('HASH_FLAG_UNINITIALIZED')) !== 0) {
+            return 0;
+        }
+        $bucketSize = Core::sizeOfType(Bucket::class);
+        // An initialized table always carries a bucket data block
+        \assert($ht->arData !== null);
+        $dataAddress = Core::addressOf($ht->arData);
+        $replaced    = 0;
+        for ($i = 0; $i < $ht->nNumUsed; $i++) {
+            $bucket = Core::pointerAtAddress(Bucket::class, $dataAddress + $i * $bucketSize);
+            if ($bucket->val->u1->v->type === 0 || $bucket->val->value->lval !== $oldAddress) {
+                continue;
             }
+            Core::cast('uintptr_t *', Core::addr($bucket->val->value))[0] = $newAddress;
+            $replaced++;
         }
 
-        return null;
+        return $replaced;
     }
 
     /**
@@ -82,6 +82,18 @@ class SharedMemoryException extends \ReflectionException
         return new self("Cannot copy out function {$lowerKey}: it is not published in the given table");
     }
 
+    /**
+     * Opline rewriting targeted a function whose opcodes live in shared memory: copying the
+     * entry out does not help, its copy keeps executing the very same shared opcodes
+     */
+    public static function immutableOpcodesMutation(string $functionName): self
+    {
+        return new self(
+            "Cannot rewrite the oplines of {$functionName}(): its opcodes live in opcache shared memory "
+            . 'and are executed by every worker process',
+        );
+    }
+
     /**
      * Handler installation targeted a temporary lazy-linking class copy while declining
      * the inheritance cache is unavailable (issues #238/#241)
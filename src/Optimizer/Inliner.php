@@ -0,0 +1,1240 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Optimizer;
+
+use ZEngine\Analysis\ControlFlowGraph;
+use ZEngine\Analysis\Liveness;
+use ZEngine\Core;
+use ZEngine\Generated\zend_op;
+use ZEngine\Generated\zval;
+use ZEngine\Reflection\FunctionBodySwap;
+use ZEngine\Reflection\FunctionLikeInterface;
+use ZEngine\Reflection\OpArrayRewriteException;
+use ZEngine\Reflection\OpArrayRewriter;
+use ZEngine\Reflection\ReflectionClass;
+use ZEngine\Reflection\ReflectionFunction;
+use ZEngine\Reflection\ReflectionMethod;
+use ZEngine\Reflection\ReflectionValue;
+use ZEngine\System\OpCode;
+use ZEngine\Type\ArgumentEntry;
+use ZEngine\Type\OpLine;
+use ZEngine\Type\StringEntry;
+
+/**
+ * Splices the bodies of small leaf functions into the op_arrays that call them
+ *
+ * A call to a tiny helper costs an INIT/SEND/DO sequence, a frame push, RECV oplines and a
+ * RETURN; inside a tight loop that is most of the work. For every call site of a caller whose
+ * target resolves at optimization time (a function called by name, a static method called as
+ * `Name::m()` or `self::m()`), the inliner replaces the call with the callee's own oplines:
+ *
+ *  - the arguments are assigned straight into fresh CVs of the caller, one set per call site;
+ *  - the callee's CVs, temporaries and literals are renumbered into the caller's body;
+ *  - every RETURN stores into the call's result and jumps past the inlined code, where the
+ *    callee's CVs are unset - values are released when a real call would have released them.
+ *
+ *     $report = (new Inliner())->inline(new ReflectionFunction('renderRows'));
+ *
+ * Only leaf callees qualify: no calls of their own, no scope-, cache- or frame-dependent
+ * opcodes (property and constant fetches, `$this`, `static`, func_get_args()), no statics,
+ * try/catch, closures, by-reference or variadic parameters, and at most maxCalleeOplines
+ * oplines. Scalar and array parameter and return types are kept exact: the inlined code checks
+ * them with TYPE_CHECK and, when a check fails, performs the real call instead - which coerces
+ * or throws exactly as before. A failed return check thus runs the body a second time: a
+ * callee with a checked return type is inlined only when that run cannot be observed - no
+ * user code, no diagnostics, no undefined locals (see findReplayEffect()).
+ *
+ * Inlining grows the caller's frame, and INIT_FCALL oplines hold the frame size of their callee
+ * as it was when they were compiled: every such opline reachable from the function and class
+ * tables, from the declared closures and from the current call stack is resized. A function
+ * compiled into opcache shared memory is never used as a caller, since its INIT_FCALL sites
+ * there cannot be written.
+ *
+ * Inlined callers are remembered by callee: redefine() of a callee first puts its callers back
+ * to their body from before their first inlining (later PeepholeOptimizer passes over them
+ * are dropped too), and redefine() of a caller forgets its inlined state. Exceptions thrown by
+ * inlined code have no frame of the callee in their trace, and diagnostics about undefined
+ * callee locals name the renamed CV ("x@helper#1").
+ */
+final class Inliner
+{
+    /**
+     * Oplines opening a call frame, as cleanup_unfinished_calls() pairs them
+     */
+    private const array INIT_OPCODES = [
+        OpCode::INIT_FCALL                     => true,
+        OpCode::INIT_FCALL_BY_NAME             => true,
+        OpCode::INIT_NS_FCALL_BY_NAME          => true,
+        OpCode::INIT_DYNAMIC_CALL              => true,
+        OpCode::INIT_USER_CALL                 => true,
+        OpCode::INIT_METHOD_CALL               => true,
+        OpCode::INIT_STATIC_METHOD_CALL        => true,
+        OpCode::INIT_PARENT_PROPERTY_HOOK_CALL => true,
+        OpCode::NEW                            => true,
+    ];
+
+    /**
+     * Oplines closing the innermost call frame
+     */
+    private const array DO_OPCODES = [
+        OpCode::DO_FCALL         => true,
+        OpCode::DO_ICALL         => true,
+        OpCode::DO_UCALL         => true,
+        OpCode::DO_FCALL_BY_NAME => true,
+        OpCode::CALLABLE_CONVERT => true,
+    ];
+
+    /**
+     * Positional by-value sends an inlined call turns into assignments
+     */
+    private const array SEND_OPCODES = [
+        OpCode::SEND_VAL           => true,
+        OpCode::SEND_VAL_EX        => true,
+        OpCode::SEND_VAR           => true,
+        OpCode::SEND_VAR_EX        => true,
+        OpCode::SEND_VAR_NO_REF_EX => true,
+    ];
+
+    /**
+     * Every other opline working on the call being set up (EX(call))
+     */
+    private const array CALL_OPERATIONS = [
+        OpCode::SEND_VAL                   => true,
+        OpCode::SEND_VAL_EX                => true,
+        OpCode::SEND_VAR                   => true,
+        OpCode::SEND_VAR_EX                => true,
+        OpCode::SEND_VAR_NO_REF_EX         => true,
+        OpCode::SEND_VAR_NO_REF            => true,
+        OpCode::SEND_REF                   => true,
+        OpCode::SEND_ARRAY                 => true,
+        OpCode::SEND_USER                  => true,
+        OpCode::SEND_UNPACK                => true,
+        OpCode::SEND_FUNC_ARG              => true,
+        OpCode::CHECK_FUNC_ARG             => true,
+        OpCode::CHECK_UNDEF_ARGS           => true,
+        OpCode::FETCH_FUNC_ARG             => true,
+        OpCode::FETCH_DIM_FUNC_ARG         => true,
+        OpCode::FETCH_OBJ_FUNC_ARG         => true,
+        OpCode::FETCH_STATIC_PROP_FUNC_ARG => true,
+    ];
+
+    /**
+     * Callee opcodes that behave the same in any frame: no scope, no run-time cache slot, no
+     * access to the executing function or its arguments
+     */
+    private const array INLINABLE = [
+        OpCode::NOP                 => true,
+        OpCode::ADD                 => true,
+        OpCode::SUB                 => true,
+        OpCode::MUL                 => true,
+        OpCode::DIV                 => true,
+        OpCode::MOD                 => true,
+        OpCode::SL                  => true,
+        OpCode::SR                  => true,
+        OpCode::CONCAT              => true,
+        OpCode::FAST_CONCAT         => true,
+        OpCode::BW_OR               => true,
+        OpCode::BW_AND              => true,
+        OpCode::BW_XOR              => true,
+        OpCode::POW                 => true,
+        OpCode::BW_NOT              => true,
+        OpCode::BOOL_NOT            => true,
+        OpCode::BOOL_XOR            => true,
+        OpCode::BOOL                => true,
+        OpCode::IS_IDENTICAL        => true,
+        OpCode::IS_NOT_IDENTICAL    => true,
+        OpCode::IS_EQUAL            => true,
+        OpCode::IS_NOT_EQUAL        => true,
+        OpCode::IS_SMALLER          => true,
+        OpCode::IS_SMALLER_OR_EQUAL => true,
+        OpCode::SPACESHIP           => true,
+        OpCode::ASSIGN              => true,
+        OpCode::ASSIGN_OP           => true,
+        OpCode::PRE_INC             => true,
+        OpCode::PRE_DEC             => true,
+        OpCode::POST_INC            => true,
+        OpCode::POST_DEC            => true,
+        OpCode::QM_ASSIGN           => true,
+        OpCode::JMP                 => true,
+        OpCode::JMPZ                => true,
+        OpCode::JMPNZ               => true,
+        OpCode::JMPZ_EX             => true,
+        OpCode::JMPNZ_EX            => true,
+        OpCode::JMP_SET             => true,
+        OpCode::COALESCE            => true,
+        OpCode::CAST                => true,
+        OpCode::TYPE_CHECK          => true,
+        OpCode::ISSET_ISEMPTY_CV    => true,
+        OpCode::FETCH_DIM_R         => true,
+        OpCode::FETCH_LIST_R        => true,
+        OpCode::INIT_ARRAY          => true,
+        OpCode::ADD_ARRAY_ELEMENT   => true,
+        OpCode::IN_ARRAY            => true,
+        OpCode::ARRAY_KEY_EXISTS    => true,
+        OpCode::COUNT               => true,
+        OpCode::STRLEN              => true,
+        OpCode::FREE                => true,
+        OpCode::VERIFY_RETURN_TYPE  => true,
+        OpCode::RETURN              => true,
+    ];
+
+    /**
+     * Inlinable opcodes writing their op1 CV
+     */
+    private const array CV_WRITERS = [
+        OpCode::ASSIGN    => true,
+        OpCode::ASSIGN_OP => true,
+        OpCode::PRE_INC   => true,
+        OpCode::PRE_DEC   => true,
+        OpCode::POST_INC  => true,
+        OpCode::POST_DEC  => true,
+    ];
+
+    /**
+     * Inlinable opcodes reading the strict_types mode of the executing function
+     */
+    private const array STRICTNESS_SENSITIVE = [
+        OpCode::STRLEN => true,
+    ];
+
+    /**
+     * Function flags that keep a callee out, with the reported reason
+     */
+    private const array REFUSED_FLAGS = [
+        Core::ZEND_ACC_GENERATOR        => 'is a generator',
+        Core::ZEND_ACC_VARIADIC         => 'is variadic',
+        Core::ZEND_ACC_RETURN_REFERENCE => 'returns by reference',
+        Core::ZEND_ACC_DEPRECATED       => 'is deprecated',
+        Core::ZEND_ACC_ABSTRACT         => 'is abstract',
+    ];
+
+    private const int VARIABLE = OpLine::IS_TMP_VAR | OpLine::IS_VAR | OpLine::IS_CV;
+
+    private const int OPERAND_TYPE = OpLine::IS_CONST | self::VARIABLE;
+
+    /**
+     * MAY_BE_NULL .. MAY_BE_RESOURCE: the types TYPE_CHECK tests, `mixed` as a whole
+     */
+    private const int MAY_BE_ANY = 0x3FE;
+
+    private const int MAY_BE_VOID = 1 << 14;
+
+    private const int MAY_BE_BOOL = (1 << ReflectionValue::IS_FALSE) | (1 << ReflectionValue::IS_TRUE);
+
+    private const int MAY_BE_LONG = 1 << ReflectionValue::IS_LONG;
+
+    private const int MAY_BE_DOUBLE = 1 << ReflectionValue::IS_DOUBLE;
+
+    private const int MAY_BE_STRING = 1 << ReflectionValue::IS_STRING;
+
+    private const int MAY_BE_ARRAY = 1 << ReflectionValue::IS_ARRAY;
+
+    private const int MAY_BE_NUMBER = self::MAY_BE_LONG | self::MAY_BE_DOUBLE;
+
+    /**
+     * null, bool, int and float: arithmetic on them never warns or calls user code
+     */
+    private const int MAY_BE_NUMERIC = (1 << ReflectionValue::IS_NULL) | self::MAY_BE_BOOL | self::MAY_BE_NUMBER;
+
+    private const int MAY_BE_SCALAR = self::MAY_BE_NUMERIC | self::MAY_BE_STRING;
+
+    private const int MAY_BE_ARRAY_KEY = self::MAY_BE_SCALAR & ~self::MAY_BE_DOUBLE;
+
+    /**
+     * Callee opcodes a checked-return callee may run twice, as [op1 types, op2 types, result]
+     *
+     * An opcode qualifies when operands of the listed MAY_BE_* types can neither call user code
+     * nor raise a diagnostic; the result is a type mask, or the operand it copies. ASSIGN_OP is
+     * judged by the binary opcode in its extended_value.
+     */
+    private const array REPLAYABLE = [
+        OpCode::NOP                 => [self::MAY_BE_ANY, self::MAY_BE_ANY, 0],
+        OpCode::ADD                 => [self::MAY_BE_NUMERIC, self::MAY_BE_NUMERIC, self::MAY_BE_NUMBER],
+        OpCode::SUB                 => [self::MAY_BE_NUMERIC, self::MAY_BE_NUMERIC, self::MAY_BE_NUMBER],
+        OpCode::MUL                 => [self::MAY_BE_NUMERIC, self::MAY_BE_NUMERIC, self::MAY_BE_NUMBER],
+        OpCode::DIV                 => [self::MAY_BE_NUMERIC, self::MAY_BE_NUMERIC, self::MAY_BE_NUMBER],
+        OpCode::POW                 => [self::MAY_BE_NUMERIC, self::MAY_BE_NUMERIC, self::MAY_BE_NUMBER],
+        OpCode::CONCAT              => [self::MAY_BE_SCALAR, self::MAY_BE_SCALAR, self::MAY_BE_STRING],
+        OpCode::FAST_CONCAT         => [self::MAY_BE_SCALAR, self::MAY_BE_SCALAR, self::MAY_BE_STRING],
+        OpCode::BOOL_NOT            => [self::MAY_BE_ANY, self::MAY_BE_ANY, self::MAY_BE_BOOL],
+        OpCode::BOOL_XOR            => [self::MAY_BE_ANY, self::MAY_BE_ANY, self::MAY_BE_BOOL],
+        OpCode::BOOL                => [self::MAY_BE_ANY, self::MAY_BE_ANY, self::MAY_BE_BOOL],
+        OpCode::IS_IDENTICAL        => [self::MAY_BE_ANY, self::MAY_BE_ANY, self::MAY_BE_BOOL],
+        OpCode::IS_NOT_IDENTICAL    => [self::MAY_BE_ANY, self::MAY_BE_ANY, self::MAY_BE_BOOL],
+        OpCode::IS_EQUAL            => [self::MAY_BE_SCALAR, self::MAY_BE_SCALAR, self::MAY_BE_BOOL],
+        OpCode::IS_NOT_EQUAL        => [self::MAY_BE_SCALAR, self::MAY_BE_SCALAR, self::MAY_BE_BOOL],
+        OpCode::IS_SMALLER          => [self::MAY_BE_SCALAR, self::MAY_BE_SCALAR, self::MAY_BE_BOOL],
+        OpCode::IS_SMALLER_OR_EQUAL => [self::MAY_BE_SCALAR, self::MAY_BE_SCALAR, self::MAY_BE_BOOL],
+        OpCode::SPACESHIP           => [self::MAY_BE_SCALAR, self::MAY_BE_SCALAR, self::MAY_BE_LONG],
+        OpCode::ASSIGN              => [self::MAY_BE_ANY, self::MAY_BE_ANY, 'op2'],
+        OpCode::PRE_INC             => [self::MAY_BE_NUMBER, self::MAY_BE_ANY, self::MAY_BE_NUMBER],
+        OpCode::PRE_DEC             => [self::MAY_BE_NUMBER, self::MAY_BE_ANY, self::MAY_BE_NUMBER],
+        OpCode::POST_INC            => [self::MAY_BE_NUMBER, self::MAY_BE_ANY, self::MAY_BE_NUMBER],
+        OpCode::POST_DEC            => [self::MAY_BE_NUMBER, self::MAY_BE_ANY, self::MAY_BE_NUMBER],
+        OpCode::QM_ASSIGN           => [self::MAY_BE_ANY, self::MAY_BE_ANY, 'op1'],
+        OpCode::JMP                 => [self::MAY_BE_ANY, self::MAY_BE_ANY, 0],
+        OpCode::JMPZ                => [self::MAY_BE_ANY, self::MAY_BE_ANY, 0],
+        OpCode::JMPNZ               => [self::MAY_BE_ANY, self::MAY_BE_ANY, 0],
+        OpCode::JMPZ_EX             => [self::MAY_BE_ANY, self::MAY_BE_ANY, self::MAY_BE_BOOL],
+        OpCode::JMPNZ_EX            => [self::MAY_BE_ANY, self::MAY_BE_ANY, self::MAY_BE_BOOL],
+        OpCode::JMP_SET             => [self::MAY_BE_ANY, self::MAY_BE_ANY, 'op1'],
+        OpCode::COALESCE            => [self::MAY_BE_ANY, self::MAY_BE_ANY, 'op1'],
+        OpCode::TYPE_CHECK          => [self::MAY_BE_ANY, self::MAY_BE_ANY, self::MAY_BE_BOOL],
+        OpCode::ISSET_ISEMPTY_CV    => [self::MAY_BE_ANY, self::MAY_BE_ANY, self::MAY_BE_BOOL],
+        OpCode::INIT_ARRAY          => [self::MAY_BE_ANY, self::MAY_BE_ARRAY_KEY, self::MAY_BE_ARRAY],
+        OpCode::ADD_ARRAY_ELEMENT   => [self::MAY_BE_ANY, self::MAY_BE_ARRAY_KEY, self::MAY_BE_ARRAY],
+        OpCode::COUNT               => [self::MAY_BE_ARRAY, self::MAY_BE_ANY, self::MAY_BE_LONG],
+        OpCode::STRLEN              => [self::MAY_BE_STRING, self::MAY_BE_ANY, self::MAY_BE_LONG],
+        OpCode::FREE                => [self::MAY_BE_ANY, self::MAY_BE_ANY, 0],
+        OpCode::VERIFY_RETURN_TYPE  => [self::MAY_BE_ANY, self::MAY_BE_ANY, 'op1'],
+        OpCode::RETURN              => [self::MAY_BE_ANY, self::MAY_BE_ANY, 0],
+    ];
+
+    /**
+     * _ZEND_TYPE_LIST_BIT | _ZEND_TYPE_LITERAL_NAME_BIT | _ZEND_TYPE_NAME_BIT: class types
+     */
+    private const int TYPE_KIND_MASK = (1 << 22) | (1 << 23) | (1 << 24);
+
+    /**
+     * ZEND_ARRAY_ELEMENT_REF flag of INIT_ARRAY/ADD_ARRAY_ELEMENT
+     */
+    private const int ARRAY_ELEMENT_REF = 1;
+
+    /**
+     * ZEND_FETCH_CLASS_SELF within the ZEND_FETCH_CLASS_MASK bits of an UNUSED class operand
+     */
+    private const int FETCH_CLASS_SELF = 1;
+
+    private const int FETCH_CLASS_MASK = 0x0F;
+
+    private const int IS_CONSTANT_AST = 11;
+
+    /**
+     * Inlined callers by callee, both keyed by lowercase name ("fn" or "class::method")
+     *
+     * @var array<string, array<string, true>>
+     */
+    private static array $callersOf = [];
+
+    /**
+     * How to find an inlined caller again, its body before the first inlining, its callees
+     *
+     * @var array<string, array{class: ?string, function: string, layout: array<string, mixed>, callees: array<string, true>}>
+     */
+    private static array $inlinedCallers = [];
+
+    /**
+     * @param int $maxCalleeOplines Largest callee body to inline, RECV oplines excluded
+     * @param int $maxSitesPerCaller Upper bound of call sites inlined into one caller per run
+     */
+    public function __construct(
+        private readonly int $maxCalleeOplines = 24,
+        private readonly int $maxSitesPerCaller = 16,
+    ) {}
+
+    /**
+     * Inlines the eligible call sites of a user function and installs the result
+     *
+     * @throws OpArrayRewriteException When the caller is internal, a generator, executing, or
+     *                                 called from opcache shared memory
+     */
+    public function inline(ReflectionFunction|ReflectionMethod $caller): InliningReport
+    {
+        $name = self::nameOf($caller);
+        if (!$caller->isUserDefined()) {
+            throw OpArrayRewriteException::internalFunction($name);
+        }
+        $common = $caller->getCommonPointer();
+        if (($common->fn_flags & Core::ZEND_ACC_GENERATOR) !== 0) {
+            throw OpArrayRewriteException::generator($name);
+        }
+        $isGlobalFunction = $common->scope === null;
+        if ($isGlobalFunction && $caller->isImmutable()) {
+            throw OpArrayRewriteException::sharedCallSites($name);
+        }
+
+        $body      = OpArrayBody::fromFunction($caller);
+        $before    = \count($body->instructions);
+        $frameSize = $body->getVariableCount() + $body->getTemporaryCount();
+        $analyses  = $inlined = $rejected = [];
+        foreach (self::findCallSites($body) as $site) {
+            if (\count($inlined) >= $this->maxSitesPerCaller) {
+                break;
+            }
+            $callee = self::resolveCallee($body, $site, $caller);
+            if ($callee === null) {
+                continue;
+            }
+            $calleeKey = strtolower(self::nameOf($callee));
+            $analysis  = $analyses[$calleeKey] ??= $this->analyze($callee);
+            $reason    = \is_string($analysis) ? $analysis : self::checkSite($body, $site, $analysis, $caller);
+            if ($reason !== null) {
+                $rejected[self::nameOf($callee)] = $reason;
+                continue;
+            }
+            $inlined[] = [$site, $analysis];
+        }
+        if ($inlined === []) {
+            return new InliningReport($before, $before, rejectedCallees: $rejected);
+        }
+
+        $lowerName       = strtolower($caller->getName());
+        $staticCallSites = $isGlobalFunction ? self::findStaticCallSites($lowerName, $name) : [];
+        $erasedCalls     = [];
+        $callees         = [];
+        foreach ($inlined as $number => [$site, $analysis]) {
+            $erasedCalls[] = $body->instructions[$site['init']];
+            self::spliceSite($body, $site, $analysis, $number + 1);
+            $callees[strtolower($analysis['name'])] = $analysis['name'];
+        }
+        if (!$body->hasJumpTables()) {
+            $body->removeInstructions(array_keys(array_filter(
+                $body->instructions,
+                static fn(Instruction $instruction): bool => \in_array($instruction, $erasedCalls, true),
+            )));
+        }
+
+        $addedSlots  = $body->getVariableCount() + $body->getTemporaryCount() - $frameSize;
+        $growthBytes = $body->offsetOf($addedSlots) - $body->offsetOf(0);
+        if ($isGlobalFunction) {
+            // Recursive calls of the new body reserve the grown frame as well
+            foreach ($body->instructions as $instruction) {
+                if ($instruction->opcode === OpCode::INIT_FCALL && $body->getLiteral($instruction->op2) === $lowerName) {
+                    $instruction->op1 += $growthBytes;
+                }
+            }
+        }
+
+        $callerKey = strtolower($name);
+        $layout    = self::$inlinedCallers[$callerKey]['layout'] ?? OpArrayBody::captureLayout($caller);
+        $body->install($caller);
+        foreach ($staticCallSites as $oplineAddress) {
+            $opline           = Core::pointerAtAddress(zend_op::class, $oplineAddress);
+            $opline->op1->num = $opline->op1->num + $growthBytes;
+        }
+
+        self::$inlinedCallers[$callerKey] ??= [
+            'class'    => $caller instanceof ReflectionMethod ? $caller->class : null,
+            'function' => $caller->getName(),
+            'layout'   => $layout,
+            'callees'  => [],
+        ];
+        foreach (array_keys($callees) as $calleeKey) {
+            self::$inlinedCallers[$callerKey]['callees'][$calleeKey] = true;
+            self::$callersOf[$calleeKey][$callerKey]                  = true;
+        }
+
+        return new InliningReport(
+            oplinesBefore: $before,
+            oplinesAfter: \count($body->instructions),
+            inlinedSites: \count($inlined),
+            inlinedCallees: array_values(array_unique($callees)),
+            rejectedCallees: $rejected,
+            addedFrameSlots: $addedSlots,
+            resizedCallSites: \count($staticCallSites),
+        );
+    }
+
+    /**
+     * Puts every caller that inlined one of the given functions back to its body from before inlining
+     *
+     * All callers are checked before any of them changes: nothing is reverted when one of them
+     * is executing on the current call stack. Callers that are among the given functions keep
+     * their state; their own body is being replaced and forgetCaller() drops it.
+     *
+     * @throws OpArrayRewriteException When an inlined caller has a live frame
+     *
+     * @internal called by redefine() and RedefinitionBatch once every swap is staged, still
+     *           inside their rollback window
+     */
+    public static function revertCallersOf(FunctionLikeInterface ...$callees): void
+    {
+        $calleeKeys = [];
+        foreach ($callees as $callee) {
+            $calleeKeys[strtolower(self::nameOf($callee))] = true;
+        }
+        $callers = [];
+        foreach (array_keys($calleeKeys) as $calleeKey) {
+            foreach (array_keys(self::$callersOf[$calleeKey] ?? []) as $callerKey) {
+                if (isset($calleeKeys[$callerKey]) || isset($callers[$callerKey])) {
+                    continue;
+                }
+                $record = self::$inlinedCallers[$callerKey];
+                $caller = $record['class'] === null
+                    ? new ReflectionFunction($record['function'])
+                    : new ReflectionMethod($record['class'], $record['function']);
+                if (FunctionBodySwap::hasLiveFrame($caller->getAddress())) {
+                    throw OpArrayRewriteException::liveFrame(self::nameOf($caller));
+                }
+                $callers[$callerKey] = $caller;
+            }
+        }
+        foreach ($callers as $callerKey => $caller) {
+            OpArrayBody::restoreLayout($caller, self::$inlinedCallers[$callerKey]['layout']);
+            self::forget($callerKey);
+        }
+    }
+
+    /**
+     * Drops the inlined state of a caller whose body was replaced by other means
+     *
+     * @internal called by redefine() after the body changed
+     */
+    public static function forgetCaller(FunctionLikeInterface $caller): void
+    {
+        self::forget(strtolower(self::nameOf($caller)));
+    }
+
+    /**
+     * Checks whether a function currently runs inlined copies of other functions
+     */
+    public static function hasInlinedCalls(FunctionLikeInterface $caller): bool
+    {
+        return isset(self::$inlinedCallers[strtolower(self::nameOf($caller))]);
+    }
+
+    private static function forget(string $callerKey): void
+    {
+        foreach (array_keys(self::$inlinedCallers[$callerKey]['callees'] ?? []) as $calleeKey) {
+            unset(self::$callersOf[$calleeKey][$callerKey]);
+            if (self::$callersOf[$calleeKey] === []) {
+                unset(self::$callersOf[$calleeKey]);
+            }
+        }
+        unset(self::$inlinedCallers[$callerKey]);
+    }
+
+    /**
+     * Pairs INIT and DO oplines the way the engine does when it unwinds unfinished calls
+     *
+     * @return list<array{init: int, do: int, sends: array<int, int>}> Call sites with plain
+     *         positional sends only, by descending DO position; sends map argument numbers
+     *         to instruction indexes
+     */
+    private static function findCallSites(OpArrayBody $body): array
+    {
+        $sites = $open = [];
+        foreach ($body->instructions as $index => $instruction) {
+            $opcode = $instruction->opcode;
+            if (isset(self::INIT_OPCODES[$opcode])) {
+                $open[] = ['init' => $index, 'sends' => [], 'plain' => true];
+                continue;
+            }
+            if ($open === []) {
+                continue;
+            }
+            $top = array_key_last($open);
+            if (isset(self::DO_OPCODES[$opcode])) {
+                $call = array_pop($open);
+                if ($call['plain'] && $opcode !== OpCode::CALLABLE_CONVERT) {
+                    $sites[] = ['init' => $call['init'], 'do' => $index, 'sends' => $call['sends']];
+                }
+            } elseif (isset(self::SEND_OPCODES[$opcode]) && $instruction->op2Type === OpLine::IS_UNUSED) {
+                $open[$top]['sends'][$instruction->op2] = $index;
+            } elseif (isset(self::CALL_OPERATIONS[$opcode])) {
+                $open[$top]['plain'] = false;
+            }
+        }
+        usort($sites, static fn(array $left, array $right): int => $right['do'] <=> $left['do']);
+
+        return $sites;
+    }
+
+    /**
+     * Returns the user function a call site calls, when the name resolves statically
+     *
+     * @param array{init: int, do: int, sends: array<int, int>} $site
+     */
+    private static function resolveCallee(
+        OpArrayBody $body,
+        array $site,
+        ReflectionFunction|ReflectionMethod $caller,
+    ): ReflectionFunction|ReflectionMethod|null {
+        $init = $body->instructions[$site['init']];
+        switch ($init->opcode) {
+            case OpCode::INIT_FCALL:
+                return self::findFunction(strtolower($body->getLiteral($init->op2)));
+
+            case OpCode::INIT_FCALL_BY_NAME:
+                return self::findFunction($body->getLiteral($init->op2 + 1));
+
+            case OpCode::INIT_NS_FCALL_BY_NAME:
+                // The namespaced name wins when it exists, the global one is the fallback
+                return self::findFunction($body->getLiteral($init->op2 + 1))
+                    ?? self::findFunction($body->getLiteral($init->op2 + 2));
+
+            case OpCode::INIT_STATIC_METHOD_CALL:
+                if ($init->op2Type !== OpLine::IS_CONST) {
+                    return null;
+                }
+                $method = $body->getLiteral($init->op2 + 1);
+                if ($init->op1Type === OpLine::IS_CONST) {
+                    return self::findMethod($body->getLiteral($init->op1 + 1), $method);
+                }
+                $scope = $caller->getCommonPointer()->scope;
+                if ($init->op1Type !== OpLine::IS_UNUSED
+                    || ($init->op1 & self::FETCH_CLASS_MASK) !== self::FETCH_CLASS_SELF
+                    || $scope === null
+                ) {
+                    return null;
+                }
+
+                return self::findMethod(strtolower(StringEntry::fromCData($scope->name)->getStringValue()), $method);
+
+            default:
+                return null;
+        }
+    }
+
+    private static function findFunction(string $lowerName): ?ReflectionFunction
+    {
+        $entry = Core::$executor->functionTable->find($lowerName);
+        if ($entry === null) {
+            return null;
+        }
+        $rawFunction = $entry->getRawFunction();
+
+        return $rawFunction->type === Core::ZEND_USER_FUNCTION ? ReflectionFunction::fromCData($rawFunction) : null;
+    }
+
+    private static function findMethod(string $lowerClass, string $lowerMethod): ?ReflectionMethod
+    {
+        $entry = Core::$executor->classTable->find($lowerClass);
+        if ($entry === null) {
+            return null;
+        }
+        try {
+            $rawClass = $entry->getRawClass();
+        } catch (\UnexpectedValueException $e) {
+            // A class alias: the aliased name is what compiled call sites resolve
+            return null;
+        }
+        $method = ReflectionClass::fromCData($rawClass)->getMethodTable()->find($lowerMethod);
+        if ($method === null) {
+            return null;
+        }
+        $rawFunction = $method->getRawFunction();
+
+        return $rawFunction->type === Core::ZEND_USER_FUNCTION ? ReflectionMethod::fromCData($rawFunction) : null;
+    }
+
+    /**
+     * Checks whether a callee can be inlined anywhere, and prepares what every site needs
+     *
+     * @return array<string, mixed>|string The analysis, or the reason the callee is refused
+     */
+    private function analyze(ReflectionFunction|ReflectionMethod $callee): array|string
+    {
+        $common = $callee->getCommonPointer();
+        $flags  = $common->fn_flags;
+        foreach (self::REFUSED_FLAGS as $flag => $reason) {
+            if (($flags & $flag) !== 0) {
+                return $reason;
+            }
+        }
+        $opArray = $callee->getOpArrayPointer();
+        $refusal = match (true) {
+            $opArray->static_variables !== null => 'declares static variables',
+            $opArray->last_try_catch > 0        => 'has try/catch blocks',
+            $opArray->last_live_range > 0       => 'keeps temporaries alive across oplines',
+            $opArray->num_dynamic_func_defs > 0 => 'declares closures',
+            default                             => null,
+        };
+        if ($refusal !== null) {
+            return $refusal;
+        }
+
+        $parameterCount = $common->num_args;
+        $guards         = [];
+        for ($parameter = 0; $parameter < $parameterCount; $parameter++) {
+            $argument = $callee->getArgumentInfo($parameter);
+            if ($argument->isByReference()) {
+                return "takes \${$argument->getName()} by reference";
+            }
+            $mask = self::checkedTypeOf($argument);
+            if ($mask === null) {
+                return "declares a class or pseudo type for \${$argument->getName()}";
+            }
+            if ($mask !== 0) {
+                $guards[$parameter] = $mask;
+            }
+        }
+        $returnMask = 0;
+        if (($flags & Core::ZEND_ACC_HAS_RETURN_TYPE) !== 0) {
+            $argument = $callee->getArgumentInfo(ArgumentEntry::RETURN_ENTRY_INDEX);
+            // void needs no check: the compiler already refuses `return $value;`
+            $returnMask = $argument->getPureTypeMask() === self::MAY_BE_VOID
+                ? 0
+                : self::checkedTypeOf($argument);
+            if ($returnMask === null) {
+                return 'declares a class or pseudo return type';
+            }
+        }
+
+        $body         = OpArrayBody::fromFunction($callee);
+        $instructions = $body->instructions;
+        $defaults     = [];
+        for ($parameter = 0; $parameter < $parameterCount; $parameter++) {
+            $receive = $instructions[$parameter] ?? null;
+            if ($receive === null
+                || ($receive->opcode !== OpCode::RECV && $receive->opcode !== OpCode::RECV_INIT)
+                || $receive->op1 !== $parameter + 1
+            ) {
+                return 'does not receive its parameters in order';
+            }
+            if ($receive->opcode === OpCode::RECV_INIT) {
+                if ($body->getLiteralType($receive->op2) === self::IS_CONSTANT_AST) {
+                    return "has a constant expression as the default of \${$callee->getArgumentInfo($parameter)->getName()}";
+                }
+                $defaults[$parameter] = $receive->op2;
+            }
+        }
+        $size = \count($instructions) - $parameterCount;
+        if ($size > $this->maxCalleeOplines) {
+            return sprintf('has %d oplines, over the budget of %d', $size, $this->maxCalleeOplines);
+        }
+
+        $writesParameter = $strictnessSensitive = $spillsReturn = false;
+        for ($index = $parameterCount; $index < \count($instructions); $index++) {
+            $instruction = $instructions[$index];
+            $opcode      = $instruction->opcode;
+            if (!isset(self::INLINABLE[$opcode])) {
+                return 'uses ' . OpCode::name($opcode);
+            }
+            if (isset(self::CV_WRITERS[$opcode])) {
+                if ($instruction->op1Type !== OpLine::IS_CV) {
+                    return 'writes through ' . OpCode::name($opcode) . ' into a non-local';
+                }
+                $writesParameter = $writesParameter || $body->slotOf($instruction->op1) < $parameterCount;
+            }
+            if (($opcode === OpCode::INIT_ARRAY || $opcode === OpCode::ADD_ARRAY_ELEMENT)
+                && ($instruction->extendedValue & self::ARRAY_ELEMENT_REF) !== 0
+            ) {
+                return 'builds an array of references';
+            }
+            $strictnessSensitive = $strictnessSensitive || isset(self::STRICTNESS_SENSITIVE[$opcode]);
+            if ($opcode !== OpCode::VERIFY_RETURN_TYPE) {
+                continue;
+            }
+            // The checked value must be what the next opline returns
+            [$valueType, $value] = $instruction->op1Type === OpLine::IS_CONST
+                ? [$instruction->resultType, $instruction->result]
+                : [$instruction->op1Type, $instruction->op1];
+            $return = $instructions[$index + 1] ?? null;
+            if ($return === null || $return->opcode !== OpCode::RETURN || $return->op1Type !== $valueType || $return->op1 !== $value) {
+                return 'verifies a value it does not return right away';
+            }
+            if ($instruction->op1Type === OpLine::IS_CONST) {
+                if ($returnMask !== 0 && (($returnMask >> $body->getLiteralType($instruction->op1)) & 1) === 0) {
+                    return 'returns a literal its return type coerces';
+                }
+            } elseif (($instruction->op1Type & (OpLine::IS_TMP_VAR | OpLine::IS_VAR)) !== 0) {
+                $spillsReturn = true;
+            }
+        }
+        if ($returnMask !== 0 && $writesParameter) {
+            // A failed return check calls the function again, with the arguments as received
+            return 'assigns a parameter before a checked return';
+        }
+        if ($returnMask !== 0) {
+            $refusal = self::findReplayEffect($callee, $body, $parameterCount, $guards);
+            if ($refusal !== null) {
+                return $refusal;
+            }
+        }
+
+        return [
+            'function'            => $callee,
+            'name'                => self::nameOf($callee),
+            'body'                => $body,
+            'parameterCount'      => $parameterCount,
+            'guards'              => $guards,
+            'defaults'            => $defaults,
+            'returnMask'          => $returnMask,
+            'strict'              => ($flags & Core::ZEND_ACC_STRICT_TYPES) !== 0,
+            'strictnessSensitive' => $strictnessSensitive,
+            'spillsReturn'        => $spillsReturn,
+        ];
+    }
+
+    /**
+     * Finds what a second run of the callee body would make observable
+     *
+     * A failed return check performs the real call after the inlined body already ran, so such
+     * a body must not call user code (__toString(), Countable::count(), comparison handlers),
+     * raise a diagnostic or read an undefined local. Value types are inferred from the
+     * parameter guards and literals, flow-insensitively: a local has every type assigned to it.
+     *
+     * @param array<int, int> $guards TYPE_CHECK masks of the checked parameters
+     *
+     * @return string|null The reason the callee is refused
+     */
+    private static function findReplayEffect(
+        ReflectionFunction|ReflectionMethod $callee,
+        OpArrayBody $body,
+        int $parameterCount,
+        array $guards,
+    ): ?string {
+        $instructions = \array_slice($body->instructions, $parameterCount);
+        foreach ($instructions as $instruction) {
+            $opcode = $instruction->opcode === OpCode::ASSIGN_OP ? $instruction->extendedValue : $instruction->opcode;
+            if (!isset(self::REPLAYABLE[$opcode])) {
+                return sprintf('may repeat the effects of %s after a failed return check', OpCode::name($opcode));
+            }
+        }
+
+        $types = [];
+        for ($parameter = 0; $parameter < $parameterCount; $parameter++) {
+            $types[$parameter] = $guards[$parameter] ?? self::MAY_BE_ANY;
+        }
+        $typesOf = static function (int $type, int $value) use ($body, &$types): int {
+            $type &= self::OPERAND_TYPE;
+
+            return match (true) {
+                $type === OpLine::IS_CONST     => 1 << $body->getLiteralType($value),
+                ($type & self::VARIABLE) !== 0 => $types[$body->slotOf($value)] ?? 0,
+                default                        => 0,
+            };
+        };
+        // Types only grow, one more pass per assignment chain
+        do {
+            $grown = false;
+            foreach ($instructions as $instruction) {
+                $isAssignOp     = $instruction->opcode === OpCode::ASSIGN_OP;
+                [, , $produces] = self::REPLAYABLE[$isAssignOp ? $instruction->extendedValue : $instruction->opcode];
+                $produced       = match ($produces) {
+                    'op1'   => $typesOf($instruction->op1Type, $instruction->op1),
+                    'op2'   => $typesOf($instruction->op2Type, $instruction->op2),
+                    default => $produces,
+                };
+                $targets = [];
+                if (($instruction->resultType & self::VARIABLE) !== 0) {
+                    $targets[] = $instruction->result;
+                }
+                if (isset(self::CV_WRITERS[$instruction->opcode]) && $instruction->op1Type === OpLine::IS_CV) {
+                    $targets[] = $instruction->op1;
+                }
+                foreach ($targets as $target) {
+                    $slot  = $body->slotOf($target);
+                    $known = $types[$slot] ?? 0;
+                    if (($known | $produced) !== $known) {
+                        $types[$slot] = $known | $produced;
+                        $grown        = true;
+                    }
+                }
+            }
+        } while ($grown);
+
+        foreach ($instructions as $instruction) {
+            $opcode                = $instruction->opcode === OpCode::ASSIGN_OP ? $instruction->extendedValue : $instruction->opcode;
+            [$accepts1, $accepts2] = self::REPLAYABLE[$opcode];
+            if (($typesOf($instruction->op1Type, $instruction->op1) & ~$accepts1) !== 0
+                || ($typesOf($instruction->op2Type, $instruction->op2) & ~$accepts2) !== 0
+            ) {
+                return sprintf('may repeat the effects of %s after a failed return check', OpCode::name($opcode));
+            }
+        }
+
+        // A local read before any assignment warns once per run
+        $liveness = Liveness::of(ControlFlowGraph::fromFunction($callee));
+        foreach ($liveness->getLiveIn(0) as $variable) {
+            if ($body->slotOf($variable) < $body->getVariableCount()) {
+                return 'may read an undefined local before a checked return';
+            }
+        }
+
+        return null;
+    }
+
+    /**
+     * Checks what the inlined copy of one call site would change besides the callee itself
+     *
+     * @param array{init: int, do: int, sends: array<int, int>} $site
+     * @param array<string, mixed>                               $callee
+     *
+     * @return string|null The reason the site stays a call
+     */
+    private static function checkSite(
+        OpArrayBody $body,
+        array $site,
+        array $callee,
+        ReflectionFunction|ReflectionMethod $caller,
+    ): ?string {
+        $function = $callee['function'];
+        if ($function->getAddress() === $caller->getAddress()) {
+            return 'is recursive';
+        }
+        $calleeCommon = $function->getCommonPointer();
+        if ($function instanceof ReflectionMethod) {
+            if (($calleeCommon->fn_flags & Core::ZEND_ACC_STATIC) === 0) {
+                return 'is an instance method';
+            }
+            $callerScope = $caller->getCommonPointer()->scope;
+            if (($calleeCommon->fn_flags & Core::ZEND_ACC_PUBLIC) === 0
+                && ($callerScope === null || Core::addressOf($callerScope) !== Core::addressOf($calleeCommon->scope))
+            ) {
+                return 'is not visible from ' . self::nameOf($caller);
+            }
+        }
+        $callerStrict = ($caller->getCommonPointer()->fn_flags & Core::ZEND_ACC_STRICT_TYPES) !== 0;
+        if ($callee['strictnessSensitive'] && $callee['strict'] !== $callerStrict) {
+            return 'depends on a strict_types mode the caller does not share';
+        }
+
+        $argumentCount = \count($site['sends']);
+        if ($body->instructions[$site['init']]->extendedValue !== $argumentCount
+            || ($argumentCount > 0 && array_keys($site['sends']) !== range(1, $argumentCount))
+        ) {
+            return 'is called with arguments sent out of order';
+        }
+        if ($argumentCount > $callee['parameterCount']) {
+            return 'is called with extra arguments';
+        }
+        for ($parameter = $argumentCount; $parameter < $callee['parameterCount']; $parameter++) {
+            if (!isset($callee['defaults'][$parameter])) {
+                return 'is called with too few arguments';
+            }
+        }
+
+        // Jump tables pin the distances between the instructions they span
+        foreach ($body->instructions as $position => $instruction) {
+            if ($instruction->jumpTable === null) {
+                continue;
+            }
+            $targets = [...array_values($instruction->jumpTable), $position];
+            if ($body->getJumpTarget($instruction, 'extended_value') > $position) {
+                $targets[] = $body->getJumpTarget($instruction, 'extended_value');
+            }
+            if (min($targets) <= $site['do'] && $site['do'] < max($targets)) {
+                return 'is called inside a switch or match';
+            }
+        }
+
+        return null;
+    }
+
+    /**
+     * Replaces one call site with an inlined copy of the callee
+     *
+     * Layout at the former DO opline: defaults of the omitted parameters, parameter type
+     * checks, the renumbered body, the fallback call (when anything is checked), then the
+     * unset of the callee's CVs that every RETURN jumps to.
+     *
+     * @param array{init: int, do: int, sends: array<int, int>} $site
+     * @param array<string, mixed>                               $callee
+     */
+    private static function spliceSite(OpArrayBody $body, array $site, array $callee, int $number): void
+    {
+        /** @var OpArrayBody $calleeBody */
+        $calleeBody    = $callee['body'];
+        $calleeName    = $callee['name'];
+        $argumentCount = \count($site['sends']);
+
+        // Fresh CVs and temporaries per site: nested and repeated calls never share them
+        $slots = [];
+        foreach ($callee['function']->getVariableNames() as $slot => $variableName) {
+            $slots[$slot] = $body->addVariable("{$variableName}@{$calleeName}#{$number}");
+        }
+        $variables   = $slots;
+        $returnSpill = $callee['spillsReturn'] ? $body->addVariable("return@{$calleeName}#{$number}") : null;
+        if ($returnSpill !== null) {
+            $variables[] = $returnSpill;
+        }
+        $calleeVariables = $calleeBody->getVariableCount();
+        for ($temporary = 0; $temporary < $calleeBody->getTemporaryCount(); $temporary++) {
+            $slots[$calleeVariables + $temporary] = $body->addTemporary();
+        }
+        // Defaults are checked too: RECV_INIT coerces them the way it coerces arguments
+        $guards        = $callee['guards'];
+        $needsFallback = $guards !== [] || $callee['returnMask'] !== 0;
+        $guard         = $needsFallback ? $body->addTemporary() : 0;
+
+        // Operands were shifted by the allocations above: read the call site only now
+        $init     = $body->instructions[$site['init']];
+        $call     = $body->instructions[$site['do']];
+        $lineNo   = $call->lineNo;
+        $fallback = [clone $init];
+        foreach ($site['sends'] as $argument => $index) {
+            $send = $body->instructions[$index];
+            // SEND_VAR on the callee's CV replays the argument for the real call
+            $fallback[] = new Instruction(
+                $init->opcode === OpCode::INIT_FCALL ? OpCode::SEND_VAR : OpCode::SEND_VAR_EX,
+                op1Type: OpLine::IS_CV,
+                op1: $slots[$argument - 1],
+                op2: $argument,
+            );
+            $valueType = $send->op1Type;
+            $value     = $send->op1;
+            $send->erase();
+            $send->opcode  = OpCode::ASSIGN;
+            $send->op1Type = OpLine::IS_CV;
+            $send->op1     = $slots[$argument - 1];
+            $send->op2Type = $valueType;
+            $send->op2     = $value;
+        }
+        $fallback[] = clone $call;
+        $init->erase();
+
+        $operand = static function (int $type, int $value) use ($body, $calleeBody, $slots): int {
+            $type &= self::OPERAND_TYPE;
+
+            return match (true) {
+                $type === OpLine::IS_CONST     => $body->importLiteral($calleeBody, $value),
+                ($type & self::VARIABLE) !== 0 => $slots[$calleeBody->slotOf($value)],
+                default                        => $value,
+            };
+        };
+
+        $replacement = $toFallback = $toEnd = $jumps = $positions = $returnValues = [];
+        for ($parameter = $argumentCount; $parameter < $callee['parameterCount']; $parameter++) {
+            $replacement[] = new Instruction(
+                OpCode::ASSIGN,
+                op1Type: OpLine::IS_CV,
+                op1: $slots[$parameter],
+                op2Type: OpLine::IS_CONST,
+                op2: $body->importLiteral($calleeBody, $callee['defaults'][$parameter]),
+            );
+        }
+        foreach ($guards as $parameter => $mask) {
+            $replacement[] = new Instruction(
+                OpCode::TYPE_CHECK,
+                op1Type: OpLine::IS_CV,
+                op1: $slots[$parameter],
+                resultType: OpLine::IS_TMP_VAR,
+                result: $guard,
+                extendedValue: $mask,
+            );
+            $toFallback[]  = \count($replacement);
+            $replacement[] = new Instruction(OpCode::JMPZ, op1Type: OpLine::IS_TMP_VAR, op1: $guard);
+        }
+
+        $calleeInstructions = $calleeBody->instructions;
+        $last               = \count($calleeInstructions) - 1;
+        for ($index = $callee['parameterCount']; $index <= $last; $index++) {
+            $source            = $calleeInstructions[$index];
+            $positions[$index] = \count($replacement);
+            if ($source->opcode === OpCode::RETURN) {
+                [$type, $value] = $returnValues[$index] ?? [$source->op1Type, $operand($source->op1Type, $source->op1)];
+                if ($call->resultType !== OpLine::IS_UNUSED) {
+                    $replacement[] = new Instruction(
+                        OpCode::QM_ASSIGN,
+                        op1Type: $type,
+                        op1: $value,
+                        resultType: $call->resultType,
+                        result: $call->result,
+                    );
+                } elseif (($type & (OpLine::IS_TMP_VAR | OpLine::IS_VAR)) !== 0) {
+                    $replacement[] = new Instruction(OpCode::FREE, op1Type: $type, op1: $value);
+                }
+                if ($needsFallback || $index !== $last) {
+                    $toEnd[]       = \count($replacement);
+                    $replacement[] = new Instruction(OpCode::JMP);
+                }
+                continue;
+            }
+            if ($source->opcode === OpCode::VERIFY_RETURN_TYPE) {
+                if ($source->op1Type === OpLine::IS_CONST) {
+                    // Checked at analysis time: the literal is returned as it is
+                    $replacement[] = new Instruction(
+                        OpCode::QM_ASSIGN,
+                        op1Type: OpLine::IS_CONST,
+                        op1: $operand(OpLine::IS_CONST, $source->op1),
+                        resultType: OpLine::IS_TMP_VAR,
+                        result: $operand($source->resultType, $source->result),
+                    );
+                } elseif ($callee['returnMask'] === 0) {
+                    $replacement[] = new Instruction(OpCode::NOP);
+                } else {
+                    $checked = [$source->op1Type, $operand($source->op1Type, $source->op1)];
+                    if ($source->op1Type !== OpLine::IS_CV) {
+                        // TYPE_CHECK would consume the temporary the RETURN still needs
+                        assert($returnSpill !== null);
+                        $replacement[] = new Instruction(
+                            OpCode::ASSIGN,
+                            op1Type: OpLine::IS_CV,
+                            op1: $returnSpill,
+                            op2Type: $checked[0],
+                            op2: $checked[1],
+                        );
+                        $checked = [OpLine::IS_CV, $returnSpill];
+                        $returnValues[$index + 1] = $checked;
+                    }
+                    $replacement[] = new Instruction(
+                        OpCode::TYPE_CHECK,
+                        op1Type: $checked[0],
+                        op1: $checked[1],
+                        resultType: OpLine::IS_TMP_VAR,
+                        result: $guard,
+                        extendedValue: $callee['returnMask'],
+                    );
+                    $toFallback[]  = \count($replacement);
+                    $replacement[] = new Instruction(OpCode::JMPZ, op1Type: OpLine::IS_TMP_VAR, op1: $guard);
+                }
+                continue;
+            }
+            $jumps[\count($replacement)] = $source;
+            $replacement[]               = new Instruction(
+                $source->opcode,
+                op1Type: $source->op1Type,
+                op1: $operand($source->op1Type, $source->op1),
+                op2Type: $source->op2Type,
+                op2: $operand($source->op2Type, $source->op2),
+                resultType: $source->resultType,
+                result: $operand($source->resultType, $source->result),
+                extendedValue: $source->extendedValue,
+            );
+        }
+
+        $fallbackStart = \count($replacement);
+        if ($needsFallback) {
+            array_push($replacement, ...$fallback);
+        }
+        $end = \count($replacement);
+        foreach ($variables as $variable) {
+            $replacement[] = new Instruction(OpCode::UNSET_CV, op1Type: OpLine::IS_CV, op1: $variable);
+        }
+
+        foreach ($replacement as $instruction) {
+            $instruction->lineNo = $lineNo;
+        }
+        foreach ($jumps as $position => $source) {
+            foreach (OpArrayRewriter::jumpFieldsOf($source->opcode, $source->extendedValue) as $field) {
+                $body->setJumpTarget($replacement[$position], $field, $positions[$calleeBody->getJumpTarget($source, $field)]);
+            }
+        }
+        foreach ($toFallback as $position) {
+            $body->setJumpTarget($replacement[$position], 'op2', $fallbackStart);
+        }
+        foreach ($toEnd as $position) {
+            $body->setJumpTarget($replacement[$position], 'op1', $end);
+        }
+        $body->splice($site['do'], $replacement);
+    }
+
+    /**
+     * Returns the TYPE_CHECK mask enforcing a declared type, 0 when nothing needs checking
+     *
+     * @return int|null Null for class, union-with-class and pseudo types (callable, static...)
+     */
+    private static function checkedTypeOf(ArgumentEntry $argument): ?int
+    {
+        if (($argument->getTypeMask() & self::TYPE_KIND_MASK) !== 0) {
+            return null;
+        }
+        $mask = $argument->getPureTypeMask();
+        if ($mask === 0 || $mask === self::MAY_BE_ANY) {
+            return 0;
+        }
+
+        return ($mask & ~self::MAY_BE_ANY) === 0 ? $mask : null;
+    }
+
+    /**
+     * Finds the INIT_FCALL oplines calling a function with a precomputed frame size
+     *
+     * Covers the function and class tables, the closures their op_arrays declare, and every
+     * op_array on the current call stack (main scripts and eval()'d code included).
+     *
+     * @return list<int> Opline addresses
+     *
+     * @throws OpArrayRewriteException When one of them lives in opcache shared memory
+     */
+    private static function findStaticCallSites(string $lowerName, string $name): array
+    {
+        $opArrays = [];
+        $collect  = static function (object $opArray) use (&$collect, &$opArrays): void {
+            if ($opArray->opcodes === null || isset($opArrays[Core::pointerAddressOf($opArray->opcodes)])) {
+                return;
+            }
+            $opArrays[Core::pointerAddressOf($opArray->opcodes)] = $opArray;
+            for ($index = 0; $index < $opArray->num_dynamic_func_defs; $index++) {
+                $collect($opArray->dynamic_func_defs[$index]);
+            }
+        };
+        foreach (Core::$executor->functionTable as $functionValue) {
+            $rawFunction = $functionValue->getRawFunction();
+            if ($rawFunction->type === Core::ZEND_USER_FUNCTION) {
+                $collect($rawFunction->op_array);
+            }
+        }
+        $seenClasses = [];
+        foreach (Core::$executor->classTable as $classValue) {
+            try {
+                $rawClass = $classValue->getRawClass();
+            } catch (\UnexpectedValueException $e) {
+                continue;
+            }
+            $classAddress = Core::addressOf($rawClass);
+            if (isset($seenClasses[$classAddress]) || $rawClass->type !== Core::ZEND_USER_CLASS) {
+                continue;
+            }
+            $seenClasses[$classAddress] = true;
+            foreach (ReflectionClass::fromCData($rawClass)->getMethodTable() as $methodValue) {
+                $rawFunction = $methodValue->getRawFunction();
+                if ($rawFunction->type === Core::ZEND_USER_FUNCTION) {
+                    $collect($rawFunction->op_array);
+                }
+            }
+        }
+        $frame = Core::$executor->getExecutionState();
+        while (true) {
+            $rawFunction = $frame->getRawFunction();
+            if ($rawFunction !== null && $rawFunction->type !== Core::ZEND_INTERNAL_FUNCTION) {
+                $collect($rawFunction->op_array);
+            }
+            if (!$frame->hasPrevious()) {
+                break;
+            }
+            $frame = $frame->getPrevious();
+        }
+
+        $opcodeSize   = Core::sizeOfType(zend_op::class);
+        $opcodeOffset = Core::offsetOfField(zend_op::class, 'opcode');
+        $sites        = [];
+        foreach ($opArrays as $base => $opArray) {
+            $total = $opArray->last;
+            $bytes = \FFI::string(Core::cast('char *', $opArray->opcodes), $total * $opcodeSize);
+            for ($index = 0; $index < $total; $index++) {
+                if (\ord($bytes[$index * $opcodeSize + $opcodeOffset]) !== OpCode::INIT_FCALL) {
+                    continue;
+                }
+                $oplineAddress = $base + $index * $opcodeSize;
+                $opline        = Core::pointerAtAddress(zend_op::class, $oplineAddress);
+                $constant      = $opline->op2->constant;
+                $literal       = Core::pointerAtAddress(
+                    zval::class,
+                    $oplineAddress + ($constant >= 0x80000000 ? $constant - 0x100000000 : $constant),
+                );
+                if (($literal->u1->type_info & 0xFF) !== ReflectionValue::IS_STRING
+                    || strtolower(StringEntry::fromCData($literal->value->str)->getStringValue()) !== $lowerName
+                ) {
+                    continue;
+                }
+                if (($opArray->fn_flags & Core::ZEND_ACC_IMMUTABLE) !== 0) {
+                    throw OpArrayRewriteException::sharedCallSites($name);
+                }
+                $sites[] = $oplineAddress;
+            }
+        }
+
+        return $sites;
+    }
+
+    private static function nameOf(FunctionLikeInterface $function): string
+    {
+        return $function instanceof ReflectionMethod
+            ? $function->class . '::' . $function->getName()
+            : $function->getName();
+    }
+}
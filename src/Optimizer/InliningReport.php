@@ -0,0 +1,46 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Optimizer;
+
+/**
+ * What one Inliner run changed in a caller
+ */
+final readonly class InliningReport
+{
+    /**
+     * @param int                   $inlinedSites     Call sites replaced by a copy of their callee
+     * @param list<string>          $inlinedCallees   Functions and "Class::method" names copied in
+     * @param array<string, string> $rejectedCallees  Callees left as calls, with the reason
+     * @param int                   $addedFrameSlots  CVs and temporaries the caller's frame grew by
+     * @param int                   $resizedCallSites INIT_FCALL oplines of other functions whose
+     *                                                reserved frame size was adjusted
+     */
+    public function __construct(
+        public int $oplinesBefore,
+        public int $oplinesAfter,
+        public int $inlinedSites = 0,
+        public array $inlinedCallees = [],
+        public array $rejectedCallees = [],
+        public int $addedFrameSlots = 0,
+        public int $resizedCallSites = 0,
+    ) {}
+
+    /**
+     * Checks whether any call site was inlined (and a new body was installed)
+     */
+    public function isChanged(): bool
+    {
+        return $this->inlinedSites > 0;
+    }
+}
@@ -0,0 +1,81 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Optimizer;
+
+use ZEngine\System\OpCode;
+use ZEngine\Type\OpLine;
+
+/**
+ * One decoded opline of an OpArrayBody
+ *
+ * Operands are stored in the meaning they have for the engine, not in their relocated form:
+ * an IS_CONST operand holds a literal index of the body, a jump operand (or extended_value)
+ * holds the index of the target instruction, and everything else holds the raw znode_op value
+ * (a variable offset, an argument number). Encoding turns them back into opline-relative
+ * offsets, so passes can move instructions around without any address arithmetic.
+ */
+final class Instruction
+{
+    /**
+     * @param int                   $source    Index of the opline the instruction was decoded from,
+     *                                         -1 for a new one (its raw bytes carry the baked handler)
+     * @param array<int|string,int> $jumpTable Target instruction by key of a SWITCH/MATCH jump table
+     */
+    public function __construct(
+        public int $opcode,
+        public int $op1Type = OpLine::IS_UNUSED,
+        public int $op1 = 0,
+        public int $op2Type = OpLine::IS_UNUSED,
+        public int $op2 = 0,
+        public int $resultType = OpLine::IS_UNUSED,
+        public int $result = 0,
+        public int $extendedValue = 0,
+        public int $lineNo = 0,
+        public int $source = -1,
+        public ?array $jumpTable = null,
+    ) {}
+
+    /**
+     * Turns the instruction into a NOP, keeping its line and source
+     */
+    public function erase(): void
+    {
+        $this->opcode        = OpCode::NOP;
+        $this->op1Type       = OpLine::IS_UNUSED;
+        $this->op1           = 0;
+        $this->op2Type       = OpLine::IS_UNUSED;
+        $this->op2           = 0;
+        $this->resultType    = OpLine::IS_UNUSED;
+        $this->result        = 0;
+        $this->extendedValue = 0;
+        $this->jumpTable     = null;
+    }
+
+    public function isNop(): bool
+    {
+        return $this->opcode === OpCode::NOP;
+    }
+
+    public function __debugInfo(): array
+    {
+        return [
+            'opcode'        => OpCode::name($this->opcode),
+            'op1'           => [$this->op1Type, $this->op1],
+            'op2'           => [$this->op2Type, $this->op2],
+            'result'        => [$this->resultType, $this->result],
+            'extendedValue' => $this->extendedValue,
+            'lineNo'        => $this->lineNo,
+        ];
+    }
+}
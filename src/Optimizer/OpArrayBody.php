@@ -0,0 +1,812 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Optimizer;
+
+use FFI\CData;
+use ZEngine\Core;
+use ZEngine\Generated\zend_function;
+use ZEngine\Generated\zend_live_range;
+use ZEngine\Generated\zend_op;
+use ZEngine\Generated\zend_op_array;
+use ZEngine\Generated\zend_try_catch_element;
+use ZEngine\Generated\zval;
+use ZEngine\Reflection\FunctionBodySwap;
+use ZEngine\Reflection\OpArrayRewriteException;
+use ZEngine\Reflection\OpArrayRewriter;
+use ZEngine\Reflection\ReflectionFunction;
+use ZEngine\Reflection\ReflectionMethod;
+use ZEngine\Reflection\ReflectionValue;
+use ZEngine\System\HandlerRebind;
+use ZEngine\System\OpCode;
+use ZEngine\Type\OpLine;
+use ZEngine\Type\StringEntry;
+
+/**
+ * Editable copy of a compiled function body: instructions, literals, live ranges, try/catch
+ *
+ * A body is decoded from a live op_array into position-independent Instructions (literal
+ * indexes and target instruction indexes instead of relocated offsets), edited by passes, and
+ * installed back as a NEW body through FunctionBodySwap: the previous opcodes are never written,
+ * so a failure anywhere before the swap leaves the function untouched.
+ *
+ * The new body shares everything that is not code with the previous one - argument info,
+ * static variables, nested closure declarations - and takes over its literals (each gets one
+ * more reference). To keep that sharing sound the previous body is never destroyed: one
+ * opcodes block per install stays allocated, and closures created over the previous body keep
+ * executing it safely. Run-time cache slots are never renumbered, so cache_size stays valid;
+ * CVs and temporaries may be appended (addVariable(), addTemporary()), which grows the frame.
+ */
+final class OpArrayBody
+{
+    /**
+     * Opcodes whose op2 literal is a jump table of opline-relative offsets
+     */
+    private const array JUMP_TABLE_OPCODES = [
+        OpCode::SWITCH_LONG   => true,
+        OpCode::SWITCH_STRING => true,
+        OpCode::MATCH         => true,
+    ];
+
+    private const int TEMPORARY = OpLine::IS_TMP_VAR | OpLine::IS_VAR;
+
+    /**
+     * zend_op_array fields describing the code of a body, see captureLayout()
+     */
+    private const array LAYOUT_FIELDS = [
+        'opcodes',
+        'literals',
+        'last',
+        'last_literal',
+        'vars',
+        'last_var',
+        'T',
+        'live_range',
+        'last_live_range',
+        'try_catch_array',
+        'last_try_catch',
+    ];
+
+    /**
+     * Decoded instructions, in execution layout order
+     *
+     * @var list<Instruction>
+     */
+    public array $instructions = [];
+
+    /**
+     * [var with ZEND_LIVE_* kind bits, start instruction, end instruction]
+     *
+     * @var list<array{int, int, int}>
+     */
+    public array $liveRanges = [];
+
+    /**
+     * [try, catch, finally, finally end] instructions, 0 for an absent catch/finally
+     *
+     * @var list<array{int, int, int, int}>
+     */
+    public array $tryCatch = [];
+
+    /**
+     * Literals added by passes, keyed by literal index
+     *
+     * @var array<int, null|bool|int|float|string>
+     */
+    private array $addedLiterals = [];
+
+    /**
+     * Literals copied from another body, keyed by literal index
+     *
+     * @var array<int, CData>
+     */
+    private array $importedLiterals = [];
+
+    /**
+     * Names of the CVs appended by passes
+     *
+     * @var list<string>
+     */
+    private array $addedVariables = [];
+
+    private int $temporaryCount;
+
+    private readonly int $opcodeSize;
+
+    private readonly int $zvalSize;
+
+    /**
+     * ZEND_CALL_FRAME_SLOT: zvals taken by the zend_execute_data header of every frame
+     */
+    private readonly int $frameSlot;
+
+    /**
+     * @param CData|null $opcodes   Source opcodes (null for an empty body)
+     * @param CData|null $literals  Source literal table
+     * @param CData|null $variables Source CV names (zend_string **)
+     */
+    private function __construct(
+        private readonly string $name,
+        private readonly ?CData $opcodes,
+        private readonly ?CData $literals,
+        private readonly int $literalCount,
+        private readonly ?CData $variables,
+        private readonly int $variableCount,
+        int $temporaryCount,
+    ) {
+        $this->temporaryCount = $temporaryCount;
+        $this->opcodeSize     = Core::sizeOfType(zend_op::class);
+        $this->zvalSize       = Core::sizeOfType(zval::class);
+        $this->frameSlot      = intdiv(Core::sizeOfType('zend_execute_data') + $this->zvalSize - 1, $this->zvalSize);
+    }
+
+    /**
+     * Decodes the current body of a user function
+     */
+    public static function fromFunction(ReflectionFunction|ReflectionMethod $function): self
+    {
+        $name = $function instanceof ReflectionMethod
+            ? $function->class . '::' . $function->getName()
+            : $function->getName();
+        if (!$function->isUserDefined()) {
+            throw OpArrayRewriteException::internalFunction($name);
+        }
+
+        return self::fromOpArray($function->getOpArrayPointer(), $name);
+    }
+
+    /**
+     * Decodes any compiled op_array, relocated opcache images included
+     *
+     * @param CData|zend_op_array $opArray
+     */
+    public static function fromOpArray(object $opArray, string $name = ''): self
+    {
+        $literalCount = $opArray->last_literal;
+        $body         = new self(
+            $name,
+            $opArray->opcodes,
+            $literalCount > 0 ? $opArray->literals : null,
+            $literalCount,
+            $opArray->last_var > 0 ? $opArray->vars : null,
+            $opArray->last_var,
+            $opArray->T,
+        );
+        $total        = $opArray->last;
+        if ($total === 0 || $body->opcodes === null) {
+            return $body;
+        }
+
+        $base         = Core::addressOf($body->opcodes);
+        $literalsBase = $body->literals === null ? 0 : Core::addressOf($body->literals);
+        for ($index = 0; $index < $total; $index++) {
+            $opline      = $body->opcodes[$index];
+            $instruction = new Instruction(
+                opcode: $opline->opcode,
+                op1Type: $opline->op1_type,
+                op1: $opline->op1->num,
+                op2Type: $opline->op2_type,
+                op2: $opline->op2->num,
+                resultType: $opline->result_type,
+                result: $opline->result->num,
+                extendedValue: $opline->extended_value,
+                lineNo: $opline->lineno,
+                source: $index,
+            );
+            $oplineAddress = $base + $index * $body->opcodeSize;
+            if ($opline->op1_type === OpLine::IS_CONST) {
+                $instruction->op1 = intdiv($oplineAddress + self::signed($opline->op1->constant) - $literalsBase, $body->zvalSize);
+            }
+            if ($opline->op2_type === OpLine::IS_CONST) {
+                $instruction->op2 = intdiv($oplineAddress + self::signed($opline->op2->constant) - $literalsBase, $body->zvalSize);
+            }
+            foreach (OpArrayRewriter::jumpFieldsOf($instruction->opcode, $instruction->extendedValue) as $field) {
+                $target = match ($field) {
+                    'op1'            => $index + intdiv(self::signed($opline->op1->num), $body->opcodeSize),
+                    'op2'            => $index + intdiv(self::signed($opline->op2->num), $body->opcodeSize),
+                    'extended_value' => $index + intdiv(self::signed($opline->extended_value), $body->opcodeSize),
+                };
+                $body->setJumpTarget($instruction, $field, $target);
+            }
+            if (isset(self::JUMP_TABLE_OPCODES[$instruction->opcode]) && $instruction->op2Type === OpLine::IS_CONST) {
+                $jumpTable = [];
+                foreach ($body->getLiteral($instruction->op2) as $key => $offset) {
+                    $jumpTable[$key] = $index + intdiv($offset, $body->opcodeSize);
+                }
+                $instruction->jumpTable = $jumpTable;
+            }
+            $body->instructions[] = $instruction;
+        }
+
+        for ($index = 0; $index < $opArray->last_live_range; $index++) {
+            $range               = $opArray->live_range[$index];
+            $body->liveRanges[] = [$range->var, $range->start, $range->end];
+        }
+        for ($index = 0; $index < $opArray->last_try_catch; $index++) {
+            $element          = $opArray->try_catch_array[$index];
+            $body->tryCatch[] = [$element->try_op, $element->catch_op, $element->finally_op, $element->finally_end];
+        }
+
+        return $body;
+    }
+
+    /**
+     * Returns the number of literals, added ones included
+     */
+    public function getLiteralCount(): int
+    {
+        return $this->literalCount + \count($this->addedLiterals) + \count($this->importedLiterals);
+    }
+
+    /**
+     * Returns the PHP value of a literal
+     */
+    public function getLiteral(int $index): mixed
+    {
+        if (\array_key_exists($index, $this->addedLiterals)) {
+            return $this->addedLiterals[$index];
+        }
+        $value = null;
+        ReflectionValue::fromValueEntry($this->literalPointer($index))->getNativeValue($value);
+
+        return $value;
+    }
+
+    /**
+     * Returns the IS_* type of a literal without converting it (IS_CONSTANT_AST included)
+     */
+    public function getLiteralType(int $index): int
+    {
+        if (\array_key_exists($index, $this->addedLiterals)) {
+            $value = $this->addedLiterals[$index];
+
+            return match (true) {
+                $value === null   => ReflectionValue::IS_NULL,
+                $value === false  => ReflectionValue::IS_FALSE,
+                $value === true   => ReflectionValue::IS_TRUE,
+                \is_int($value)   => ReflectionValue::IS_LONG,
+                \is_float($value) => ReflectionValue::IS_DOUBLE,
+                default           => ReflectionValue::IS_STRING,
+            };
+        }
+
+        return $this->literalPointer($index)->u1->type_info & 0xFF;
+    }
+
+    /**
+     * Appends a scalar literal, returns its index
+     *
+     * Strings are stored interned (StringEntry::persistentInterned()), like every literal the
+     * compiler produces.
+     */
+    public function addLiteral(null|bool|int|float|string $value): int
+    {
+        $index                       = $this->getLiteralCount();
+        $this->addedLiterals[$index] = $value;
+
+        return $index;
+    }
+
+    /**
+     * Appends a copy of a literal of another body, returns its index here
+     *
+     * The copy takes one more reference on the value when the body is installed.
+     */
+    public function importLiteral(self $from, int $index): int
+    {
+        if (\array_key_exists($index, $from->addedLiterals)) {
+            return $this->addLiteral($from->addedLiterals[$index]);
+        }
+        $newIndex                          = $this->getLiteralCount();
+        $this->importedLiterals[$newIndex] = $from->literalPointer($index);
+
+        return $newIndex;
+    }
+
+    /**
+     * Returns the number of CVs, added ones included (the op_array's last_var)
+     */
+    public function getVariableCount(): int
+    {
+        return $this->variableCount + \count($this->addedVariables);
+    }
+
+    /**
+     * Returns the number of temporaries, added ones included (the op_array's T)
+     */
+    public function getTemporaryCount(): int
+    {
+        return $this->temporaryCount;
+    }
+
+    /**
+     * Returns the frame slot an operand offset addresses: CVs first, then temporaries
+     */
+    public function slotOf(int $offset): int
+    {
+        return intdiv($offset, $this->zvalSize) - $this->frameSlot;
+    }
+
+    /**
+     * Returns the operand offset of a frame slot
+     */
+    public function offsetOf(int $slot): int
+    {
+        return ($this->frameSlot + $slot) * $this->zvalSize;
+    }
+
+    /**
+     * Appends a CV, returns its operand offset
+     *
+     * Temporaries live after the CVs in the frame, so every TMP/VAR operand and live range of
+     * the body moves up by one slot. INIT_FCALL oplines calling the function keep the frame
+     * size they were compiled with: whoever grows a frame resizes them (see Inliner).
+     */
+    public function addVariable(string $name): int
+    {
+        $offset                 = $this->offsetOf($this->getVariableCount());
+        $this->addedVariables[] = $name;
+        $shift                  = $this->zvalSize;
+        foreach ($this->instructions as $instruction) {
+            if (($instruction->op1Type & self::TEMPORARY) !== 0) {
+                $instruction->op1 += $shift;
+            }
+            if (($instruction->op2Type & self::TEMPORARY) !== 0) {
+                $instruction->op2 += $shift;
+            }
+            if (($instruction->resultType & self::TEMPORARY) !== 0) {
+                $instruction->result += $shift;
+            }
+        }
+        foreach ($this->liveRanges as $index => [$var, $start, $end]) {
+            // Offsets are zval-aligned, the ZEND_LIVE_* kind bits stay untouched
+            $this->liveRanges[$index] = [$var + $shift, $start, $end];
+        }
+
+        return $offset;
+    }
+
+    /**
+     * Appends a temporary, returns its operand offset
+     */
+    public function addTemporary(): int
+    {
+        return $this->offsetOf($this->getVariableCount() + $this->temporaryCount++);
+    }
+
+    /**
+     * Replaces one instruction with a sequence of new ones
+     *
+     * Jump targets inside the replacement are indexes relative to its first instruction.
+     * Jumps, live ranges and try/catch elements of the body that pointed at the replaced
+     * instruction now point at the first instruction of the replacement.
+     *
+     * @param list<Instruction> $replacement
+     */
+    public function splice(int $index, array $replacement): void
+    {
+        $growth = \count($replacement) - 1;
+        $moved  = static fn(int $target): int => $target > $index ? $target + $growth : $target;
+        foreach ($this->instructions as $instruction) {
+            foreach (OpArrayRewriter::jumpFieldsOf($instruction->opcode, $instruction->extendedValue) as $field) {
+                $this->setJumpTarget($instruction, $field, $moved($this->getJumpTarget($instruction, $field)));
+            }
+            if ($instruction->jumpTable !== null) {
+                $instruction->jumpTable = array_map($moved, $instruction->jumpTable);
+            }
+        }
+        foreach ($replacement as $instruction) {
+            foreach (OpArrayRewriter::jumpFieldsOf($instruction->opcode, $instruction->extendedValue) as $field) {
+                $this->setJumpTarget($instruction, $field, $index + $this->getJumpTarget($instruction, $field));
+            }
+        }
+        array_splice($this->instructions, $index, 1, $replacement);
+
+        foreach ($this->liveRanges as $position => [$var, $start, $end]) {
+            $this->liveRanges[$position] = [$var, $moved($start), $moved($end)];
+        }
+        foreach ($this->tryCatch as $position => [$try, $catch, $finally, $finallyEnd]) {
+            $this->tryCatch[$position] = [$moved($try), $moved($catch), $moved($finally), $moved($finallyEnd)];
+        }
+    }
+
+    /**
+     * Returns the target instruction of a jump field (op1, op2 or extended_value)
+     *
+     * @param 'op1'|'op2'|'extended_value' $field
+     */
+    public function getJumpTarget(Instruction $instruction, string $field): int
+    {
+        return match ($field) {
+            'op1'            => $instruction->op1,
+            'op2'            => $instruction->op2,
+            'extended_value' => $instruction->extendedValue,
+        };
+    }
+
+    /**
+     * @param 'op1'|'op2'|'extended_value' $field
+     */
+    public function setJumpTarget(Instruction $instruction, string $field, int $target): void
+    {
+        match ($field) {
+            'op1'            => $instruction->op1 = $target,
+            'op2'            => $instruction->op2 = $target,
+            'extended_value' => $instruction->extendedValue = $target,
+        };
+    }
+
+    /**
+     * Checks whether a SWITCH/MATCH jump table pins the distances between some instructions
+     */
+    public function hasJumpTables(): bool
+    {
+        foreach ($this->instructions as $instruction) {
+            if ($instruction->jumpTable !== null) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Removes instructions; jumps, live ranges and try/catch elements that pointed at a removed
+     * instruction now point at the next remaining one
+     *
+     * @param list<int> $indexes
+     */
+    public function removeInstructions(array $indexes): void
+    {
+        if ($indexes === []) {
+            return;
+        }
+        $removed  = array_fill_keys($indexes, true);
+        $newIndex = [];
+        $position = 0;
+        foreach ($this->instructions as $index => $instruction) {
+            $newIndex[$index] = $position;
+            if (!isset($removed[$index])) {
+                $position++;
+            }
+        }
+        $newIndex[\count($this->instructions)] = $position;
+
+        $remaining = [];
+        foreach ($this->instructions as $index => $instruction) {
+            if (isset($removed[$index])) {
+                continue;
+            }
+            foreach (OpArrayRewriter::jumpFieldsOf($instruction->opcode, $instruction->extendedValue) as $field) {
+                $this->setJumpTarget($instruction, $field, $newIndex[$this->getJumpTarget($instruction, $field)]);
+            }
+            if ($instruction->jumpTable !== null) {
+                foreach ($instruction->jumpTable as $key => $target) {
+                    $instruction->jumpTable[$key] = $newIndex[$target];
+                }
+            }
+            $remaining[] = $instruction;
+        }
+        $this->instructions = $remaining;
+
+        $liveRanges = [];
+        foreach ($this->liveRanges as [$var, $start, $end]) {
+            if ($newIndex[$start] < $newIndex[$end]) {
+                $liveRanges[] = [$var, $newIndex[$start], $newIndex[$end]];
+            }
+        }
+        $this->liveRanges = $liveRanges;
+        foreach ($this->tryCatch as $index => [$try, $catch, $finally, $finallyEnd]) {
+            $this->tryCatch[$index] = [
+                $newIndex[$try],
+                $catch === 0 ? 0 : $newIndex[$catch],
+                $finally === 0 ? 0 : $newIndex[$finally],
+                $finallyEnd === 0 ? 0 : $newIndex[$finallyEnd],
+            ];
+        }
+    }
+
+    /**
+     * Swaps the encoded body into the function it was decoded from
+     *
+     * Refused while a frame of the current call stack executes the function (its opline
+     * pointer and exception handling would mix both bodies). Generator functions are refused
+     * as a whole: suspended generator frames cannot be discovered.
+     */
+    public function install(ReflectionFunction|ReflectionMethod $function): void
+    {
+        $opArray = $function->getOpArrayPointer();
+        if (Core::pointerAddressOf($opArray->opcodes) !== Core::pointerAddressOf($this->opcodes)) {
+            throw new \LogicException('The body was decoded from another op_array');
+        }
+        if (FunctionBodySwap::hasLiveFrame($function->getAddress())) {
+            throw OpArrayRewriteException::liveFrame($this->name);
+        }
+        if (($function->getCommonPointer()->fn_flags & Core::ZEND_ACC_GENERATOR) !== 0) {
+            throw OpArrayRewriteException::generator($this->name);
+        }
+        $this->assertJumpTablesKeepDistances();
+        [$opcodes, $literals] = $this->encode();
+
+        self::restoreLayout($function, [
+            'opcodes'      => $opcodes,
+            'literals'     => $literals,
+            'last'         => \count($this->instructions),
+            'last_literal' => $this->getLiteralCount(),
+            'vars'         => $this->encodeVariables(),
+            'last_var'     => $this->getVariableCount(),
+            'T'            => $this->temporaryCount,
+            ...$this->encodeLiveRanges(),
+            ...$this->encodeTryCatch(),
+        ]);
+    }
+
+    /**
+     * Captures the code-related fields of a function's current body, for restoreLayout()
+     *
+     * @return array<string, mixed> zend_op_array field values
+     */
+    public static function captureLayout(ReflectionFunction|ReflectionMethod $function): array
+    {
+        $opArray = $function->getOpArrayPointer();
+        $layout  = [];
+        foreach (self::LAYOUT_FIELDS as $field) {
+            $layout[$field] = $opArray->{$field};
+        }
+
+        return $layout;
+    }
+
+    /**
+     * Swaps a body described by its code-related fields into a function
+     *
+     * Everything else (argument info, statics, run-time cache size) is taken from the current
+     * body, and the current body stays allocated. Used by install() and to bring back a layout
+     * captured earlier, whose arrays are still alive because bodies are never destroyed here.
+     *
+     * @param array<string, mixed> $layout zend_op_array field values, see captureLayout()
+     */
+    public static function restoreLayout(ReflectionFunction|ReflectionMethod $function, array $layout): void
+    {
+        $function->copyEntryOutOfSharedMemory();
+        $opArray       = $function->getOpArrayPointer();
+        $staticsMapPtr = $opArray->static_variables_ptr__ptr;
+
+        // The donor starts as a byte copy of the entry: everything but the code stays shared
+        $donor = Core::new(zend_function::class);
+        Core::memcpy($donor, $function->getEntryPointer(), Core::sizeOfType(zend_function::class));
+        $donorFunction = ReflectionFunction::fromCData(Core::cast(zend_function::class, Core::addr($donor)));
+        $donorArray    = $donorFunction->getOpArrayPointer();
+        foreach ($layout as $field => $value) {
+            $donorArray->{$field} = $value;
+        }
+        if ($opArray->refcount !== null) {
+            // The swap takes one reference per published bucket; destroy_op_array() efree()s the cell
+            $refCount                = Core::new('uint32_t', false);
+            $donorArray->refcount    = Core::cast('uint32_t *', Core::addr($refCount));
+            $donorArray->refcount[0] = 0;
+        }
+
+        FunctionBodySwap::swapUserFunctionBody(
+            $function,
+            $donorFunction,
+            preserveDeclaration: true,
+            // The defaults table is shared with a previous body that is never destroyed
+            duplicateStatics: false,
+            // The entry keeps its references on the previous body, so closures created over
+            // it can never bring it to zero and free the arrays both bodies share
+            destroyPrevious: false,
+            publishedShares: FunctionBodySwap::countPublishedShares($function),
+        )->commit();
+        // Static variables keep their current values: the live table moves to the new body
+        $function->getOpArrayPointer()->static_variables_ptr__ptr = $staticsMapPtr;
+    }
+
+    /**
+     * Lays the instructions and literals out as one block, the way pass_two() does
+     *
+     * @return array{CData, CData|null} Opcodes and literals pointers into the new block
+     */
+    private function encode(): array
+    {
+        $total          = \count($this->instructions);
+        $literalCount   = $this->getLiteralCount();
+        $literalsOffset = ($total * $this->opcodeSize + 15) & ~15;
+        $memory         = Core::new('char[' . ($literalsOffset + $literalCount * $this->zvalSize) . ']', false);
+        $opcodes        = Core::cast('zend_op *', $memory);
+        $base           = Core::addressOf($opcodes);
+        $literalsBase   = $base + $literalsOffset;
+
+        if ($this->literalCount > 0) {
+            assert($this->literals !== null);
+            Core::memcpy(Core::pointerAtAddress('zval *', $literalsBase), $this->literals, $this->literalCount * $this->zvalSize);
+            for ($index = 0; $index < $this->literalCount; $index++) {
+                // Both bodies hold the literal now, and the previous one never releases it
+                Core::call('zval_add_ref', Core::pointerAtAddress('zval *', $literalsBase + $index * $this->zvalSize));
+            }
+        }
+        foreach ($this->addedLiterals as $index => $value) {
+            self::writeScalar(Core::pointerAtAddress('zval *', $literalsBase + $index * $this->zvalSize), $value);
+        }
+        foreach ($this->importedLiterals as $index => $source) {
+            $literal = Core::pointerAtAddress('zval *', $literalsBase + $index * $this->zvalSize);
+            Core::memcpy($literal, $source, $this->zvalSize);
+            Core::call('zval_add_ref', $literal);
+        }
+
+        foreach ($this->instructions as $position => $instruction) {
+            $opline         = $opcodes[$position];
+            $oplineAddress  = $base + $position * $this->opcodeSize;
+            $constantOffset = fn(int $literal): int => ($literalsBase + $literal * $this->zvalSize - $oplineAddress) & 0xFFFFFFFF;
+            $jumpOffset     = fn(int $target): int => (($target - $position) * $this->opcodeSize) & 0xFFFFFFFF;
+
+            $source = null;
+            if ($instruction->source >= 0) {
+                assert($this->opcodes !== null);
+                $source = $this->opcodes[$instruction->source];
+                // Carries the baked handler along
+                Core::memcpy(Core::addr($opline), Core::addr($source), $this->opcodeSize);
+            }
+            $opline->opcode         = $instruction->opcode;
+            $opline->op1_type       = $instruction->op1Type;
+            $opline->op2_type       = $instruction->op2Type;
+            $opline->result_type    = $instruction->resultType;
+            $opline->op1->num       = $instruction->op1Type === OpLine::IS_CONST ? $constantOffset($instruction->op1) : $instruction->op1;
+            $opline->op2->num       = $instruction->op2Type === OpLine::IS_CONST ? $constantOffset($instruction->op2) : $instruction->op2;
+            $opline->result->num    = $instruction->result;
+            $opline->extended_value = $instruction->extendedValue;
+            $opline->lineno         = $instruction->lineNo;
+            foreach (OpArrayRewriter::jumpFieldsOf($instruction->opcode, $instruction->extendedValue) as $field) {
+                $offset = $jumpOffset($this->getJumpTarget($instruction, $field));
+                match ($field) {
+                    'op1'            => $opline->op1->num = $offset,
+                    'op2'            => $opline->op2->num = $offset,
+                    'extended_value' => $opline->extended_value = $offset,
+                };
+            }
+            $sameShape = $source !== null
+                && $source->opcode === $instruction->opcode
+                && $source->op1_type === $instruction->op1Type
+                && $source->op2_type === $instruction->op2Type
+                && $source->result_type === $instruction->resultType;
+            if (!$sameShape) {
+                // The VM handler is specialized by opcode and operand types
+                HandlerRebind::rebindOpline($opline);
+            }
+        }
+
+        return [$opcodes, $literalCount > 0 ? Core::pointerAtAddress('zval *', $literalsBase) : null];
+    }
+
+    /**
+     * Jump table literals are reused as they are: the distances they encode must still hold
+     */
+    private function assertJumpTablesKeepDistances(): void
+    {
+        foreach ($this->instructions as $position => $instruction) {
+            if ($instruction->jumpTable === null) {
+                continue;
+            }
+            foreach ($this->getLiteral($instruction->op2) as $key => $offset) {
+                if ($instruction->jumpTable[$key] - $position !== intdiv($offset, $this->opcodeSize)) {
+                    throw OpArrayRewriteException::shiftedJumpTable($this->name, $position);
+                }
+            }
+        }
+    }
+
+    /**
+     * Returns the CV names table: the source one, or a new one when CVs were added
+     */
+    private function encodeVariables(): ?CData
+    {
+        $count = $this->getVariableCount();
+        if ($this->addedVariables === []) {
+            return $this->variables;
+        }
+        // destroy_op_array() releases every name and efree()s the table
+        $variables = Core::new("zend_string *[{$count}]", false);
+        if ($this->variableCount > 0) {
+            assert($this->variables !== null);
+            Core::memcpy($variables, $this->variables, $this->variableCount * PHP_INT_SIZE);
+        }
+        foreach ($this->addedVariables as $index => $name) {
+            $variables[$this->variableCount + $index] = StringEntry::persistentInterned($name)->getRawValue();
+        }
+
+        return Core::cast('zend_string **', $variables);
+    }
+
+    /**
+     * @return array{live_range: CData|null, last_live_range: int}
+     */
+    private function encodeLiveRanges(): array
+    {
+        $count = \count($this->liveRanges);
+        if ($count === 0) {
+            return ['live_range' => null, 'last_live_range' => 0];
+        }
+        $ranges = Core::new("zend_live_range[{$count}]", false);
+        foreach ($this->liveRanges as $index => [$var, $start, $end]) {
+            $ranges[$index]->var   = $var;
+            $ranges[$index]->start = $start;
+            $ranges[$index]->end   = $end;
+        }
+
+        return ['live_range' => Core::cast(zend_live_range::class, $ranges), 'last_live_range' => $count];
+    }
+
+    /**
+     * @return array{try_catch_array: CData|null, last_try_catch: int}
+     */
+    private function encodeTryCatch(): array
+    {
+        $count = \count($this->tryCatch);
+        if ($count === 0) {
+            return ['try_catch_array' => null, 'last_try_catch' => 0];
+        }
+        $elements = Core::new("zend_try_catch_element[{$count}]", false);
+        foreach ($this->tryCatch as $index => [$try, $catch, $finally, $finallyEnd]) {
+            $elements[$index]->try_op      = $try;
+            $elements[$index]->catch_op    = $catch;
+            $elements[$index]->finally_op  = $finally;
+            $elements[$index]->finally_end = $finallyEnd;
+        }
+
+        return ['try_catch_array' => Core::cast(zend_try_catch_element::class, $elements), 'last_try_catch' => $count];
+    }
+
+    /**
+     * @param CData|zval $literal Zero-filled zval
+     */
+    private static function writeScalar(object $literal, null|bool|int|float|string $value): void
+    {
+        if (\is_int($value)) {
+            $literal->value->lval = $value;
+        } elseif (\is_float($value)) {
+            $literal->value->dval = $value;
+        } elseif (\is_string($value)) {
+            // Interned strings are not refcounted: the type info carries no flags
+            $literal->value->str = StringEntry::persistentInterned($value)->getRawValue();
+        }
+        $literal->u1->type_info = match (true) {
+            $value === null   => ReflectionValue::IS_NULL,
+            $value === false  => ReflectionValue::IS_FALSE,
+            $value === true   => ReflectionValue::IS_TRUE,
+            \is_int($value)   => ReflectionValue::IS_LONG,
+            \is_float($value) => ReflectionValue::IS_DOUBLE,
+            default           => ReflectionValue::IS_STRING,
+        };
+    }
+
+    /**
+     * @return CData|zval Source or imported literal
+     */
+    private function literalPointer(int $index): object
+    {
+        if (isset($this->importedLiterals[$index])) {
+            return $this->importedLiterals[$index];
+        }
+        assert($this->literals !== null && $index < $this->literalCount);
+
+        return Core::pointerAtAddress(zval::class, Core::addressOf($this->literals) + $index * $this->zvalSize);
+    }
+
+    /**
+     * znode_op offsets are uint32_t holding signed values
+     */
+    private static function signed(int $unsigned): int
+    {
+        return $unsigned >= 0x80000000 ? $unsigned - 0x100000000 : $unsigned;
+    }
+}
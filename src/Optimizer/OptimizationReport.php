@@ -0,0 +1,44 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Optimizer;
+
+/**
+ * What one PeepholeOptimizer run changed in a function body
+ */
+final readonly class OptimizationReport
+{
+    /**
+     * @param int $foldedConstants  Instructions evaluated at optimization time, their result
+     *                              substituted as a literal into the consumer
+     * @param int $eliminatedStores Temporaries that were computed only to be freed
+     * @param int $threadedJumps    Jumps redirected, resolved or dropped
+     * @param int $removedNops      NOPs compacted out of the body
+     */
+    public function __construct(
+        public int $oplinesBefore,
+        public int $oplinesAfter,
+        public int $foldedConstants = 0,
+        public int $eliminatedStores = 0,
+        public int $threadedJumps = 0,
+        public int $removedNops = 0,
+    ) {}
+
+    /**
+     * Checks whether any pass changed the body (and a new body was installed)
+     */
+    public function isChanged(): bool
+    {
+        return $this->foldedConstants + $this->eliminatedStores + $this->threadedJumps + $this->removedNops > 0;
+    }
+}
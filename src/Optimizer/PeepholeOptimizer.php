@@ -0,0 +1,507 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Optimizer;
+
+use ZEngine\Core;
+use ZEngine\Reflection\OpArrayRewriteException;
+use ZEngine\Reflection\ReflectionFunction;
+use ZEngine\Reflection\ReflectionMethod;
+use ZEngine\System\OpCode;
+use ZEngine\Type\OpLine;
+
+/**
+ * Local optimizations over the body of a live function, for code opcache never optimizes
+ *
+ * Closures that were addFunction()'d, addMethod()'d or redefine()'d at run time, and any code
+ * when opcache is off, execute the op_arrays the compiler emitted. This optimizer runs the
+ * cheap, local part of opcache's pipeline over such a body and installs the result through
+ * FunctionBodySwap:
+ *
+ *  - constant folding: an instruction whose operands are all literals is evaluated once, and
+ *    its only consumer reads the result as a literal instead of a temporary;
+ *  - dead-store elimination: a side-effect-free instruction whose temporary is only freed is
+ *    dropped, together with the FREE, and so is a boolean result nothing reads;
+ *  - jump threading: conditional jumps on a literal become a JMP or disappear, jumps to a JMP
+ *    go straight to its target, and jumps to the next instruction are dropped;
+ *  - NOP compaction: the NOPs the other passes (and the compiler) leave behind are removed.
+ *
+ * Passes repeat until nothing changes, so folding a comparison feeds jump threading, which in
+ * turn exposes more NOPs. Temporaries, CVs and run-time cache slots are never renumbered.
+ *
+ *     $report = (new PeepholeOptimizer())->optimize(ReflectionFunction::addFunction('render', $closure));
+ *
+ * Folding runs the operation in this process under an error handler that refuses anything
+ * emitting a diagnostic or throwing: the optimized function raises exactly what it raised
+ * before. Generator functions are refused (their suspended frames cannot be found); NOP
+ * compaction is skipped for bodies with a SWITCH/MATCH jump table, whose literal offsets pin
+ * the distances between instructions.
+ */
+final class PeepholeOptimizer
+{
+    /**
+     * IS_SMART_BRANCH_JMPZ | IS_SMART_BRANCH_JMPNZ: the comparison does not store its result,
+     * it jumps on behalf of the JMPZ/JMPNZ that follows
+     */
+    private const int SMART_BRANCH_MASK = (1 << 4) | (1 << 5);
+
+    private const int TEMPORARY = OpLine::IS_TMP_VAR | OpLine::IS_VAR;
+
+    /**
+     * Longest string a fold may produce, so that folding never bloats the literal table
+     */
+    private const int MAX_FOLDED_STRING_LENGTH = 4096;
+
+    /**
+     * Binary operations evaluated at optimization time; their handlers accept a literal on
+     * either side, but not on both (CONCAT has no CONST_CONST specialization)
+     */
+    private const array FOLDABLE_BINARY = [
+        OpCode::ADD                 => true,
+        OpCode::SUB                 => true,
+        OpCode::MUL                 => true,
+        OpCode::DIV                 => true,
+        OpCode::MOD                 => true,
+        OpCode::SL                  => true,
+        OpCode::SR                  => true,
+        OpCode::CONCAT              => true,
+        OpCode::FAST_CONCAT         => true,
+        OpCode::BW_OR               => true,
+        OpCode::BW_AND              => true,
+        OpCode::BW_XOR              => true,
+        OpCode::POW                 => true,
+        OpCode::BOOL_XOR            => true,
+        OpCode::IS_IDENTICAL        => true,
+        OpCode::IS_NOT_IDENTICAL    => true,
+        OpCode::IS_EQUAL            => true,
+        OpCode::IS_NOT_EQUAL        => true,
+        OpCode::IS_SMALLER          => true,
+        OpCode::IS_SMALLER_OR_EQUAL => true,
+        OpCode::SPACESHIP           => true,
+    ];
+
+    /**
+     * Unary operations evaluated at optimization time
+     */
+    private const array FOLDABLE_UNARY = [
+        OpCode::BW_NOT    => true,
+        OpCode::BOOL_NOT  => true,
+        OpCode::BOOL      => true,
+        OpCode::QM_ASSIGN => true,
+    ];
+
+    /**
+     * Consumers whose handler accepts a literal op1, besides the foldable operations
+     */
+    private const array CONST_OP1_CONSUMERS = [
+        OpCode::ECHO        => true,
+        OpCode::RETURN      => true,
+        OpCode::SEND_VAL    => true,
+        OpCode::SEND_VAL_EX => true,
+        OpCode::CAST        => true,
+        OpCode::JMPZ        => true,
+        OpCode::JMPNZ       => true,
+        OpCode::JMPZ_EX     => true,
+        OpCode::JMPNZ_EX    => true,
+    ];
+
+    /**
+     * Producers without side effects when their operands are literals or temporaries
+     */
+    private const array PURE_PRODUCERS = [
+        OpCode::QM_ASSIGN        => true,
+        OpCode::BOOL             => true,
+        OpCode::BOOL_NOT         => true,
+        OpCode::IS_IDENTICAL     => true,
+        OpCode::IS_NOT_IDENTICAL => true,
+    ];
+
+    /**
+     * @param int $maxRounds Upper bound of pass repetitions over one body
+     */
+    public function __construct(private readonly int $maxRounds = 8) {}
+
+    /**
+     * Optimizes the body of a user function and installs it when anything changed
+     *
+     * @throws OpArrayRewriteException When the function is internal, a generator, or executing
+     */
+    public function optimize(ReflectionFunction|ReflectionMethod $function): OptimizationReport
+    {
+        $name = $function instanceof ReflectionMethod
+            ? $function->class . '::' . $function->getName()
+            : $function->getName();
+        if ($function->isUserDefined() && ($function->getCommonPointer()->fn_flags & Core::ZEND_ACC_GENERATOR) !== 0) {
+            throw OpArrayRewriteException::generator($name);
+        }
+
+        $body   = OpArrayBody::fromFunction($function);
+        $report = $this->optimizeBody($body);
+        if ($report->isChanged()) {
+            $body->install($function);
+        }
+
+        return $report;
+    }
+
+    /**
+     * Runs the passes over a decoded body, without installing it
+     */
+    public function optimizeBody(OpArrayBody $body): OptimizationReport
+    {
+        $before = \count($body->instructions);
+        $folded = $eliminated = $threaded = 0;
+        for ($round = 0; $round < $this->maxRounds; $round++) {
+            $roundFolded     = $this->foldConstants($body);
+            $roundEliminated = $this->eliminateDeadStores($body);
+            $roundThreaded   = $this->threadJumps($body);
+            $folded         += $roundFolded;
+            $eliminated     += $roundEliminated;
+            $threaded       += $roundThreaded;
+            if ($roundFolded + $roundEliminated + $roundThreaded === 0) {
+                break;
+            }
+        }
+
+        $removedNops = 0;
+        if (!$body->hasJumpTables()) {
+            $nops = [];
+            foreach ($body->instructions as $index => $instruction) {
+                if ($instruction->isNop()) {
+                    $nops[] = $index;
+                }
+            }
+            $body->removeInstructions($nops);
+            $removedNops = \count($nops);
+        }
+
+        return new OptimizationReport(
+            oplinesBefore: $before,
+            oplinesAfter: \count($body->instructions),
+            foldedConstants: $folded,
+            eliminatedStores: $eliminated,
+            threadedJumps: $threaded,
+            removedNops: $removedNops,
+        );
+    }
+
+    /**
+     * Evaluates all-literal operations whose temporary has exactly one consumer able to read
+     * a literal instead
+     */
+    private function foldConstants(OpArrayBody $body): int
+    {
+        $folded = 0;
+        [$writers, $readers] = self::temporaryUses($body);
+        foreach ($body->instructions as $index => $producer) {
+            $isBinary = isset(self::FOLDABLE_BINARY[$producer->opcode]);
+            if (!$isBinary && !isset(self::FOLDABLE_UNARY[$producer->opcode])) {
+                continue;
+            }
+            if (($producer->resultType & ~self::SMART_BRANCH_MASK) !== OpLine::IS_TMP_VAR) {
+                continue;
+            }
+            $variable = $producer->result;
+            if (\count($writers[$variable] ?? []) !== 1 || \count($readers[$variable] ?? []) !== 1) {
+                continue;
+            }
+            if ($producer->op1Type !== OpLine::IS_CONST || ($isBinary && $producer->op2Type !== OpLine::IS_CONST)) {
+                continue;
+            }
+            [$consumerIndex, $operand] = $readers[$variable][0];
+            $consumer                  = $body->instructions[$consumerIndex];
+            if (!self::acceptsLiteral($consumer, $operand)) {
+                continue;
+            }
+            $op1 = $body->getLiteral($producer->op1);
+            $op2 = $isBinary ? $body->getLiteral($producer->op2) : null;
+            if ((!\is_scalar($op1) && $op1 !== null) || (!\is_scalar($op2) && $op2 !== null)) {
+                continue;
+            }
+            try {
+                $value = self::evaluate($producer->opcode, $op1, $op2);
+            } catch (\Throwable) {
+                // Division by zero, an invalid operand, a deprecation: left to run time
+                continue;
+            }
+            if (!\is_scalar($value) && $value !== null) {
+                continue;
+            }
+            if (\is_string($value) && \strlen($value) > self::MAX_FOLDED_STRING_LENGTH) {
+                continue;
+            }
+
+            $literal = $body->addLiteral($value);
+            if ($operand === 'op1') {
+                [$consumer->op1Type, $consumer->op1] = [OpLine::IS_CONST, $literal];
+            } else {
+                [$consumer->op2Type, $consumer->op2] = [OpLine::IS_CONST, $literal];
+            }
+            $producer->erase();
+            self::dropLiveRanges($body, $variable);
+            $folded++;
+        }
+
+        return $folded;
+    }
+
+    /**
+     * Drops side-effect-free instructions whose temporary is only freed, or never read at all
+     */
+    private function eliminateDeadStores(OpArrayBody $body): int
+    {
+        $eliminated = 0;
+        [$writers, $readers] = self::temporaryUses($body);
+        foreach ($body->instructions as $free) {
+            if ($free->opcode !== OpCode::FREE || $free->extendedValue !== 0 || ($free->op1Type & self::TEMPORARY) === 0) {
+                continue;
+            }
+            $variable = $free->op1;
+            if (\count($writers[$variable] ?? []) !== 1 || \count($readers[$variable] ?? []) !== 1) {
+                continue;
+            }
+            if (!self::erasePureProducer($body->instructions[$writers[$variable][0]])) {
+                continue;
+            }
+            $free->erase();
+            self::dropLiveRanges($body, $variable);
+            $eliminated++;
+        }
+
+        // The compiler frees no boolean result (zend_do_free()): an unread BOOL or BOOL_NOT is
+        // a dead store on its own
+        foreach ($body->instructions as $producer) {
+            if ($producer->opcode !== OpCode::BOOL && $producer->opcode !== OpCode::BOOL_NOT) {
+                continue;
+            }
+            $variable = $producer->result;
+            if ($producer->resultType !== OpLine::IS_TMP_VAR || \count($writers[$variable] ?? []) !== 1 || isset($readers[$variable])) {
+                continue;
+            }
+            if (!self::erasePureProducer($producer)) {
+                continue;
+            }
+            self::dropLiveRanges($body, $variable);
+            $eliminated++;
+        }
+
+        return $eliminated;
+    }
+
+    /**
+     * Erases a side-effect-free producer, keeping the release of a temporary operand
+     */
+    private static function erasePureProducer(Instruction $producer): bool
+    {
+        if (!isset(self::PURE_PRODUCERS[$producer->opcode]) || ($producer->resultType & self::SMART_BRANCH_MASK) !== 0) {
+            return false;
+        }
+        $isUnary = isset(self::FOLDABLE_UNARY[$producer->opcode]);
+        if ($producer->op1Type === OpLine::IS_CONST && ($isUnary || $producer->op2Type === OpLine::IS_CONST)) {
+            $producer->erase();
+        } elseif ($isUnary && ($producer->op1Type & self::TEMPORARY) !== 0) {
+            // The operand still has to be released, the operation on it does not
+            $operandType = $producer->op1Type;
+            $operand     = $producer->op1;
+            $producer->erase();
+            [$producer->opcode, $producer->op1Type, $producer->op1] = [OpCode::FREE, $operandType, $operand];
+        } else {
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * Resolves jumps on literals, follows jump chains and drops jumps to the next instruction
+     */
+    private function threadJumps(OpArrayBody $body): int
+    {
+        $threaded     = 0;
+        $instructions = $body->instructions;
+        [$writers]    = self::temporaryUses($body);
+        foreach ($instructions as $index => $jump) {
+            $isConditional = $jump->opcode === OpCode::JMPZ || $jump->opcode === OpCode::JMPNZ;
+            if ($jump->opcode !== OpCode::JMP && !$isConditional) {
+                continue;
+            }
+            $field = $isConditional ? 'op2' : 'op1';
+
+            if ($isConditional && $jump->op1Type === OpLine::IS_CONST) {
+                $taken  = (bool) $body->getLiteral($jump->op1) === ($jump->opcode === OpCode::JMPNZ);
+                $target = $jump->op2;
+                $jump->erase();
+                if ($taken) {
+                    [$jump->opcode, $jump->op1] = [OpCode::JMP, $target];
+                }
+                $threaded++;
+                continue;
+            }
+
+            $target  = $body->getJumpTarget($jump, $field);
+            $visited = [$index => true];
+            while (true) {
+                $target = self::skipNops($instructions, $target);
+                if ($instructions[$target]->opcode !== OpCode::JMP || isset($visited[$target])) {
+                    break;
+                }
+                $visited[$target] = true;
+                $target           = $instructions[$target]->op1;
+            }
+
+            if ($target === self::skipNops($instructions, $index + 1)) {
+                if (!$isConditional) {
+                    $jump->erase();
+                    $threaded++;
+                } elseif (($jump->op1Type & self::TEMPORARY) !== 0 && !self::isSmartBranchOperand($body, $writers, $jump->op1)) {
+                    // Both ways lead to the same instruction: only the condition has to be released
+                    [$operandType, $operand] = [$jump->op1Type, $jump->op1];
+                    $jump->erase();
+                    [$jump->opcode, $jump->op1Type, $jump->op1] = [OpCode::FREE, $operandType, $operand];
+                    $threaded++;
+                }
+                continue;
+            }
+            if ($target !== $body->getJumpTarget($jump, $field)) {
+                $body->setJumpTarget($jump, $field, $target);
+                $threaded++;
+            }
+        }
+
+        return $threaded;
+    }
+
+    /**
+     * Indexes every write and read of each temporary slot (TMP and VAR share the numbering)
+     *
+     * @return array{array<int, list<int>>, array<int, list<array{int, 'op1'|'op2'}>>}
+     */
+    private static function temporaryUses(OpArrayBody $body): array
+    {
+        $writers = $readers = [];
+        foreach ($body->instructions as $index => $instruction) {
+            if (($instruction->resultType & self::TEMPORARY) !== 0) {
+                $writers[$instruction->result][] = $index;
+            }
+            if (($instruction->op1Type & self::TEMPORARY) !== 0) {
+                $readers[$instruction->op1][] = [$index, 'op1'];
+            }
+            if (($instruction->op2Type & self::TEMPORARY) !== 0) {
+                $readers[$instruction->op2][] = [$index, 'op2'];
+            }
+        }
+
+        return [$writers, $readers];
+    }
+
+    /**
+     * Checks whether the handler of the consumer has a specialization reading a literal operand
+     *
+     * @param 'op1'|'op2' $operand
+     */
+    private static function acceptsLiteral(Instruction $consumer, string $operand): bool
+    {
+        if (isset(self::FOLDABLE_BINARY[$consumer->opcode])) {
+            $otherType = $operand === 'op1' ? $consumer->op2Type : $consumer->op1Type;
+
+            return $otherType !== OpLine::IS_CONST;
+        }
+
+        return match ($operand) {
+            'op1' => isset(self::FOLDABLE_UNARY[$consumer->opcode]) || isset(self::CONST_OP1_CONSUMERS[$consumer->opcode]),
+            'op2' => $consumer->opcode === OpCode::ASSIGN,
+        };
+    }
+
+    /**
+     * Evaluates one foldable operation; every diagnostic is turned into an exception
+     */
+    private static function evaluate(int $opcode, null|bool|int|float|string $op1, null|bool|int|float|string $op2): mixed
+    {
+        set_error_handler(static function (int $severity, string $message): never {
+            throw new \ErrorException($message, 0, $severity);
+        });
+        try {
+            return match ($opcode) {
+                OpCode::ADD                 => $op1 + $op2,
+                OpCode::SUB                 => $op1 - $op2,
+                OpCode::MUL                 => $op1 * $op2,
+                OpCode::DIV                 => $op1 / $op2,
+                OpCode::MOD                 => $op1 % $op2,
+                OpCode::SL                  => $op1 << $op2,
+                OpCode::SR                  => $op1 >> $op2,
+                OpCode::CONCAT,
+                OpCode::FAST_CONCAT         => $op1 . $op2,
+                OpCode::BW_OR               => $op1 | $op2,
+                OpCode::BW_AND              => $op1 & $op2,
+                OpCode::BW_XOR              => $op1 ^ $op2,
+                OpCode::POW                 => $op1 ** $op2,
+                OpCode::BOOL_XOR            => $op1 xor $op2,
+                OpCode::IS_IDENTICAL        => $op1 === $op2,
+                OpCode::IS_NOT_IDENTICAL    => $op1 !== $op2,
+                OpCode::IS_EQUAL            => $op1 == $op2,
+                OpCode::IS_NOT_EQUAL        => $op1 != $op2,
+                OpCode::IS_SMALLER          => $op1 < $op2,
+                OpCode::IS_SMALLER_OR_EQUAL => $op1 <= $op2,
+                OpCode::SPACESHIP           => $op1 <=> $op2,
+                OpCode::BW_NOT              => ~$op1,
+                OpCode::BOOL_NOT            => !$op1,
+                OpCode::BOOL                => (bool) $op1,
+                OpCode::QM_ASSIGN           => $op1,
+            };
+        } finally {
+            restore_error_handler();
+        }
+    }
+
+    /**
+     * A fused comparison jumps by itself and never stores the temporary its JMPZ/JMPNZ names
+     *
+     * @param array<int, list<int>> $writers
+     */
+    private static function isSmartBranchOperand(OpArrayBody $body, array $writers, int $variable): bool
+    {
+        foreach ($writers[$variable] ?? [] as $writer) {
+            if (($body->instructions[$writer]->resultType & self::SMART_BRANCH_MASK) !== 0) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * @param list<Instruction> $instructions
+     */
+    private static function skipNops(array $instructions, int $index): int
+    {
+        $last = \count($instructions) - 1;
+        while ($index < $last && $instructions[$index]->isNop()) {
+            $index++;
+        }
+
+        return $index;
+    }
+
+    /**
+     * Live ranges release a temporary when an exception unwinds past it; once its producer is
+     * gone there is nothing left to release
+     */
+    private static function dropLiveRanges(OpArrayBody $body, int $variable): void
+    {
+        $body->liveRanges = array_values(array_filter(
+            $body->liveRanges,
+            static fn(array $range): bool => ($range[0] & ~7) !== $variable,
+        ));
+    }
+}
@@ -0,0 +1,195 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Profiler;
+
+use ZEngine\Reflection\OpArrayRewriter;
+use ZEngine\Reflection\ReflectionFunction;
+use ZEngine\Reflection\ReflectionMethod;
+use ZEngine\System\OpCode;
+use ZEngine\Type\StringEntry;
+
+/**
+ * Execution counters compiled into the bytecode of the counted functions
+ *
+ * Every probe is a single ZEND_PRE_INC_STATIC_PROP opline inserted by OpArrayRewriter: it
+ * increments one static property of a holder class generated for the bank, with its own
+ * run-time cache slot, so after the first hit a probe costs one VM dispatch and an integer
+ * increment - no libffi crossing, no PHP callback. That makes it cheap enough for hot loops,
+ * where an opcode hook (Path A) would dominate the measured code.
+ *
+ * Probes go at function entry (after argument reception), on the taken edge of every loop
+ * back-edge, or before chosen oplines. The whole bank is read back in one call:
+ *
+ *     $counters = new BytecodeCounters();
+ *     $counters->instrument(new ReflectionFunction('hot'));
+ *     register_shutdown_function(static fn() => error_log(print_r($counters->read(), true)));
+ *
+ * The counters are request-scoped, like the generated holder class itself. The rewriting rules
+ * and their limits (live frames, generators, closures created earlier) are those of
+ * OpArrayRewriter.
+ */
+final class BytecodeCounters
+{
+    private const int CACHE_SLOTS_PER_PROBE = 3;
+
+    /**
+     * Lowercase name of the generated holder class (the name is its own lookup key)
+     */
+    private readonly string $holder;
+
+    /**
+     * Counter slot of every label
+     *
+     * @var array<string, int>
+     */
+    private array $labels = [];
+
+    /**
+     * Names of the instrumented functions
+     *
+     * @var array<string, true>
+     */
+    private array $instrumented = [];
+
+    public function __construct(private readonly int $capacity = 1024)
+    {
+        if ($capacity < 1) {
+            throw new \InvalidArgumentException('A counter bank needs at least one counter');
+        }
+        $this->holder = 'zengine_bytecode_counters_' . bin2hex(random_bytes(8));
+        $properties   = implode(', ', array_map(static fn(int $slot): string => "\$s{$slot} = 0", range(0, $capacity - 1)));
+        eval("final class {$this->holder} { public static {$properties}; }");
+    }
+
+    /**
+     * Inserts counters into a user function, returns the slot of every new label
+     *
+     * Labels are the function name (Class::method for methods) for the entry counter,
+     * "<name>@back-edge:<opline>" for each loop back-edge and "<name>@opline:<opline>" for
+     * each chosen opline, opline indexes referring to the body before instrumentation.
+     *
+     * @param list<int> $oplines Indexes of oplines to count right before they run
+     *
+     * @return array<string, int>
+     */
+    public function instrument(
+        ReflectionFunction|ReflectionMethod $function,
+        bool $entry = true,
+        bool $backEdges = true,
+        array $oplines = [],
+    ): array {
+        $name = $function instanceof ReflectionMethod
+            ? $function->class . '::' . $function->getName()
+            : $function->getName();
+        if (isset($this->instrumented[$name])) {
+            throw ProfilerException::alreadyInstrumented($name);
+        }
+        $rewriter = new OpArrayRewriter($function);
+        $edges    = $backEdges ? $rewriter->getBackEdges() : [];
+        $needed   = ($entry ? 1 : 0) + \count($edges) + \count($oplines);
+        if (\count($this->labels) + $needed > $this->capacity) {
+            throw ProfilerException::counterCapacityExhausted($this->capacity, $needed);
+        }
+
+        // ZEND_FETCH_STATIC_PROP_* reads the class name and its lowercase form from two
+        // consecutive literals: the holder name is lowercase already
+        $className = StringEntry::persistentInterned($this->holder);
+        $classPair = $rewriter->addStringLiteral($className);
+        $rewriter->addStringLiteral($className);
+
+        $labels = [];
+        $probe  = function (string $label) use ($rewriter, $classPair, &$labels): array {
+            $slot           = \count($this->labels) + \count($labels);
+            $labels[$label] = $slot;
+
+            return [
+                OpCode::PRE_INC_STATIC_PROP,
+                $rewriter->addStringLiteral(StringEntry::persistentInterned("s{$slot}")),
+                $classPair,
+                $rewriter->reserveCacheSlots(self::CACHE_SLOTS_PER_PROBE),
+            ];
+        };
+        if ($entry) {
+            // Jumps back to the first statement are loop iterations, not calls
+            $rewriter->insertBefore($rewriter->getEntryIndex(), ...$probe($name), landsJumps: false);
+        }
+        foreach ($edges as $jumpIndex) {
+            $rewriter->insertOnEdge($jumpIndex, ...$probe("{$name}@back-edge:{$jumpIndex}"));
+        }
+        foreach ($oplines as $index) {
+            $rewriter->insertBefore($index, ...$probe("{$name}@opline:{$index}"));
+        }
+        $rewriter->apply();
+
+        $this->labels             += $labels;
+        $this->instrumented[$name] = true;
+
+        return $labels;
+    }
+
+    /**
+     * Returns the current value of every counter by label
+     *
+     * @return array<string, int>
+     */
+    public function read(): array
+    {
+        $values   = $this->readSlots();
+        $counters = [];
+        foreach ($this->labels as $label => $slot) {
+            $counters[$label] = $values[$slot];
+        }
+
+        return $counters;
+    }
+
+    /**
+     * Returns the raw counter values indexed by slot
+     *
+     * @return list<int>
+     */
+    public function readSlots(): array
+    {
+        $values = [];
+        foreach ((new \ReflectionClass($this->holder))->getStaticProperties() as $value) {
+            $values[] = $value;
+        }
+
+        return \array_slice($values, 0, $this->getUsedSlots());
+    }
+
+    /**
+     * Zeroes every counter, probes stay in place
+     */
+    public function reset(): void
+    {
+        $holder = new \ReflectionClass($this->holder);
+        for ($slot = 0; $slot < $this->getUsedSlots(); $slot++) {
+            $holder->setStaticPropertyValue("s{$slot}", 0);
+        }
+    }
+
+    public function getCapacity(): int
+    {
+        return $this->capacity;
+    }
+
+    /**
+     * Returns the number of counters handed out so far
+     */
+    public function getUsedSlots(): int
+    {
+        return \count($this->labels);
+    }
+}
@@ -0,0 +1,120 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Profiler;
+
+use FFI\CData;
+use ZEngine\Core;
+use ZEngine\Generated\zend_function;
+use ZEngine\Generated\zend_string;
+
+/**
+ * Numbers the functions a profiler sees, by name, file and start line
+ *
+ * Names are resolved the first time a function shows up and memoized by the zend_function and
+ * name addresses, so a function that was seen costs one hash lookup. Nothing here throws for a
+ * well-formed zend_function: it runs inside hook callbacks, where throwing is a fatal error.
+ *
+ * @internal shared by SamplingProfiler and OpcodeCensus
+ */
+final class FunctionSymbolTable
+{
+    /**
+     * [name, file, start line] keyed by function id
+     *
+     * @var array<int, array{string, string, int}>
+     */
+    private array $functions = [];
+
+    /**
+     * Function ids keyed by "name\0file\0start line", so every copy of one closure shares an id
+     *
+     * @var array<string, int>
+     */
+    private array $functionIds = [];
+
+    /**
+     * Function ids keyed by "zend_function address:function_name address" - the fast path
+     *
+     * @var array<string, int>
+     */
+    private array $symbolCache = [];
+
+    /**
+     * Returns the id of a function, registering it on first sight
+     *
+     * @param CData|zend_function $function
+     */
+    public function idOf(object $function): int
+    {
+        $name      = $function->common->function_name;
+        $symbolKey = Core::pointerAddressOf($function) . ':' . ($name === null ? 0 : Core::pointerAddressOf($name));
+        if (isset($this->symbolCache[$symbolKey])) {
+            return $this->symbolCache[$symbolKey];
+        }
+
+        $functionName = $name === null ? '{main}' : self::stringOf($name);
+        $scope        = $function->common->scope;
+        if ($scope !== null) {
+            $functionName = self::stringOf($scope->name) . '::' . $functionName;
+        }
+        $fileName  = '';
+        $startLine = 0;
+        if ($function->type === Core::ZEND_USER_FUNCTION) {
+            $opArray   = $function->op_array;
+            $fileName  = $opArray->filename === null ? '' : self::stringOf($opArray->filename);
+            $startLine = $opArray->line_start;
+        }
+
+        return $this->symbolCache[$symbolKey] = $this->register($functionName, $fileName, $startLine);
+    }
+
+    /**
+     * Returns the id of a function given by its symbol, for pseudo frames
+     */
+    public function register(string $name, string $fileName, int $startLine): int
+    {
+        $identity = $name . "\0" . $fileName . "\0" . $startLine;
+        if (!isset($this->functionIds[$identity])) {
+            $functionId                   = \count($this->functions) + 1;
+            $this->functions[$functionId] = [$name, $fileName, $startLine];
+            $this->functionIds[$identity] = $functionId;
+        }
+
+        return $this->functionIds[$identity];
+    }
+
+    /**
+     * @return array<int, array{string, string, int}> [name, file, start line] keyed by function id
+     */
+    public function getFunctions(): array
+    {
+        return $this->functions;
+    }
+
+    /**
+     * Reads a zend_string without any throwing code path (see Compiler::getFileName())
+     *
+     * @param CData|zend_string $string
+     */
+    private static function stringOf(object $string): string
+    {
+        $length = $string->len;
+        if ($length < 1) {
+            return '';
+        }
+
+        // @phpstan-ignore argument.type (the char[1] element proxy is CData at runtime)
+        return \FFI::string(\FFI::addr($string->val[0]), $length);
+    }
+}
@@ -0,0 +1,150 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Profiler;
+
+use Closure;
+use FFI;
+
+/**
+ * CPU-time interval timer: setitimer(ITIMER_PROF) raises SIGPROF, ext-pcntl turns it into a call
+ *
+ * PHP exposes no sub-second timer, so the itimer is armed through a tiny libc binding of its
+ * own (setitimer() is resolved from the process image, like every other libc call). The kernel
+ * only counts CPU time the process spends, so a worker blocked on I/O receives no ticks - the
+ * profile answers "where is the CPU going", not "where is the wall clock going".
+ *
+ * Delivery goes through ext-pcntl's async signals: the C signal handler raises EG(vm_interrupt)
+ * and ext-pcntl's own zend_interrupt_function runs the PHP handler at the next interrupt check.
+ * Every interrupt hook installed after ext-pcntl therefore has to chain to it (see
+ * InterruptHook::proceed()), or the tick is never dispatched.
+ *
+ * Between ticks nothing of this runs: the kernel counts, the engine executes untouched.
+ */
+final class IntervalTimer
+{
+    /**
+     * which argument of setitimer() selecting the process CPU-time clock (Linux and Darwin agree)
+     */
+    private const int ITIMER_PROF = 2;
+
+    /**
+     * tv_usec is a long on Linux and an int (followed by padding) on Darwin: both little-endian
+     * targets see the same bytes for the sub-second values written here
+     */
+    private const string LIBC_DEFINITION = <<<'C'
+        struct zengine_timeval { long tv_sec; long tv_usec; };
+        struct zengine_itimerval { struct zengine_timeval it_interval; struct zengine_timeval it_value; };
+        int setitimer(int which, const struct zengine_itimerval *new_value, struct zengine_itimerval *old_value);
+        C;
+
+    private static ?FFI $libc = null;
+
+    private bool $running = false;
+
+    /**
+     * SIGPROF disposition found at start(), put back by stop()
+     */
+    private mixed $previousSignalHandler = null;
+
+    private bool $previousAsyncSignals = false;
+
+    /**
+     * @param Closure(): void $onTick Called from the signal dispatch, once per elapsed interval
+     */
+    public function __construct(
+        private readonly int $intervalMicroseconds,
+        private readonly Closure $onTick,
+    ) {
+        if ($intervalMicroseconds < 1) {
+            throw ProfilerException::invalidInterval($intervalMicroseconds);
+        }
+    }
+
+    /**
+     * Checks whether this process can run the timer (POSIX platform with ext-pcntl loaded)
+     */
+    public static function isAvailable(): bool
+    {
+        return \DIRECTORY_SEPARATOR === '/' && \function_exists('pcntl_signal') && \defined('SIGPROF');
+    }
+
+    public function start(): void
+    {
+        if ($this->running) {
+            throw ProfilerException::alreadyRunning();
+        }
+        if (!self::isAvailable()) {
+            throw ProfilerException::timerUnavailable();
+        }
+
+        $this->previousSignalHandler = pcntl_signal_get_handler(\SIGPROF);
+        $this->previousAsyncSignals  = pcntl_async_signals(true);
+        $onTick                      = $this->onTick;
+        pcntl_signal(\SIGPROF, static function () use ($onTick): void {
+            $onTick();
+        });
+        try {
+            $this->arm($this->intervalMicroseconds);
+        } catch (ProfilerException $e) {
+            $this->restoreSignalDisposition();
+
+            throw $e;
+        }
+        $this->running = true;
+    }
+
+    public function stop(): void
+    {
+        if (!$this->running) {
+            return;
+        }
+        $this->running = false;
+        $this->arm(0);
+        $this->restoreSignalDisposition();
+    }
+
+    public function isRunning(): bool
+    {
+        return $this->running;
+    }
+
+    /**
+     * Arms the itimer with the given period, zero disarms it
+     */
+    private function arm(int $intervalMicroseconds): void
+    {
+        self::$libc ??= FFI::cdef(self::LIBC_DEFINITION);
+
+        $value = self::$libc->new('struct zengine_itimerval');
+        $value->it_interval->tv_sec  = intdiv($intervalMicroseconds, 1_000_000);
+        $value->it_interval->tv_usec = $intervalMicroseconds % 1_000_000;
+        $value->it_value->tv_sec     = $value->it_interval->tv_sec;
+        $value->it_value->tv_usec    = $value->it_interval->tv_usec;
+
+        if (self::$libc->setitimer(self::ITIMER_PROF, FFI::addr($value), null) !== 0) {
+            throw ProfilerException::timerRejected();
+        }
+    }
+
+    private function restoreSignalDisposition(): void
+    {
+        pcntl_signal(\SIGPROF, $this->previousSignalHandler ?? \SIG_DFL);
+        pcntl_async_signals($this->previousAsyncSignals);
+    }
+
+    public function __destruct()
+    {
+        $this->stop();
+    }
+}
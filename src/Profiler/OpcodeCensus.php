@@ -0,0 +1,301 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Profiler;
+
+use ZEngine\Core;
+use ZEngine\System\ExecutionData;
+use ZEngine\System\HandlerRebind;
+use ZEngine\System\Hook\OpCodeHook;
+use ZEngine\System\OpCode;
+use ZEngine\Type\ConstantNames;
+
+/**
+ * Exact opcode and op_array execution counts for a time window
+ *
+ * Every counted opcode gets an opcode hook for the duration of the window, and every hit
+ * bumps two counters: the opcode's, and the executing op_array's. A call is counted when its
+ * op_array executes RETURN, RETURN_BY_REF or GENERATOR_RETURN, so "oplines per call" only
+ * covers calls that returned normally. The tables are keyed by opcode and by function, so
+ * their size depends on the code that ran, not on how long it ran.
+ *
+ * This is instrumentation, not sampling: every hit crosses into PHP, which makes the counted
+ * code several times slower. The window bounds that cost - the first hit after the deadline
+ * uninstalls every hook - so a census can run on a single production worker:
+ *
+ *     $census = OpcodeCensus::run(windowSeconds: 30.0);
+ *     // ... the worker keeps serving requests, the hooks are gone after 30 seconds ...
+ *     file_put_contents('/tmp/census.csv', $census->getResult()->toCsv());
+ *
+ * Opcode hooks only reach op_arrays compiled after their installation; pass the files whose
+ * code is already loaded to have it rebound (see HandlerRebind) at start and released at the
+ * end of the window. HANDLE_EXCEPTION and CATCH are never counted: they run while an exception
+ * is pending, when the engine refuses to call back into PHP.
+ */
+final class OpcodeCensus
+{
+    /**
+     * Opcodes that run with EG(exception) set, or never on their own
+     */
+    private const array UNCOUNTABLE_OPCODES = [
+        OpCode::HANDLE_EXCEPTION => true,
+        OpCode::CATCH            => true,
+        OpCode::USER_OPCODE      => true,
+        OpCode::OP_DATA          => true,
+    ];
+
+    /**
+     * Each completed call executes exactly one of these
+     */
+    private const array RETURN_OPCODES = [
+        OpCode::RETURN           => true,
+        OpCode::RETURN_BY_REF    => true,
+        OpCode::GENERATOR_RETURN => true,
+    ];
+
+    /**
+     * Counted opcodes
+     *
+     * @var list<int>
+     */
+    private readonly array $opCodes;
+
+    /**
+     * Installed hooks in installation order
+     *
+     * @var list<OpCodeHook>
+     */
+    private array $hooks = [];
+
+    /**
+     * Hits keyed by opcode
+     *
+     * @var array<int, int>
+     */
+    private array $opcodeHits = [];
+
+    private FunctionSymbolTable $symbols;
+
+    /**
+     * [oplines, calls] keyed by function id
+     *
+     * @var array<int, array{int, int}>
+     */
+    private array $functionCounts = [];
+
+    /**
+     * hrtime() of the end of the window, 0 while the window is open-ended
+     */
+    private int $deadline = 0;
+
+    private int $startedAt = 0;
+
+    private int $startedAtMonotonic = 0;
+
+    private int $runningNanos = 0;
+
+    /**
+     * Whether hits are counted: cleared by stop() even when a hook could not be uninstalled
+     */
+    private bool $counting = false;
+
+    /**
+     * Why the stop() at the end of the window failed, until a later stop() succeeds
+     */
+    private ?\Throwable $stopFailure = null;
+
+    /**
+     * @param list<int>|null $opCodes   OpCode::* constants to count, null for all of them
+     * @param list<string>   $fileNames Already compiled files to rebind for the window
+     */
+    public function __construct(?array $opCodes = null, private readonly array $fileNames = [])
+    {
+        $opCodes ??= array_keys(ConstantNames::of(OpCode::class));
+
+        $this->opCodes = array_values(array_filter(
+            $opCodes,
+            static fn(int $opCode): bool => !isset(self::UNCOUNTABLE_OPCODES[$opCode]),
+        ));
+        $this->symbols = new FunctionSymbolTable();
+    }
+
+    /**
+     * Starts a census that ends by itself after the given window
+     *
+     * @param list<int>|null $opCodes   OpCode::* constants to count, null for all of them
+     * @param list<string>   $fileNames Already compiled files to rebind for the window
+     */
+    public static function run(float $windowSeconds, ?array $opCodes = null, array $fileNames = []): self
+    {
+        $census = new self($opCodes, $fileNames);
+        $census->start($windowSeconds);
+
+        return $census;
+    }
+
+    /**
+     * Installs the hooks
+     *
+     * @param float $windowSeconds Length of the window, 0 to count until stop()
+     */
+    public function start(float $windowSeconds = 0.0): void
+    {
+        if ($this->hooks !== []) {
+            throw ProfilerException::alreadyRunning();
+        }
+        if ($windowSeconds < 0) {
+            throw new \InvalidArgumentException('The census window cannot be negative');
+        }
+
+        foreach ($this->opCodes as $opCode) {
+            $this->hooks[] = OpCode::setHandler(
+                $opCode,
+                fn(ExecutionData $scope): int => $this->onHit($opCode, $scope),
+            );
+        }
+        foreach ($this->fileNames as $fileName) {
+            HandlerRebind::rebindFile($fileName, $this->opCodes);
+        }
+        if ($this->startedAt === 0) {
+            $this->startedAt = (int) (microtime(true) * 1e9);
+        }
+        $this->startedAtMonotonic = hrtime(true);
+        $this->deadline           = $windowSeconds > 0 ? $this->startedAtMonotonic + (int) ($windowSeconds * 1e9) : 0;
+        $this->counting           = true;
+    }
+
+    /**
+     * Ends the window and uninstalls the hooks; the counts are kept
+     *
+     * Counting stops even when a hook cannot be uninstalled (another hook was stacked on a
+     * counted opcode): the hooks still installed stay in place and a later stop() retries them.
+     */
+    public function stop(): void
+    {
+        if ($this->counting) {
+            $this->runningNanos += hrtime(true) - $this->startedAtMonotonic;
+            $this->counting = false;
+        }
+        if ($this->hooks === []) {
+            return;
+        }
+        // Uninstalled in reverse order, each one leaves the list once it is gone
+        while ($this->hooks !== []) {
+            $this->hooks[array_key_last($this->hooks)]->uninstall();
+            array_pop($this->hooks);
+        }
+        foreach ($this->fileNames as $fileName) {
+            // Routes the rebound oplines back to their native handlers
+            HandlerRebind::rebindFile($fileName, $this->opCodes);
+        }
+        $this->stopFailure = null;
+    }
+
+    /**
+     * Checks whether hooks are installed (see getStopFailure() for a window that could not end)
+     */
+    public function isRunning(): bool
+    {
+        return $this->hooks !== [];
+    }
+
+    /**
+     * Returns why the hooks were left installed when the window ended, null when it ended cleanly
+     *
+     * Hits are no longer counted either way; call stop() once the stacked hook is gone.
+     */
+    public function getStopFailure(): ?\Throwable
+    {
+        return $this->stopFailure;
+    }
+
+    /**
+     * Returns a snapshot of everything counted so far
+     */
+    public function getResult(): OpcodeCensusResult
+    {
+        $runningNanos = $this->runningNanos;
+        if ($this->counting) {
+            $runningNanos += hrtime(true) - $this->startedAtMonotonic;
+        }
+
+        return new OpcodeCensusResult(
+            opcodes: $this->opcodeHits,
+            functions: $this->functionRows(),
+            startedAt: $this->startedAt,
+            durationNanos: $runningNanos,
+        );
+    }
+
+    /**
+     * Discards every count
+     */
+    public function reset(): void
+    {
+        $this->opcodeHits         = [];
+        $this->symbols            = new FunctionSymbolTable();
+        $this->functionCounts     = [];
+        $this->runningNanos       = 0;
+        $this->startedAt          = $this->counting ? (int) (microtime(true) * 1e9) : 0;
+        $this->startedAtMonotonic = hrtime(true);
+    }
+
+    /**
+     * Counts one hit; runs inside an FFI callback, so it never throws
+     */
+    private function onHit(int $opCode, ExecutionData $scope): int
+    {
+        if ($this->deadline !== 0 && hrtime(true) >= $this->deadline) {
+            $this->deadline = 0;
+            try {
+                $this->stop();
+            } catch (\Throwable $e) {
+                // Another hook was stacked on a counted opcode: counting ended, the remaining
+                // hooks stay until that hook is gone and stop() is called again
+                $this->stopFailure = $e;
+            }
+
+            return Core::ZEND_USER_OPCODE_DISPATCH;
+        }
+        if (!$this->counting) {
+            return Core::ZEND_USER_OPCODE_DISPATCH;
+        }
+
+        $this->opcodeHits[$opCode] = ($this->opcodeHits[$opCode] ?? 0) + 1;
+        $function                  = $scope->getRawFunction();
+        if ($function !== null) {
+            $functionId = $this->symbols->idOf($function);
+            $this->functionCounts[$functionId] ??= [0, 0];
+            $this->functionCounts[$functionId][0]++;
+            if (isset(self::RETURN_OPCODES[$opCode])) {
+                $this->functionCounts[$functionId][1]++;
+            }
+        }
+
+        return Core::ZEND_USER_OPCODE_DISPATCH;
+    }
+
+    /**
+     * @return list<array{string, string, int, int, int}> [name, file, start line, oplines, calls]
+     */
+    private function functionRows(): array
+    {
+        $rows = [];
+        foreach ($this->symbols->getFunctions() as $functionId => [$name, $fileName, $startLine]) {
+            [$oplines, $calls] = $this->functionCounts[$functionId] ?? [0, 0];
+            $rows[]            = [$name, $fileName, $startLine, $oplines, $calls];
+        }
+
+        return $rows;
+    }
+}
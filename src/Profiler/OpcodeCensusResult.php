@@ -0,0 +1,121 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Profiler;
+
+use ZEngine\System\OpCode;
+
+/**
+ * Immutable snapshot of the counts an OpcodeCensus collected
+ *
+ * Two tables: hits per opcode, and per function the number of oplines it executed and the
+ * number of calls that returned. toCsv() renders both into one table with a "kind" column,
+ * ready for a spreadsheet or `sort -t, -k5 -rn`.
+ */
+final readonly class OpcodeCensusResult
+{
+    public const array CSV_HEADER = ['kind', 'name', 'file', 'line', 'executed', 'calls', 'per_call'];
+
+    /**
+     * @param array<int, int>                            $opcodes       Hits keyed by opcode
+     * @param list<array{string, string, int, int, int}> $functions     [name, file, start line, oplines, calls]
+     * @param int                                        $startedAt     Wall-clock start, Unix nanoseconds
+     * @param int                                        $durationNanos Time the census was running
+     */
+    public function __construct(
+        public array $opcodes,
+        public array $functions,
+        public int $startedAt,
+        public int $durationNanos,
+    ) {}
+
+    /**
+     * Returns the total number of counted oplines
+     */
+    public function getExecutedOplines(): int
+    {
+        return array_sum($this->opcodes);
+    }
+
+    /**
+     * Returns the most executed opcodes, name => hits, most executed first
+     *
+     * @return array<string, int>
+     */
+    public function getTopOpcodes(int $limit = 20): array
+    {
+        $opcodes = $this->opcodes;
+        arsort($opcodes);
+
+        $top = [];
+        foreach (\array_slice($opcodes, 0, $limit, true) as $opCode => $hits) {
+            $top[OpCode::name($opCode)] = $hits;
+        }
+
+        return $top;
+    }
+
+    /**
+     * Returns the functions that executed the most oplines, hottest first
+     *
+     * @return list<array{string, string, int, int, int}> [name, file, start line, oplines, calls]
+     */
+    public function getHotFunctions(int $limit = 20): array
+    {
+        $functions = $this->functions;
+        usort($functions, static fn(array $left, array $right): int => $right[3] <=> $left[3]);
+
+        return \array_slice($functions, 0, $limit);
+    }
+
+    /**
+     * Returns the average number of oplines a returning call executed, over all functions
+     *
+     * Functions without a counted return (the window cut them, or they only threw) are left out.
+     */
+    public function getAverageOplinesPerCall(): float
+    {
+        $oplines = 0;
+        $calls   = 0;
+        foreach ($this->functions as [, , , $executed, $returned]) {
+            if ($returned > 0) {
+                $oplines += $executed;
+                $calls   += $returned;
+            }
+        }
+
+        return $calls === 0 ? 0.0 : $oplines / $calls;
+    }
+
+    /**
+     * Renders both tables as CSV (RFC 4180), opcodes first, each table sorted by executions
+     */
+    public function toCsv(): string
+    {
+        $stream = fopen('php://memory', 'w+');
+        assert($stream !== false);
+        fputcsv($stream, self::CSV_HEADER, escape: '');
+        foreach ($this->getTopOpcodes(\count($this->opcodes)) as $name => $hits) {
+            fputcsv($stream, ['opcode', $name, '', '', $hits, '', ''], escape: '');
+        }
+        foreach ($this->getHotFunctions(\count($this->functions)) as [$name, $file, $line, $executed, $calls]) {
+            $perCall = $calls === 0 ? '' : sprintf('%.1f', $executed / $calls);
+            fputcsv($stream, ['function', $name, $file, $line, $executed, $calls, $perCall], escape: '');
+        }
+        rewind($stream);
+        $csv = (string) stream_get_contents($stream);
+        fclose($stream);
+
+        return $csv;
+    }
+}
@@ -0,0 +1,146 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Profiler;
+
+/**
+ * Encodes a SampleProfile as a pprof Profile message (github.com/google/pprof, proto/profile.proto)
+ *
+ * Only the handful of protobuf wire features the message needs are implemented: varints and
+ * length-delimited fields, with repeated scalars packed. Two sample values are emitted per stack,
+ * "samples/count" and "cpu/nanoseconds" (count times the sampling period), which is what
+ * `go tool pprof` expects from a CPU profile.
+ *
+ * @internal use SampleProfile::toPprof()
+ */
+final class PprofEncoder
+{
+    private const int WIRE_VARINT = 0;
+
+    private const int WIRE_LENGTH_DELIMITED = 2;
+
+    /**
+     * Field numbers of the Profile message
+     */
+    private const int PROFILE_SAMPLE_TYPE    = 1;
+    private const int PROFILE_SAMPLE         = 2;
+    private const int PROFILE_LOCATION       = 4;
+    private const int PROFILE_FUNCTION       = 5;
+    private const int PROFILE_STRING_TABLE   = 6;
+    private const int PROFILE_TIME_NANOS     = 9;
+    private const int PROFILE_DURATION_NANOS = 10;
+    private const int PROFILE_PERIOD_TYPE    = 11;
+    private const int PROFILE_PERIOD         = 12;
+
+    /**
+     * String table being built; index 0 must be the empty string
+     *
+     * @var array<string, int>
+     */
+    private array $strings = ['' => 0];
+
+    private function __construct() {}
+
+    public static function encode(SampleProfile $profile): string
+    {
+        return new self()->encodeProfile($profile);
+    }
+
+    private function encodeProfile(SampleProfile $profile): string
+    {
+        $samples = $this->valueType('samples', 'count');
+        $cpu     = $this->valueType('cpu', 'nanoseconds');
+        $message = self::bytesField(self::PROFILE_SAMPLE_TYPE, $samples)
+            . self::bytesField(self::PROFILE_SAMPLE_TYPE, $cpu);
+
+        foreach ($profile->stacks as [$locationIds, $count]) {
+            $sample   = self::bytesField(1, self::packed($locationIds))
+                . self::bytesField(2, self::packed([$count, $count * $profile->periodNanos]));
+            $message .= self::bytesField(self::PROFILE_SAMPLE, $sample);
+        }
+        foreach ($profile->locations as $locationId => [$functionId, $line]) {
+            $lineMessage = self::varintField(1, $functionId) . self::varintField(2, $line);
+            $location    = self::varintField(1, $locationId) . self::bytesField(4, $lineMessage);
+            $message    .= self::bytesField(self::PROFILE_LOCATION, $location);
+        }
+        foreach ($profile->functions as $functionId => [$name, $file, $startLine]) {
+            $nameIndex = $this->stringIndex($name);
+            $function  = self::varintField(1, $functionId)
+                . self::varintField(2, $nameIndex)
+                . self::varintField(3, $nameIndex)
+                . self::varintField(4, $this->stringIndex($file))
+                . self::varintField(5, $startLine);
+            $message  .= self::bytesField(self::PROFILE_FUNCTION, $function);
+        }
+
+        $message .= self::varintField(self::PROFILE_TIME_NANOS, $profile->startedAt)
+            . self::varintField(self::PROFILE_DURATION_NANOS, $profile->durationNanos)
+            . self::bytesField(self::PROFILE_PERIOD_TYPE, $cpu)
+            . self::varintField(self::PROFILE_PERIOD, $profile->periodNanos);
+
+        // Emitted last: every string above has been interned by now
+        foreach (array_keys($this->strings) as $string) {
+            $message .= self::bytesField(self::PROFILE_STRING_TABLE, (string) $string);
+        }
+
+        return $message;
+    }
+
+    private function valueType(string $type, string $unit): string
+    {
+        return self::varintField(1, $this->stringIndex($type)) . self::varintField(2, $this->stringIndex($unit));
+    }
+
+    private function stringIndex(string $string): int
+    {
+        return $this->strings[$string] ??= count($this->strings);
+    }
+
+    private static function varintField(int $field, int $value): string
+    {
+        // proto3 omits default values
+        return $value === 0 ? '' : self::varint($field << 3 | self::WIRE_VARINT) . self::varint($value);
+    }
+
+    private static function bytesField(int $field, string $bytes): string
+    {
+        return self::varint($field << 3 | self::WIRE_LENGTH_DELIMITED) . self::varint(\strlen($bytes)) . $bytes;
+    }
+
+    /**
+     * @param list<int> $values
+     */
+    private static function packed(array $values): string
+    {
+        $bytes = '';
+        foreach ($values as $value) {
+            $bytes .= self::varint($value);
+        }
+
+        return $bytes;
+    }
+
+    /**
+     * Base-128 varint of a non-negative integer
+     */
+    private static function varint(int $value): string
+    {
+        $bytes = '';
+        while ($value > 0x7F) {
+            $bytes .= \chr(($value & 0x7F) | 0x80);
+            $value >>= 7;
+        }
+
+        return $bytes . \chr($value);
+    }
+}
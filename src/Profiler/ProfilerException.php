@@ -0,0 +1,53 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Profiler;
+
+/**
+ * Raised when a profiler cannot be started or driven in the current process
+ */
+final class ProfilerException extends \RuntimeException
+{
+    public static function timerUnavailable(): self
+    {
+        return new self(
+            'The SIGPROF interval timer needs a POSIX platform and ext-pcntl; '
+            . 'drive SamplingProfiler::requestSample() from your own timer instead',
+        );
+    }
+
+    public static function timerRejected(): self
+    {
+        return new self('setitimer(ITIMER_PROF) rejected the requested interval');
+    }
+
+    public static function alreadyRunning(): self
+    {
+        return new self('The profiler is already running');
+    }
+
+    public static function invalidInterval(int $intervalMicroseconds): self
+    {
+        return new self(sprintf('Sampling interval must be positive, %d microseconds given', $intervalMicroseconds));
+    }
+
+    public static function counterCapacityExhausted(int $capacity, int $requested): self
+    {
+        return new self(sprintf('%d more counters requested, the bank holds %d in total', $requested, $capacity));
+    }
+
+    public static function alreadyInstrumented(string $name): self
+    {
+        return new self(sprintf('%s is already instrumented by this counter bank', $name));
+    }
+}
@@ -0,0 +1,98 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Profiler;
+
+/**
+ * Immutable snapshot of the samples a SamplingProfiler aggregated
+ *
+ * The shape mirrors pprof's own tables, so both exports are straight projections: functions
+ * (name, file, first line) and locations (function plus executing line) are numbered from 1,
+ * and every distinct stack is one list of location ids, leaf first, with the number of samples
+ * that caught it.
+ */
+final readonly class SampleProfile
+{
+    /**
+     * @param array<int, array{string, string, int}> $functions        [name, file, start line] keyed by id
+     * @param array<int, array{int, int}>            $locations        [function id, line] keyed by id
+     * @param list<array{list<int>, int}>            $stacks           [location ids leaf first, samples]
+     * @param int                                    $periodNanos      CPU time one sample stands for
+     * @param int                                    $startedAt        Wall-clock start, Unix nanoseconds
+     * @param int                                    $durationNanos    Time the profiler was running
+     * @param int                                    $truncatedSamples Samples cut at the depth limit
+     */
+    public function __construct(
+        public array $functions,
+        public array $locations,
+        public array $stacks,
+        public int $periodNanos,
+        public int $startedAt,
+        public int $durationNanos,
+        public int $truncatedSamples,
+    ) {}
+
+    /**
+     * Returns the total number of samples taken
+     */
+    public function getSampleCount(): int
+    {
+        $total = 0;
+        foreach ($this->stacks as [, $count]) {
+            $total += $count;
+        }
+
+        return $total;
+    }
+
+    /**
+     * Renders the samples as folded stacks, the input format of flamegraph.pl and speedscope
+     *
+     * One line per distinct function-level stack, frames from the outermost to the innermost
+     * joined by ';', then a space and the sample count. Line numbers are dropped, so stacks that
+     * only differ in the executing line fold into one.
+     */
+    public function toFoldedStacks(): string
+    {
+        $folded = [];
+        foreach ($this->stacks as [$locationIds, $count]) {
+            $frames = [];
+            foreach (array_reverse($locationIds) as $locationId) {
+                [$functionId] = $this->locations[$locationId];
+                // ';' separates frames: it must not leak from a name
+                $frames[] = str_replace(';', '_', $this->functions[$functionId][0]);
+            }
+            $key          = implode(';', $frames);
+            $folded[$key] = ($folded[$key] ?? 0) + $count;
+        }
+
+        $output = '';
+        foreach ($folded as $stack => $count) {
+            $output .= $stack . ' ' . $count . "\n";
+        }
+
+        return $output;
+    }
+
+    /**
+     * Renders the samples as a gzip-compressed pprof profile (uncompressed without ext-zlib)
+     *
+     * @see PprofEncoder
+     */
+    public function toPprof(): string
+    {
+        $profile = PprofEncoder::encode($this);
+
+        return \function_exists('gzencode') ? (string) gzencode($profile) : $profile;
+    }
+}
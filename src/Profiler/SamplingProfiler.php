@@ -0,0 +1,282 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Profiler;
+
+use ZEngine\Core;
+use ZEngine\System\ExecutionData;
+use ZEngine\System\Hook\InterruptHook;
+
+/**
+ * Statistical profiler: samples the PHP stack at a fixed interval instead of instrumenting calls
+ *
+ * A tick (the SIGPROF IntervalTimer by default, or any caller of requestSample()) marks a sample
+ * as due and raises EG(vm_interrupt) through Executor::requestInterrupt(); the interrupt hook then
+ * walks the interrupted frame's ExecutionData::getPrevious() chain at the next VM interrupt
+ * check and aggregates the stack in memory. Nothing runs between ticks - no opcode hook, no
+ * per-call observer - so the overhead is proportional to the sampling rate, not to the work the
+ * process does, and it is cheap enough for live workers.
+ *
+ * The work per sample is bounded: at most $maxDepth frames are walked, and each frame costs a
+ * couple of field reads plus two hash lookups once its function was seen. Names are resolved
+ * the first time a function shows up in a sample and memoized by the zend_function and name
+ * addresses (FunctionSymbolTable), so the stored profile grows with the number of distinct stacks, not with the
+ * number of samples.
+ *
+ * Export with getProfile()->toFoldedStacks() (flamegraph.pl, speedscope) or ->toPprof()
+ * (`go tool pprof`).
+ *
+ * <span style="color:red; font-weight: bold">Warning!</span> Samples are taken inside an FFI
+ * callback, where throwing is a fatal engine error: a sample that fails is dropped and counted
+ * (getFailedSampleCount()) instead.
+ */
+final class SamplingProfiler
+{
+    public const int DEFAULT_INTERVAL_MICROSECONDS = 10_000;
+
+    public const int DEFAULT_MAX_DEPTH = 128;
+
+    /**
+     * Name of the pseudo frame on top of stacks cut at the depth limit
+     */
+    public const string TRUNCATED_FRAME = '[truncated]';
+
+    private ?InterruptHook $hook = null;
+
+    private ?IntervalTimer $timer = null;
+
+    /**
+     * Set by a tick, consumed by the next interrupt callback
+     */
+    private bool $sampleDue = false;
+
+    private FunctionSymbolTable $symbols;
+
+    /**
+     * [function id, line] keyed by location id
+     *
+     * @var array<int, array{int, int}>
+     */
+    private array $locations = [];
+
+    /**
+     * Location ids keyed by "function id:line"
+     *
+     * @var array<string, int>
+     */
+    private array $locationIds = [];
+
+    /**
+     * Sample counts keyed by the comma-joined location ids, leaf first
+     *
+     * @var array<string, int>
+     */
+    private array $stacks = [];
+
+    private int $truncatedSamples = 0;
+
+    private int $failedSamples = 0;
+
+    private int $startedAt = 0;
+
+    private int $startedAtMonotonic = 0;
+
+    private int $runningNanos = 0;
+
+    public function __construct(
+        private readonly int $intervalMicroseconds = self::DEFAULT_INTERVAL_MICROSECONDS,
+        private readonly int $maxDepth = self::DEFAULT_MAX_DEPTH,
+    ) {
+        if ($intervalMicroseconds < 1) {
+            throw ProfilerException::invalidInterval($intervalMicroseconds);
+        }
+        $this->symbols = new FunctionSymbolTable();
+    }
+
+    /**
+     * Installs the interrupt hook and, unless disabled, arms the SIGPROF interval timer
+     *
+     * @param bool $armTimer False to drive requestSample() from an external timer instead
+     */
+    public function start(bool $armTimer = true): void
+    {
+        if ($this->hook !== null) {
+            throw ProfilerException::alreadyRunning();
+        }
+        if ($armTimer && !IntervalTimer::isAvailable()) {
+            throw ProfilerException::timerUnavailable();
+        }
+
+        $this->hook = Core::setInterruptHandler($this->onInterrupt(...));
+        if ($armTimer) {
+            $this->timer = new IntervalTimer($this->intervalMicroseconds, $this->requestSample(...));
+            try {
+                $this->timer->start();
+            } catch (ProfilerException $e) {
+                $this->timer = null;
+                $this->hook->uninstall();
+                $this->hook = null;
+
+                throw $e;
+            }
+        }
+        if ($this->startedAt === 0) {
+            $this->startedAt = (int) (microtime(true) * 1e9);
+        }
+        $this->startedAtMonotonic = hrtime(true);
+    }
+
+    /**
+     * Disarms the timer and removes the interrupt hook; the collected samples are kept
+     */
+    public function stop(): void
+    {
+        if ($this->hook === null) {
+            return;
+        }
+        $this->timer?->stop();
+        $this->timer = null;
+        $this->hook->uninstall();
+        $this->hook          = null;
+        $this->sampleDue     = false;
+        $this->runningNanos += hrtime(true) - $this->startedAtMonotonic;
+    }
+
+    public function isRunning(): bool
+    {
+        return $this->hook !== null;
+    }
+
+    /**
+     * Schedules one sample of whatever stack is executing at the next VM interrupt check
+     *
+     * This is what the interval timer calls; it is a flag write plus one byte store into the
+     * executor globals, and therefore safe to call from a signal handler.
+     */
+    public function requestSample(): void
+    {
+        $this->sampleDue = true;
+        Core::$executor->requestInterrupt();
+    }
+
+    /**
+     * Returns a snapshot of everything sampled so far
+     */
+    public function getProfile(): SampleProfile
+    {
+        $stacks = [];
+        foreach ($this->stacks as $key => $count) {
+            $stacks[] = [array_map(intval(...), explode(',', (string) $key)), $count];
+        }
+        $runningNanos = $this->runningNanos;
+        if ($this->hook !== null) {
+            $runningNanos += hrtime(true) - $this->startedAtMonotonic;
+        }
+
+        return new SampleProfile(
+            functions: $this->symbols->getFunctions(),
+            locations: $this->locations,
+            stacks: $stacks,
+            periodNanos: $this->intervalMicroseconds * 1000,
+            startedAt: $this->startedAt,
+            durationNanos: $runningNanos,
+            truncatedSamples: $this->truncatedSamples,
+        );
+    }
+
+    /**
+     * Returns the number of samples dropped because walking their stack failed
+     */
+    public function getFailedSampleCount(): int
+    {
+        return $this->failedSamples;
+    }
+
+    /**
+     * Discards every collected sample and symbol
+     */
+    public function reset(): void
+    {
+        $this->symbols            = new FunctionSymbolTable();
+        $this->locations          = [];
+        $this->locationIds        = [];
+        $this->stacks             = [];
+        $this->truncatedSamples   = 0;
+        $this->failedSamples      = 0;
+        $this->runningNanos       = 0;
+        $this->startedAt          = $this->hook === null ? 0 : (int) (microtime(true) * 1e9);
+        $this->startedAtMonotonic = hrtime(true);
+    }
+
+    private function onInterrupt(InterruptHook $hook): void
+    {
+        if ($this->sampleDue) {
+            $this->sampleDue = false;
+            try {
+                $this->record($hook->getExecutionData());
+            } catch (\Throwable) {
+                $this->failedSamples++;
+            }
+        }
+        // ext-pcntl dispatches the SIGPROF handler from its own interrupt function: without this
+        // chain the next tick would never be delivered
+        if ($hook->hasOriginalHandler()) {
+            $hook->proceed();
+        }
+    }
+
+    private function record(ExecutionData $frame): void
+    {
+        $locationIds = [];
+        $depth       = 0;
+        while (true) {
+            $function = $frame->getRawFunction();
+            if ($function !== null) {
+                if ($depth === $this->maxDepth) {
+                    $locationIds[] = $this->locationOf($this->truncatedFunctionId(), 0);
+                    $this->truncatedSamples++;
+                    break;
+                }
+                $locationIds[] = $this->locationOf($this->symbols->idOf($function), $frame->getLine());
+                $depth++;
+            }
+            if (!$frame->hasPrevious()) {
+                break;
+            }
+            $frame = $frame->getPrevious();
+        }
+        if ($locationIds === []) {
+            return;
+        }
+
+        $key                = implode(',', $locationIds);
+        $this->stacks[$key] = ($this->stacks[$key] ?? 0) + 1;
+    }
+
+    private function truncatedFunctionId(): int
+    {
+        return $this->symbols->register(self::TRUNCATED_FRAME, '', 0);
+    }
+
+    private function locationOf(int $functionId, int $line): int
+    {
+        $locationKey = $functionId . ':' . $line;
+        if (!isset($this->locationIds[$locationKey])) {
+            $locationId                      = \count($this->locations) + 1;
+            $this->locations[$locationId]    = [$functionId, $line];
+            $this->locationIds[$locationKey] = $locationId;
+        }
+
+        return $this->locationIds[$locationKey];
+    }
+}
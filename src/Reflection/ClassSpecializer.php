@@ -1304,7 +1304,7 @@ class ClassSpecializer
             return;
         }
 
-        $copiedOpcodes = $this->duplicateOpcodes($opArrayCopy, $sourceOpArray, $total);
+        $copiedOpcodes = self::duplicateOpcodes($opArrayCopy, $sourceOpArray, $total);
         foreach ($patches as $index => [$newMask, $needsCheckingHandler]) {
             $patched = $copiedOpcodes[$index];
             assert($patched instanceof CData);
@@ -1423,8 +1423,11 @@ class ClassSpecializer
      * @return CData The copied zend_op[] block
      * @param \FFI\CData $opArrayCopy
      * @param \FFI\CData $sourceOpArray
+     *
+     * @internal shared with FunctionLikeTrait::rebindOpcodeHandlers(), which privatizes the body
+     *           of an opcache-shared function before rewriting its handlers
      */
-    private function duplicateOpcodes(object $opArrayCopy, object $sourceOpArray, int $total): object
+    public static function duplicateOpcodes(object $opArrayCopy, object $sourceOpArray, int $total): object
     {
         $sourceOpcodes = $sourceOpArray->opcodes;
         $totalLiterals = $sourceOpArray->last_literal;
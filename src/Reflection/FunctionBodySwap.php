@@ -35,7 +35,8 @@ use ZEngine\Type\StringEntry;
  *  - The entry gets a fresh HEAP_RT_CACHE run-time cache: the donor's cache is
  *    scope-dependent and owned by the donor; the engine frees a heap cache together
  *    with the entry (destroy_op_array), and every subsequent swap releases the
- *    previous one, so repeated swaps stay memory-flat.
+ *    previous one, so repeated swaps stay memory-flat. A batch of swaps carves its
+ *    caches out of one RunTimeCacheArena block instead.
  *  - Static variables never stay shared with a donor that owns them: a closure
  *    destroys its own static table when it dies, so the entry duplicates the
  *    defaults; the live per-entry table materializes lazily on the first
@@ -120,6 +121,8 @@ final class FunctionBodySwap
      *                                   (opcache shared memory is never freed)
      * @param int   $publishedShares     Number of table buckets pointing at this entry structure,
      *                                   see countPublishedShares()
+     * @param ?RunTimeCacheArena $cacheArena Block the fresh run-time cache is carved from (a batch
+     *                                       of swaps); null allocates an own heap cache
      *
      * @internal
      */
@@ -130,6 +133,7 @@ final class FunctionBodySwap
         bool $duplicateStatics,
         bool $destroyPrevious = true,
         int $publishedShares = 1,
+        ?RunTimeCacheArena $cacheArena = null,
     ): PendingBodySwap {
         assert($publishedShares >= 1);
         $entry        = $entryFunction->getEntryPointer();
@@ -173,7 +177,7 @@ final class FunctionBodySwap
         for ($share = 0; $share < $publishedShares; $share++) {
             self::addBodyReference($entryFunction);
         }
-        self::installFreshRunTimeCache($entryFunction);
+        self::installFreshRunTimeCache($entryFunction, $cacheArena);
         $previousMintedRecord = self::$mintedStaticDefaults[$entryAddress] ?? null;
         $mintedDefaults       = self::unshareStaticVariables($entryFunction, $duplicateStatics, $entryAddress);
 
@@ -359,14 +363,22 @@ final class FunctionBodySwap
      * property slots assume the donor's scope) and owned by the donor, so it must
      * never be shared. A heap cache (ZEND_ACC_HEAP_RT_CACHE) is released by
      * destroy_op_array together with the entry - and by the next swap's
-     * previous-body destruction, which keeps repeated swaps memory-flat.
+     * previous-body destruction, which keeps repeated swaps memory-flat. An arena
+     * cache is carved out of a batch block instead and is never freed on its own.
+     *
+     * @internal also used by OpArrayRewriter once it grew the cache of a rewritten body
      */
-    private static function installFreshRunTimeCache(FunctionLikeInterface $entryFunction): void
-    {
+    public static function installFreshRunTimeCache(
+        FunctionLikeInterface $entryFunction,
+        ?RunTimeCacheArena $cacheArena = null,
+    ): void {
         $opArray     = $entryFunction->getOpArrayPointer();
         $entryCommon = $entryFunction->getCommonPointer();
         $cacheSize   = $opArray->cache_size;
-        if ($cacheSize > 0) {
+        if ($cacheSize > 0 && $cacheArena !== null) {
+            $opArray->run_time_cache__ptr = $cacheArena->allocate($cacheSize);
+            $entryCommon->fn_flags &= (~Core::ZEND_ACC_HEAP_RT_CACHE);
+        } elseif ($cacheSize > 0) {
             // Request-allocator block handed over to the engine: destroy_op_array
             // releases it through efree, matching the allocation exactly
             $cache                        = Core::new("char[{$cacheSize}]", false);
@@ -512,8 +524,10 @@ final class FunctionBodySwap
      * (ReflectionFunction::getAddress()). Suspended frames that are not part of the
      * current stack (generators, fibers) cannot be discovered this way - see the
      * interaction notes in docs/hot-swap.md.
+     *
+     * @internal also used by OpArrayRewriter to refuse rewriting a running body
      */
-    private static function hasLiveFrame(int $entryAddress): bool
+    public static function hasLiveFrame(int $entryAddress): bool
     {
         $frame = Core::$executor->getExecutionState();
         while (true) {
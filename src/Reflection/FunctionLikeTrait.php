@@ -21,6 +21,9 @@ use ZEngine\Generated\zend_function_common;
 use ZEngine\Generated\zend_internal_function;
 use ZEngine\Generated\zend_op_array;
 use ZEngine\OpCache\SharedMemoryException;
+use ZEngine\Optimizer\Inliner;
+use ZEngine\System\HandlerRebind;
+use ZEngine\System\StatementStrip;
 use ZEngine\Type\ArgumentEntry;
 use ZEngine\Type\ClosureEntry;
 use ZEngine\Type\HashTable;
@@ -182,35 +185,29 @@ trait FunctionLikeTrait
      * which is copied out of shared memory the same way - see docs/hot-swap.md for
      * the matrix and the copy-out caveats.
      *
+     * The new body starts with an empty run-time cache; $warmup copies or prefills it before
+     * the first call (RunTimeCacheWarmer). Internal functions have no such cache.
+     *
      * @internal
      */
-    public function redefine(\Closure $newCode): void
+    public function redefine(\Closure $newCode, RunTimeCacheWarmup $warmup = RunTimeCacheWarmup::Cold): void
     {
-        $this->ensureCompatibleClosure($newCode);
-
         if (!$this->isInternal()) {
-            $selfExecutionState = Core::$executor->getExecutionState();
-            $newCodeEntry       = $selfExecutionState->getArgument(0)->getRawObject();
-            $closureEntry       = ClosureEntry::fromCData(Core::cast('zend_closure *', $newCodeEntry));
-            $newFunction        = $closureEntry->getRawFunction();
-
-            $isSharedMemoryEntry = $this->copyEntryOutOfSharedMemory();
-
-            $entryFunction = ReflectionFunction::fromCData($this->pointer);
-            $donorFunction = ReflectionFunction::fromCData(Core::addr($newFunction));
-            FunctionBodySwap::swapUserFunctionBody(
-                $entryFunction,
-                $donorFunction,
-                preserveDeclaration: true,
-                // The donor closure owns (and destroys) its static-variables table
-                duplicateStatics: true,
-                // A shared-memory body is immortal by definition and must not be freed
-                destroyPrevious: !$isSharedMemoryEntry,
-                // Subclass method tables may share this very structure - every such
-                // bucket releases one body reference when the engine destroys it
-                publishedShares: FunctionBodySwap::countPublishedShares($entryFunction),
-            )->commit();
+            $pending = $this->stageRedefinition($newCode);
+            try {
+                $pending->warmRunTimeCache($warmup);
+                // Inlined copies of the previous body go once the swap is staged; a caller
+                // with a live frame refuses the whole redefine
+                Inliner::revertCallersOf($this);
+            } catch (\Throwable $error) {
+                // Still staged: the entry goes back to its previous body like a failed batch
+                $pending->rollback();
+                throw $error;
+            }
+            $pending->commit();
+            Inliner::forgetCaller($this);
         } else {
+            $this->ensureCompatibleClosure($newCode);
             // For internal function we can simply adjust a handler
             /** @var zend_internal_function $internalEntry Internal entries hold the internal view */
             $internalEntry          = $this->pointer;
@@ -223,6 +220,47 @@ trait FunctionLikeTrait
         }
     }
 
+    /**
+     * Stages the body swap of redefine() and returns it uncommitted
+     *
+     * The entry already runs the new body when this returns; the caller commits or rolls
+     * back the handle while $newCode is still alive, and reverts inlined callers
+     * (Inliner::revertCallersOf()) before it commits. RedefinitionBatch stages many swaps
+     * this way and carves their run-time caches out of one $cacheArena.
+     *
+     * @throws \ReflectionException When the closure is incompatible or the function is internal
+     *
+     * @internal
+     */
+    public function stageRedefinition(\Closure $newCode, ?RunTimeCacheArena $cacheArena = null): PendingBodySwap
+    {
+        $this->ensureCompatibleClosure($newCode);
+        if ($this->isInternal()) {
+            throw new \ReflectionException("Internal function {$this->getName()} has no body to swap");
+        }
+        $closureEntry = new ClosureEntry($newCode);
+        $newFunction  = $closureEntry->getRawFunction();
+
+        $isSharedMemoryEntry = $this->copyEntryOutOfSharedMemory();
+
+        $entryFunction = ReflectionFunction::fromCData($this->pointer);
+        $donorFunction = ReflectionFunction::fromCData(Core::addr($newFunction));
+
+        return FunctionBodySwap::swapUserFunctionBody(
+            $entryFunction,
+            $donorFunction,
+            preserveDeclaration: true,
+            // The donor closure owns (and destroys) its static-variables table
+            duplicateStatics: true,
+            // A shared-memory body is immortal by definition and must not be freed
+            destroyPrevious: !$isSharedMemoryEntry,
+            // Subclass method tables may share this very structure - every such
+            // bucket releases one body reference when the engine destroys it
+            publishedShares: FunctionBodySwap::countPublishedShares($entryFunction),
+            cacheArena: $cacheArena,
+        );
+    }
+
     /**
      * Copies an opcache-shared (ZEND_ACC_IMMUTABLE) entry out of shared memory and
      * rebinds this reflection to the writable entry now published in its table
@@ -390,6 +428,72 @@ trait FunctionLikeTrait
         return $opCodes;
     }
 
+    /**
+     * Rewrites the EXT_STMT oplines of this function to NOP, so a statement hook stops firing here
+     *
+     * The opline handlers are re-baked as well, the VM stops dispatching the stripped
+     * statements to the user opcode handler right away (see StatementStrip). Closures
+     * declared inside this function are separate op_arrays and keep their statements.
+     *
+     * @return int Number of stripped statements (zero when already stripped)
+     *
+     * @throws SharedMemoryException When the opcodes live in opcache shared memory
+     */
+    public function stripStatementHooks(): int
+    {
+        if ($this->isImmutable()) {
+            throw SharedMemoryException::immutableOpcodesMutation($this->getName());
+        }
+
+        return StatementStrip::strip($this->getOpArrayPointer());
+    }
+
+    /**
+     * Puts back the EXT_STMT oplines stripStatementHooks() removed
+     *
+     * @return int Number of restored statements
+     */
+    public function restoreStatementHooks(): int
+    {
+        if (!$this->isUserDefined()) {
+            return 0;
+        }
+
+        return StatementStrip::restore($this->getOpArrayPointer());
+    }
+
+    /**
+     * Re-derives the baked handlers of this function's oplines of the given opcodes
+     *
+     * Call it after OpCode::setHandler() to route already compiled code to the new user
+     * handler, and after uninstalling that hook to release the code again (see HandlerRebind).
+     * An opcache-shared entry is first copied out of shared memory and its opcodes moved to a
+     * private request-memory block, so only this worker's copy is instrumented; that body
+     * stays private for the rest of the request.
+     *
+     * @param int ...$opCodes One or more OpCode::* constants
+     *
+     * @return int Number of rebound oplines
+     *
+     * @throws SharedMemoryException When the entry cannot be copied out of shared memory
+     */
+    public function rebindOpcodeHandlers(int ...$opCodes): int
+    {
+        if (!$this->isUserDefined() || $opCodes === []) {
+            return 0;
+        }
+        if ($this->copyEntryOutOfSharedMemory()) {
+            // The copied-out entry still executes the shared opcodes: give it its own block,
+            // relocated from a snapshot of the op_array so the copy is checked against the source
+            $opArray = $this->getOpArrayPointer();
+            $source  = Core::new(zend_op_array::class);
+            Core::memcpy($source, $opArray, Core::sizeOfType(zend_op_array::class));
+            ClassSpecializer::duplicateOpcodes($opArray, $source, $opArray->last);
+        }
+
+        return HandlerRebind::rebind($this->getOpArrayPointer(), array_values($opCodes));
+    }
+
     /**
      * Returns the names of the compiled variables (CV slots) of this function
      *
@@ -0,0 +1,67 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Reflection;
+
+/**
+ * Thrown when an op_array cannot be rewritten safely
+ *
+ * Every refusal happens BEFORE the op_array is touched: a failed OpArrayRewriter::apply()
+ * leaves the function executing its previous body.
+ */
+final class OpArrayRewriteException extends \ReflectionException
+{
+    public static function internalFunction(string $name): self
+    {
+        return new self(sprintf('Internal function %s has no op_array to rewrite', $name));
+    }
+
+    public static function unsupportedPosition(string $name, int $index, string $reason): self
+    {
+        return new self(sprintf('Cannot insert before opline #%d of %s: %s', $index, $name, $reason));
+    }
+
+    public static function notALoopJump(string $name, int $index): self
+    {
+        return new self(sprintf('Opline #%d of %s is not a JMP, JMPZ or JMPNZ', $index, $name));
+    }
+
+    public static function shiftedJumpTable(string $name, int $index): self
+    {
+        return new self(sprintf(
+            'The jump table of opline #%d of %s would need to be rebuilt, insert outside of the switch/match',
+            $index,
+            $name,
+        ));
+    }
+
+    public static function liveFrame(string $name): self
+    {
+        return new self(sprintf('%s is executing on the current call stack', $name));
+    }
+
+    public static function generator(string $name): self
+    {
+        return new self(sprintf('%s is a generator function, its suspended frames cannot be found', $name));
+    }
+
+    public static function sharedCallSites(string $name): self
+    {
+        return new self(sprintf('%s is called from opcache shared memory with a fixed frame size', $name));
+    }
+
+    public static function alreadyApplied(): self
+    {
+        return new self('The rewrite was already applied, create a new rewriter for the rewritten body');
+    }
+}
@@ -0,0 +1,625 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Reflection;
+
+use FFI\CData;
+use ZEngine\Core;
+use ZEngine\Generated\zend_live_range;
+use ZEngine\Generated\zend_op;
+use ZEngine\Generated\zend_try_catch_element;
+use ZEngine\Generated\zval;
+use ZEngine\System\HandlerRebind;
+use ZEngine\System\OpCode;
+use ZEngine\Type\OpLine;
+use ZEngine\Type\StringEntry;
+
+/**
+ * Inserts VM oplines into a compiled user function
+ *
+ * Instrumentation through opcode hooks (Path A, docs/memory-model.md) pays a libffi crossing on
+ * every hit. An inserted opline costs one VM dispatch instead: the rewritten function runs at
+ * native VM speed, and the data it produces (counters, flags) lives in ordinary engine
+ * structures that are read in bulk afterwards.
+ *
+ * Insertions are collected first and applied at once. apply() lays out a new opcodes+literals
+ * block exactly like pass_two() does (literals right after the 16-aligned opcodes), copies the
+ * old oplines into it, rebases every IS_CONST operand and every jump, remaps the live ranges
+ * and the try/catch table, bakes the handlers of the new oplines and grows the run-time cache
+ * by the slots reserved for them. An opcache-shared function is copied out of shared memory
+ * first, the shared body itself is never written.
+ *
+ * Two kinds of insertion exist:
+ *  - insertBefore() runs the new oplines right before a given opline. By default jumps to
+ *    that opline land on the new oplines too; a probe that must run on fall-through only
+ *    (the entry of a function whose first statement is a loop) opts out.
+ *  - insertOnEdge() runs the new oplines only when a given JMP/JMPZ/JMPNZ is taken: the jump
+ *    is retargeted to a block appended after the last opline, which runs the insertion and
+ *    jumps on to the original target. This is how a loop back-edge is counted without
+ *    touching the comparison that feeds the jump (a smart branch reads the jump opline that
+ *    follows it, nothing may be placed between them).
+ *
+ * Oplines are addressed by their index in the current body. A rewrite is refused when any
+ * frame of the current call stack executes the function: the frame holds pointers into the
+ * previous block. Suspended generators and fibers cannot be discovered that way, the same
+ * caveat as for body swaps (docs/hot-swap.md); never rewrite a generator function that has
+ * live instances. Closure objects created before the rewrite keep their own copy of the
+ * op_array and keep executing the previous block, which is therefore never freed.
+ */
+final class OpArrayRewriter
+{
+    /**
+     * IS_SMART_BRANCH_JMPZ | IS_SMART_BRANCH_JMPNZ: the result of a comparison fused with the
+     * jump that follows it
+     */
+    private const int SMART_BRANCH_MASK = (1 << 4) | (1 << 5);
+
+    /**
+     * ZEND_LAST_CATCH: the last CATCH of a try block has no "next catch" jump in op2
+     */
+    private const int LAST_CATCH = 1;
+
+    private const array CONSTANT_OPERAND_FIELDS = [
+        'op1_type'    => 'op1',
+        'op2_type'    => 'op2',
+        'result_type' => 'result',
+    ];
+
+    /**
+     * Opcodes whose op1 is a jump offset
+     */
+    private const array OP1_JUMPS = [
+        OpCode::JMP       => true,
+        OpCode::FAST_CALL => true,
+    ];
+
+    /**
+     * Opcodes whose op2 is a jump offset (CATCH only when it is not the last catch)
+     */
+    private const array OP2_JUMPS = [
+        OpCode::JMPZ                    => true,
+        OpCode::JMPNZ                   => true,
+        OpCode::JMPZ_EX                 => true,
+        OpCode::JMPNZ_EX                => true,
+        OpCode::JMP_SET                 => true,
+        OpCode::COALESCE                => true,
+        OpCode::JMP_NULL                => true,
+        OpCode::FE_RESET_R              => true,
+        OpCode::FE_RESET_RW             => true,
+        OpCode::ASSERT_CHECK            => true,
+        OpCode::BIND_INIT_STATIC_OR_JMP => true,
+        OpCode::JMP_FRAMELESS           => true,
+        OpCode::CATCH                   => true,
+    ];
+
+    /**
+     * Opcodes whose extended_value is a jump offset (the default target of a jump table)
+     */
+    private const array EXTENDED_VALUE_JUMPS = [
+        OpCode::FE_FETCH_R    => true,
+        OpCode::FE_FETCH_RW   => true,
+        OpCode::SWITCH_LONG   => true,
+        OpCode::SWITCH_STRING => true,
+        OpCode::MATCH         => true,
+    ];
+
+    /**
+     * Jumps that close a loop, with the operand holding their target
+     */
+    private const array LOOP_JUMPS = [
+        OpCode::JMP   => 'op1',
+        OpCode::JMPZ  => 'op2',
+        OpCode::JMPNZ => 'op2',
+    ];
+
+    private readonly string $name;
+
+    private readonly int $opcodeSize;
+
+    /**
+     * Number of oplines of the body the insertions refer to
+     */
+    private readonly int $total;
+
+    /**
+     * Pending insertions by the index of the opline they run before
+     *
+     * @var array<int, list<array{opcode: int, op1: ?int, op2: ?int, extendedValue: int, landsJumps: bool}>>
+     */
+    private array $insertions = [];
+
+    /**
+     * Pending insertions by the index of the jump whose taken edge runs them
+     *
+     * @var array<int, list<array{opcode: int, op1: ?int, op2: ?int, extendedValue: int, landsJumps: bool}>>
+     */
+    private array $edgeInsertions = [];
+
+    /**
+     * Strings appended to the literal table, in literal order
+     *
+     * @var list<StringEntry>
+     */
+    private array $literals = [];
+
+    private int $reservedCacheSize = 0;
+
+    private bool $applied = false;
+
+    public function __construct(private readonly ReflectionFunction|ReflectionMethod $function)
+    {
+        $this->name = $function instanceof ReflectionMethod
+            ? $function->class . '::' . $function->getName()
+            : $function->getName();
+        if (!$function->isUserDefined()) {
+            throw OpArrayRewriteException::internalFunction($this->name);
+        }
+        $this->opcodeSize = Core::sizeOfType(zend_op::class);
+        $this->total      = $function->getOpArrayPointer()->last;
+    }
+
+    /**
+     * Returns the number of oplines of the body being rewritten
+     */
+    public function getLength(): int
+    {
+        return $this->total;
+    }
+
+    /**
+     * Returns the index of the first opline after argument reception (RECV, RECV_INIT, RECV_VARIADIC)
+     *
+     * The engine skips the RECV oplines of arguments that were passed, so this is the first
+     * opline every call executes.
+     */
+    public function getEntryIndex(): int
+    {
+        $index = 0;
+        while ($index < $this->total) {
+            $opcode = $this->opline($index)->opcode;
+            if ($opcode !== OpCode::RECV && $opcode !== OpCode::RECV_INIT && $opcode !== OpCode::RECV_VARIADIC) {
+                break;
+            }
+            $index++;
+        }
+
+        return $index;
+    }
+
+    /**
+     * Returns the indexes of the JMP/JMPZ/JMPNZ oplines that jump backwards (loop back-edges)
+     *
+     * @return list<int>
+     */
+    public function getBackEdges(): array
+    {
+        $backEdges = [];
+        for ($index = 0; $index < $this->total; $index++) {
+            $opline = $this->opline($index);
+            $field  = self::LOOP_JUMPS[$opline->opcode] ?? null;
+            if ($field !== null && $this->jumpTarget($index, $opline->{$field}->num) <= $index) {
+                $backEdges[] = $index;
+            }
+        }
+
+        return $backEdges;
+    }
+
+    /**
+     * Appends a string to the literal table, returns its literal index
+     *
+     * Literals appended one after the other get consecutive indexes (an opcode that reads a
+     * class name pair, such as the *_STATIC_PROP family, expects the lowercase name right
+     * after the original one).
+     *
+     * @param StringEntry $string Interned string (StringEntry::persistentInterned()): literals
+     *                            are never released separately from the op_array
+     */
+    public function addStringLiteral(StringEntry $string): int
+    {
+        if (!$string->isInterned()) {
+            throw new \InvalidArgumentException('Only interned strings can be added as literals');
+        }
+        $this->literals[] = $string;
+
+        return $this->function->getOpArrayPointer()->last_literal + \count($this->literals) - 1;
+    }
+
+    /**
+     * Reserves pointer slots in the run-time cache, returns the byte offset of the first one
+     *
+     * The offset goes into the extended_value (or the operand) of the inserted opline that
+     * caches there, exactly like the compiler's zend_alloc_cache_slots().
+     */
+    public function reserveCacheSlots(int $count): int
+    {
+        $offset                   = $this->function->getOpArrayPointer()->cache_size + $this->reservedCacheSize;
+        $this->reservedCacheSize += $count * \PHP_INT_SIZE;
+
+        return $offset;
+    }
+
+    /**
+     * Inserts one opline before the given one
+     *
+     * @param int      $index         Index of the opline in the current body
+     * @param int      $opcode        OpCode::* constant
+     * @param int|null $op1Literal    Literal index of a CONST op1 (null for UNUSED)
+     * @param int|null $op2Literal    Literal index of a CONST op2 (null for UNUSED)
+     * @param bool     $landsJumps    Whether jumps to $index run the inserted opline as well
+     */
+    public function insertBefore(
+        int $index,
+        int $opcode,
+        ?int $op1Literal = null,
+        ?int $op2Literal = null,
+        int $extendedValue = 0,
+        bool $landsJumps = true,
+    ): void {
+        $this->assertPending();
+        if ($index < $this->getEntryIndex() || $index >= $this->total) {
+            throw OpArrayRewriteException::unsupportedPosition($this->name, $index, 'outside of the function body');
+        }
+        if ($this->opline($index)->opcode === OpCode::OP_DATA) {
+            throw OpArrayRewriteException::unsupportedPosition($this->name, $index, 'OP_DATA belongs to the previous opline');
+        }
+        if ($this->opline($index)->opcode === OpCode::CATCH) {
+            throw OpArrayRewriteException::unsupportedPosition($this->name, $index, 'a CATCH must start its handler');
+        }
+        if ($index > 0 && ($this->opline($index - 1)->result_type & self::SMART_BRANCH_MASK) !== 0) {
+            throw OpArrayRewriteException::unsupportedPosition($this->name, $index, 'the previous opline is a smart branch');
+        }
+        $this->insertions[$index][] = [
+            'opcode'        => $opcode,
+            'op1'           => $op1Literal,
+            'op2'           => $op2Literal,
+            'extendedValue' => $extendedValue,
+            'landsJumps'    => $landsJumps,
+        ];
+    }
+
+    /**
+     * Inserts one opline on the taken edge of a JMP, JMPZ or JMPNZ
+     *
+     * @see insertBefore() for the arguments
+     */
+    public function insertOnEdge(
+        int $jumpIndex,
+        int $opcode,
+        ?int $op1Literal = null,
+        ?int $op2Literal = null,
+        int $extendedValue = 0,
+    ): void {
+        $this->assertPending();
+        if ($jumpIndex < 0 || $jumpIndex >= $this->total || !isset(self::LOOP_JUMPS[$this->opline($jumpIndex)->opcode])) {
+            throw OpArrayRewriteException::notALoopJump($this->name, $jumpIndex);
+        }
+        $this->edgeInsertions[$jumpIndex][] = [
+            'opcode'        => $opcode,
+            'op1'           => $op1Literal,
+            'op2'           => $op2Literal,
+            'extendedValue' => $extendedValue,
+            'landsJumps'    => false,
+        ];
+    }
+
+    /**
+     * Lays the rewritten body out and publishes it in the function
+     */
+    public function apply(): void
+    {
+        $this->assertPending();
+        if (FunctionBodySwap::hasLiveFrame($this->function->getAddress())) {
+            throw OpArrayRewriteException::liveFrame($this->name);
+        }
+        [$newIndex, $landing, $edgeStart, $newTotal] = $this->layout();
+        $this->assertJumpTablesKeepDistances($newIndex, $landing);
+
+        $this->function->copyEntryOutOfSharedMemory();
+        $opArray = $this->function->getOpArrayPointer();
+        assert(($opArray->fn_flags & Core::ZEND_ACC_DONE_PASS_TWO) !== 0);
+
+        $zvalSize        = Core::sizeOfType(zval::class);
+        $oldLiteralCount = $opArray->last_literal;
+        $literalCount    = $oldLiteralCount + \count($this->literals);
+
+        // ZEND_MM_ALIGNED_SIZE_EX(sizeof(zend_op) * last, 16): the layout pass_two() produces,
+        // destroy_op_array() releases opcodes and literals as this one block
+        $literalsOffset = ($newTotal * $this->opcodeSize + 15) & ~15;
+        $memory         = Core::new('char[' . ($literalsOffset + $literalCount * $zvalSize) . ']', false);
+        $opcodes        = Core::cast('zend_op *', $memory);
+        $base           = Core::addressOf($opcodes);
+        $literalsBase   = $base + $literalsOffset;
+
+        $oldOpcodes  = $opArray->opcodes;
+        $oldBase     = Core::addressOf($oldOpcodes);
+        $oldLiterals = 0;
+        if ($oldLiteralCount > 0) {
+            $oldLiterals = Core::addressOf($opArray->literals);
+            // A shallow copy: the literals change owner, the old block is never destroyed
+            Core::memcpy(Core::pointerAtAddress('zval *', $literalsBase), $opArray->literals, $oldLiteralCount * $zvalSize);
+        }
+        foreach ($this->literals as $offset => $string) {
+            $literal = Core::pointerAtAddress('zval *', $literalsBase + ($oldLiteralCount + $offset) * $zvalSize);
+            // Interned strings are not refcounted: the type info carries no flags
+            $literal->value->str    = $string->getRawValue();
+            $literal->u1->type_info = ReflectionValue::IS_STRING;
+        }
+
+        $constantOffset = fn(int $literalIndex, int $position): int
+            => ($literalsBase + $literalIndex * $zvalSize - ($base + $position * $this->opcodeSize)) & 0xFFFFFFFF;
+        $jumpOffset     = fn(int $target, int $position): int
+            => (($target - $position) * $this->opcodeSize) & 0xFFFFFFFF;
+
+        for ($index = 0; $index < $this->total; $index++) {
+            $position = $newIndex[$index] - \count($this->insertions[$index] ?? []);
+            foreach ($this->insertions[$index] ?? [] as $insertion) {
+                $this->emit($opcodes[$position], $insertion, $constantOffset, $position, $oldOpcodes[$index]->lineno);
+                $position++;
+            }
+
+            $opline = $opcodes[$position];
+            Core::memcpy(Core::addr($opline), Core::addr($oldOpcodes[$index]), $this->opcodeSize);
+            foreach (self::CONSTANT_OPERAND_FIELDS as $typeField => $operandField) {
+                if ($opline->{$typeField} === OpLine::IS_CONST) {
+                    $operand           = $opline->{$operandField};
+                    $literalAddress    = $oldBase + $index * $this->opcodeSize + self::signed($operand->constant);
+                    $literalIndex      = intdiv($literalAddress - $oldLiterals, $zvalSize);
+                    $operand->constant = $constantOffset($literalIndex, $position);
+                }
+            }
+            foreach (self::jumpFields($opline) as $field) {
+                $offset = $field === 'extended_value' ? $opline->extended_value : $opline->{$field}->num;
+                $target = isset($edgeStart[$index]) && self::LOOP_JUMPS[$opline->opcode] === $field
+                    ? $edgeStart[$index]
+                    : $landing[$this->jumpTarget($index, $offset)];
+                if ($field === 'extended_value') {
+                    $opline->extended_value = $jumpOffset($target, $position);
+                } else {
+                    $opline->{$field}->num = $jumpOffset($target, $position);
+                }
+            }
+        }
+
+        foreach ($this->edgeInsertions as $jumpIndex => $insertions) {
+            $position = $edgeStart[$jumpIndex];
+            $jump     = $oldOpcodes[$jumpIndex];
+            foreach ($insertions as $insertion) {
+                $this->emit($opcodes[$position], $insertion, $constantOffset, $position, $jump->lineno);
+                $position++;
+            }
+            $target   = $this->jumpTarget($jumpIndex, $jump->{self::LOOP_JUMPS[$jump->opcode]}->num);
+            $continue = $opcodes[$position];
+
+            $continue->opcode   = OpCode::JMP;
+            $continue->op1->num = $jumpOffset($landing[$target], $position);
+            $continue->lineno   = $jump->lineno;
+            HandlerRebind::rebindOpline($continue);
+        }
+
+        $this->remapLiveRanges($opArray, $newIndex);
+        $this->remapTryCatch($opArray, $newIndex, $landing);
+
+        $opArray->opcodes      = $opcodes;
+        $opArray->literals     = $literalCount > 0 ? Core::pointerAtAddress('zval *', $literalsBase) : null;
+        $opArray->last         = $newTotal;
+        $opArray->last_literal = $literalCount;
+        $opArray->cache_size  += $this->reservedCacheSize;
+        // The previous cache is sized (and keyed) for the previous body
+        FunctionBodySwap::installFreshRunTimeCache($this->function);
+
+        $this->applied = true;
+    }
+
+    /**
+     * Computes where every old opline goes in the rewritten body
+     *
+     * @return array{array<int, int>, array<int, int>, array<int, int>, int} New index of each
+     *         old opline, where jumps to each old opline land, start of each edge block, new length
+     */
+    private function layout(): array
+    {
+        $newIndex = [];
+        $landing  = [];
+        $position = 0;
+        for ($index = 0; $index < $this->total; $index++) {
+            foreach ($this->insertions[$index] ?? [] as $insertion) {
+                if ($insertion['landsJumps'] && !isset($landing[$index])) {
+                    $landing[$index] = $position;
+                }
+                $position++;
+            }
+            $newIndex[$index]  = $position;
+            $landing[$index] ??= $position;
+            $position++;
+        }
+        $newIndex[$this->total] = $landing[$this->total] = $position;
+
+        $edgeStart = [];
+        foreach ($this->edgeInsertions as $jumpIndex => $insertions) {
+            $edgeStart[$jumpIndex] = $position;
+            // The inserted oplines, then the JMP to the original target
+            $position += \count($insertions) + 1;
+        }
+
+        return [$newIndex, $landing, $edgeStart, $position];
+    }
+
+    /**
+     * Refuses a layout that moves the targets of a SWITCH/MATCH jump table relative to it
+     *
+     * The table is an array literal of opline-relative offsets, possibly immutable (opcache):
+     * it is checked here instead of being rebuilt.
+     *
+     * @param array<int, int> $newIndex
+     * @param array<int, int> $landing
+     */
+    private function assertJumpTablesKeepDistances(array $newIndex, array $landing): void
+    {
+        for ($index = 0; $index < $this->total; $index++) {
+            $opline = $this->opline($index);
+            if (!isset(self::EXTENDED_VALUE_JUMPS[$opline->opcode]) || $opline->op2_type !== OpLine::IS_CONST) {
+                continue;
+            }
+            $table = null;
+            ReflectionValue::fromValueEntry(Core::pointerAtAddress(
+                'zval *',
+                Core::addressOf($opline) + self::signed($opline->op2->constant),
+            ))->getNativeValue($table);
+            foreach ($table as $offset) {
+                $target = $this->jumpTarget($index, $offset);
+                if ($landing[$target] - $newIndex[$index] !== $target - $index) {
+                    throw OpArrayRewriteException::shiftedJumpTable($this->name, $index);
+                }
+            }
+        }
+    }
+
+    /**
+     * Fills one zero-filled opline slot with an insertion and bakes its handler
+     *
+     * @param CData                   $opline
+     * @param array{opcode: int, op1: ?int, op2: ?int, extendedValue: int, landsJumps: bool} $insertion
+     * @param \Closure(int, int): int $constantOffset
+     */
+    private function emit(CData $opline, array $insertion, \Closure $constantOffset, int $position, int $lineNo): void
+    {
+        $opline->opcode         = $insertion['opcode'];
+        $opline->extended_value = $insertion['extendedValue'];
+        $opline->lineno         = $lineNo;
+        foreach (['op1', 'op2'] as $operandField) {
+            if ($insertion[$operandField] !== null) {
+                $opline->{$operandField . '_type'}  = OpLine::IS_CONST;
+                $opline->{$operandField}->constant = $constantOffset($insertion[$operandField], $position);
+            }
+        }
+        HandlerRebind::rebindOpline($opline);
+    }
+
+    /**
+     * Copies the live ranges with shifted bounds into a new array owned by the op_array
+     *
+     * A range starts right after the opline defining the variable and ends at the one consuming
+     * it, so oplines inserted in between fall inside: the variable is still live there.
+     *
+     * @param CData           $opArray
+     * @param array<int, int> $newIndex
+     */
+    private function remapLiveRanges(CData $opArray, array $newIndex): void
+    {
+        $count = $opArray->last_live_range;
+        if ($count === 0) {
+            return;
+        }
+        $ranges = Core::new("zend_live_range[{$count}]", false);
+        Core::memcpy($ranges, $opArray->live_range, Core::sizeOfType(zend_live_range::class) * $count);
+        for ($index = 0; $index < $count; $index++) {
+            $range        = $ranges[$index];
+            $range->start = $range->start > 0 ? $newIndex[$range->start - 1] + 1 : 0;
+            $range->end   = $newIndex[$range->end];
+        }
+        // The previous array stays with the previous block (closure copies still use both)
+        $opArray->live_range = Core::cast(zend_live_range::class, $ranges);
+    }
+
+    /**
+     * Copies the try/catch table with shifted oplines into a new array owned by the op_array
+     *
+     * Oplines inserted before the first opline of a try block belong to the block.
+     *
+     * @param CData           $opArray
+     * @param array<int, int> $newIndex
+     * @param array<int, int> $landing
+     */
+    private function remapTryCatch(CData $opArray, array $newIndex, array $landing): void
+    {
+        $count = $opArray->last_try_catch;
+        if ($count === 0) {
+            return;
+        }
+        $elements = Core::new("zend_try_catch_element[{$count}]", false);
+        Core::memcpy($elements, $opArray->try_catch_array, Core::sizeOfType(zend_try_catch_element::class) * $count);
+        for ($index = 0; $index < $count; $index++) {
+            $element         = $elements[$index];
+            $element->try_op = $landing[$element->try_op];
+            // Zero means "no catch" / "no finally" for the other three
+            foreach (['catch_op', 'finally_op', 'finally_end'] as $field) {
+                if ($element->{$field} !== 0) {
+                    $element->{$field} = $newIndex[$element->{$field}];
+                }
+            }
+        }
+        $opArray->try_catch_array = Core::cast(zend_try_catch_element::class, $elements);
+    }
+
+    /**
+     * Returns the fields of an opline that hold jump offsets
+     *
+     * @param CData|zend_op $opline
+     *
+     * @return list<'op1'|'op2'|'extended_value'>
+     */
+    private static function jumpFields(object $opline): array
+    {
+        return self::jumpFieldsOf($opline->opcode, $opline->extended_value);
+    }
+
+    /**
+     * Returns the fields that hold jump offsets for the given opcode and extended_value
+     *
+     * @return list<'op1'|'op2'|'extended_value'>
+     *
+     * @internal also used by OpArrayBody to decode jumps into instruction indexes
+     */
+    public static function jumpFieldsOf(int $opcode, int $extendedValue): array
+    {
+        return match (true) {
+            isset(self::OP1_JUMPS[$opcode])            => ['op1'],
+            $opcode === OpCode::CATCH                  => ($extendedValue & self::LAST_CATCH) !== 0 ? [] : ['op2'],
+            isset(self::OP2_JUMPS[$opcode])            => ['op2'],
+            isset(self::EXTENDED_VALUE_JUMPS[$opcode]) => ['extended_value'],
+            default                                    => [],
+        };
+    }
+
+    /**
+     * Resolves an opline-relative jump offset (ZEND_OFFSET_TO_OPLINE) to an opline index
+     */
+    private function jumpTarget(int $index, int $offset): int
+    {
+        return $index + intdiv(self::signed($offset), $this->opcodeSize);
+    }
+
+    /**
+     * @return CData|zend_op
+     */
+    private function opline(int $index): CData
+    {
+        return $this->function->getOpArrayPointer()->opcodes[$index];
+    }
+
+    private function assertPending(): void
+    {
+        if ($this->applied) {
+            throw OpArrayRewriteException::alreadyApplied();
+        }
+    }
+
+    /**
+     * znode_op offsets are uint32_t holding signed values
+     */
+    private static function signed(int $unsigned): int
+    {
+        return $unsigned >= 0x80000000 ? $unsigned - 0x100000000 : $unsigned;
+    }
+}
@@ -53,6 +53,21 @@ final class PendingBodySwap
         private ?int $previousMintedRecord,
     ) {}
 
+    /**
+     * Fills the fresh run-time cache of the entry, see RunTimeCacheWarmer
+     *
+     * Must run before commit(): copying reads the cache of the previous body, which commit
+     * releases.
+     *
+     * @return int Number of slot ranges filled
+     */
+    public function warmRunTimeCache(RunTimeCacheWarmup $warmup): int
+    {
+        $this->assertUnresolved();
+
+        return RunTimeCacheWarmer::warm($this->entry, $this->previousBody, $warmup);
+    }
+
     /**
      * Finalizes the swap: the previous body is destroyed (unless it is immortal SHM)
      */
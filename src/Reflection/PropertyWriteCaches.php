@@ -0,0 +1,152 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Reflection;
+
+use ZEngine\Core;
+use ZEngine\Generated\zend_closure;
+use ZEngine\Generated\zend_op;
+use ZEngine\System\OpCode;
+use ZEngine\Type\OpLine;
+
+/**
+ * Drops the property-write inline caches the VM keeps for one class
+ *
+ * ASSIGN_OBJ with a literal property name caches (class, property offset) in its run-time
+ * cache slots on the first write that goes through zend_std_write_property(). While the
+ * object's class matches the cached one, later executions store into the property slot
+ * directly and never call write_property again - so a write_property handler installed after
+ * that first write would be skipped. Clearing the class slot sends the next write through the
+ * handler, which decides whether the cache gets warmed again.
+ *
+ * Reaches the op_arrays of the function and class tables, the closures they declare, live
+ * Closure objects (each carries its own run-time cache) and every frame of the call stack.
+ */
+final class PropertyWriteCaches
+{
+    /**
+     * Writes with a literal property name (op2), extended_value holds their first cache slot
+     */
+    private const array WRITE_OPCODES = [
+        OpCode::ASSIGN_OBJ     => true,
+        OpCode::ASSIGN_OBJ_REF => true,
+    ];
+
+    private function __construct() {}
+
+    /**
+     * Clears every cached property write keyed by the given class, returns how many were cleared
+     *
+     * @param object $classEntry zend_class_entry
+     */
+    public static function forget(object $classEntry): int
+    {
+        $classAddress = Core::addressOf($classEntry);
+        $opcodeSize   = Core::sizeOfType(zend_op::class);
+        $opcodeOffset = Core::offsetOfField(zend_op::class, 'opcode');
+        $pointerSize  = Core::sizeOfType('void *');
+        $cleared      = 0;
+        foreach (self::reachableOpArrays() as $opArray) {
+            $cache = RunTimeCacheWarmer::cacheOf($opArray);
+            if ($cache === null) {
+                continue;
+            }
+            $base  = Core::pointerAddressOf($opArray->opcodes);
+            $bytes = \FFI::string(Core::cast('char *', $opArray->opcodes), $opArray->last * $opcodeSize);
+            for ($index = 0; $index < $opArray->last; $index++) {
+                if (!isset(self::WRITE_OPCODES[\ord($bytes[$index * $opcodeSize + $opcodeOffset])])) {
+                    continue;
+                }
+                $opline = Core::pointerAtAddress(zend_op::class, $base + $index * $opcodeSize);
+                if ($opline->op2_type !== OpLine::IS_CONST) {
+                    continue;
+                }
+                $slot   = intdiv($opline->extended_value, $pointerSize);
+                $cached = $cache[$slot];
+                if ($cached !== null && Core::addressOf($cached) === $classAddress) {
+                    $cache[$slot] = null;
+                    $cleared++;
+                }
+            }
+        }
+
+        return $cleared;
+    }
+
+    /**
+     * Returns the op_arrays whose run-time caches may hold property writes, each once
+     *
+     * @return list<object> zend_op_array views
+     */
+    private static function reachableOpArrays(): array
+    {
+        $opArrays = [];
+        $collect  = static function (object $opArray) use (&$collect, &$opArrays): void {
+            $address = Core::addressOf(Core::addr($opArray));
+            if ($opArray->opcodes === null || isset($opArrays[$address])) {
+                return;
+            }
+            $opArrays[$address] = $opArray;
+            for ($index = 0; $index < $opArray->num_dynamic_func_defs; $index++) {
+                $collect($opArray->dynamic_func_defs[$index][0]);
+            }
+        };
+        $collectFunctions = static function (iterable $functionTable) use ($collect): void {
+            foreach ($functionTable as $functionValue) {
+                $rawFunction = $functionValue->getRawFunction();
+                if ($rawFunction->type === Core::ZEND_USER_FUNCTION) {
+                    $collect($rawFunction->op_array);
+                }
+            }
+        };
+
+        $collectFunctions(Core::$executor->functionTable);
+        $closureClass = null;
+        foreach (Core::$executor->classTable as $lowerName => $classValue) {
+            try {
+                $rawClass = $classValue->getRawClass();
+            } catch (\UnexpectedValueException $e) {
+                // A class alias, the aliased entry is visited under its own name
+                continue;
+            }
+            if ($lowerName === 'closure') {
+                $closureClass = Core::addressOf($rawClass);
+            }
+            if ($rawClass->type === Core::ZEND_USER_CLASS) {
+                $collectFunctions(ReflectionClass::fromCData($rawClass)->getMethodTable());
+            }
+        }
+
+        $objectStore = Core::$executor->objectStore;
+        for ($handle = 1; $handle <= \count($objectStore); $handle++) {
+            $object = $objectStore[$handle]?->getRawValue();
+            if ($object !== null && Core::addressOf($object->ce) === $closureClass) {
+                $collect(Core::cast(zend_closure::class, $object)->func->op_array);
+            }
+        }
+
+        $frame = Core::$executor->getExecutionState();
+        while (true) {
+            $rawFunction = $frame->getRawFunction();
+            if ($rawFunction !== null && $rawFunction->type !== Core::ZEND_INTERNAL_FUNCTION) {
+                $collect($rawFunction->op_array);
+            }
+            if (!$frame->hasPrevious()) {
+                break;
+            }
+            $frame = $frame->getPrevious();
+        }
+
+        return array_values($opArrays);
+    }
+}
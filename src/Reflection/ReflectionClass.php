@@ -20,6 +20,7 @@ use ZEngine\ClassExtension\Hook\CastObjectHook;
 use ZEngine\ClassExtension\Hook\CloneObjectHook;
 use ZEngine\ClassExtension\Hook\CompareValuesHook;
 use ZEngine\ClassExtension\Hook\CountElementsHook;
+use ZEngine\ClassExtension\Hook\CountElementsStubHook;
 use ZEngine\ClassExtension\Hook\CreateObjectHook;
 use ZEngine\ClassExtension\Hook\DoOperationHook;
 use ZEngine\ClassExtension\Hook\GetClassNameHook;
@@ -34,12 +35,17 @@ use ZEngine\ClassExtension\Hook\GetPropertyPointerHook;
 use ZEngine\ClassExtension\Hook\HasDimensionHook;
 use ZEngine\ClassExtension\Hook\HasPropertyHook;
 use ZEngine\ClassExtension\Hook\InterfaceGetsImplementedHook;
+use ZEngine\ClassExtension\Hook\NativeStubHook;
 use ZEngine\ClassExtension\Hook\ReadDimensionHook;
 use ZEngine\ClassExtension\Hook\ReadPropertyHook;
 use ZEngine\ClassExtension\Hook\UnsetDimensionHook;
 use ZEngine\ClassExtension\Hook\UnsetPropertyHook;
+use ZEngine\ClassExtension\Hook\UnsetPropertyStubHook;
 use ZEngine\ClassExtension\Hook\WriteDimensionHook;
 use ZEngine\ClassExtension\Hook\WritePropertyHook;
+use ZEngine\ClassExtension\Hook\WritePropertyStubHook;
+use ZEngine\ClassExtension\Native\NativeStubException;
+use ZEngine\ClassExtension\Native\NativeStubs;
 use ZEngine\ClassExtension\ObjectCastInterface;
 use ZEngine\ClassExtension\ObjectCloneInterface;
 use ZEngine\ClassExtension\ObjectCompareValuesInterface;
@@ -70,6 +76,7 @@ use ZEngine\Generated\zend_object;
 use ZEngine\Generated\zend_trait_precedence;
 use ZEngine\Generated\zval;
 use ZEngine\Hook\AbstractHook;
+use ZEngine\Hook\HookMultiplexer;
 use ZEngine\OpCache\SharedMemoryException;
 use ZEngine\Type\ClosureEntry;
 use ZEngine\Type\HashTable;
@@ -192,6 +199,25 @@ class ReflectionClass extends NativeReflectionClass
      */
     private static array $objectHandlers = [];
 
+    /**
+     * Class entries (by address) whose objects share the multiplexed handlers block
+     *
+     * @var array<int, true>
+     */
+    private static array $multiplexedClasses = [];
+
+    /**
+     * The one zend_object_handlers block shared by every multiplexed class (allocated on first use)
+     */
+    private static ?CData $sharedObjectHandlers = null;
+
+    /**
+     * Shared trampolines of the multiplexed handlers block, keyed by field name
+     *
+     * @var array<string, HookMultiplexer>
+     */
+    private static array $handlerMultiplexers = [];
+
     public function __construct($classNameOrObject)
     {
         try {
@@ -2356,13 +2382,19 @@ class ReflectionClass extends NativeReflectionClass
 
     /**
      * Installs user-defined object handlers for given class to control extra-features of this class
+     *
+     * @param bool $multiplexed Whether the class joins the shared handlers block instead of owning
+     *                          one, see useMultiplexedObjectHandlers()
      */
-    public function installExtensionHandlers(): void
+    public function installExtensionHandlers(bool $multiplexed = false): void
     {
         if (!$this->implementsInterface(ObjectCreateInterface::class)) {
             $str = 'Class ' . $this->name . ' should implement at least ObjectCreateInterface to setup user handlers';
             throw new \ReflectionException($str);
         }
+        if ($multiplexed) {
+            $this->useMultiplexedObjectHandlers();
+        }
 
         foreach (self::EXTENSION_HANDLERS as $interfaceName => [$methodName, $installerName]) {
             if (!$this->implementsInterface($interfaceName)) {
@@ -2560,6 +2592,62 @@ class ReflectionClass extends NativeReflectionClass
         return $this->installObjectHook(UnsetDimensionHook::class, $handler);
     }
 
+    /**
+     * Makes instances immutable through native write_property/unset_property stubs
+     *
+     * The stubs are generated machine code (NativeStubs), so a property write never enters
+     * PHP: immutable value objects pay nothing per write beyond the engine's own lookup. With
+     * $allowInitialization each property accepts the one write that creates it - the
+     * constructor assignment of a typed property without default - and rejects every later
+     * one, like a readonly class; without it every write throws. Unsets always throw.
+     *
+     * Requires linux-x64 NTS (NativeStubs::isAvailable()) and, like every handler, an
+     * installed create_object handler so instances get the class's handlers block.
+     *
+     * Plain assignments are covered, including ones the VM cached before the install (those
+     * caches are cleared). Compound assignments, increments and indirect modifications
+     * ($o->x += 1, $o->x++, $o->list[] = 1) write through get_property_ptr_ptr and are not
+     * intercepted.
+     *
+     * @return array{WritePropertyStubHook, UnsetPropertyStubHook}
+     */
+    public function installNativeImmutability(bool $allowInitialization = true): array
+    {
+        $writeStub = $allowInitialization ? NativeStubs::writeOnceProperty() : NativeStubs::denyPropertyWrite();
+
+        return [
+            $this->installNativeStub(WritePropertyStubHook::class, $writeStub),
+            $this->installNativeStub(UnsetPropertyStubHook::class, NativeStubs::denyPropertyUnset()),
+        ];
+    }
+
+    /**
+     * Makes count($object) report a fixed number through a native count_elements stub
+     *
+     * @see installNativeImmutability() for the requirements
+     */
+    public function installNativeCount(int $count): CountElementsStubHook
+    {
+        return $this->installNativeStub(CountElementsStubHook::class, NativeStubs::fixedCount($count));
+    }
+
+    /**
+     * Forbids/allows dynamic properties on instances of this class
+     *
+     * No handler is involved: for classes flagged ZEND_ACC_NO_DYNAMIC_PROPERTIES the standard
+     * write_property and get_property_ptr_ptr already throw on undeclared names at C speed.
+     *
+     * @param bool $isForbidden True to reject dynamic properties/false to accept them again
+     */
+    public function setNoDynamicProperties(bool $isForbidden = true): void
+    {
+        if ($isForbidden) {
+            $this->pointer->ce_flags |= Core::ZEND_ACC_NO_DYNAMIC_PROPERTIES;
+        } else {
+            $this->pointer->ce_flags &= (~Core::ZEND_ACC_NO_DYNAMIC_PROPERTIES);
+        }
+    }
+
     /**
      * Installs the "count_elements" handler for the current class
      *
@@ -2695,12 +2783,55 @@ class ReflectionClass extends NativeReflectionClass
         return $hook;
     }
 
+    /**
+     * Makes objects of this class share one handlers block with every other multiplexed class
+     *
+     * By default each hooked class owns a zend_object_handlers block, and each hook writes its
+     * own libffi trampoline into it: dozens of value-object classes with the same do_operation
+     * and compare hooks cost dozens of blocks and trampolines. Multiplexed classes share one
+     * block with one trampoline per field instead (installed on first use); the trampoline looks
+     * the subject's class entry up in a PHP table and hands the call to that class's hook, or
+     * to the standard handler for classes without one. Installing or uninstalling a multiplexed
+     * class's hook is then a table write, with no trampoline minted or released.
+     *
+     * The subject is the object the engine dispatched on: the first argument for most fields,
+     * the first object operand that uses the shared block for do_operation and compare. The
+     * hooks returned by the setXxxHandler() methods keep their usual API - proceed() reaches
+     * the standard handler - and can be uninstalled in any order. The price is one table
+     * lookup per call, negligible next to the trampoline itself.
+     *
+     * Must be called before the first handler of the class is installed (the switch cannot move
+     * objects that already point to the class's own block); calling it again is a no-op.
+     */
+    public function useMultiplexedObjectHandlers(): void
+    {
+        $classEntryAddress = Core::addressOf($this->pointer);
+        if (isset(self::$multiplexedClasses[$classEntryAddress])) {
+            return;
+        }
+        if (isset(self::$objectHandlers[$classEntryAddress])) {
+            throw new \LogicException(
+                'Class ' . $this->name . ' already owns an object handlers block; multiplex it before installing handlers',
+            );
+        }
+        self::$multiplexedClasses[$classEntryAddress] = true;
+    }
+
+    /**
+     * Checks if objects of this class use the multiplexed handlers block
+     */
+    public function isUsingMultiplexedObjectHandlers(): bool
+    {
+        return isset(self::$multiplexedClasses[Core::addressOf($this->pointer)]);
+    }
+
     /**
      * Installs one zend_object_handlers hook of the given kind for the current class
      *
      * Every setXxxHandler() above is this one operation with a different hook class: the
      * class gets its own writable copy of the handlers block (allocated on first use) and
-     * the hook writes its trampoline into the matching field. The template parameter keeps
+     * the hook writes its trampoline into the matching field. For a multiplexed class the hook
+     * is attached to the shared trampoline of that field instead. The template parameter keeps
      * the precise hook type on the caller side, so the public setters stay exactly typed.
      *
      * @template THook of AbstractHook
@@ -2714,8 +2845,41 @@ class ReflectionClass extends NativeReflectionClass
         $this->keepLazyLinkingCopyProcessLocal($hookClass);
         $handlers = self::getObjectHandlers($this->pointer);
 
-        $hook = new $hookClass($handler, $handlers);
+        $hook              = new $hookClass($handler, $handlers);
+        $classEntryAddress = Core::addressOf($this->pointer);
+        if (isset(self::$multiplexedClasses[$classEntryAddress])) {
+            $hook->routeThrough(self::getHandlerMultiplexer($hookClass::getHookField()), $classEntryAddress);
+        }
+        $hook->install();
+
+        return $hook;
+    }
+
+    /**
+     * Installs a native stub into the handlers block of the current class
+     *
+     * @template THook of NativeStubHook
+     *
+     * @param class-string<THook> $hookClass   Stub hook of the target handler field
+     * @param int                 $stubAddress Entry point from NativeStubs
+     *
+     * @return THook
+     */
+    private function installNativeStub(string $hookClass, int $stubAddress): NativeStubHook
+    {
+        // The shared block serves every multiplexed class, a stub cannot be routed per class
+        if ($this->isUsingMultiplexedObjectHandlers()) {
+            throw NativeStubException::multiplexedClass($this->name);
+        }
+        $this->keepLazyLinkingCopyProcessLocal($hookClass);
+        $handlers = self::getObjectHandlers($this->pointer);
+
+        $hook = new $hookClass($stubAddress, $handlers);
         $hook->install();
+        if ($hook instanceof WritePropertyStubHook) {
+            // ASSIGN_OBJ oplines warmed before the install would keep writing past the stub
+            PropertyWriteCaches::forget($this->pointer);
+        }
 
         return $hook;
     }
@@ -2884,6 +3048,9 @@ class ReflectionClass extends NativeReflectionClass
     private static function getObjectHandlers(object $classType): object
     {
         $classEntryAddress = Core::addressOf($classType);
+        if (isset(self::$multiplexedClasses[$classEntryAddress])) {
+            return self::$sharedObjectHandlers ??= self::allocateClassObjectHandlers();
+        }
         if (!isset(self::$objectHandlers[$classEntryAddress])) {
             self::$objectHandlers[$classEntryAddress] = self::allocateClassObjectHandlers();
         }
@@ -2904,4 +3071,113 @@ class ReflectionClass extends NativeReflectionClass
 
         return Core::addr($handlers);
     }
+
+    /**
+     * Returns the shared trampoline of one field of the multiplexed handlers block
+     */
+    private static function getHandlerMultiplexer(string $field): HookMultiplexer
+    {
+        if (!isset(self::$handlerMultiplexers[$field])) {
+            $sharedHandlers = self::$sharedObjectHandlers ??= self::allocateClassObjectHandlers();
+
+            self::$handlerMultiplexers[$field] = new HookMultiplexer(
+                $sharedHandlers,
+                $field,
+                self::multiplexedRouteResolver($field, Core::pointerAddressOf($sharedHandlers)),
+                self::multiplexedAbsentHandler($field),
+            );
+        }
+
+        return self::$handlerMultiplexers[$field];
+    }
+
+    /**
+     * Builds the resolver of the class entry address an engine call of the given field is about
+     *
+     * Runs inside engine callbacks, so it only reads raw fields (pointerAddressOf() never throws).
+     *
+     * @param int $sharedHandlersAddress Address of the shared block, to tell which operand the
+     *                                   engine dispatched on
+     *
+     * @return Closure(array<int, mixed>): ?int
+     */
+    private static function multiplexedRouteResolver(string $field, int $sharedHandlersAddress): Closure
+    {
+        return match ($field) {
+            // zend_object_do_operation_t(zend_uchar opcode, zval *result, zval *op1, zval *op2)
+            'do_operation' => static fn(array $arguments): ?int => self::resolveOperandRoute(
+                $field,
+                $sharedHandlersAddress,
+                $arguments[2],
+                $arguments[3],
+            ),
+            // zend_object_compare_t(zval *object1, zval *object2)
+            'compare' => static fn(array $arguments): ?int => self::resolveOperandRoute(
+                $field,
+                $sharedHandlersAddress,
+                $arguments[0],
+                $arguments[1],
+            ),
+            // zend_object_get_method_t(zend_object **object, zend_string *method, const zval *key)
+            'get_method' => static fn(array $arguments): ?int => Core::pointerAddressOf($arguments[0][0]->ce),
+            // Every other handler takes the subject zend_object* first
+            default => static fn(array $arguments): ?int => Core::pointerAddressOf($arguments[0]->ce),
+        };
+    }
+
+    /**
+     * Builds the answer to unrouted calls of the given field when the shared block holds no handler
+     *
+     * std_object_handlers leaves do_operation, count_elements and get_properties_for empty; the
+     * engine then falls back on its own, so an unrouted call must give the same answer it would.
+     *
+     * @return (Closure(array<int, mixed>): mixed)|null
+     */
+    private static function multiplexedAbsentHandler(string $field): ?Closure
+    {
+        return match ($field) {
+            // zend_binary_op() tries op2 next and count() asks Countable::count() on FAILURE
+            'do_operation', 'count_elements' => static fn(array $arguments): int => Core::FAILURE,
+            // zend_get_properties_for() calls the standard implementation for an empty field
+            'get_properties_for' => static fn(array $arguments): ?CData => Core::call(
+                'zend_std_get_properties_for',
+                $arguments[0],
+                $arguments[1],
+            ),
+            default => null,
+        };
+    }
+
+    /**
+     * Returns the class entry address of the first object operand routed for the given field
+     *
+     * Only operands that use the shared block are candidates, op1 first (zend_binary_op() and
+     * zend_compare() both try op1 first). An op1 without a route of its own does not hide a
+     * routed op2 - for `$plain + $hooked` the engine calls op1's handler, which is the shared one.
+     *
+     * @param zval $op1
+     * @param zval $op2
+     */
+    private static function resolveOperandRoute(string $field, int $sharedHandlersAddress, object $op1, object $op2): ?int
+    {
+        $multiplexer = self::$handlerMultiplexers[$field] ?? null;
+        if ($multiplexer === null) {
+            return null;
+        }
+        foreach ([$op1, $op2] as $operand) {
+            if ($operand->u1->v->type !== ReflectionValue::IS_OBJECT) {
+                continue;
+            }
+            $object = $operand->value->obj;
+            if (Core::pointerAddressOf($object->handlers) !== $sharedHandlersAddress) {
+                continue;
+            }
+            $route = Core::pointerAddressOf($object->ce);
+            if ($multiplexer->hasRoute($route)) {
+                return $route;
+            }
+        }
+
+        return null;
+    }
 }
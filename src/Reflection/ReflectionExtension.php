@@ -62,6 +62,7 @@ class ReflectionExtension extends NativeReflectionExtension
     public function __construct(string $name)
     {
         parent::__construct($name);
+        Core::requireHeaderSlice('module');
 
         $moduleEntry = Core::$modules->find($name);
         if ($moduleEntry === null) {
@@ -152,6 +152,201 @@ class ReflectionFunction extends NativeReflectionFunction implements FunctionLik
         return $reflectionFunction;
     }
 
+    /**
+     * Compiles a generated source unit once and returns every global function it declares
+     *
+     * The bulk form of addFunction() for code generators: the unit is one eval() compile, and
+     * its top-level functions are bound into the engine function table at compile time, in
+     * one pass. The bodies are ordinary engine-owned op_arrays - no closure object per
+     * function, nothing to immortalize, destroyed by the engine at request end like any other
+     * declared function. String literals are interned during compilation, so names and
+     * strings repeated across the unit share one zend_string.
+     *
+     * Only unconditional top-level declarations are collected (a namespace statement is
+     * honoured, braced and alternative-syntax blocks are not top level); everything else in
+     * the unit runs as ordinary code.
+     *
+     * @param string $code PHP code without the opening tag
+     *
+     * @return array<string, ReflectionFunction> Declared functions keyed by their name
+     *
+     * @throws \ReflectionException When a declared function already exists or the unit does not parse
+     * @internal
+     */
+    public static function addFunctionsFromSource(string $code): array
+    {
+        $functionNames = self::findDeclaredFunctions("<?php\n" . $code);
+        self::ensureUndeclared($functionNames);
+        try {
+            (static function (string $code): void {
+                eval($code);
+            })($code);
+        } catch (\CompileError $compileError) {
+            throw new \ReflectionException("Generated source does not parse: {$compileError->getMessage()}", 0, $compileError);
+        }
+
+        return self::collectDeclared($functionNames);
+    }
+
+    /**
+     * Includes a generated file once and returns every global function it declares
+     *
+     * Same contract as addFunctionsFromSource(), but the unit goes through the regular include
+     * path: with opcache enabled the compiled file is cached in shared memory and the
+     * functions are published as immutable entries shared by every worker.
+     *
+     * @return array<string, ReflectionFunction> Declared functions keyed by their name
+     *
+     * @throws \ReflectionException When the file is unreadable, a declared function already
+     *                              exists or the file does not parse
+     * @internal
+     */
+    public static function addFunctionsFromFile(string $fileName): array
+    {
+        $source = @file_get_contents($fileName);
+        if ($source === false) {
+            throw new \ReflectionException("Generated source file {$fileName} is not readable");
+        }
+        $functionNames = self::findDeclaredFunctions($source);
+        self::ensureUndeclared($functionNames);
+        try {
+            (static function (string $fileName): void {
+                require $fileName;
+            })($fileName);
+        } catch (\CompileError $compileError) {
+            throw new \ReflectionException("Generated source {$fileName} does not parse: {$compileError->getMessage()}", 0, $compileError);
+        }
+
+        return self::collectDeclared($functionNames);
+    }
+
+    /**
+     * Returns the fully qualified names of the unconditional top-level function declarations
+     *
+     * @return list<string>
+     */
+    private static function findDeclaredFunctions(string $source): array
+    {
+        $tokens         = \PhpToken::tokenize($source);
+        $tokenCount     = count($tokens);
+        $namespace      = '';
+        $namespaceDepth = 0;
+        $depth          = 0;
+        $previousToken  = null;
+        $functionNames  = [];
+        for ($index = 0; $index < $tokenCount; $index++) {
+            $token = $tokens[$index];
+            if ($token->isIgnorable()) {
+                continue;
+            }
+            if ($token->is(['{', T_CURLY_OPEN, T_DOLLAR_OPEN_CURLY_BRACES])) {
+                $depth++;
+            } elseif ($token->is([T_IF, T_WHILE, T_FOR, T_FOREACH, T_SWITCH, T_DECLARE])) {
+                // "if (...):" to "endif;" nests like a braced block; elseif/else stay inside it
+                if (self::opensAlternativeBlock($tokens, $index)) {
+                    $depth++;
+                }
+            } elseif ($token->is([T_ENDIF, T_ENDWHILE, T_ENDFOR, T_ENDFOREACH, T_ENDSWITCH, T_ENDDECLARE])) {
+                $depth--;
+            } elseif ($token->is('}')) {
+                $depth--;
+                if ($depth < $namespaceDepth) {
+                    // End of a braced namespace block
+                    $namespace      = '';
+                    $namespaceDepth = 0;
+                }
+            } elseif ($token->is(T_NAMESPACE) && $depth === $namespaceDepth) {
+                $namespace = '';
+                while (++$index < $tokenCount && !$tokens[$index]->is([';', '{'])) {
+                    if ($tokens[$index]->is([T_STRING, T_NAME_QUALIFIED])) {
+                        $namespace = $tokens[$index]->text . '\\';
+                    }
+                }
+                if ($index < $tokenCount && $tokens[$index]->is('{')) {
+                    $depth++;
+                    $namespaceDepth = $depth;
+                }
+            } elseif ($token->is(T_FUNCTION) && $depth === $namespaceDepth && !$previousToken?->is(T_USE)) {
+                // Closures at the top level are followed by "(" and are not declarations
+                $nameIndex = $index + 1;
+                while ($nameIndex < $tokenCount && $tokens[$nameIndex]->is([T_WHITESPACE, T_COMMENT, T_DOC_COMMENT, '&'])) {
+                    $nameIndex++;
+                }
+                if ($nameIndex < $tokenCount && $tokens[$nameIndex]->is(T_STRING)) {
+                    $functionNames[] = $namespace . $tokens[$nameIndex]->text;
+                }
+            }
+            $previousToken = $token;
+        }
+
+        return $functionNames;
+    }
+
+    /**
+     * Checks whether the control structure at the given token uses the alternative syntax
+     *
+     * @param list<\PhpToken> $tokens
+     */
+    private static function opensAlternativeBlock(array $tokens, int $index): bool
+    {
+        $tokenCount  = count($tokens);
+        $parentheses = 0;
+        $isOpened    = false;
+        for ($index++; $index < $tokenCount; $index++) {
+            $token = $tokens[$index];
+            if ($token->isIgnorable()) {
+                continue;
+            }
+            if ($isOpened && $parentheses === 0) {
+                // First token after the parenthesized head
+                return $token->is(':');
+            }
+            if ($token->is('(')) {
+                $parentheses++;
+                $isOpened = true;
+            } elseif ($token->is(')')) {
+                $parentheses--;
+            } elseif (!$isOpened) {
+                return false;
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Refuses a unit that redeclares a function: the engine would raise a fatal compile error
+     *
+     * @param list<string> $functionNames
+     */
+    private static function ensureUndeclared(array $functionNames): void
+    {
+        $functionTable = Core::$executor->functionTable;
+        $seenNames     = [];
+        foreach ($functionNames as $functionName) {
+            $lowerName = strtolower($functionName);
+            if (isset($seenNames[$lowerName]) || $functionTable->find($lowerName) !== null) {
+                throw new \ReflectionException("Function {$functionName} already exists in the engine");
+            }
+            $seenNames[$lowerName] = true;
+        }
+    }
+
+    /**
+     * @param list<string> $functionNames
+     *
+     * @return array<string, ReflectionFunction>
+     */
+    private static function collectDeclared(array $functionNames): array
+    {
+        $functions = [];
+        foreach ($functionNames as $functionName) {
+            $functions[$functionName] = new ReflectionFunction($functionName);
+        }
+
+        return $functions;
+    }
+
     /**
      * Returns the class scope this function entry is bound to as a framework wrapper,
      * or null for plain functions, closures without a bound scope and main-scope
@@ -181,7 +181,7 @@ class ReflectionValue implements ReferenceCountedInterface
         $valueEntry         = $selfExecutionState->getArgument(0);
 
         $container     = Core::new(zval::class, false);
-        $this->pointer = Core::cast(zval::class, Core::addr($container));
+        $this->pointer = Core::castPointer(zval::class, Core::addr($container));
         // copy() takes an own reference on refcounted payloads, exactly like ZVAL_COPY
         $valueEntry->copy($this->pointer);
 
@@ -219,7 +219,7 @@ class ReflectionValue implements ReferenceCountedInterface
 
         // The payload write goes through a raw view: zend_value member writes are
         // FFI-level struct-to-pointer conversions the typed stubs do not model
-        Core::cast('zval *', Core::addr($entry))->value->zv = Core::cast('zval', $value);
+        Core::castPointer('zval *', Core::addr($entry))->value->zv = Core::cast('zval', $value);
         $entry->u1->type_info                               = self::buildTypeInfo($type, $entry);
 
         $reflectionValue = self::fromValueEntry(Core::addr($entry));
@@ -0,0 +1,84 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Reflection;
+
+use FFI\CData;
+use ZEngine\Core;
+
+/**
+ * One zero-filled request-allocator block carved into the run-time caches of a batch of body swaps
+ *
+ * Arena caches are installed WITHOUT ZEND_ACC_HEAP_RT_CACHE, like the caches the engine itself
+ * carves out of CG(arena): destroy_op_array never frees them one by one (that would efree an
+ * interior pointer). The whole block is released by release() when the batch rolls back, and
+ * otherwise lives until the request allocator is torn down - a later redefinition of an entry
+ * installs a fresh cache of its own and leaves its arena slice unused until then.
+ */
+final class RunTimeCacheArena
+{
+    /**
+     * Zero-filled block, null once released or when no swap of the batch needs a cache
+     */
+    private ?CData $block;
+
+    private int $usedBytes = 0;
+
+    /**
+     * @param int $size Total size in bytes, the sum of slotSizeOf() for every cache to carve
+     */
+    public function __construct(public readonly int $size)
+    {
+        $this->block = $size > 0 ? Core::new("char[{$size}]", false) : null;
+    }
+
+    /**
+     * Returns the number of arena bytes a run-time cache of the given size takes
+     *
+     * Slices are pointer-aligned: every cache slot is a void * read by the VM.
+     */
+    public static function slotSizeOf(int $cacheSize): int
+    {
+        $pointerSize = Core::sizeOfType('void *');
+
+        return intdiv($cacheSize + $pointerSize - 1, $pointerSize) * $pointerSize;
+    }
+
+    /**
+     * Carves the next zero-filled run-time cache out of the block
+     *
+     * @return CData void ** pointer to the first slot of the cache
+     */
+    public function allocate(int $cacheSize): CData
+    {
+        $sliceSize = self::slotSizeOf($cacheSize);
+        if ($this->block === null || $this->usedBytes + $sliceSize > $this->size) {
+            throw new \LogicException("Run-time cache arena cannot fit {$cacheSize} more bytes");
+        }
+        $cache            = Core::cast('void **', Core::cast('char *', $this->block) + $this->usedBytes);
+        $this->usedBytes += $sliceSize;
+
+        return $cache;
+    }
+
+    /**
+     * Frees the whole block; only legal once no entry uses an arena cache anymore (rollback)
+     */
+    public function release(): void
+    {
+        if ($this->block !== null) {
+            Core::free($this->block);
+            $this->block = null;
+        }
+    }
+}
@@ -0,0 +1,386 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Reflection;
+
+use FFI\CData;
+use ZEngine\Core;
+use ZEngine\Optimizer\Instruction;
+use ZEngine\Optimizer\OpArrayBody;
+use ZEngine\System\OpCode;
+use ZEngine\Type\OpLine;
+
+/**
+ * Fills the fresh run-time cache of a swapped entry before the new body first runs
+ *
+ * The compiler hands out cache slots per opline kind: a call by name gets one slot for the
+ * resolved function, a method call two (class, method), a property access three (class,
+ * offset, property info), and so on. What ends up in a slot depends only on the opline kind,
+ * its literal names and the scope of the function - never on the position of the opline. So:
+ *
+ *  - Copy pairs the slot-owning oplines of the previous and the new body by that key (opcode,
+ *    operand kinds, literal names; the n-th occurrence with the n-th one) and copies the slot
+ *    contents over. Everything the VM caches polymorphically (properties, methods, class
+ *    constants) is checked against the run-time class before use, as it is for any cache.
+ *  - Prefill resolves what the VM would resolve on first use without side effects: functions
+ *    called by name and classes named by NEW, INSTANCEOF, CATCH and static calls, when they
+ *    are already declared. User functions whose own run-time cache does not exist yet are
+ *    left to the VM, which initializes it together with the slot; an unqualified call in a
+ *    namespace is prefilled only when the namespaced function exists.
+ *
+ * The slot operand of every supported opline is known from the engine's compiler; slot ranges
+ * that fall outside the cache or overlap each other mean the table does not describe this
+ * body, and nothing is copied at all.
+ */
+final class RunTimeCacheWarmer
+{
+    /**
+     * Calls resolving one function by name, result.num holds the slot
+     */
+    private const array FUNCTION_CALLS = [
+        OpCode::INIT_FCALL            => true,
+        OpCode::INIT_FCALL_BY_NAME    => true,
+        OpCode::INIT_NS_FCALL_BY_NAME => true,
+    ];
+
+    /**
+     * Single-slot oplines keeping their slot in extended_value
+     */
+    private const array EXTENDED_VALUE_SLOTS = [
+        OpCode::FETCH_CONSTANT => true,
+        OpCode::DEFINED        => true,
+        OpCode::BIND_GLOBAL    => true,
+        OpCode::CATCH          => true,
+    ];
+
+    /**
+     * Property oplines with a literal property name (op2): three slots in extended_value
+     */
+    private const array PROPERTY_OPCODES = [
+        OpCode::FETCH_OBJ_R            => true,
+        OpCode::FETCH_OBJ_W            => true,
+        OpCode::FETCH_OBJ_RW           => true,
+        OpCode::FETCH_OBJ_IS           => true,
+        OpCode::FETCH_OBJ_FUNC_ARG     => true,
+        OpCode::FETCH_OBJ_UNSET        => true,
+        OpCode::ASSIGN_OBJ             => true,
+        OpCode::ASSIGN_OBJ_REF         => true,
+        OpCode::PRE_INC_OBJ            => true,
+        OpCode::PRE_DEC_OBJ            => true,
+        OpCode::POST_INC_OBJ           => true,
+        OpCode::POST_DEC_OBJ           => true,
+        OpCode::ISSET_ISEMPTY_PROP_OBJ => true,
+        OpCode::UNSET_OBJ              => true,
+    ];
+
+    /**
+     * Static property oplines with a literal property name (op1): three slots in extended_value
+     */
+    private const array STATIC_PROPERTY_OPCODES = [
+        OpCode::FETCH_STATIC_PROP_R        => true,
+        OpCode::FETCH_STATIC_PROP_W        => true,
+        OpCode::FETCH_STATIC_PROP_RW       => true,
+        OpCode::FETCH_STATIC_PROP_IS       => true,
+        OpCode::FETCH_STATIC_PROP_FUNC_ARG => true,
+        OpCode::FETCH_STATIC_PROP_UNSET    => true,
+        OpCode::ASSIGN_STATIC_PROP         => true,
+        OpCode::ASSIGN_STATIC_PROP_REF     => true,
+        OpCode::PRE_INC_STATIC_PROP        => true,
+        OpCode::PRE_DEC_STATIC_PROP        => true,
+        OpCode::POST_INC_STATIC_PROP       => true,
+        OpCode::POST_DEC_STATIC_PROP       => true,
+        OpCode::ISSET_ISEMPTY_STATIC_PROP  => true,
+        OpCode::UNSET_STATIC_PROP          => true,
+    ];
+
+    /**
+     * Oplines whose first slot caches the class named by their op1 literal
+     */
+    private const array CLASS_LITERAL_SLOTS = [
+        OpCode::NEW                     => true,
+        OpCode::CATCH                   => true,
+        OpCode::INIT_STATIC_METHOD_CALL => true,
+    ];
+
+    /**
+     * ZEND_FETCH_CLASS_MASK: the self/parent/static bits of an UNUSED class operand
+     */
+    private const int FETCH_CLASS_MASK = 0x0F;
+
+    private function __construct() {}
+
+    /**
+     * Warms the run-time cache the swap installed on the entry
+     *
+     * @param CData|null $previousBody zend_function snapshot of the previous body, still
+     *                                 alive (a PendingBodySwap before commit); null for none
+     *
+     * @return int Number of slot ranges filled
+     *
+     * @internal called by PendingBodySwap::warmRunTimeCache()
+     */
+    public static function warm(FunctionLikeInterface $entry, ?CData $previousBody, RunTimeCacheWarmup $warmup): int
+    {
+        $opArray = $entry->getOpArrayPointer();
+        $cache   = self::cacheOf($opArray);
+        if ($warmup === RunTimeCacheWarmup::Cold || $cache === null) {
+            return 0;
+        }
+        $body  = OpArrayBody::fromOpArray($opArray);
+        $slots = self::slotsOf($body, $opArray->cache_size);
+        if ($slots === null) {
+            return 0;
+        }
+
+        $filled = [];
+        if ($warmup->copiesSlots() && $previousBody !== null) {
+            $filled = self::copySlots($slots, $cache, Core::cast('zend_op_array *', Core::addr($previousBody)));
+        }
+        if ($warmup->prefillsSlots()) {
+            $filled += self::prefillSlots($body, $slots, $cache);
+        }
+
+        return \count($filled);
+    }
+
+    /**
+     * @param list<array{index: int, key: string, slot: int, count: int}> $slots
+     *
+     * @return array<int, true> Indexes of the filled slot ranges
+     */
+    private static function copySlots(array $slots, CData $cache, CData $previousOpArray): array
+    {
+        $previousCache = self::cacheOf($previousOpArray);
+        if ($previousCache === null) {
+            return [];
+        }
+        $previousSlots = self::slotsOf(OpArrayBody::fromOpArray($previousOpArray), $previousOpArray->cache_size);
+        if ($previousSlots === null) {
+            return [];
+        }
+        $previousByKey = [];
+        foreach ($previousSlots as $previous) {
+            $previousByKey[$previous['key']][] = $previous;
+        }
+
+        $filled = [];
+        foreach ($slots as $position => $current) {
+            $previous = isset($previousByKey[$current['key']]) ? array_shift($previousByKey[$current['key']]) : null;
+            if ($previous === null || $previous['count'] !== $current['count']) {
+                continue;
+            }
+            for ($offset = 0; $offset < $current['count']; $offset++) {
+                $cache[$current['slot'] + $offset] = $previousCache[$previous['slot'] + $offset];
+            }
+            $filled[$position] = true;
+        }
+
+        return $filled;
+    }
+
+    /**
+     * @param list<array{index: int, key: string, slot: int, count: int}> $slots
+     *
+     * @return array<int, true> Indexes of the filled slot ranges
+     */
+    private static function prefillSlots(OpArrayBody $body, array $slots, CData $cache): array
+    {
+        $filled = [];
+        foreach ($slots as $position => $current) {
+            if ($cache[$current['slot']] !== null) {
+                continue;
+            }
+            $instruction = $body->instructions[$current['index']];
+            // Literals after a name hold its lowercase (and for namespaced calls, unqualified) form
+            $resolved = match (true) {
+                $instruction->opcode === OpCode::INIT_FCALL => self::findFunction($body->getLiteral($instruction->op2)),
+                $instruction->opcode === OpCode::INIT_FCALL_BY_NAME,
+                $instruction->opcode === OpCode::INIT_NS_FCALL_BY_NAME => self::findFunction($body->getLiteral($instruction->op2 + 1)),
+                $instruction->opcode === OpCode::INSTANCEOF => self::findClass($body->getLiteral($instruction->op2 + 1)),
+                $instruction->op1Type === OpLine::IS_CONST
+                    && isset(self::CLASS_LITERAL_SLOTS[$instruction->opcode]) => self::findClass($body->getLiteral($instruction->op1 + 1)),
+                default => null,
+            };
+            if ($resolved !== null) {
+                $cache[$current['slot']] = Core::cast('void *', $resolved);
+                $filled[$position]       = true;
+            }
+        }
+
+        return $filled;
+    }
+
+    /**
+     * Lists the slot ranges of a body in opline order
+     *
+     * @return list<array{index: int, key: string, slot: int, count: int}>|null Null when the
+     *         ranges contradict the cache size or each other
+     */
+    private static function slotsOf(OpArrayBody $body, int $cacheSize): ?array
+    {
+        $pointerSize = Core::sizeOfType('void *');
+        $totalSlots  = intdiv($cacheSize, $pointerSize);
+        $slots       = $taken = [];
+        foreach ($body->instructions as $index => $instruction) {
+            $layout = self::slotLayoutOf($instruction);
+            if ($layout === null) {
+                continue;
+            }
+            [$field, $count] = $layout;
+            $offset          = match ($field) {
+                'result'         => $instruction->result,
+                'op2'            => $instruction->op2,
+                // Low bits carry fetch flags (ZEND_FETCH_OBJ_FLAGS, ZEND_ISEMPTY, ZEND_LAST_CATCH)
+                'extended_value' => $instruction->extendedValue & ~($pointerSize - 1),
+                'op_data'        => ($body->instructions[$index + 1] ?? null)?->opcode === OpCode::OP_DATA
+                    ? $body->instructions[$index + 1]->extendedValue
+                    : -1,
+            };
+            if ($offset < 0 || $offset % $pointerSize !== 0) {
+                return null;
+            }
+            $slot = intdiv($offset, $pointerSize);
+            if ($slot + $count > $totalSlots) {
+                return null;
+            }
+            for ($next = $slot; $next < $slot + $count; $next++) {
+                if (isset($taken[$next])) {
+                    return null;
+                }
+                $taken[$next] = true;
+            }
+            $slots[] = ['index' => $index, 'key' => self::keyOf($body, $instruction), 'slot' => $slot, 'count' => $count];
+        }
+
+        return $slots;
+    }
+
+    /**
+     * Returns where the slot offset of an opline is stored and how many slots it owns
+     *
+     * @return array{'result'|'op2'|'extended_value'|'op_data', int}|null
+     */
+    private static function slotLayoutOf(Instruction $instruction): ?array
+    {
+        $opcode     = $instruction->opcode;
+        $op1IsConst = $instruction->op1Type === OpLine::IS_CONST;
+        $op2IsConst = $instruction->op2Type === OpLine::IS_CONST;
+
+        return match (true) {
+            isset(self::FUNCTION_CALLS[$opcode])                   => ['result', 1],
+            $opcode === OpCode::INIT_METHOD_CALL                   => $op2IsConst ? ['result', 2] : null,
+            $opcode === OpCode::INIT_STATIC_METHOD_CALL            => match (true) {
+                $op2IsConst => ['result', 2],
+                $op1IsConst => ['result', 1],
+                default     => null,
+            },
+            $opcode === OpCode::NEW                                => $op1IsConst ? ['op2', 1] : null,
+            isset(self::EXTENDED_VALUE_SLOTS[$opcode])             => ['extended_value', 1],
+            $opcode === OpCode::INSTANCEOF                         => $op2IsConst ? ['extended_value', 1] : null,
+            $opcode === OpCode::FETCH_CLASS_CONSTANT               => $op2IsConst ? ['extended_value', 2] : null,
+            isset(self::PROPERTY_OPCODES[$opcode])                 => $op2IsConst ? ['extended_value', 3] : null,
+            isset(self::STATIC_PROPERTY_OPCODES[$opcode])          => $op1IsConst ? ['extended_value', 3] : null,
+            $opcode === OpCode::ASSIGN_OBJ_OP                      => $op2IsConst ? ['op_data', 3] : null,
+            $opcode === OpCode::ASSIGN_STATIC_PROP_OP              => $op1IsConst ? ['op_data', 3] : null,
+            default                                                => null,
+        };
+    }
+
+    /**
+     * Identifies what a slot caches: the opcode, its operand kinds and literal names
+     */
+    private static function keyOf(OpArrayBody $body, Instruction $instruction): string
+    {
+        $key = [$instruction->opcode];
+        foreach ([[$instruction->op1Type, $instruction->op1], [$instruction->op2Type, $instruction->op2]] as [$type, $value]) {
+            $key[] = match (true) {
+                $type === OpLine::IS_CONST  => $body->getLiteralType($value) === ReflectionValue::IS_STRING
+                    ? 's:' . $body->getLiteral($value)
+                    : 't:' . $body->getLiteralType($value),
+                // self/parent/static; INIT_FCALL keeps a frame size here, a multiple of the zval size
+                $type === OpLine::IS_UNUSED => 'u:' . ($value & self::FETCH_CLASS_MASK),
+                default                     => 'v:' . $type,
+            };
+        }
+
+        return implode('|', $key);
+    }
+
+    /**
+     * Returns a declared function the VM may call without initializing anything first
+     */
+    private static function findFunction(string $lowerName): ?CData
+    {
+        $entry = Core::$executor->functionTable->find($lowerName);
+        if ($entry === null) {
+            return null;
+        }
+        $rawFunction = $entry->getRawFunction();
+        if ($rawFunction->type === Core::ZEND_USER_FUNCTION && self::cacheOf($rawFunction->op_array) === null) {
+            return null;
+        }
+
+        return $rawFunction;
+    }
+
+    /**
+     * Returns a declared and linked class, never triggering autoloading
+     */
+    private static function findClass(string $lowerName): ?CData
+    {
+        $entry = Core::$executor->classTable->find($lowerName);
+        if ($entry === null) {
+            return null;
+        }
+        try {
+            $rawClass = $entry->getRawClass();
+        } catch (\UnexpectedValueException $e) {
+            // A class alias: left to the VM, which resolves it through the alias
+            return null;
+        }
+
+        return ($rawClass->ce_flags & Core::ZEND_ACC_LINKED) !== 0 ? $rawClass : null;
+    }
+
+    /**
+     * Returns the run-time cache of an op_array, null while it was never initialized
+     *
+     * Immutable (opcache shared-memory) op_arrays keep the offset form of ZEND_MAP_PTR, an odd
+     * byte offset into CG(map_ptr_base), see FunctionLikeTrait::getStaticVariables().
+     *
+     * @param CData|object $opArray zend_op_array
+     *
+     * @return CData|null void **
+     *
+     * @internal also used by PropertyWriteCaches to clear the slots of one class
+     */
+    public static function cacheOf(object $opArray): ?CData
+    {
+        $cache = $opArray->run_time_cache__ptr;
+        if ($cache === null) {
+            return null;
+        }
+        $rawFieldValue = Core::addressOf($cache);
+        if (($rawFieldValue & 1) === 0) {
+            return $cache;
+        }
+        $mapPointerBase = Core::$compiler->getMapPointerBaseAddress();
+        if ($mapPointerBase === 0
+            || intdiv($rawFieldValue - 1, Core::sizeOfType('void *')) >= Core::$compiler->getMapPointerLast()
+        ) {
+            return null;
+        }
+
+        return Core::pointerAtAddress('void **', $mapPointerBase + $rawFieldValue)[0];
+    }
+}
@@ -0,0 +1,58 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Reflection;
+
+/**
+ * How a body swap fills the fresh run-time cache of the swapped entry
+ *
+ * Every swap installs a zeroed cache sized for the new body, so function, class, property and
+ * constant lookups are resolved again on first use. The warm policies take that cold phase out
+ * of the request that first runs the new body; see RunTimeCacheWarmer for what is filled.
+ */
+enum RunTimeCacheWarmup
+{
+    /** Keep the zeroed cache: every slot is resolved by the VM on first use */
+    case Cold;
+
+    /** Copy the slots of oplines that the previous body shares with the new one */
+    case Copy;
+
+    /** Resolve the function and class names of already loaded entries into the empty slots */
+    case Prefill;
+
+    /** Copy first, then prefill what is still empty */
+    case CopyAndPrefill;
+
+    public function copiesSlots(): bool
+    {
+        return $this === self::Copy || $this === self::CopyAndPrefill;
+    }
+
+    public function prefillsSlots(): bool
+    {
+        return $this === self::Prefill || $this === self::CopyAndPrefill;
+    }
+
+    /**
+     * Returns the policy without its copy step, for swaps whose previous slots may be stale
+     */
+    public function withoutCopy(): self
+    {
+        return match ($this) {
+            self::Copy           => self::Cold,
+            self::CopyAndPrefill => self::Prefill,
+            default              => $this,
+        };
+    }
+}
@@ -375,6 +375,8 @@ class Compiler
      */
     public function parseString(string $source, string $fileName = ''): NodeInterface
     {
+        Core::requireHeaderSlice('compiler');
+
         // The scanner takes ownership semantics on this zval: it may release the string
         // inside and replace it with a padded copy, so the container must hold its own
         // reference - release() then drops whichever string ends up inside
@@ -16,6 +16,8 @@ namespace ZEngine\System;
 use FFI\CData;
 use ZEngine\Core;
 use ZEngine\Generated\zend_execute_data;
+use ZEngine\Generated\zend_function;
+use ZEngine\Generated\zend_op;
 use ZEngine\Generated\zval;
 use ZEngine\Reflection\FunctionLikeTrait;
 use ZEngine\Reflection\ReflectionClass;
@@ -71,12 +73,37 @@ use ZEngine\Type\OpLine;
  */
 class ExecutionData
 {
+    /**
+     * Selects the first operand of the current opline in the raw operand accessors
+     */
+    public const int OP1 = 1;
+
+    /**
+     * Selects the second operand of the current opline in the raw operand accessors
+     */
+    public const int OP2 = 2;
+
+    /**
+     * sizeof(zend_op), resolved on the first getOplineIndex() call
+     */
+    private static ?int $oplineSize = null;
+
     /**
      * @var zend_execute_data Typed view of the wrapped frame; the runtime value is
      *                        the raw FFI\CData handle (see stubs/zend-engine-structs.php)
      */
     private object $pointer;
 
+    /**
+     * Wrapper of the current opline, materialized on the first getOpline() call
+     */
+    private ?OpLine $opline = null;
+
+    /**
+     * Address of the zend_op the cached wrapper points at, the opline pointer moves as the frame runs
+     */
+    private int $oplineAddress = 0;
+
     /**
      * @param CData|zend_execute_data $pointer
      */
@@ -86,15 +113,88 @@ class ExecutionData
         $this->pointer = $pointer;
     }
 
+    /**
+     * Points this wrapper at another frame, dropping everything derived from the previous one
+     *
+     * Hook dispatch (OpCodeHook, InterruptHook) keeps one instance per hook and rebinds it on
+     * every hit instead of allocating a wrapper per call, so the instance a handler receives
+     * is only valid until the handler returns: keep the values, not the wrapper.
+     *
+     * @param CData|zend_execute_data $pointer
+     * @internal
+     */
+    public function rebind(object $pointer): static
+    {
+        /** @var zend_execute_data $pointer Narrowed to the stub view at the owning boundary */
+        $this->pointer       = $pointer;
+        $this->opline        = null;
+        $this->oplineAddress = 0;
+
+        return $this;
+    }
+
     /**
      * Returns the currently executed opline
+     *
+     * The wrapper is built on first use and reused while the frame stays on the same opline.
      */
     public function getOpline(): OpLine
     {
         $opline = $this->pointer->opline;
         assert($opline !== null);
+        $address = Core::pointerAddressOf($opline);
+        if ($this->opline === null || $this->oplineAddress !== $address) {
+            $this->opline        = new OpLine($opline, $this);
+            $this->oplineAddress = $address;
+        }
+
+        return $this->opline;
+    }
+
+    /**
+     * Returns the zval type (ReflectionValue::IS_* constant) held by an operand of the current opline
+     *
+     * The allocation-free counterpart of getOpline()->getOp1()->getType() for hot handlers:
+     * no OpLine or ReflectionValue is built. Unused operands report IS_UNDEF, a CV bound by
+     * reference reports IS_REFERENCE (its payload is not dereferenced).
+     *
+     * @param int $operand ExecutionData::OP1 or ExecutionData::OP2
+     */
+    public function getOperandType(int $operand): int
+    {
+        $value = $this->getOperandValue($operand);
+
+        return $value === null ? ReflectionValue::IS_UNDEF : $value->u1->v->type;
+    }
+
+    /**
+     * Returns the integer payload of an IS_LONG operand of the current opline
+     *
+     * @param int $operand ExecutionData::OP1 or ExecutionData::OP2
+     */
+    public function getOperandLong(int $operand): int
+    {
+        $value = $this->getOperandValue($operand);
+        if ($value === null || $value->u1->v->type !== ReflectionValue::IS_LONG) {
+            throw new \UnexpectedValueException('Integer payload available only for operands of the type IS_LONG');
+        }
 
-        return new OpLine($opline, $this);
+        return $value->value->lval;
+    }
+
+    /**
+     * Returns the float payload of an IS_DOUBLE operand of the current opline
+     *
+     * @param int $operand ExecutionData::OP1 or ExecutionData::OP2
+     */
+    public function getOperandDouble(int $operand): float
+    {
+        $value = $this->getOperandValue($operand);
+        if ($value === null || $value->u1->v->type !== ReflectionValue::IS_DOUBLE) {
+            throw new \UnexpectedValueException('Float payload available only for operands of the type IS_DOUBLE');
+        }
+
+        return $value->value->dval;
     }
 
     /**
@@ -107,8 +207,9 @@ class ExecutionData
         // Pointer arithmetic on the raw frame view: advancing opline by one zend_op.
         // The raw CData view keeps the field reads/writes untyped (FFI handles the
         // pointer arithmetic), the typed stub does not model pointer + int.
-        $rawFrame = Core::cast('zend_execute_data *', $this->pointer);
+        $rawFrame = Core::castPointer('zend_execute_data *', $this->pointer);
         $rawFrame->opline++;
+        $this->opline = null;
     }
 
     /**
@@ -166,6 +267,57 @@ class ExecutionData
         return ReflectionFunction::fromCData($rawFunction);
     }
 
+    /**
+     * Returns the raw zend_function this frame executes, or null for frames without one
+     *
+     * A BORROWED engine pointer and no wrapper at all: meant for per-frame hot paths such as
+     * the sampling profiler, which must not build a reflection for every frame it walks.
+     *
+     * @return zend_function|null
+     */
+    public function getRawFunction(): ?object
+    {
+        return $this->pointer->func;
+    }
+
+    /**
+     * Returns the source line this frame currently executes, or 0 when the frame runs no
+     * user code (internal functions never publish an opline of their own)
+     */
+    public function getLine(): int
+    {
+        $function = $this->pointer->func;
+        if ($function === null || $function->type !== Core::ZEND_USER_FUNCTION) {
+            return 0;
+        }
+        $opline = $this->pointer->opline;
+
+        return $opline === null ? 0 : $opline->lineno;
+    }
+
+    /**
+     * Returns the position of the current opline within the op_array of this frame, or -1 when
+     * the frame runs no user code
+     *
+     * The position is stable for the op_array's lifetime and addresses the same opline as
+     * `op_array->opcodes[$index]`, which makes it the natural key for per-opline state.
+     */
+    public function getOplineIndex(): int
+    {
+        $function = $this->pointer->func;
+        if ($function === null || $function->type !== Core::ZEND_USER_FUNCTION) {
+            return -1;
+        }
+        $opline = $this->pointer->opline;
+        if ($opline === null) {
+            return -1;
+        }
+        self::$oplineSize ??= Core::sizeOfType(zend_op::class);
+        $offset = Core::pointerAddressOf($opline) - Core::pointerAddressOf($function->op_array->opcodes);
+
+        return intdiv($offset, self::$oplineSize);
+    }
+
     /**
      * Returns the class scope of the code executing in this frame as a framework
      * wrapper, or null when there is none (plain function, unbound closure, main
@@ -409,8 +561,8 @@ class ExecutionData
     public function getCallVariable(int $variableOffset): object
     {
         // ((zval*)(((char*)(call)) + ((int)(n))))
-        $pointer = Core::cast('char *', $this->pointer) + $variableOffset;
-        $value   = Core::cast('zval *', $pointer);
+        $pointer = Core::castPointer('char *', $this->pointer) + $variableOffset;
+        $value   = Core::castPointer('zval *', $pointer);
 
         return $value;
     }
@@ -433,11 +585,39 @@ class ExecutionData
     public function getCallVariableByNumber(int $variableNum): object
     {
         // (((zval*)(call)) + (ZEND_CALL_FRAME_SLOT + ((int)(n))))
-        $pointer = Core::cast('zval *', $this->pointer);
+        $pointer = Core::castPointer('zval *', $this->pointer);
 
         return $pointer + self::getCallFrameSlot() + $variableNum;
     }
 
+    /**
+     * Resolves the zval of an operand of the current opline, null for unused operands
+     *
+     * The wrapper-free form of OpLine::getValuePointer(): literals live at a byte offset from
+     * the opline (RT_CONSTANT), every other operand kind at a byte offset from the frame
+     * (ZEND_CALL_VAR), so one typed view at the final address is all that gets created.
+     *
+     * @return zval|null zval* pointer; the runtime value is always raw CData
+     */
+    private function getOperandValue(int $operand): ?object
+    {
+        $opline = $this->pointer->opline;
+        if ($opline === null) {
+            return null;
+        }
+        [$node, $opType] = match ($operand) {
+            self::OP1 => [$opline->op1, $opline->op1_type],
+            self::OP2 => [$opline->op2, $opline->op2_type],
+            default   => throw new \InvalidArgumentException('Operand must be ExecutionData::OP1 or ExecutionData::OP2'),
+        };
+
+        return match ($opType) {
+            OpLine::IS_UNUSED => null,
+            OpLine::IS_CONST  => Core::pointerAtAddress(zval::class, Core::pointerAddressOf($opline) + $node->constant),
+            default           => Core::pointerAtAddress(zval::class, Core::pointerAddressOf($this->pointer) + $node->var),
+        };
+    }
+
     /**
      * Returns the shaped view of the frame's This zval, which carries the frame
      * flags (call_info in u1.type_info) and the argument count (u2.num_args)
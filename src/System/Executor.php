@@ -269,6 +269,14 @@ class Executor
         return $precision;
     }
 
+    /**
+     * Returns the address of EG(error_zval), the value object handlers return after throwing
+     */
+    public function getErrorZvalAddress(): int
+    {
+        return Core::addressOf(Core::addr($this->pointer->error_zval));
+    }
+
     /**
      * Returns the script timeout in seconds (EG(timeout_seconds), the "max_execution_time" ini)
      */
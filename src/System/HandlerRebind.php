@@ -0,0 +1,103 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\System;
+
+use FFI\CData;
+use ZEngine\Core;
+use ZEngine\Generated\zend_op;
+use ZEngine\Generated\zend_op_array;
+use ZEngine\Type\StructArray;
+
+/**
+ * Re-derives the baked opline handlers of already compiled op_arrays
+ *
+ * The VM dispatches on opline->handler, which pass_two() bakes once per opline from the opcode,
+ * the operand types and zend_user_opcodes[] - the table zend_set_user_opcode_handler() flips
+ * to ZEND_USER_OPCODE while a user handler is installed. That is why an opcode hook only sees
+ * op_arrays compiled after it was installed (docs/self-debugging.md). Rebinding runs the very
+ * same derivation, zend_vm_set_opcode_handler(), over existing oplines: after an install it
+ * routes them to the user handler, after an uninstall back to the native one. Hot code can be
+ * instrumented and released on demand, without recompiling it or restarting the worker.
+ *
+ * Only oplines of the requested opcodes are touched. The optimizer bakes some oplines with
+ * type-specialized handlers (zend_vm_set_opcode_handler_ex()); a rebound opline gets the
+ * generic handler of its opcode instead, which is equivalent for every operand type, just
+ * not the fastest variant.
+ *
+ * Op_arrays in opcache shared memory are never rewritten here (their opcodes serve every
+ * worker): FunctionLikeTrait::rebindOpcodeHandlers() first moves such a function to a
+ * private, writable body.
+ */
+final class HandlerRebind
+{
+    /**
+     * Rebinds the oplines of the given opcodes in one op_array, returns how many were rebound
+     *
+     * @param CData|zend_op_array $opArray Writable op_array (never an opcache-shared one)
+     * @param list<int>           $opCodes One or more OpCode::* constants
+     */
+    public static function rebind(object $opArray, array $opCodes): int
+    {
+        if ($opCodes === [] || $opArray->opcodes === null) {
+            return 0;
+        }
+        $wanted = array_fill_keys($opCodes, true);
+        $count  = 0;
+        foreach (new StructArray($opArray->opcodes, $opArray->last) as $opline) {
+            if (isset($wanted[$opline->opcode])) {
+                self::rebindOpline($opline);
+                $count++;
+            }
+        }
+
+        return $count;
+    }
+
+    /**
+     * Rebinds the given opcodes in every reachable, writable op_array compiled from a file
+     *
+     * @param list<int> $opCodes One or more OpCode::* constants
+     *
+     * @see StatementStrip::fileOpArrays() for what is reachable
+     */
+    public static function rebindFile(string $fileName, array $opCodes): int
+    {
+        $count = 0;
+        foreach (StatementStrip::fileOpArrays($fileName) as $opArray) {
+            $count += self::rebind($opArray, $opCodes);
+        }
+
+        return $count;
+    }
+
+    /**
+     * Recomputes opline->handler from the current opcode, operand types and user handler table
+     *
+     * @param CData|zend_op $opline
+     *
+     * @throws \RuntimeException When the engine definitions predate the zend_vm_set_opcode_handler export
+     */
+    public static function rebindOpline(object $opline): void
+    {
+        try {
+            Core::call('zend_vm_set_opcode_handler', Core::addr($opline));
+        } catch (\FFI\Exception $e) {
+            throw new \RuntimeException(
+                'Engine definitions do not declare zend_vm_set_opcode_handler (regenerate with `composer gen-headers`)',
+                0,
+                $e,
+            );
+        }
+    }
+}
@@ -49,6 +49,11 @@ final class InterruptHook extends AbstractHook
      */
     protected object $executeData;
 
+    /**
+     * Frame wrapper handed out by getExecutionData(), rebound instead of reallocated
+     */
+    private ?ExecutionData $executionData = null;
+
     /**
      * typedef void (*zend_interrupt_function)(zend_execute_data *execute_data);
      *
@@ -66,10 +71,15 @@ final class InterruptHook extends AbstractHook
 
     /**
      * Returns the interrupted stack frame
+     *
+     * The same instance is rebound on every interrupt (see ExecutionData::rebind()), so it
+     * describes the interrupted frame only until the handler returns.
      */
     public function getExecutionData(): ExecutionData
     {
-        return new ExecutionData($this->executeData);
+        $this->executionData ??= new ExecutionData($this->executeData);
+
+        return $this->executionData->rebind($this->executeData);
     }
 
     /**
@@ -0,0 +1,153 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\System\Hook;
+
+use Closure;
+use FFI\CData;
+use ZEngine\Core;
+use ZEngine\Generated\zend_execute_data;
+use ZEngine\Generated\zend_op_array;
+use ZEngine\Reflection\ReflectionFunction;
+
+/**
+ * Decides once per op_array whether the frames executing it reach an opcode hook
+ *
+ * OpCodeHook::handle() runs on every execution of the hooked opcode - with
+ * COMPILE_EXTENDED_STMT on, that is every statement of every instrumented file. Resolving the
+ * frame's scope class there (an ExecutionData, a ReflectionFunction and a ReflectionClass per
+ * hit) made z-engine's own self-exclusion the dominant cost of a statement hook. The gate
+ * memoizes the verdict by the op_array's opcodes address instead: a hit on an already decided
+ * op_array reads a handful of fields off the frame and allocates no wrapper at all.
+ *
+ * Keying by opcodes rather than by the zend_function address makes every closure instance of
+ * one declaration share a decision (zend_create_closure() copies the op_array, not its
+ * opcodes). Addresses can be reused once an op_array is destroyed (eval()'d and non-cached
+ * top-level code are freed right after they run), so each decision also records the op_array's
+ * line span and opcode count and is re-taken whenever those disagree with the frame.
+ *
+ * The verdict combines, in order: z-engine's own code (scope class in the ZEngine namespace) is
+ * never admitted (see docs/self-debugging.md); the optional file filter, asked once per file;
+ * the optional function filter, asked once per op_array.
+ */
+final class OpArrayGate
+{
+    /**
+     * Class-name prefix of z-engine's own code: opcodes executed by a frame whose scope
+     * starts with it never reach a user handler, which keeps the framework from calling
+     * back into itself
+     */
+    private const string ENGINE_SCOPE_PREFIX = 'ZEngine';
+
+    /**
+     * Memoized verdicts keyed by opcodes address: [line_start, line_end, last, admitted]
+     *
+     * @var array<int, array{int, int, int, bool}>
+     */
+    private array $decisions = [];
+
+    /**
+     * Memoized file filter verdicts keyed by file name
+     *
+     * @var array<string, bool>
+     */
+    private array $fileDecisions = [];
+
+    /**
+     * Set while a verdict is being taken: the reflection and the filters run PHP code that
+     * executes the hooked opcode too, and must not recurse into deciding their own frames
+     */
+    private bool $deciding = false;
+
+    /**
+     * @param (Closure(string): bool)|null             $fileFilter     Whether code of the given file is
+     *                                                                 instrumented, asked once per file
+     * @param (Closure(ReflectionFunction): bool)|null $functionFilter Whether the given op_array is
+     *                                                                 instrumented, asked once per op_array
+     */
+    public function __construct(
+        private readonly ?Closure $fileFilter = null,
+        private readonly ?Closure $functionFilter = null,
+    ) {}
+
+    /**
+     * Checks whether the frame executing the hooked opcode should reach the user handler
+     *
+     * @param CData|zend_execute_data $executeData Frame the user opcode handler was called with
+     */
+    public function admits(object $executeData): bool
+    {
+        $function = $executeData->func;
+        if ($function === null) {
+            return false;
+        }
+        /** @var zend_op_array $opArray */
+        $opArray   = $function->op_array;
+        $key       = Core::pointerAddressOf($opArray->opcodes);
+        $lineStart = $opArray->line_start;
+        $lineEnd   = $opArray->line_end;
+        $last      = $opArray->last;
+
+        $decision = $this->decisions[$key] ?? null;
+        if ($decision !== null && $decision[0] === $lineStart && $decision[1] === $lineEnd && $decision[2] === $last) {
+            return $decision[3];
+        }
+
+        if ($this->deciding) {
+            return false;
+        }
+        $this->deciding = true;
+        try {
+            $admitted = $this->decide(ReflectionFunction::fromCData($function));
+        } finally {
+            $this->deciding = false;
+        }
+        $this->decisions[$key] = [$lineStart, $lineEnd, $last, $admitted];
+
+        return $admitted;
+    }
+
+    /**
+     * Drops every memoized verdict, eg after the filters' inputs changed (new breakpoints)
+     */
+    public function reset(): void
+    {
+        $this->decisions     = [];
+        $this->fileDecisions = [];
+    }
+
+    /**
+     * Returns the number of op_arrays with a memoized verdict
+     */
+    public function getDecisionCount(): int
+    {
+        return count($this->decisions);
+    }
+
+    private function decide(ReflectionFunction $function): bool
+    {
+        $scope = $function->getClosureScopeClass()?->getName();
+        if ($scope !== null && str_starts_with($scope, self::ENGINE_SCOPE_PREFIX)) {
+            return false;
+        }
+        if ($this->fileFilter !== null) {
+            $fileName = $function->getFileName() ?? '';
+            $this->fileDecisions[$fileName] ??= (bool) ($this->fileFilter)($fileName);
+            if (!$this->fileDecisions[$fileName]) {
+                return false;
+            }
+        }
+
+        return $this->functionFilter === null || (bool) ($this->functionFilter)($function);
+    }
+}
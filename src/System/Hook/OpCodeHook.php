@@ -43,16 +43,14 @@ final class OpCodeHook implements HookInterface
     private const string FIELD_KEY_PREFIX = 'user-opcode';
 
     /**
-     * Class-name prefix of z-engine's own code: opcodes executed by a frame whose scope
-     * starts with it never reach a user handler, which keeps the framework from calling
-     * back into itself (see docs/self-debugging.md)
+     * Custom user handler with signature function($scope): int
      */
-    private const string ENGINE_SCOPE_PREFIX = 'ZEngine';
+    private Closure $userHandler;
 
     /**
-     * Custom user handler with signature function($scope): int
+     * Per-op_array verdict on which frames reach the user handler (z-engine's own code never does)
      */
-    private Closure $userHandler;
+    private OpArrayGate $gate;
 
     /**
      * Hooked operation code, one of OpCode::* constants
@@ -71,11 +69,22 @@ final class OpCodeHook implements HookInterface
      */
     private bool $installed = false;
 
-    public function __construct(int $opCode, Closure $userHandler)
+    /**
+     * Frame wrapper rebound on every admitted hit, see ExecutionData::rebind()
+     */
+    private ?ExecutionData $scope = null;
+
+    /**
+     * Whether the user handler is currently running with $scope, a nested hit gets its own wrapper
+     */
+    private bool $dispatching = false;
+
+    public function __construct(int $opCode, Closure $userHandler, ?OpArrayGate $gate = null)
     {
         self::ensureValidOpCodeHandler($userHandler);
         $this->opCode      = $opCode;
         $this->userHandler = $userHandler;
+        $this->gate        = $gate ?? new OpArrayGate();
     }
 
     /**
@@ -99,7 +108,7 @@ final class OpCodeHook implements HookInterface
         assert($previousHandler === null || $previousHandler instanceof CData);
         $this->originalHandler = $previousHandler;
 
-        $result = Core::call('zend_set_user_opcode_handler', $this->opCode, $this->handle(...));
+        $result = Core::call('zend_set_user_opcode_handler', $this->opCode, Core::hookTrampoline($this));
         if ($result === Core::FAILURE) {
             throw OpCodeHookException::handlerInstallFailed();
         }
@@ -174,6 +183,14 @@ final class OpCodeHook implements HookInterface
         return $this->opCode;
     }
 
+    /**
+     * Returns the gate that decides which frames reach the user handler
+     */
+    public function getGate(): OpArrayGate
+    {
+        return $this->gate;
+    }
+
     /**
      * @inheritDoc
      */
@@ -205,7 +222,7 @@ final class OpCodeHook implements HookInterface
         if (!$this->installed) {
             return;
         }
-        Core::call('zend_set_user_opcode_handler', $this->opCode, $this->handle(...));
+        Core::call('zend_set_user_opcode_handler', $this->opCode, Core::hookTrampoline($this));
     }
 
     /**
@@ -213,12 +230,14 @@ final class OpCodeHook implements HookInterface
      *
      * typedef int (*user_opcode_handler_t)(zend_execute_data *execute_data);
      *
-     * The frame that executes the opcode is the callback argument itself, so the class
-     * scope that decides whether z-engine's own code is running is read straight off it
-     * (see ExecutionData::getScopeClass()) - no stack walk is needed, and none is
-     * affordable here: this runs on EVERY execution of the hooked opcode. Stacked hooks
-     * pass the very same execute_data down the chain, so a delegated call resolves the
-     * same executing frame as the top hook did, with no delegation frames to skip.
+     * The frame that executes the opcode is the callback argument itself, and the gate
+     * decides from its op_array whether the hit reaches the user handler - once per op_array,
+     * since this runs on EVERY execution of the hooked opcode (see OpArrayGate). Excluded
+     * frames, z-engine's own code among them, are dispatched without allocating a single
+     * wrapper. Admitted frames reuse one ExecutionData rebound to the incoming frame, only
+     * a hit nested inside the user handler (the handler runs code with the same opcode) gets
+     * a fresh one. Stacked hooks pass the very same execute_data down the chain, so a
+     * delegated call gates the same executing frame as the top hook did.
      *
      * @param mixed ...$rawArguments Raw C arguments of this callback (zend_execute_data*)
      */
@@ -228,16 +247,28 @@ final class OpCodeHook implements HookInterface
         [$state] = $rawArguments;
         assert($state instanceof CData);
 
-        $executionState = new ExecutionData($state);
-        $frameScope     = $executionState->getScopeClass()?->getName();
-        if ($frameScope !== null && str_starts_with($frameScope, self::ENGINE_SCOPE_PREFIX)) {
-            // For all our internal classes just proceed with default opcode handler
+        if (!$this->gate->admits($state)) {
+            // Excluded frames (our internal classes among them) proceed with the default opcode handler
+            Core::recordHookProceed($this);
 
             return Core::ZEND_USER_OPCODE_DISPATCH;
         }
 
-        $handleResult = ($this->userHandler)($executionState);
+        if ($this->dispatching) {
+            $handleResult = ($this->userHandler)(new ExecutionData($state));
+        } else {
+            $this->dispatching = true;
+            try {
+                $this->scope ??= new ExecutionData($state);
+                $handleResult  = ($this->userHandler)($this->scope->rebind($state));
+            } finally {
+                $this->dispatching = false;
+            }
+        }
         assert(is_int($handleResult));
+        if ($handleResult === Core::ZEND_USER_OPCODE_DISPATCH) {
+            Core::recordHookProceed($this);
+        }
 
         if ($handleResult === Core::ZEND_USER_OPCODE_DISPATCH && $this->originalHandler !== null) {
             // Chain to the user handler that was installed on this opcode before this hook
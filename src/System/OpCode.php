@@ -15,6 +15,7 @@ namespace ZEngine\System;
 
 use Closure;
 use ZEngine\Core;
+use ZEngine\System\Hook\OpArrayGate;
 use ZEngine\System\Hook\OpCodeHook;
 use ZEngine\Type\ConstantNames;
 
@@ -254,17 +255,60 @@ final class OpCode
      * installed user handler on ZEND_USER_OPCODE_DISPATCH, unwinds automatically at
      * Core::shutdown() and can be uninstalled explicitly via the returned hook.
      *
-     * @param int     $opCode  Operation code to hook
-     * @param Closure $handler Callback that will receive a control for overloaded operation code
+     * An optional gate scopes the handler to the frames it admits (see OpArrayGate); excluded
+     * frames dispatch to the VM handler without ever reaching PHP code.
+     *
+     * @param int              $opCode  Operation code to hook
+     * @param Closure          $handler Callback that will receive a control for overloaded operation code
+     * @param OpArrayGate|null $gate    Per-op_array frame filter, z-engine's own code is always excluded
      */
-    public static function setHandler(int $opCode, Closure $handler): OpCodeHook
+    public static function setHandler(int $opCode, Closure $handler, ?OpArrayGate $gate = null): OpCodeHook
     {
-        $hook = new OpCodeHook($opCode, $handler);
+        $hook = new OpCodeHook($opCode, $handler, $gate);
         $hook->install();
 
         return $hook;
     }
 
+    /**
+     * Strips the EXT_STMT statements of every reachable op_array of a file (see StatementStrip)
+     *
+     * Use it to silence a statement hook for files no breakpoint or coverage consumer
+     * targets: the stripped statements never reach the libffi trampoline again until
+     * restoreStatements() puts them back.
+     *
+     * @return int Number of stripped statements
+     */
+    public static function stripStatements(string $fileName): int
+    {
+        return StatementStrip::stripFile($fileName);
+    }
+
+    /**
+     * Puts back the EXT_STMT statements stripStatements() removed from a file
+     *
+     * @return int Number of restored statements
+     */
+    public static function restoreStatements(string $fileName): int
+    {
+        return StatementStrip::restoreFile($fileName);
+    }
+
+    /**
+     * Rebinds the given opcodes in every reachable op_array of an already compiled file
+     *
+     * User opcode handlers only reach code compiled after their installation; call this after
+     * setHandler() to instrument a file that is already loaded, and again after uninstalling
+     * the hook to release it (see HandlerRebind). Opcache-shared op_arrays are skipped - rebind
+     * those per function through FunctionLikeTrait::rebindOpcodeHandlers().
+     *
+     * @return int Number of rebound oplines
+     */
+    public static function rebindHandlers(string $fileName, int ...$opCodes): int
+    {
+        return HandlerRebind::rebindFile($fileName, array_values($opCodes));
+    }
+
     /**
      * Restores the previous opcode handler by uninstalling the top hook for that opcode
      *
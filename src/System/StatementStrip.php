@@ -0,0 +1,252 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\System;
+
+use FFI\CData;
+use ZEngine\Core;
+use ZEngine\Generated\zend_op;
+use ZEngine\Generated\zend_op_array;
+use ZEngine\Type\HashTable;
+use ZEngine\Type\StructArray;
+
+/**
+ * Strips EXT_STMT statement markers out of compiled op_arrays and puts them back on demand
+ *
+ * With COMPILE_EXTENDED_STMT on, every statement of every compiled file starts with an
+ * EXT_STMT opline, and once a user opcode handler is installed for it each of them crosses
+ * the libffi trampoline - whether or not a breakpoint or coverage consumer cares about that
+ * file (docs/self-debugging.md). Stripping rewrites those oplines to NOP and restoring turns
+ * them back into EXT_STMT; both re-bake opline->handler through zend_vm_set_opcode_handler(),
+ * because the VM dispatches on the baked handler pointer, never on the opcode byte.
+ *
+ * Restoring re-derives the handler instead of writing back a saved pointer, so a statement
+ * restored after its hook was uninstalled runs the native EXT_STMT handler (and one restored
+ * after a hook was installed reaches that hook) - exactly what a fresh compilation would bake.
+ *
+ * Stripped positions are remembered per process, keyed by the opcodes address; only oplines
+ * that this class turned into NOP are ever turned back. Op_arrays in opcache shared memory
+ * (ZEND_ACC_IMMUTABLE) are never touched: their opcodes are shared by every worker process.
+ */
+final class StatementStrip
+{
+    /**
+     * Stripped opline positions keyed by opcodes address
+     *
+     * @var array<int, list<int>>
+     */
+    private static array $strippedOplines = [];
+
+    /**
+     * Rewrites the EXT_STMT oplines of one op_array to NOP and returns how many were stripped
+     *
+     * Idempotent: an op_array that is already stripped reports zero.
+     *
+     * @param CData|zend_op_array $opArray Writable op_array (never an opcache-shared one)
+     */
+    public static function strip(object $opArray): int
+    {
+        $opcodesAddress = Core::pointerAddressOf($opArray->opcodes);
+        $stripped       = self::$strippedOplines[$opcodesAddress] ?? [];
+        $count          = 0;
+        try {
+            foreach (self::oplines($opArray) as $index => $opline) {
+                if ($opline->opcode !== OpCode::EXT_STMT) {
+                    continue;
+                }
+                $opline->opcode = OpCode::NOP;
+                try {
+                    HandlerRebind::rebindOpline($opline);
+                } catch (\RuntimeException $e) {
+                    // Never leave a NOP behind that still carries the EXT_STMT handler
+                    $opline->opcode = OpCode::EXT_STMT;
+
+                    throw $e;
+                }
+                $stripped[] = $index;
+                $count++;
+            }
+        } finally {
+            if ($stripped !== []) {
+                self::$strippedOplines[$opcodesAddress] = $stripped;
+            }
+        }
+
+        return $count;
+    }
+
+    /**
+     * Rewrites a single EXT_STMT opline to NOP, returns false when that opline is no EXT_STMT
+     *
+     * The position joins the ones strip() remembers, so restore() brings it back too. Safe to
+     * call on the opline currently executing: the rewrite only changes what the next execution
+     * of that opline dispatches to.
+     *
+     * @param CData|zend_op_array $opArray Writable op_array (never an opcache-shared one)
+     * @param int                 $index   Position of the opline within the op_array
+     */
+    public static function stripOpline(object $opArray, int $index): bool
+    {
+        if ($index < 0 || $index >= $opArray->last) {
+            return false;
+        }
+        $opline = self::oplines($opArray)[$index];
+        if ($opline->opcode !== OpCode::EXT_STMT) {
+            return false;
+        }
+        $opline->opcode = OpCode::NOP;
+        try {
+            HandlerRebind::rebindOpline($opline);
+        } catch (\RuntimeException $e) {
+            $opline->opcode = OpCode::EXT_STMT;
+
+            throw $e;
+        }
+        self::$strippedOplines[Core::pointerAddressOf($opArray->opcodes)][] = $index;
+
+        return true;
+    }
+
+    /**
+     * Turns the oplines strip() rewrote back into EXT_STMT and returns how many were restored
+     *
+     * @param CData|zend_op_array $opArray Op_array previously passed to strip()
+     */
+    public static function restore(object $opArray): int
+    {
+        $opcodesAddress = Core::pointerAddressOf($opArray->opcodes);
+        if (!isset(self::$strippedOplines[$opcodesAddress])) {
+            return 0;
+        }
+        $oplines = new StructArray($opArray->opcodes, $opArray->last);
+        $count   = 0;
+        foreach (self::$strippedOplines[$opcodesAddress] as $index) {
+            // A destroyed op_array may have left its address to a new one: only NOPs are ours
+            if ($index >= $opArray->last || $oplines[$index]->opcode !== OpCode::NOP) {
+                continue;
+            }
+            $oplines[$index]->opcode = OpCode::EXT_STMT;
+            HandlerRebind::rebindOpline($oplines[$index]);
+            $count++;
+        }
+        unset(self::$strippedOplines[$opcodesAddress]);
+
+        return $count;
+    }
+
+    /**
+     * Checks whether strip() rewrote any opline of the given op_array
+     *
+     * @param CData|zend_op_array $opArray
+     */
+    public static function isStripped(object $opArray): bool
+    {
+        return isset(self::$strippedOplines[Core::pointerAddressOf($opArray->opcodes)]);
+    }
+
+    /**
+     * Strips every op_array compiled from the given file that is still reachable
+     *
+     * Reachable means: global functions, methods of declared classes and the closures both
+     * declare (op_array dynamic_func_defs). The file's top-level code is not - the engine
+     * frees it once it ran, unless opcache holds it, and then it is shared memory anyway.
+     *
+     * @return int Number of EXT_STMT oplines stripped
+     */
+    public static function stripFile(string $fileName): int
+    {
+        $count = 0;
+        foreach (self::fileOpArrays($fileName) as $opArray) {
+            $count += self::strip($opArray);
+        }
+
+        return $count;
+    }
+
+    /**
+     * Restores every op_array of the given file that stripFile() (or strip()) rewrote
+     *
+     * @return int Number of EXT_STMT oplines restored
+     */
+    public static function restoreFile(string $fileName): int
+    {
+        $count = 0;
+        foreach (self::fileOpArrays($fileName) as $opArray) {
+            $count += self::restore($opArray);
+        }
+
+        return $count;
+    }
+
+    /**
+     * @param CData|zend_op_array $opArray
+     *
+     * @return StructArray<zend_op>
+     */
+    private static function oplines(object $opArray): StructArray
+    {
+        return new StructArray($opArray->opcodes, $opArray->last);
+    }
+
+    /**
+     * Collects the writable op_arrays declared by a file that are still reachable, each once
+     *
+     * @internal shared with the coverage collector, which reports the statements of functions
+     *           that never ran
+     *
+     * @return list<zend_op_array>
+     */
+    public static function fileOpArrays(string $fileName): array
+    {
+        $opArrays = [];
+        $visit    = static function (object $opArray) use (&$visit, &$opArrays, $fileName): void {
+            /** @var zend_op_array $opArray */
+            if ($opArray->filename === null || $opArray->opcodes === null) {
+                return;
+            }
+            if (($opArray->fn_flags & Core::ZEND_ACC_IMMUTABLE) !== 0) {
+                return;
+            }
+            $address = Core::pointerAddressOf($opArray->opcodes);
+            if (isset($opArrays[$address])) {
+                return;
+            }
+            if (\FFI::string($opArray->filename->val, $opArray->filename->len) !== $fileName) {
+                return;
+            }
+            $opArrays[$address] = $opArray;
+            for ($i = 0; $i < $opArray->num_dynamic_func_defs; $i++) {
+                $visit($opArray->dynamic_func_defs[$i][0]);
+            }
+        };
+
+        $visitFunctions = static function (HashTable $functionTable) use ($visit): void {
+            foreach ($functionTable as $functionValue) {
+                /** @var CData $function */
+                $function = $functionValue->getRawFunction();
+                if ($function->type === Core::ZEND_USER_FUNCTION) {
+                    $visit($function->op_array);
+                }
+            }
+        };
+        $visitFunctions(Core::$executor->functionTable);
+        foreach (Core::$executor->classTable as $classValue) {
+            $classEntry = $classValue->getRawClass();
+            if ($classEntry->type !== Core::ZEND_INTERNAL_CLASS) {
+                $visitFunctions(HashTable::fromCData(Core::addr($classEntry->function_table)));
+            }
+        }
+
+        return array_values($opArrays);
+    }
+}
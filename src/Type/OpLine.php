@@ -268,8 +268,8 @@ class OpLine
     {
         // ((zval*)(((char*)(opline)) + (int32_t)(node).constant))
         $constantOffset = $node->constant;
-        $pointer        = Core::cast('char *', $opline) + $constantOffset;
+        $pointer        = Core::castPointer('char *', $opline) + $constantOffset;
 
-        return Core::cast(zval::class, $pointer);
+        return Core::castPointer(zval::class, $pointer);
     }
 }
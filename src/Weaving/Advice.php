@@ -0,0 +1,39 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Weaving;
+
+/**
+ * One advice registered with a Weaver: a static method called at the methods a pointcut selects
+ *
+ * The advice is referenced by name ("Aspect\Logging::before"), not by a callable, because the
+ * call is compiled into the woven method: the aspect class is loaded by the application's
+ * autoloader on the first call, never by the weaver.
+ */
+final class Advice
+{
+    /** Fully qualified class name and method name of the advice */
+    public readonly string $method;
+
+    public function __construct(
+        public readonly AdviceKind $kind,
+        public readonly Pointcut $pointcut,
+        string $method,
+    ) {
+        $name = '[A-Za-z_\x80-\xff][A-Za-z0-9_\x80-\xff]*';
+        if (preg_match("/^\\\\?{$name}(\\\\{$name})*::{$name}\$/", $method) !== 1) {
+            throw new \InvalidArgumentException("Advice must name a static method as Class::method, got '{$method}'");
+        }
+        $this->method = ltrim($method, '\\');
+    }
+}
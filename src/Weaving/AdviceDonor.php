@@ -0,0 +1,196 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Weaving;
+
+use ZEngine\Core;
+
+/**
+ * Generates the donor script whose compiled wrappers are grafted over the join points of one
+ * target script
+ *
+ * One abstract donor class per target class, in the target's namespace, with the target's
+ * imports, strict_types and parent, so the wrapper signatures compile exactly like the
+ * originals. Each wrapper builds the Invocation, calls the before advices, runs the original
+ * body (directly, or through the around chain) and hands its result to the after advices;
+ * class and method names are literals, never self::class, because the wrapper moves to
+ * another class. The placeholder method next to it only contributes the name the original
+ * body is kept under in the target (ReflectionOpcacheFile::wrapMethodFrom()).
+ *
+ * @internal used by Weaver
+ */
+final class AdviceDonor
+{
+    /** Prefix of the private name the original body of a woven method is kept under */
+    public const string ALIAS_PREFIX = '__zengine_woven_';
+
+    /** Locals of the generated wrapper; a parameter with one of these names cannot be woven */
+    private const array RESERVED_VARIABLES = ['zengineInvocation', 'zengineResult'];
+
+    /**
+     * The name of the donor class for a target class
+     */
+    public static function className(string $scriptPath, string $targetClassName): string
+    {
+        return 'ZEngineWoven_' . md5($scriptPath . "\0" . strtolower($targetClassName));
+    }
+
+    /**
+     * The private name the original body of a method is kept under after weaving
+     */
+    public static function aliasName(string $methodName): string
+    {
+        return self::ALIAS_PREFIX . strtolower($methodName);
+    }
+
+    /**
+     * Checks if a wrapper can forward the method's parameters faithfully
+     *
+     * @param array{name: string, signature: string, returnType: string, parameters: list<array{name: string, byReference: bool, variadic: bool}>} $method
+     *
+     * @return string|null Why the method cannot be woven, null when it can
+     */
+    public static function findProblem(array $method): ?string
+    {
+        foreach ($method['parameters'] as $parameter) {
+            if (in_array($parameter['name'], self::RESERVED_VARIABLES, true)) {
+                return "parameter \${$parameter['name']} clashes with a local of the woven wrapper";
+            }
+            if ($parameter['variadic'] && $parameter['byReference']) {
+                return 'variadic by-reference parameters cannot be forwarded';
+            }
+        }
+
+        return null;
+    }
+
+    /**
+     * Generates the donor source for the join points of one script
+     *
+     * @param list<JoinPoint> $joinPoints Join points whose method outline has no problem
+     *
+     * @throws WeavingException When the source lacks a class or method the image declares
+     */
+    public static function generate(string $scriptPath, SourceOutline $outline, array $joinPoints): string
+    {
+        $joinPointsByClass = [];
+        foreach ($joinPoints as $joinPoint) {
+            $joinPointsByClass[$joinPoint->className][] = $joinPoint;
+        }
+
+        $source = "<?php\n\n";
+        if ($outline->strictTypes) {
+            $source .= "declare(strict_types=1);\n\n";
+        }
+        foreach ($joinPointsByClass as $className => $classJoinPoints) {
+            $class = $outline->getClass($className);
+            if ($class === null) {
+                throw WeavingException::sourceMismatch($scriptPath, "class {$className} is not declared at the top level");
+            }
+            $members = [];
+            foreach ($classJoinPoints as $joinPoint) {
+                $method = $class['methods'][strtolower($joinPoint->methodName)] ?? null;
+                if ($method === null) {
+                    throw WeavingException::sourceMismatch($scriptPath, "method {$joinPoint} is not declared");
+                }
+                $members[] = self::wrapper($joinPoint, $method);
+                $members[] = '    private function ' . self::aliasName($joinPoint->methodName) . "(): void {}\n";
+            }
+            $extends = $class['parent'] !== null ? " extends {$class['parent']}" : '';
+
+            $source .= $class['namespace'] === '' ? "namespace {\n" : "namespace {$class['namespace']} {\n";
+            foreach ($class['imports'] as $import) {
+                $source .= "{$import}\n";
+            }
+            $source .= "\n/**\n * Advice donor of {$className}, generated by ZEngine\\Weaving\\Weaver\n */\n";
+            $source .= 'abstract class ' . self::className($scriptPath, $className) . "{$extends}\n{\n";
+            $source .= implode("\n", $members);
+            $source .= "}\n}\n\n";
+        }
+
+        return $source;
+    }
+
+    /**
+     * @param array{name: string, signature: string, returnType: string, parameters: list<array{name: string, byReference: bool, variadic: bool}>} $method
+     */
+    private static function wrapper(JoinPoint $joinPoint, array $method): string
+    {
+        $isStatic   = ($joinPoint->flags & Core::ZEND_ACC_STATIC) !== 0;
+        $returnType = strtolower($method['returnType']);
+        $arguments  = [];
+        $forwarded  = [];
+        foreach ($method['parameters'] as $parameter) {
+            $variable    = '$' . $parameter['name'];
+            $forwarded[] = $parameter['variadic'] ? "...{$variable}" : $variable;
+            $arguments[] = match (true) {
+                $parameter['variadic']    => "...{$variable}",
+                $parameter['byReference'] => "&{$variable}",
+                default                   => $variable,
+            };
+        }
+
+        $modifiers = match (true) {
+            ($joinPoint->flags & Core::ZEND_ACC_PRIVATE) !== 0   => 'private',
+            ($joinPoint->flags & Core::ZEND_ACC_PROTECTED) !== 0 => 'protected',
+            default                                              => 'public',
+        };
+        if (($joinPoint->flags & Core::ZEND_ACC_FINAL) !== 0) {
+            $modifiers = "final {$modifiers}";
+        }
+        if ($isStatic) {
+            $modifiers .= ' static';
+        }
+
+        $invocation = sprintf(
+            'new \\%s(%s, %s, [%s], %s',
+            Invocation::class,
+            var_export($joinPoint->className, true),
+            var_export($joinPoint->methodName, true),
+            implode(', ', $arguments),
+            $isStatic ? 'null' : '$this',
+        );
+        $original = 'self::' . self::aliasName($joinPoint->methodName);
+        if ($joinPoint->around !== []) {
+            $around      = array_map(static fn(string $advice): string => var_export($advice, true), $joinPoint->around);
+            $invocation .= ", {$original}(...), [" . implode(', ', $around) . ']';
+            $call        = '$zengineInvocation->proceed()';
+        } else {
+            $call = "{$original}(" . implode(', ', $forwarded) . ')';
+        }
+        $invocation .= ')';
+
+        $body = ["\$zengineInvocation = {$invocation};"];
+        foreach ($joinPoint->before as $advice) {
+            $body[] = "\\{$advice}(\$zengineInvocation);";
+        }
+        if ($returnType === 'never') {
+            $body[] = "{$call};";
+        } elseif ($returnType === 'void') {
+            $body[] = "{$call};";
+            foreach ($joinPoint->after as $advice) {
+                $body[] = "\\{$advice}(\$zengineInvocation, null);";
+            }
+        } else {
+            $body[] = "\$zengineResult = {$call};";
+            foreach ($joinPoint->after as $advice) {
+                $body[] = "\\{$advice}(\$zengineInvocation, \$zengineResult);";
+            }
+            $body[] = 'return $zengineResult;';
+        }
+
+        return "    {$modifiers} function {$method['name']}{$method['signature']}\n    {\n        "
+            . implode("\n        ", $body)
+            . "\n    }\n";
+    }
+}
@@ -0,0 +1,29 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Weaving;
+
+/**
+ * Where a woven method calls an advice
+ */
+enum AdviceKind
+{
+    /** Before the original body: `static function (Invocation $invocation): void` */
+    case Before;
+
+    /** After the original body returned: `static function (Invocation $invocation, mixed $result): void` */
+    case After;
+
+    /** Instead of the original body, which the advice reaches through Invocation::proceed(): `static function (Invocation $invocation): mixed` */
+    case Around;
+}
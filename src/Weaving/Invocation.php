@@ -0,0 +1,78 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Weaving;
+
+/**
+ * One call of a woven method, as its advices see it
+ *
+ * Created by the woven method itself on every call; this is the only piece of the weaving
+ * pipeline that runs at request time, so it touches neither FFI nor the engine structures.
+ * Before and after advices inspect it; around advices decide whether, and with which
+ * arguments, the original body runs by calling proceed().
+ */
+final class Invocation
+{
+    /** Position of the next around advice in the chain */
+    private int $nextAround = 0;
+
+    /**
+     * @param list<mixed>|array<string, mixed> $arguments Arguments the woven method received, variadic ones spread
+     * @param object|null                      $target    The instance the method was called on, null for static methods
+     * @param \Closure|null                    $original  The original body, for around advices
+     * @param list<string>                     $around    Around advices as Class::method, outermost first
+     */
+    public function __construct(
+        public readonly string $className,
+        public readonly string $methodName,
+        private array $arguments,
+        public readonly ?object $target = null,
+        private readonly ?\Closure $original = null,
+        private readonly array $around = [],
+    ) {}
+
+    /**
+     * @return list<mixed>|array<string, mixed>
+     */
+    public function getArguments(): array
+    {
+        return $this->arguments;
+    }
+
+    /**
+     * Runs the rest of the around chain, then the original body, and returns its result
+     *
+     * Arguments given here replace the ones the method was called with, for the inner advices
+     * and the original body.
+     */
+    public function proceed(mixed ...$arguments): mixed
+    {
+        if ($arguments !== []) {
+            $this->arguments = $arguments;
+        }
+        if (isset($this->around[$this->nextAround])) {
+            $advice = $this->around[$this->nextAround++];
+            try {
+                return $advice($this);
+            } finally {
+                // An around advice may proceed more than once, e.g. to retry
+                $this->nextAround--;
+            }
+        }
+        if ($this->original === null) {
+            throw new \LogicException("{$this->className}::{$this->methodName}() was woven without around advice, there is nothing to proceed to");
+        }
+
+        return ($this->original)(...$this->arguments);
+    }
+}
@@ -0,0 +1,43 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Weaving;
+
+/**
+ * A method of a cache image selected by at least one pointcut, with its advices in
+ * registration order
+ *
+ * @internal built and consumed by Weaver
+ */
+final class JoinPoint
+{
+    /**
+     * @param int          $flags  fn_flags of the method in the image
+     * @param list<string> $before Before advices as Class::method
+     * @param list<string> $after  After advices as Class::method
+     * @param list<string> $around Around advices as Class::method, outermost first
+     */
+    public function __construct(
+        public readonly string $className,
+        public readonly string $methodName,
+        public readonly int $flags,
+        public readonly array $before,
+        public readonly array $after,
+        public readonly array $around,
+    ) {}
+
+    public function __toString(): string
+    {
+        return "{$this->className}::{$this->methodName}";
+    }
+}
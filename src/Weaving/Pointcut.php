@@ -0,0 +1,88 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Weaving;
+
+/**
+ * Selects the methods an advice applies to, by class name, method name and attributes
+ *
+ * Names are matched with fnmatch() wildcards (`*`, `?`, `[...]`), case-insensitively, against
+ * the fully qualified class name without the leading backslash; `*` also crosses namespace
+ * separators, so `App\Service\*` selects every class below that namespace. An attribute
+ * condition is met when the method or its declaring class carries the attribute, named by its
+ * fully qualified class name.
+ *
+ * Matching runs on what the cache images hold - class entries, method tables and attribute
+ * tables - so nothing is autoloaded and no attribute class has to exist at weaving time.
+ */
+final class Pointcut
+{
+    private function __construct(
+        private readonly string $classPattern,
+        private readonly string $methodPattern,
+        private readonly ?string $attributeName,
+    ) {}
+
+    /**
+     * Selects methods by class and method name patterns
+     */
+    public static function method(string $classPattern, string $methodPattern = '*'): self
+    {
+        return new self(self::normalizeName($classPattern), strtolower($methodPattern), null);
+    }
+
+    /**
+     * Selects every method that carries the attribute, or whose class carries it
+     */
+    public static function annotatedWith(string $attributeName): self
+    {
+        return new self('*', '*', self::normalizeName($attributeName));
+    }
+
+    /**
+     * Narrows the pointcut to methods that carry the attribute, or whose class carries it
+     */
+    public function withAttribute(string $attributeName): self
+    {
+        return new self($this->classPattern, $this->methodPattern, self::normalizeName($attributeName));
+    }
+
+    /**
+     * Checks if a method is selected
+     *
+     * @param list<string> $attributeNames Attributes of the method and of its declaring class
+     */
+    public function matches(string $className, string $methodName, array $attributeNames): bool
+    {
+        if (!fnmatch($this->classPattern, self::normalizeName($className), FNM_NOESCAPE)
+            || !fnmatch($this->methodPattern, strtolower($methodName), FNM_NOESCAPE)
+        ) {
+            return false;
+        }
+        if ($this->attributeName === null) {
+            return true;
+        }
+        foreach ($attributeNames as $attributeName) {
+            if (self::normalizeName($attributeName) === $this->attributeName) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    private static function normalizeName(string $name): string
+    {
+        return strtolower(ltrim($name, '\\'));
+    }
+}
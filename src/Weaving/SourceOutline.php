@@ -0,0 +1,309 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Weaving;
+
+/**
+ * The declarations of a script the advice donor has to reproduce: strict_types, and for every
+ * top-level class its namespace, the imports in effect, its parent and the signatures of its
+ * methods, as source text
+ *
+ * The image knows the compiled shape of a method but not the source of its parameter defaults
+ * and types; the donor wrapper is compiled from the very same text instead, in the same
+ * namespace and with the same imports, so it resolves every name exactly as the original did.
+ * The one exception is a "self" type, which the compiler resolves against the class being
+ * compiled: signatures carry it as the fully qualified name of the declaring class.
+ *
+ * @internal used by Weaver to generate advice donors
+ */
+final class SourceOutline
+{
+    /**
+     * @param array<string, array{
+     *     name: string,
+     *     namespace: string,
+     *     imports: list<string>,
+     *     parent: ?string,
+     *     methods: array<string, array{
+     *         name: string,
+     *         signature: string,
+     *         returnType: string,
+     *         parameters: list<array{name: string, byReference: bool, variadic: bool}>
+     *     }>
+     * }> $classes Keyed by the lowercased fully qualified class name
+     */
+    private function __construct(public readonly bool $strictTypes, private readonly array $classes) {}
+
+    /**
+     * @throws WeavingException When the script cannot be read
+     */
+    public static function ofFile(string $scriptPath): self
+    {
+        $source = file_get_contents($scriptPath);
+        if ($source === false) {
+            throw WeavingException::sourceMismatch($scriptPath, 'the source cannot be read');
+        }
+
+        return self::parse($source);
+    }
+
+    public static function parse(string $source): self
+    {
+        $tokens         = \PhpToken::tokenize($source);
+        $tokenCount     = count($tokens);
+        $strictTypes    = false;
+        $namespace      = '';
+        $namespaceDepth = 0;
+        $imports        = [];
+        $depth          = 0;
+        $class          = null;
+        $classDepth     = 0;
+        $classes        = [];
+        $previousToken  = null;
+        for ($index = 0; $index < $tokenCount; $index++) {
+            $token = $tokens[$index];
+            if ($token->isIgnorable()) {
+                continue;
+            }
+            if ($token->is(['{', T_CURLY_OPEN, T_DOLLAR_OPEN_CURLY_BRACES])) {
+                $depth++;
+            } elseif ($token->is('}')) {
+                $depth--;
+                if ($class !== null && $depth < $classDepth) {
+                    $classes[strtolower($class['name'])] = $class;
+                    $class                               = null;
+                } elseif ($depth < $namespaceDepth) {
+                    // End of a braced namespace block
+                    $namespace      = '';
+                    $namespaceDepth = 0;
+                    $imports        = [];
+                }
+            } elseif ($token->is(T_DECLARE) && $depth === 0) {
+                $end       = self::findToken($tokens, $index, [')']);
+                $directive = strtolower(preg_replace('/\s+/', '', self::textBetween($tokens, $index + 1, $end)) ?? '');
+                if (str_contains($directive, 'strict_types=1')) {
+                    $strictTypes = true;
+                }
+                $index = $end;
+            } elseif ($token->is(T_NAMESPACE) && $class === null && $depth === $namespaceDepth) {
+                $namespace = '';
+                $imports   = [];
+                while (++$index < $tokenCount && !$tokens[$index]->is([';', '{'])) {
+                    if ($tokens[$index]->is([T_STRING, T_NAME_QUALIFIED])) {
+                        $namespace = $tokens[$index]->text . '\\';
+                    }
+                }
+                if ($index < $tokenCount && $tokens[$index]->is('{')) {
+                    $depth++;
+                    $namespaceDepth = $depth;
+                }
+            } elseif ($token->is(T_USE) && $class === null && $depth === $namespaceDepth && !$previousToken?->is(')')) {
+                // An import; a closure's "use (...)" follows its parameter list
+                $end       = self::findToken($tokens, $index, [';']);
+                $imports[] = self::textBetween($tokens, $index, $end + 1);
+                $index     = $end;
+            } elseif ($token->is(T_CLASS) && $class === null && $depth === $namespaceDepth
+                && !$previousToken?->is([T_DOUBLE_COLON, T_NEW])
+            ) {
+                $nameIndex = self::nextSignificant($tokens, $index);
+                $bodyIndex = self::findToken($tokens, $index, ['{']);
+                $parent    = null;
+                for ($cursor = $nameIndex; $cursor < $bodyIndex; $cursor++) {
+                    if ($tokens[$cursor]->is(T_EXTENDS)) {
+                        $parent = $tokens[self::nextSignificant($tokens, $cursor)]->text;
+                        break;
+                    }
+                }
+                $class = [
+                    'name'      => $namespace . $tokens[$nameIndex]->text,
+                    'namespace' => rtrim($namespace, '\\'),
+                    'imports'   => $imports,
+                    'parent'    => $parent,
+                    'methods'   => [],
+                ];
+                $index = $bodyIndex;
+                $depth++;
+                $classDepth = $depth;
+            } elseif ($token->is(T_FUNCTION) && $class !== null && $depth === $classDepth) {
+                $nameIndex = self::nextSignificant($tokens, $index);
+                if ($tokens[$nameIndex]->text === '&') {
+                    // Returns by reference: never woven, but the signature still has to be skipped
+                    $nameIndex = self::nextSignificant($tokens, $nameIndex);
+                }
+                $method    = self::parseMethod($tokens, $nameIndex, $class['name']);
+                $methodKey = strtolower($method['outline']['name']);
+
+                $class['methods'][$methodKey] = $method['outline'];
+                // Resume at the body brace (or the ";" of an abstract method) so depth stays balanced
+                $index = $method['bodyIndex'] - 1;
+            }
+            $previousToken = $token;
+        }
+
+        return new self($strictTypes, $classes);
+    }
+
+    /**
+     * @return array{
+     *     name: string,
+     *     namespace: string,
+     *     imports: list<string>,
+     *     parent: ?string,
+     *     methods: array<string, array{
+     *         name: string,
+     *         signature: string,
+     *         returnType: string,
+     *         parameters: list<array{name: string, byReference: bool, variadic: bool}>
+     *     }>
+     * }|null
+     */
+    public function getClass(string $className): ?array
+    {
+        return $this->classes[strtolower(ltrim($className, '\\'))] ?? null;
+    }
+
+    /**
+     * Reads a method declaration from its name to the brace of its body
+     *
+     * @param list<\PhpToken> $tokens
+     * @param string          $className Fully qualified name of the declaring class
+     *
+     * @return array{
+     *     outline: array{
+     *         name: string,
+     *         signature: string,
+     *         returnType: string,
+     *         parameters: list<array{name: string, byReference: bool, variadic: bool}>
+     *     },
+     *     bodyIndex: int
+     * }
+     */
+    private static function parseMethod(array $tokens, int $nameIndex, string $className): array
+    {
+        $openIndex  = self::findToken($tokens, $nameIndex, ['(']);
+        $nesting    = 0;
+        $parameters = [];
+        $closeIndex = $openIndex;
+        for ($cursor = $openIndex; $cursor < count($tokens); $cursor++) {
+            $token = $tokens[$cursor];
+            if ($token->is(['(', '[', T_ATTRIBUTE])) {
+                $nesting++;
+            } elseif ($token->is([')', ']'])) {
+                $nesting--;
+                if ($nesting === 0) {
+                    $closeIndex = $cursor;
+                    break;
+                }
+            } elseif ($token->is(T_VARIABLE) && $nesting === 1) {
+                $modifier = self::previousSignificant($tokens, $cursor);
+                $variadic = $tokens[$modifier]->is(T_ELLIPSIS);
+                if ($variadic) {
+                    $modifier = self::previousSignificant($tokens, $modifier);
+                }
+                $parameters[] = [
+                    'name'        => substr($token->text, 1),
+                    'byReference' => $tokens[$modifier]->text === '&',
+                    'variadic'    => $variadic,
+                ];
+            }
+        }
+        $bodyIndex  = self::findToken($tokens, $closeIndex, ['{', ';']);
+        $returnType = trim(self::typeTextBetween($tokens, $closeIndex + 1, $bodyIndex, $className));
+
+        return [
+            'outline' => [
+                'name'       => $tokens[$nameIndex]->text,
+                'signature'  => trim(self::typeTextBetween($tokens, $openIndex, $bodyIndex, $className)),
+                'returnType' => ltrim($returnType, ": \t\r\n"),
+                'parameters' => $parameters,
+            ],
+            'bodyIndex' => $bodyIndex,
+        ];
+    }
+
+    /**
+     * @param list<\PhpToken>  $tokens
+     * @param list<string|int> $kinds
+     */
+    private static function findToken(array $tokens, int $index, array $kinds): int
+    {
+        $tokenCount = count($tokens);
+        while (++$index < $tokenCount && !$tokens[$index]->is($kinds)) {
+        }
+
+        return min($index, $tokenCount - 1);
+    }
+
+    /**
+     * @param list<\PhpToken> $tokens
+     */
+    private static function nextSignificant(array $tokens, int $index): int
+    {
+        $tokenCount = count($tokens);
+        while (++$index < $tokenCount && $tokens[$index]->isIgnorable()) {
+        }
+
+        return min($index, $tokenCount - 1);
+    }
+
+    /**
+     * @param list<\PhpToken> $tokens
+     */
+    private static function previousSignificant(array $tokens, int $index): int
+    {
+        while (--$index > 0 && $tokens[$index]->isIgnorable()) {
+        }
+
+        return max($index, 0);
+    }
+
+    /**
+     * Returns the source text of a signature part with every "self" type spelled as the class
+     *
+     * A "self" type is bound to the class that compiles it, so the donor class would otherwise
+     * check against itself; "self::" in defaults and attributes is resolved at run time and stays.
+     *
+     * @param list<\PhpToken> $tokens
+     */
+    private static function typeTextBetween(array $tokens, int $start, int $end, string $className): string
+    {
+        $notTypes = [T_NEW, T_DOUBLE_COLON, T_OBJECT_OPERATOR, T_NULLSAFE_OBJECT_OPERATOR];
+        $text     = '';
+        for ($index = $start; $index < $end; $index++) {
+            $token = $tokens[$index];
+            if ($token->is(T_STRING) && strtolower($token->text) === 'self'
+                && !$tokens[self::nextSignificant($tokens, $index)]->is(T_DOUBLE_COLON)
+                && !$tokens[self::previousSignificant($tokens, $index)]->is($notTypes)
+            ) {
+                $text .= '\\' . $className;
+                continue;
+            }
+            $text .= $token->text;
+        }
+
+        return $text;
+    }
+
+    /**
+     * @param list<\PhpToken> $tokens
+     */
+    private static function textBetween(array $tokens, int $start, int $end): string
+    {
+        $text = '';
+        for ($index = $start; $index < $end; $index++) {
+            $text .= $tokens[$index]->text;
+        }
+
+        return $text;
+    }
+}
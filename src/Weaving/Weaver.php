@@ -0,0 +1,398 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Weaving;
+
+use ZEngine\Core;
+use ZEngine\OpCache\BinaryCacheFile;
+use ZEngine\OpCache\FileCacheManifest;
+use ZEngine\OpCache\FileCacheWarmer;
+use ZEngine\OpCache\OpCacheException;
+use ZEngine\OpCache\ReflectionOpcacheFile;
+use ZEngine\Reflection\ReflectionAttributeEntry;
+use ZEngine\Type\HashTable;
+
+/**
+ * Weaves advices into the cache binaries of an application, offline
+ *
+ * A run goes through four stages, each in one batch for all scripts:
+ *
+ *  1. match: every class method in the cache images is tested against the pointcuts, by
+ *     class name, method name and the attributes the image holds; nothing is autoloaded;
+ *  2. donors: for every script with selected methods an advice donor is generated from its
+ *     source (AdviceDonor) and all donors are compiled by a FileCacheWarmer pool;
+ *  3. graft: each selected method is replaced with its compiled wrapper and the original
+ *     body is kept under a private alias (ReflectionOpcacheFile::wrapMethodFrom());
+ *  4. save: the grown images are re-emitted through ScriptSerializer and written back,
+ *     and the FileCacheManifest of the cache directory is updated to match.
+ *
+ * The woven binaries call their advices directly: no proxy class, no __call() and no
+ * interception hook is left at runtime, only the Invocation the wrapper creates.
+ *
+ * Constructors, destructors and other magic methods, abstract methods and methods returning
+ * by reference are not woven and are reported as skipped when a pointcut selects them;
+ * interfaces, traits and enums are not woven either. A method that was already woven is
+ * skipped, so weaving the same binaries twice is harmless - rewarming a changed script
+ * brings its binary back unwoven, ready for the next run.
+ */
+final class Weaver
+{
+    /**
+     * Lowercased names of the magic methods, never woven
+     */
+    private const array MAGIC_METHODS = [
+        '__construct'   => true,
+        '__destruct'    => true,
+        '__call'        => true,
+        '__callstatic'  => true,
+        '__get'         => true,
+        '__set'         => true,
+        '__isset'       => true,
+        '__unset'       => true,
+        '__sleep'       => true,
+        '__wakeup'      => true,
+        '__serialize'   => true,
+        '__unserialize' => true,
+        '__tostring'    => true,
+        '__invoke'      => true,
+        '__set_state'   => true,
+        '__clone'       => true,
+        '__debuginfo'   => true,
+    ];
+
+    /** @var list<Advice> */
+    private array $advices = [];
+
+    /**
+     * @param int          $workers         Number of compile workers for the advice donors
+     * @param list<string> $extraDirectives Additional `-d name=value` ini directives for those workers
+     */
+    public function __construct(
+        private readonly ?string $phpBinary = null,
+        private readonly int $workers = 4,
+        private readonly array $extraDirectives = [],
+    ) {}
+
+    public function addAdvice(Advice $advice): self
+    {
+        $this->advices[] = $advice;
+
+        return $this;
+    }
+
+    /**
+     * Calls the static method named by $advice before every selected method
+     */
+    public function before(Pointcut $pointcut, string $advice): self
+    {
+        return $this->addAdvice(new Advice(AdviceKind::Before, $pointcut, $advice));
+    }
+
+    /**
+     * Calls the static method named by $advice after every selected method returned
+     */
+    public function after(Pointcut $pointcut, string $advice): self
+    {
+        return $this->addAdvice(new Advice(AdviceKind::After, $pointcut, $advice));
+    }
+
+    /**
+     * Calls the static method named by $advice instead of every selected method
+     */
+    public function around(Pointcut $pointcut, string $advice): self
+    {
+        return $this->addAdvice(new Advice(AdviceKind::Around, $pointcut, $advice));
+    }
+
+    /**
+     * Weaves the binaries of every script recorded in a FileCacheWarmer manifest
+     */
+    public function weaveWarmed(string $fileCacheDir): WeavingReport
+    {
+        return $this->weave($fileCacheDir, array_keys(FileCacheManifest::load($fileCacheDir)->entries()));
+    }
+
+    /**
+     * Weaves the binaries of the given scripts, compiled into a file-cache directory beforehand
+     *
+     * Per-script failures are reported, not thrown, and leave that script's binary as it was.
+     *
+     * @param iterable<string> $scriptPaths
+     */
+    public function weave(string $fileCacheDir, iterable $scriptPaths): WeavingReport
+    {
+        $startedAt = hrtime(true);
+        $woven     = [];
+        $untouched = [];
+        $skipped   = [];
+        $failed    = [];
+
+        /** @var array<string, array{BinaryCacheFile, list<JoinPoint>}> $targets Keyed by script real path */
+        $targets = [];
+        foreach ($scriptPaths as $scriptPath) {
+            try {
+                $binPath = BinaryCacheFile::locate($fileCacheDir, $scriptPath);
+                $script  = (string) realpath($scriptPath);
+                if (isset($targets[$script]) || in_array($script, $untouched, true)) {
+                    continue;
+                }
+                if (!is_file($binPath)) {
+                    throw WeavingException::binaryMissing($script, $binPath);
+                }
+                $file       = BinaryCacheFile::read($binPath, $script);
+                $joinPoints = $this->findJoinPoints($file->getReflection(), $skipped);
+            } catch (OpCacheException|WeavingException $error) {
+                $failed[$scriptPath] = $error->getMessage();
+                continue;
+            }
+            if ($joinPoints === []) {
+                $untouched[] = $script;
+                continue;
+            }
+            $targets[$script] = [$file, $joinPoints];
+        }
+        if ($targets === []) {
+            return new WeavingReport($woven, $untouched, $skipped, $failed, hrtime(true) - $startedAt);
+        }
+
+        $workDirectory = sys_get_temp_dir() . '/zengine-weave-' . bin2hex(random_bytes(6));
+        try {
+            $donorPaths = $this->writeDonors($workDirectory, $targets, $skipped, $failed);
+            $donors     = $this->compileDonors($workDirectory, $donorPaths, $failed);
+            $manifest   = FileCacheManifest::load($fileCacheDir);
+            foreach ($donors as $script => $donor) {
+                [$file, $joinPoints] = $targets[$script];
+                try {
+                    $view = $file->getReflection();
+                    foreach ($joinPoints as $joinPoint) {
+                        $view->wrapMethodFrom(
+                            $donor,
+                            AdviceDonor::className($script, $joinPoint->className),
+                            $joinPoint->methodName,
+                            $joinPoint->className,
+                            AdviceDonor::aliasName($joinPoint->methodName),
+                        );
+                    }
+                    $file->save();
+                } catch (OpCacheException $error) {
+                    $failed[$script] = $error->getMessage();
+                    continue;
+                }
+                $woven[$script] = array_map(strval(...), $joinPoints);
+                if ($manifest->get($script) !== null) {
+                    clearstatcache(true, $file->binPath());
+                    $manifest->record($script, $file->binPath(), $file->metaInfo(), (int) filesize($file->binPath()));
+                }
+            }
+            if ($woven !== [] && is_file($manifest->path())) {
+                $manifest->save();
+            }
+        } finally {
+            // The donor images live on in memory, referenced by the saved targets
+            self::removeDirectory($workDirectory);
+        }
+
+        return new WeavingReport($woven, $untouched, $skipped, $failed, hrtime(true) - $startedAt);
+    }
+
+    /**
+     * Tests every method of the image's classes against the pointcuts
+     *
+     * @param array<string, string> $skipped
+     *
+     * @return list<JoinPoint>
+     */
+    private function findJoinPoints(ReflectionOpcacheFile $view, array &$skipped): array
+    {
+        $joinPoints = [];
+        foreach ($view->getClasses() as $class) {
+            if (($class->getFlags() & (Core::ZEND_ACC_INTERFACE | Core::ZEND_ACC_TRAIT | Core::ZEND_ACC_ENUM | Core::ZEND_ACC_ANON_CLASS)) !== 0) {
+                continue;
+            }
+            $className       = (string) $class->getName();
+            $classAttributes = self::attributeNames($class->getAttributesTable());
+            $methods         = $class->getDeclaredMethods();
+            foreach ($methods as $lcName => $method) {
+                // The original bodies of woven methods, kept under their alias
+                if (str_starts_with($lcName, AdviceDonor::ALIAS_PREFIX)) {
+                    continue;
+                }
+                $methodName = $method->getFunctionName() ?? $lcName;
+                $attributes = [...$classAttributes, ...self::attributeNames($method->getAttributesTable())];
+                $advices    = [];
+                foreach ($this->advices as $advice) {
+                    if ($advice->pointcut->matches($className, $methodName, $attributes)) {
+                        $advices[$advice->kind->name][] = $advice->method;
+                    }
+                }
+                if ($advices === []) {
+                    continue;
+                }
+                $flags = $method->getCommonPointer()->fn_flags;
+                $name  = "{$className}::{$methodName}";
+                if (isset(self::MAGIC_METHODS[$lcName])) {
+                    $skipped[$name] = 'magic method';
+                } elseif (($flags & Core::ZEND_ACC_ABSTRACT) !== 0) {
+                    $skipped[$name] = 'abstract method';
+                } elseif (($flags & Core::ZEND_ACC_RETURN_REFERENCE) !== 0) {
+                    $skipped[$name] = 'returns by reference';
+                } elseif (isset($methods[AdviceDonor::aliasName($methodName)])) {
+                    $skipped[$name] = 'already woven';
+                } else {
+                    $joinPoints[] = new JoinPoint(
+                        $className,
+                        $methodName,
+                        $flags,
+                        $advices[AdviceKind::Before->name] ?? [],
+                        $advices[AdviceKind::After->name] ?? [],
+                        $advices[AdviceKind::Around->name] ?? [],
+                    );
+                }
+            }
+        }
+
+        return $joinPoints;
+    }
+
+    /**
+     * Generates one donor script per target script
+     *
+     * @param array<string, array{BinaryCacheFile, list<JoinPoint>}> $targets
+     * @param array<string, string>                                  $skipped
+     * @param array<string, string>                                  $failed
+     *
+     * @return array<string, string> Donor script path per target script
+     */
+    private function writeDonors(string $workDirectory, array &$targets, array &$skipped, array &$failed): array
+    {
+        BinaryCacheFile::ensureDirectory($workDirectory . '/donors', 0o700);
+        $donorPaths = [];
+        foreach ($targets as $script => [$file, $joinPoints]) {
+            try {
+                $outline  = SourceOutline::ofFile($script);
+                $weavable = [];
+                foreach ($joinPoints as $joinPoint) {
+                    $method  = $outline->getClass($joinPoint->className)['methods'][strtolower($joinPoint->methodName)] ?? null;
+                    $problem = $method !== null ? AdviceDonor::findProblem($method) : null;
+                    if ($problem !== null) {
+                        $skipped[(string) $joinPoint] = $problem;
+                    } else {
+                        $weavable[] = $joinPoint;
+                    }
+                }
+                if ($weavable === []) {
+                    unset($targets[$script]);
+                    continue;
+                }
+                $source = AdviceDonor::generate($script, $outline, $weavable);
+            } catch (WeavingException $error) {
+                $failed[$script] = $error->getMessage();
+                unset($targets[$script]);
+                continue;
+            }
+            $donorPath = $workDirectory . '/donors/' . md5($script) . '.php';
+            if (file_put_contents($donorPath, $source) === false) {
+                throw OpCacheException::writeFailed($donorPath);
+            }
+            $targets[$script]    = [$file, $weavable];
+            $donorPaths[$script] = $donorPath;
+        }
+
+        return $donorPaths;
+    }
+
+    /**
+     * Compiles the donors in one warm-up batch and reads their images back
+     *
+     * The donors are compiled unoptimized: the optimizer would resolve the call of the
+     * placeholder alias to its empty body, while the real target is the original method.
+     *
+     * @param array<string, string> $donorPaths Donor script path per target script
+     * @param array<string, string> $failed
+     *
+     * @return array<string, ReflectionOpcacheFile> Donor image per target script
+     */
+    private function compileDonors(string $workDirectory, array $donorPaths, array &$failed): array
+    {
+        if ($donorPaths === []) {
+            return [];
+        }
+        $cacheDir = $workDirectory . '/cache';
+        $warmer   = new FileCacheWarmer(
+            $cacheDir,
+            workers: min($this->workers, count($donorPaths)),
+            phpBinary: $this->phpBinary,
+            extraDirectives: [
+                'opcache.optimization_level=0',
+                // The donors were written a moment ago
+                'opcache.file_update_protection=0',
+                ...$this->extraDirectives,
+            ],
+            directoryPermissions: 0o700,
+        );
+        $report = $warmer->warm(array_values($donorPaths));
+
+        $donors = [];
+        foreach ($donorPaths as $script => $donorPath) {
+            $donorRealPath = (string) realpath($donorPath);
+            if (isset($report->failed[$donorRealPath])) {
+                $failed[$script] = WeavingException::donorDidNotCompile($script, $report->failed[$donorRealPath])->getMessage();
+                continue;
+            }
+            try {
+                $donor           = BinaryCacheFile::read(BinaryCacheFile::locate($cacheDir, $donorRealPath), $donorRealPath);
+                $donors[$script] = $donor->getReflection();
+            } catch (OpCacheException $error) {
+                $failed[$script] = WeavingException::donorDidNotCompile($script, $error->getMessage())->getMessage();
+            }
+        }
+
+        return $donors;
+    }
+
+    /**
+     * @return list<string> Attribute class names, parameter attributes excluded
+     */
+    private static function attributeNames(?HashTable $attributes): array
+    {
+        if ($attributes === null) {
+            return [];
+        }
+        $names = [];
+        foreach ($attributes as $value) {
+            $attribute = ReflectionAttributeEntry::fromValueEntry($value);
+            // Parameter attributes share the method's table, under their parameter offset
+            if ($attribute->getOffset() === 0) {
+                $names[] = $attribute->getName();
+            }
+        }
+
+        return $names;
+    }
+
+    private static function removeDirectory(string $directory): void
+    {
+        if (!is_dir($directory)) {
+            return;
+        }
+        $iterator = new \RecursiveIteratorIterator(
+            new \RecursiveDirectoryIterator($directory, \FilesystemIterator::SKIP_DOTS),
+            \RecursiveIteratorIterator::CHILD_FIRST,
+        );
+        foreach ($iterator as $item) {
+            assert($item instanceof \SplFileInfo);
+            $item->isDir() ? rmdir($item->getPathname()) : unlink($item->getPathname());
+        }
+        rmdir($directory);
+    }
+}
@@ -0,0 +1,38 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Weaving;
+
+/**
+ * Raised by the weaving pipeline when a script cannot be woven: no cache binary, a source
+ * that no longer matches its image, or an advice donor that does not compile.
+ *
+ * Every failure mode has a named static constructor (project convention, see AGENTS.md).
+ */
+class WeavingException extends \RuntimeException
+{
+    public static function binaryMissing(string $scriptPath, string $binPath): self
+    {
+        return new self("Cannot weave {$scriptPath}: there is no cache binary {$binPath}, warm the file cache first");
+    }
+
+    public static function sourceMismatch(string $scriptPath, string $what): self
+    {
+        return new self("Cannot weave {$scriptPath}: the source does not match its cache binary, {$what}");
+    }
+
+    public static function donorDidNotCompile(string $scriptPath, string $reason): self
+    {
+        return new self("Cannot weave {$scriptPath}: its advice donor does not compile: {$reason}");
+    }
+}
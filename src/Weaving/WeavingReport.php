@@ -0,0 +1,55 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Weaving;
+
+/**
+ * What one Weaver run wove, left alone and failed on
+ *
+ * Scripts are listed by real path, join points as Class::method.
+ */
+final class WeavingReport
+{
+    /**
+     * @param array<string, list<string>> $woven            Join points woven per script
+     * @param list<string>                $untouched        Scripts no pointcut selected a method of
+     * @param array<string, string>       $skipped          Why a selected join point was not woven
+     * @param array<string, string>       $failed           Failure reason per script; its binary was not written
+     * @param int                         $totalNanoseconds Whole run, hrtime() nanoseconds
+     *
+     * @internal built by Weaver::weave()
+     */
+    public function __construct(
+        public readonly array $woven,
+        public readonly array $untouched,
+        public readonly array $skipped,
+        public readonly array $failed,
+        public readonly int $totalNanoseconds,
+    ) {}
+
+    /**
+     * Returns the number of methods woven across all scripts
+     */
+    public function countWovenJoinPoints(): int
+    {
+        return array_sum(array_map(count(...), $this->woven));
+    }
+
+    /**
+     * Checks if every selected script was woven
+     */
+    public function isComplete(): bool
+    {
+        return $this->failed === [];
+    }
+}
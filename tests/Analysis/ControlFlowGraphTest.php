@@ -0,0 +1,118 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Analysis;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\TestCase;
+use ZEngine\OpCache\BinaryCacheFile;
+use ZEngine\OpCache\FileCacheFixture;
+use ZEngine\OpCache\PayloadRelocator;
+use ZEngine\Reflection\ReflectionFunction;
+use ZEngine\System\OpCode;
+
+/**
+ * Blocks, edges, back-edges and liveness of eval()'d functions and of cache image op_arrays
+ */
+final class ControlFlowGraphTest extends TestCase
+{
+    use FileCacheFixture;
+
+    protected function tearDown(): void
+    {
+        self::removeCacheDir();
+    }
+
+    public function testLoopsDeadCodeAndExceptionEdges(): void
+    {
+        $name = self::createFunction(<<<'PHP'
+            ($limit) {
+                $sum = 0;
+                for ($i = 0; $i < $limit; $i++) {
+                    try {
+                        $sum += intdiv(10, $i);
+                    } catch (\DivisionByZeroError $error) {
+                        $sum = -$sum;
+                    }
+                }
+                return $sum;
+                echo 'dead';
+            }
+            PHP);
+        $graph = ControlFlowGraph::fromFunction(new ReflectionFunction($name));
+
+        $this->assertSame(0, $graph->getBlock(0)->start);
+        $this->assertSame($graph->getOplineCount(), $graph->getBlocks()[\count($graph->getBlocks()) - 1]->end);
+        $this->assertCount(1, $graph->getBackEdges(), 'One loop');
+        [[$from, $to]] = $graph->getBackEdges();
+        $this->assertContains($to, $graph->getBlock($from)->successors);
+        $this->assertSame([$to], $graph->getLoopHeaders());
+
+        [$element] = $graph->getTryCatchElements();
+        $tryBlock  = $graph->getBlockOf($element->getTryOp());
+        $this->assertSame([$graph->getBlockOf($element->getCatchOp())->index], $tryBlock->handlers);
+        $this->assertTrue($graph->getBlockOf($element->getCatchOp())->reachable, 'Catch blocks are reached through exception edges');
+
+        $unreachable = $graph->getUnreachableBlocks();
+        $this->assertCount(1, $unreachable);
+        $oplines = $graph->getOplines();
+        $this->assertSame(OpCode::ECHO, $oplines[$unreachable[0]->start]['opcode']);
+    }
+
+    public function testLivenessFollowsDefinitionsAndReads(): void
+    {
+        $name    = self::createFunction('($a) { $b = $a + 1; $c = 5; echo $b; return $a; }');
+        $graph   = ControlFlowGraph::fromFunction(new ReflectionFunction($name));
+        $oplines = $graph->getOplines();
+        $assigns = array_keys(array_filter($oplines, static fn(array $opline): bool => $opline['opcode'] === OpCode::ASSIGN));
+        $this->assertCount(2, $assigns);
+        [$assignB, $assignC] = $assigns;
+        $b = $oplines[$assignB]['op1'];
+        $c = $oplines[$assignC]['op1'];
+        $a = $oplines[0]['result'];
+
+        $liveness = Liveness::of($graph);
+        $this->assertSame([], $liveness->getLiveIn(0), 'RECV defines the argument');
+        $this->assertTrue($liveness->isLiveAfter($assignB, $b));
+        $this->assertTrue($liveness->isLiveAfter($assignB, $a), '$a is returned later');
+        $this->assertFalse($liveness->isLiveAfter($assignC, $c), '$c is never read: a dead store');
+    }
+
+    #[Group('opcache')]
+    public function testAnalysesEveryOpArrayOfARelocatedImage(): void
+    {
+        if (!PayloadRelocator::isSupported()) {
+            self::markTestSkipped('The file-cache relocator supports 64-bit POSIX payloads only');
+        }
+        $file   = BinaryCacheFile::read(self::compileFixture(), self::fixturePath());
+        $graphs = ControlFlowGraph::allOf($file->getReflection());
+
+        $this->assertArrayHasKey('{main}', $graphs);
+        $this->assertArrayHasKey('zengine_bin_answer', $graphs);
+        $describe = $graphs['ZEngineBinSubject::describe'];
+        $this->assertCount(1, $describe->getTryCatchElements());
+        $this->assertNotSame([], $describe->getBlock(0)->successors);
+        foreach ($graphs as $graph) {
+            Liveness::of($graph);
+            $this->assertSame([], $graph->getBackEdges());
+        }
+    }
+
+    private static function createFunction(string $signatureAndBody): string
+    {
+        $name = str_replace('.', '_', uniqid('zengine_cfg_', true));
+        eval("function {$name}{$signatureAndBody}");
+
+        return $name;
+    }
+}
@@ -39,6 +39,107 @@ final class CoreInitializationTest extends TestCase
         $this->assertTrue(Core::isInitialized());
     }
 
+    public function testBootProfileReportsEveryPhase(): void
+    {
+        Core::init();
+        $profile = Core::getBootProfile();
+
+        foreach (['parse', 'verify', 'globals', 'classes', 'hooks', 'total'] as $phase) {
+            $this->assertArrayHasKey($phase, $profile);
+            $this->assertGreaterThanOrEqual(0.0, $profile[$phase]);
+        }
+        // A re-init keeps the binding (and the verdict) of the first boot of this process
+        $this->assertSame(0.0, $profile['parse']);
+        $this->assertSame('reused', $profile['layoutCheck'] ?? null);
+    }
+
+    /**
+     * The stamp mode verifies once per build and layout set, then trusts its own record
+     *
+     * Needs fresh processes: within one process the binding is bound and verified only once.
+     */
+    public function testStampedLayoutCheckSkipsReverificationOnTheNextBoot(): void
+    {
+        $stampDirectory = sys_get_temp_dir() . '/z-engine-stamp-' . getmypid();
+        @mkdir($stampDirectory, 0700);
+
+        try {
+            $environment = ['ZENGINE_STRICT_LAYOUT_CHECK' => 'stamp', 'ZENGINE_LAYOUT_STAMP_DIR' => $stampDirectory];
+            $probe       = 'echo \ZEngine\Core::getBootProfile()["layoutCheck"];';
+
+            $this->assertSame('stamp-recorded', $this->runBootProbe($probe, $environment));
+            $this->assertCount(1, glob($stampDirectory . '/z-engine-layouts-*.stamp') ?: []);
+            $this->assertSame('stamp-hit', $this->runBootProbe($probe, $environment));
+        } finally {
+            array_map('unlink', glob($stampDirectory . '/*') ?: []);
+            @rmdir($stampDirectory);
+        }
+    }
+
+    /**
+     * Anyone who can write a stamp can switch the check off, so a shared directory gets none
+     */
+    public function testStampIsNeverTrustedInADirectoryOthersCanWrite(): void
+    {
+        if (\DIRECTORY_SEPARATOR === '\\') {
+            $this->markTestSkipped('POSIX permissions only');
+        }
+        $stampDirectory = sys_get_temp_dir() . '/z-engine-stamp-shared-' . getmypid();
+        @mkdir($stampDirectory);
+        chmod($stampDirectory, 0777);
+
+        try {
+            $environment = [
+                'ZENGINE_STRICT_LAYOUT_CHECK' => 'stamp',
+                'ZENGINE_LAYOUT_STAMP_DIR'    => $stampDirectory,
+                'ZENGINE_HEADER_SLICES'       => '',
+            ];
+            $probe = 'echo \ZEngine\Core::getBootProfile()["layoutCheck"];';
+
+            $this->assertSame('full', $this->runBootProbe($probe, $environment));
+            $this->assertSame([], glob($stampDirectory . '/*') ?: []);
+
+            // The stamp a full engine.h binding of this build would look for
+            $layoutsJson = (string) file_get_contents(dirname(__DIR__) . '/include/' . Core::platformKey() . '/layouts.json');
+            $fingerprint = hash('xxh128', Core::systemId() . "\0*\0" . $layoutsJson);
+            touch("{$stampDirectory}/z-engine-layouts-{$fingerprint}.stamp");
+            $this->assertSame('full', $this->runBootProbe($probe, $environment));
+        } finally {
+            array_map('unlink', glob($stampDirectory . '/*') ?: []);
+            @rmdir($stampDirectory);
+        }
+    }
+
+    public function testBaseHeaderSlicesGuardTheLeftOutSubsystems(): void
+    {
+        $probe = <<<'PHP'
+            use ZEngine\Core;
+            try {
+                Core::requireHeaderSlice('classes');
+                Core::requireHeaderSlice('opcache');
+                echo Core::hasHeaderSlice('opcache') ? 'bound' : 'unguarded';
+            } catch (RuntimeException $e) {
+                echo Core::hasHeaderSlice('opcache') ? 'inconsistent' : 'guarded';
+            }
+            PHP;
+
+        $this->assertSame('guarded', $this->runBootProbe($probe, ['ZENGINE_HEADER_SLICES' => 'none']));
+        $this->assertSame('bound', $this->runBootProbe($probe, ['ZENGINE_HEADER_SLICES' => 'opcache']));
+        $this->assertSame('bound', $this->runBootProbe($probe, ['ZENGINE_HEADER_SLICES' => '']));
+    }
+
+    public function testSlicedBindingsPassTheStrictLayoutCheck(): void
+    {
+        $probe = 'echo \ZEngine\Core::getBootProfile()["layoutCheck"];';
+        foreach (['none', 'compiler', 'compiler,module,opcache'] as $slices) {
+            $this->assertSame(
+                'full',
+                $this->runBootProbe($probe, ['ZENGINE_HEADER_SLICES' => $slices, 'ZENGINE_STRICT_LAYOUT_CHECK' => '1']),
+                "ZENGINE_HEADER_SLICES={$slices}",
+            );
+        }
+    }
+
     public function testPreloadIsIdempotentAfterTheAutomaticBoot(): void
     {
         // An existing opcache.preload script calls Core::preload() right after requiring the
@@ -47,4 +148,31 @@ final class CoreInitializationTest extends TestCase
         Core::preload();
         $this->assertTrue(Core::isInitialized());
     }
+
+    /**
+     * Boots the bridge in a child process with the given environment and returns its output
+     *
+     * @param array<string, string> $environment
+     */
+    private function runBootProbe(string $probe, array $environment): string
+    {
+        $command = [
+            PHP_BINARY,
+            '-d', 'ffi.enable=1',
+            '-d', 'display_errors=stderr',
+            '-r',
+            sprintf('require %s; %s', var_export(dirname(__DIR__) . '/vendor/autoload.php', true), $probe),
+        ];
+        $process = proc_open($command, [1 => ['pipe', 'w'], 2 => ['pipe', 'w']], $pipes, null, [...getenv(), ...$environment]);
+        $this->assertIsResource($process, 'could not start a child PHP process');
+
+        $stdout = (string) stream_get_contents($pipes[1]);
+        $stderr = (string) stream_get_contents($pipes[2]);
+        fclose($pipes[1]);
+        fclose($pipes[2]);
+        proc_close($process);
+        $this->assertSame('', trim($stderr));
+
+        return trim($stdout);
+    }
 }
@@ -0,0 +1,108 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Coverage;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\TestCase;
+
+/**
+ * The self-removing EXT_STMT collector: line hits, uncovered functions, NOP patching, exports
+ */
+#[Group('internal')]
+final class CoverageCollectorTest extends TestCase
+{
+    private CoverageCollector $collector;
+
+    protected function setUp(): void
+    {
+        $this->collector = new CoverageCollector();
+        $this->collector->start();
+    }
+
+    protected function tearDown(): void
+    {
+        $this->collector->stop();
+    }
+
+    public function testReportsCoveredAndUncoveredLines(): void
+    {
+        [$hit, $fileName] = self::compileProbe();
+        $this->assertSame(14, $hit(7));
+
+        $report = $this->collector->getReport();
+        $this->assertSame(0, $this->collector->getFailedHitCount());
+        $this->assertArrayHasKey($fileName, $report->files);
+        $lines = $report->files[$fileName];
+        $this->assertTrue($lines[2], 'The body of the called function is covered');
+        $this->assertTrue($lines[3]);
+        $this->assertFalse($lines[6], 'The body of the function that never ran is reported uncovered');
+
+        $lcov = $report->toLcov();
+        $this->assertStringContainsString("SF:{$fileName}\n", $lcov);
+        $this->assertStringContainsString("DA:2,1\n", $lcov);
+        $this->assertStringContainsString("DA:6,0\n", $lcov);
+        $this->assertStringEndsWith("end_of_record\n", $lcov);
+
+        $clover = $report->toClover();
+        $this->assertStringContainsString('<line num="2" type="stmt" count="1"/>', $clover);
+        $this->assertStringContainsString('<line num="6" type="stmt" count="0"/>', $clover);
+        if (\function_exists('simplexml_load_string')) {
+            $this->assertNotFalse(simplexml_load_string($clover), 'Clover output is well-formed XML');
+        }
+    }
+
+    public function testExecutedStatementsStopReachingTheCollector(): void
+    {
+        [$hit] = self::compileProbe();
+        $hit(1);
+        if (!$this->collector->isSelfRemoving()) {
+            $this->assertNotNull($this->collector->getReport()->selfRemovalFailure, 'The per-hit fallback is reported');
+            $this->markTestSkipped('Engine definitions predate zend_vm_set_opcode_handler (run `composer gen-headers`)');
+        }
+        $this->assertNull($this->collector->getReport()->selfRemovalFailure);
+        $crossings = $this->collector->getCrossingCount();
+
+        for ($i = 0; $i < 100; $i++) {
+            $hit($i);
+        }
+        $this->assertSame($crossings, $this->collector->getCrossingCount(), 'Each statement crosses the trampoline once');
+
+        // Stopping restores the patched statements, a new collector sees them again
+        $this->collector->stop();
+        $this->collector = new CoverageCollector();
+        $this->collector->start();
+        $hit(1);
+        $this->assertSame(2, $this->collector->getCrossingCount());
+    }
+
+    /**
+     * @return array{\Closure(int): int, string}
+     */
+    private static function compileProbe(): array
+    {
+        $name = str_replace('.', '_', uniqid('zengine_coverage_probe_', true));
+        eval(<<<PHP
+            function {$name}_hit(\$n) {
+            \$double = \$n * 2;
+            return \$double;
+            }
+            function {$name}_miss(\$n) {
+            return \$n;
+            }
+            PHP);
+        $function = new \ReflectionFunction($name . '_hit');
+
+        return [$function->getClosure(), (string) $function->getFileName()];
+    }
+}
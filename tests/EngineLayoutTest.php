@@ -27,6 +27,11 @@ use PHPUnit\Framework\TestCase;
  */
 final class EngineLayoutTest extends TestCase
 {
+    /**
+     * Slices every sliced binding concatenates first, in this order (Core::engineDefinition())
+     */
+    private const array BASE_SLICES = ['values', 'classes', 'executor'];
+
     /**
      * @return array<string, array{0: string, 1: array{size: int, fields: array<string, int>}}>
      */
@@ -64,6 +69,65 @@ final class EngineLayoutTest extends TestCase
         }
     }
 
+    /**
+     * @return array<string, array{0: list<string>}>
+     */
+    public static function sliceCompositionProvider(): array
+    {
+        $optional     = array_values(array_diff(array_keys(self::loadSliceMap()), self::BASE_SLICES));
+        $compositions = ['base' => [self::BASE_SLICES]];
+        foreach ($optional as $slice) {
+            $compositions["base+{$slice}"] = [[...self::BASE_SLICES, $slice]];
+        }
+        $compositions['base+all'] = [[...self::BASE_SLICES, ...$optional]];
+
+        return $compositions;
+    }
+
+    public function testEveryStructIsDefinedByExactlyOneHeaderSlice(): void
+    {
+        $sliceMap = self::loadSliceMap();
+        $this->assertSame(self::BASE_SLICES, array_slice(array_keys($sliceMap), 0, count(self::BASE_SLICES)));
+
+        $structs = array_merge(...array_values($sliceMap));
+        sort($structs);
+        $expected = array_keys(self::loadLayouts()['structs']);
+        sort($expected);
+        $this->assertSame($expected, $structs);
+    }
+
+    /**
+     * Binds the slices on their own, the way Core does without preload, and checks the structs
+     * slices.json assigns to them
+     *
+     * @param list<string> $slices
+     */
+    #[DataProvider('sliceCompositionProvider')]
+    public function testHeaderSliceCompositionMatchesGroundTruth(array $slices): void
+    {
+        $definition = '';
+        foreach ($slices as $slice) {
+            $definition .= (string) file_get_contents(self::platformDirectory() . "/engine.{$slice}.h");
+        }
+        $library  = \DIRECTORY_SEPARATOR === '/' ? null : 'php' . PHP_MAJOR_VERSION . (\ZEND_THREAD_SAFE ? 'ts' : '') . '.dll';
+        $ffi      = FFI::cdef($definition, $library);
+        $layouts  = self::loadLayouts()['structs'];
+        $sliceMap = self::loadSliceMap();
+        foreach ($slices as $slice) {
+            foreach ($sliceMap[$slice] as $struct) {
+                $type = $ffi->type($struct);
+                $this->assertSame($layouts[$struct]['size'], $type->getSize(), "sizeof({$struct}) in slice {$slice}");
+                foreach ($layouts[$struct]['fields'] as $field => $expectedOffset) {
+                    $this->assertSame(
+                        $expectedOffset,
+                        $type->getStructFieldOffset($field),
+                        "offsetof({$struct}, {$field}) in slice {$slice}",
+                    );
+                }
+            }
+        }
+    }
+
     public function testLayoutsWereProbedForTheRunningPhpMinor(): void
     {
         $meta         = self::loadLayouts()['meta'];
@@ -78,8 +142,23 @@ final class EngineLayoutTest extends TestCase
      */
     private static function loadLayouts(): array
     {
-        $file = __DIR__ . '/../include/' . Core::platformKey() . '/layouts.json';
+        $file = self::platformDirectory() . '/layouts.json';
 
         return json_decode((string) file_get_contents($file), true, 16, JSON_THROW_ON_ERROR);
     }
+
+    /**
+     * @return array<string, list<string>> slice name => layout structs it defines
+     */
+    private static function loadSliceMap(): array
+    {
+        $file = self::platformDirectory() . '/slices.json';
+
+        return json_decode((string) file_get_contents($file), true, 16, JSON_THROW_ON_ERROR);
+    }
+
+    private static function platformDirectory(): string
+    {
+        return __DIR__ . '/../include/' . Core::platformKey();
+    }
 }
@@ -0,0 +1,99 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Hook;
+
+use Closure;
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\TestCase;
+use ZEngine\Core;
+use ZEngine\EngineExtension\ZEngineModule;
+use ZEngine\System\ExecutionData;
+use ZEngine\System\Hook\OpCodeHook;
+use ZEngine\System\OpCode;
+
+/**
+ * Opt-in per-field hook counters: calls, pass-throughs, latency buckets and the phpinfo rows
+ */
+#[Group('internal')]
+final class HookStatisticsTest extends TestCase
+{
+    public function testBucketsAreFloorLog2(): void
+    {
+        $this->assertSame(0, HookStatistics::bucketOf(0));
+        $this->assertSame(0, HookStatistics::bucketOf(1));
+        $this->assertSame(1, HookStatistics::bucketOf(3));
+        $this->assertSame(10, HookStatistics::bucketOf(1024));
+        $this->assertSame(10, HookStatistics::bucketOf(2047));
+        $this->assertSame(HookStatistics::HIGHEST_BUCKET, HookStatistics::bucketOf(PHP_INT_MAX));
+    }
+
+    public function testSnapshotAndQuantiles(): void
+    {
+        $statistics = new HookStatistics();
+        for ($i = 0; $i < 99; $i++) {
+            $statistics->recordCall('field', 1000);
+        }
+        $statistics->recordCall('field', 50_000);
+        $statistics->recordProceed('field');
+
+        $figures = $statistics->snapshot()['field'];
+        $this->assertSame(100, $figures['calls']);
+        $this->assertSame(1, $figures['proceeds']);
+        $this->assertSame(99 * 1000 + 50_000, $figures['totalNanos']);
+        $this->assertSame(50_000, $figures['maxNanos']);
+        $this->assertSame([9 => 99, 15 => 1], $figures['histogram']);
+        $this->assertSame(1024, $statistics->getQuantileBound('field', 0.5));
+        $this->assertSame(65536, $statistics->getQuantileBound('field', 1.0));
+
+        $statistics->reset();
+        $this->assertSame([], $statistics->snapshot());
+    }
+
+    public function testInstrumentedTrampolineCountsCallsAndPassThroughs(): void
+    {
+        $statistics = Core::enableHookStatistics();
+        $hook       = OpCode::setHandler(OpCode::ADD, fn(ExecutionData $scope): int => Core::ZEND_USER_OPCODE_DISPATCH);
+        try {
+            // The handler is resolved when the probe is compiled, so compile it under the hook
+            $probe = self::compileProbe();
+            for ($i = 0; $i < 10; $i++) {
+                $this->assertSame($i + 1, $probe($i, 1));
+            }
+            $figures = $statistics->snapshot()[OpCodeHook::fieldKeyFor(OpCode::ADD)] ?? null;
+            $this->assertNotNull($figures);
+            $this->assertSame('OpCodeHook', $figures['hook']);
+            $this->assertGreaterThan(0, $figures['calls']);
+            $this->assertGreaterThanOrEqual(10, $figures['calls']);
+            $this->assertSame($figures['calls'], $figures['proceeds'], 'Every call dispatched back to the VM');
+            $this->assertSame($figures['calls'], array_sum($figures['histogram']));
+
+            $info = (new \ReflectionClass(ZEngineModule::class))->newInstanceWithoutConstructor()->getDisplayInfo();
+            $this->assertSame('enabled', $info['Hook statistics']);
+            $this->assertArrayHasKey('Hook OpCodeHook ' . OpCodeHook::fieldKeyFor(OpCode::ADD), $info);
+        } finally {
+            $hook->uninstall();
+            Core::disableHookStatistics();
+        }
+        $this->assertNull(Core::getHookStatistics());
+    }
+
+    private static function compileProbe(): Closure
+    {
+        $name = str_replace('.', '_', uniqid('zengine_statistics_probe_', true));
+        eval("function {$name}(\$a, \$b) {\nreturn \$a + \$b;\n}");
+        assert(is_callable($name));
+
+        return Closure::fromCallable($name);
+    }
+}
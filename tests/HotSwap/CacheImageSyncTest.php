@@ -28,7 +28,8 @@ use ZEngine\OpCache\PayloadRelocator;
  * compiled into a per-test directory owned by this class:
  *
  *  - plain child (opcache off): unchanged-noop diff, patched apply, live
- *    dispatch of the patched bodies, idempotent re-diff, single-use sync;
+ *    dispatch of the patched bodies, reverted inlined callers, idempotent
+ *    re-diff, single-use sync;
  *  - shared-memory child (opcache on): the same loop against immutable
  *    entries, proving the copy-out path and the untouched SHM originals;
  *  - refusal child: never-loaded images report not-loaded entries instead of
@@ -63,6 +64,7 @@ class CacheImageSyncTest extends TestCase
         self::assertStringContainsString('noop-diff: ok', $stdout, $report);
         self::assertStringContainsString('patched-apply: ok', $stdout, $report);
         self::assertStringContainsString('live-dispatch: ok', $stdout, $report);
+        self::assertStringContainsString('inlined-caller: ok', $stdout, $report);
         self::assertStringContainsString('idempotency: ok', $stdout, $report);
         self::assertStringContainsString('IMAGE SYNC OK', $stdout, $report);
     }
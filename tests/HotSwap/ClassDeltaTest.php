@@ -19,7 +19,10 @@ use PHPUnit\Framework\TestCase;
 use ZEngine\ClassExtension\Hook\CompareValuesHook;
 use ZEngine\ClassExtension\ObjectCreateTrait;
 use ZEngine\OpCache\SharedMemoryException;
+use ZEngine\Optimizer\Inliner;
 use ZEngine\Reflection\ReflectionClass;
+use ZEngine\Reflection\ReflectionFunction;
+use ZEngine\Reflection\ReflectionMethod;
 
 class ClassDeltaTest extends TestCase
 {
@@ -139,6 +142,46 @@ class ClassDeltaTest extends TestCase
         $this->assertSame('base', self::callMethod($restoredInstance, 'speak'));
     }
 
+    #[RunInSeparateProcess]
+    public function testChangedAndRemovedMethodsRevertTheirInlinedCallers(): void
+    {
+        $className = $this->declareClass(
+            'Inlined',
+            '{ public static function rate(): int { return 2; } public static function bonus(): int { return 5; }'
+            . ' public static function total(int $a): int { return self::rate() * $a; } }',
+        );
+        $rateCaller  = str_replace('.', '_', uniqid('zengine_delta_rate_', true));
+        $bonusCaller = str_replace('.', '_', uniqid('zengine_delta_bonus_', true));
+        eval("function {$rateCaller}(\$a) { return {$className}::rate() * \$a; }");
+        eval("function {$bonusCaller}() { return {$className}::bonus(); }");
+        assert(is_callable($rateCaller) && is_callable($bonusCaller));
+
+        $inliner = new Inliner();
+        $inliner->inline(new ReflectionFunction($rateCaller));
+        $inliner->inline(new ReflectionFunction($bonusCaller));
+        $inliner->inline(new ReflectionMethod($className, 'total'));
+        $this->assertSame(6, $rateCaller(3));
+        $this->assertSame(5, $bonusCaller());
+
+        HotSwap::prepare(
+            $className,
+            "class {$className} { public static function rate(): int { return 4; }"
+            . ' public static function total(int $a): int { return self::rate() * $a + 1; } }',
+        )->apply();
+
+        // The callers call the new body instead of their stale inlined copy
+        $this->assertFalse(Inliner::hasInlinedCalls(new ReflectionFunction($rateCaller)));
+        $this->assertSame(12, $rateCaller(3));
+        // A replaced caller forgets its pre-inlining layout, no later revert writes it back
+        $this->assertFalse(Inliner::hasInlinedCalls(new ReflectionMethod($className, 'total')));
+        $this->assertSame(13, self::callMethod(self::newInstance($className), 'total', 3));
+
+        $this->assertFalse(Inliner::hasInlinedCalls(new ReflectionFunction($bonusCaller)));
+        $this->expectException(\Error::class);
+        $this->expectExceptionMessage('Call to undefined method');
+        $bonusCaller();
+    }
+
     public function testConstantChangeAndAddition(): void
     {
         $className = $this->declareClass('Const', '{ public const VERSION = 1; }');
@@ -0,0 +1,125 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\HotSwap;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\Attributes\RunInSeparateProcess;
+use PHPUnit\Framework\TestCase;
+use ZEngine\Core;
+use ZEngine\Reflection\ReflectionFunction;
+use ZEngine\Reflection\ReflectionMethod;
+use ZEngine\Reflection\RunTimeCacheArena;
+
+/**
+ * Batched redefinitions of eval()'d functions and methods: all or nothing, one cache block
+ */
+#[Group('internal')]
+final class RedefinitionBatchTest extends TestCase
+{
+    #[RunInSeparateProcess]
+    public function testAllEntriesSwapFromOneCacheBlock(): void
+    {
+        [$first, $second, $class] = self::createFixture();
+        $firstBody  = fn($value) => strtoupper($value) . '!';
+        $secondBody = fn($value) => $value * 3;
+        $methodBody = fn($value) => str_repeat('x', $value);
+
+        $report = (new RedefinitionBatch())
+            ->addFunction($first, $firstBody)
+            ->addFunction($second, $secondBody)
+            ->addMethod($class, 'render', $methodBody)
+            ->commit();
+
+        $this->assertSame('ABC!', $first('abc'));
+        $this->assertSame(12, $second(4));
+        $this->assertSame('xxx', (new $class())->render(3));
+
+        $this->assertSame([$first, $second, "{$class}::render"], $report->getEntries());
+        $this->assertFalse($report->isNoOp());
+        $this->assertGreaterThanOrEqual($report->stagingTimes[$first], $report->getSwapTime($first));
+        $this->assertGreaterThanOrEqual(array_sum($report->stagingTimes), $report->totalNanoseconds);
+
+        $expectedSize = 0;
+        foreach ([new ReflectionFunction($first), new ReflectionFunction($second), new ReflectionMethod($class, 'render')] as $entry) {
+            $expectedSize += RunTimeCacheArena::slotSizeOf($entry->getOpArrayPointer()->cache_size);
+            $heapCache     = ($entry->getCommonPointer()->fn_flags & Core::ZEND_ACC_HEAP_RT_CACHE) !== 0;
+            $this->assertFalse($heapCache, 'Arena caches are never freed one by one');
+        }
+        $this->assertSame($expectedSize, $report->arenaBytes);
+    }
+
+    #[RunInSeparateProcess]
+    public function testFailureRollsEveryStagedSwapBack(): void
+    {
+        [$first, $second] = self::createFixture();
+        $batch = (new RedefinitionBatch())
+            ->addFunction($first, fn($value) => 'changed')
+            ->addFunction($second, fn($value, $extra) => 'incompatible');
+
+        try {
+            $batch->commit();
+            $this->fail('The incompatible signature must abort the batch');
+        } catch (HotSwapException $error) {
+            $this->assertInstanceOf(\ReflectionException::class, $error->getPrevious());
+        }
+        $this->assertSame('abc', $first('abc'), 'The staged swap was rolled back');
+        $this->assertSame(8, $second(4));
+    }
+
+    #[RunInSeparateProcess]
+    public function testRedefiningAnEntryAgainLeavesTheBatchBlockAlone(): void
+    {
+        [$first, $second] = self::createFixture();
+        (new RedefinitionBatch())
+            ->addFunction($first, fn($value) => "v1:{$value}")
+            ->addFunction($second, fn($value) => $value + 1)
+            ->commit();
+
+        (new ReflectionFunction($first))->redefine(fn($value) => "v2:{$value}");
+        $this->assertSame('v2:a', $first('a'));
+        $this->assertSame(5, $second(4), 'The sibling cache in the same block is still intact');
+    }
+
+    public function testEntriesAreAddedOnce(): void
+    {
+        $batch = (new RedefinitionBatch())->addFunction('Some_Function', fn() => null);
+
+        $this->expectException(HotSwapException::class);
+        $batch->addFunction('some_function', fn() => null);
+    }
+
+    public function testEmptyBatchIsANoOp(): void
+    {
+        $report = (new RedefinitionBatch())->commit();
+
+        $this->assertTrue($report->isNoOp());
+        $this->assertSame(0, $report->arenaBytes);
+    }
+
+    /**
+     * @return array{string, string, string} Two function names and a class name
+     */
+    private static function createFixture(): array
+    {
+        $suffix = str_replace('.', '_', uniqid('', true));
+        $first  = "zengine_batch_first_{$suffix}";
+        $second = "zengine_batch_second_{$suffix}";
+        $class  = "ZEngineBatchSubject{$suffix}";
+        eval("function {$first}(\$value) { return \$value; }");
+        eval("function {$second}(\$value) { return \$value * 2; }");
+        eval("class {$class} { public function render(\$value) { return (string) \$value; } }");
+
+        return [$first, $second, $class];
+    }
+}
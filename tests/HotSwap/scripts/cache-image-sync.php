@@ -24,6 +24,7 @@ use ZEngine\Core;
 use ZEngine\HotSwap\CacheImageSync;
 use ZEngine\HotSwap\HotSwapException;
 use ZEngine\OpCache\BinaryCacheFile;
+use ZEngine\Optimizer\Inliner;
 use ZEngine\Reflection\ReflectionFunction;
 use ZEngine\Reflection\ReflectionMethod;
 
@@ -88,6 +89,13 @@ $patchLiteral($image->getFunctions()['zengine_bin_answer'], 41, 42);
 $patchLiteral($image->getFunctions()['zengine_bin_greeting'], 'hello', 'patched-hello');
 $patchLiteral($image->getClasses()['zenginebinsubject']->getDeclaredMethods()['describe'], 1, 3);
 
+// A live caller runs an inlined copy of the function the image changes
+eval('function zengine_image_sync_caller(): int { return zengine_bin_answer() * 2; }');
+$inlining = (new Inliner())->inline(new ReflectionFunction('zengine_image_sync_caller'));
+if ($inlining->inlinedCallees !== ['zengine_bin_answer']) {
+    $fail('the caller did not inline the function: ' . json_encode($inlining->rejectedCallees));
+}
+
 $sync = CacheImageSync::prepare($image);
 if ($sync->getChangedFunctions() !== ['zengine_bin_answer', 'zengine_bin_greeting']) {
     $fail('changed function set is wrong: ' . json_encode($sync->getChangedFunctions()));
@@ -139,6 +147,15 @@ if ($callStatic('ZEngineBinSubject', 'describe', 0) !== 'stablestablestable') {
 $callStatic('ZEngineBinSubject', 'describe', 0);
 echo "live-dispatch: ok\n";
 
+// The inlined caller went back to a real call of the patched body
+if (Inliner::hasInlinedCalls(new ReflectionFunction('zengine_image_sync_caller'))) {
+    $fail('the inlined caller was not reverted');
+}
+if ($callIt('zengine_image_sync_caller') !== 84) {
+    $fail('the inlined caller still runs the stale copy');
+}
+echo "inlined-caller: ok\n";
+
 // 4. Idempotency: a fresh diff of the same image against the synced process is
 //    empty; re-applying the consumed sync is refused loudly
 $again = CacheImageSync::prepare($image);
@@ -85,6 +85,21 @@ final class CacheMetaInfoTest extends TestCase
         self::assertNotSame($meta->timestamp(), $modified->timestamp());
     }
 
+    public function testIncrementalChecksumMatchesAFullOne(): void
+    {
+        $previous = random_bytes(70000);
+        $changes  = [0 => "\x00\xff", 4097 => random_bytes(13), 69999 => "\x7f"];
+        $current  = $previous;
+        foreach ($changes as $offset => $bytes) {
+            $current = substr_replace($current, $bytes, $offset, strlen($bytes));
+        }
+
+        self::assertSame(
+            CacheMetaInfo::checksumOf($current),
+            CacheMetaInfo::updateChecksum(CacheMetaInfo::checksumOf($previous), $previous, $changes),
+        );
+    }
+
     public function testRejectsForeignMagic(): void
     {
         $this->expectException(OpCacheException::class);
@@ -0,0 +1,108 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\OpCache;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\TestCase;
+
+/**
+ * Directory-scale warm-up: a worker pool fills the cache, a re-run only recompiles what changed
+ */
+#[Group('opcache')]
+final class FileCacheWarmerTest extends TestCase
+{
+    use FileCacheFixture;
+
+    private static string $sourceDir = '';
+
+    protected function setUp(): void
+    {
+        if (!extension_loaded('Zend OPcache')) {
+            self::markTestSkipped('Zend OPcache extension is not loaded');
+        }
+        if (\DIRECTORY_SEPARATOR !== '/') {
+            self::markTestSkipped('The warmer test assumes the POSIX cache layout (issue #119)');
+        }
+        self::$cacheDir  = sys_get_temp_dir() . '/zengine-opcache-' . bin2hex(random_bytes(6));
+        self::$sourceDir = sys_get_temp_dir() . '/zengine-warm-src-' . bin2hex(random_bytes(6));
+        mkdir(self::$sourceDir . '/nested', 0777, true);
+        // Older than opcache.file_update_protection, which never caches a just-modified script
+        $modifiedAt = time() - 60;
+        foreach (['first.php', 'second.php', 'nested/third.php'] as $index => $fileName) {
+            file_put_contents(self::$sourceDir . "/{$fileName}", "<?php function zengine_warm_{$index}() { return {$index}; }\n");
+            touch(self::$sourceDir . "/{$fileName}", $modifiedAt);
+        }
+        file_put_contents(self::$sourceDir . '/broken.php', "<?php function (\n");
+        touch(self::$sourceDir . '/broken.php', $modifiedAt);
+        file_put_contents(self::$sourceDir . '/notes.txt', 'not a script');
+    }
+
+    protected function tearDown(): void
+    {
+        self::removeCacheDir();
+        self::removeDirectory(self::$sourceDir);
+    }
+
+    public function testDirectoryIsWarmedIncrementally(): void
+    {
+        $warmer = new FileCacheWarmer(self::$cacheDir, workers: 2, scriptsPerWorker: 1);
+        $report = $warmer->warmDirectory(self::$sourceDir);
+
+        $broken = realpath(self::$sourceDir . '/broken.php');
+        self::assertCount(3, $report->compiled);
+        self::assertSame([], $report->upToDate);
+        self::assertSame([$broken], array_keys($report->failed));
+        self::assertFalse($report->isComplete());
+
+        $manifest = FileCacheManifest::load(self::$cacheDir);
+        self::assertSame($manifest->path(), $report->manifestPath);
+        foreach ($report->compiled as $script) {
+            $entry = $manifest->get($script);
+            self::assertNotNull($entry);
+            self::assertFileExists($entry['binPath']);
+            self::assertSame(filemtime($script), $entry['timestamp']);
+            self::assertSame(filesize($entry['binPath']), $entry['size']);
+            self::assertSame(SystemId::current()->toHex(), $entry['systemId']);
+        }
+
+        // A re-run skips every current binary; only a touched script is compiled again
+        $touched = realpath(self::$sourceDir . '/nested/third.php');
+        touch($touched, time() - 30);
+        $rerun = $warmer->warmDirectory(self::$sourceDir);
+        self::assertSame([$touched], $rerun->compiled);
+        self::assertCount(2, $rerun->upToDate);
+        self::assertSame(filemtime($touched), FileCacheManifest::load(self::$cacheDir)->get($touched)['timestamp'] ?? null);
+    }
+
+    public function testLostManifestIsRebuiltFromBinaryHeaders(): void
+    {
+        $warmer = new FileCacheWarmer(self::$cacheDir, workers: 1);
+        $warmer->warmDirectory(self::$sourceDir);
+        unlink(self::$cacheDir . '/' . FileCacheManifest::FILE_NAME);
+
+        $report = $warmer->warmDirectory(self::$sourceDir);
+        self::assertSame([], $report->compiled);
+        self::assertCount(3, $report->upToDate);
+        self::assertCount(3, FileCacheManifest::load(self::$cacheDir)->entries());
+    }
+
+    public function testClassMapBinariesAreExecutedFromCache(): void
+    {
+        $report = (new FileCacheWarmer(self::$cacheDir))->warmClassMap(['ZEngineBinSubject' => self::fixturePath()]);
+
+        self::assertTrue($report->isComplete());
+        self::assertSame([self::fixturePath()], $report->compiled);
+        self::assertSame('41', self::runFromCache(self::fixturePath(), 'zengine_bin_answer', self::$cacheDir));
+    }
+}
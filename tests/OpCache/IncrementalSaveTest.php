@@ -0,0 +1,98 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\OpCache;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\TestCase;
+use ZEngine\Reflection\ReflectionValue;
+
+/**
+ * Size-preserving edits are saved as changed ranges plus the header, byte-identical to a full write
+ */
+#[Group('opcache')]
+#[Group('opcache-relocator')]
+final class IncrementalSaveTest extends TestCase
+{
+    use FileCacheFixture;
+
+    protected function setUp(): void
+    {
+        if (!PayloadRelocator::isSupported()) {
+            self::markTestSkipped(
+                'The file-cache relocator supports 64-bit POSIX payloads only'
+                . ' (Windows opcache support is an intentional non-goal, issue #119)',
+            );
+        }
+    }
+
+    protected function tearDown(): void
+    {
+        self::removeCacheDir();
+    }
+
+    public function testOneLiteralEditWritesOnlyItsRange(): void
+    {
+        $binPath  = self::compileFixture();
+        $fullPath = self::$cacheDir . '/full-write.bin';
+
+        $reference = BinaryCacheFile::read($binPath);
+        self::patchAnswer($reference);
+        $reference->save($fullPath);
+        self::assertSame(filesize($fullPath), $reference->lastWrittenBytes());
+
+        $file = BinaryCacheFile::read($binPath, self::fixturePath());
+        self::assertTrue($file->verifyChecksum());
+        self::patchAnswer($file);
+        $file->save();
+
+        self::assertGreaterThan(CacheMetaInfo::byteSize(), $file->lastWrittenBytes());
+        self::assertLessThanOrEqual(CacheMetaInfo::byteSize() + 64, $file->lastWrittenBytes());
+        self::assertSame(file_get_contents($fullPath), file_get_contents($binPath));
+        self::assertTrue(BinaryCacheFile::read($binPath)->verifyChecksum());
+        self::assertSame('42', self::runFromCache(self::fixturePath(), 'zengine_bin_answer', self::$cacheDir));
+    }
+
+    public function testUnchangedImageWritesNothing(): void
+    {
+        $binPath = self::compileFixture();
+        $file    = BinaryCacheFile::read($binPath);
+        $file->getReflection();
+        $file->save();
+
+        self::assertSame(0, $file->lastWrittenBytes());
+    }
+
+    public function testReplacedBinaryTakesTheFullWrite(): void
+    {
+        $binPath = self::compileFixture();
+        $file    = BinaryCacheFile::read($binPath);
+        self::patchAnswer($file);
+        // Another writer replaced the binary since it was read
+        BinaryCacheFile::read($binPath)->save(timestamp: 1);
+        $file->save();
+
+        self::assertSame(filesize($binPath), $file->lastWrittenBytes());
+        self::assertNotSame(1, BinaryCacheFile::read($binPath)->metaInfo()->timestamp());
+    }
+
+    private static function patchAnswer(BinaryCacheFile $file): void
+    {
+        foreach ($file->getReflection()->getFunctions()['zengine_bin_answer']->getLiterals() as $literal) {
+            $literal->getNativeValue($value);
+            if ($literal->getBaseType() === ReflectionValue::IS_LONG && $value === 41) {
+                $literal->setNativeValue(42);
+            }
+        }
+    }
+}
@@ -0,0 +1,92 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\OpCache;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\TestCase;
+use ZEngine\Core;
+use ZEngine\Reflection\ReflectionValue;
+
+/**
+ * Lazy relocation: only the accessed entries leave file form, and a partially
+ * relocated image still serializes byte-identically
+ */
+#[Group('opcache')]
+#[Group('opcache-relocator')]
+final class LazyRelocationTest extends TestCase
+{
+    use FileCacheFixture;
+
+    protected function setUp(): void
+    {
+        if (!PayloadRelocator::isSupported()) {
+            self::markTestSkipped(
+                'The file-cache relocator supports 64-bit POSIX payloads only'
+                . ' (Windows opcache support is an intentional non-goal, issue #119)',
+            );
+        }
+    }
+
+    protected function tearDown(): void
+    {
+        self::removeCacheDir();
+    }
+
+    public function testOnlyAccessedEntriesAreRelocated(): void
+    {
+        $binPath = self::compileFixture();
+        $bytes   = (string) file_get_contents($binPath);
+        $payload = substr($bytes, CacheMetaInfo::byteSize());
+        $meta    = CacheMetaInfo::parse($bytes, $binPath);
+
+        $length = strlen($payload);
+        $buffer = Core::new("char[{$length}]", false);
+        Core::memcpy($buffer, $payload, $length);
+        $relocator = new PayloadRelocator($buffer, $meta);
+        $view      = new ReflectionOpcacheFile($relocator->relocate(lazy: true), $relocator);
+        self::assertTrue($relocator->hasDeferredEntries());
+
+        self::assertGreaterThan(0, count([...$view->getFunction('ZENGINE_BIN_ANSWER')->getOpCodes()]));
+        self::assertSame('ZEngineBinSubject', (string) $view->getClass('zenginebinsubject')->getName());
+        self::assertTrue($relocator->hasDeferredEntries(), 'The greeting function and the marker class were not accessed');
+
+        self::assertSame($payload, $relocator->derelocate(), 'A partially relocated image serializes byte-for-byte');
+        self::assertFalse($relocator->hasDeferredEntries());
+        self::assertGreaterThan(0, count([...$view->getFunction('zengine_bin_greeting')->getOpCodes()]));
+    }
+
+    public function testPatchedLazyImageIsExecutedFromCache(): void
+    {
+        $file     = BinaryCacheFile::read(self::compileFixture(), self::fixturePath());
+        $function = $file->getReflection(lazy: true)->getFunction('zengine_bin_answer');
+        foreach ($function->getLiterals() as $literal) {
+            $literal->getNativeValue($value);
+            if ($literal->getBaseType() === ReflectionValue::IS_LONG && $value === 41) {
+                $literal->setNativeValue(42);
+            }
+        }
+        $file->save();
+
+        self::assertSame('42', self::runFromCache(self::fixturePath(), 'zengine_bin_answer', self::$cacheDir));
+        self::assertSame('hello', self::runFromCache(self::fixturePath(), 'zengine_bin_greeting', self::$cacheDir));
+    }
+
+    public function testUnknownEntriesAreReported(): void
+    {
+        $view = BinaryCacheFile::read(self::compileFixture(), self::fixturePath())->getReflection(lazy: true);
+
+        $this->expectException(OpCacheException::class);
+        $view->getFunction('zengine_bin_missing');
+    }
+}
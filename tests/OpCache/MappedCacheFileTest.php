@@ -0,0 +1,150 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\OpCache;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\TestCase;
+use ZEngine\Reflection\ReflectionValue;
+
+/**
+ * map()ped binaries: the same header, checksum and image as read(), relocated in a
+ * copy-on-write view that never reaches the file
+ */
+#[Group('opcache')]
+#[Group('opcache-relocator')]
+final class MappedCacheFileTest extends TestCase
+{
+    use FileCacheFixture;
+
+    protected function setUp(): void
+    {
+        if (!CacheBinaryMapping::isSupported()) {
+            self::markTestSkipped(
+                'Cache binaries can be mapped on 64-bit POSIX builds only'
+                . ' (Windows opcache support is an intentional non-goal, issue #119)',
+            );
+        }
+    }
+
+    protected function tearDown(): void
+    {
+        self::removeCacheDir();
+    }
+
+    public function testMappedBinaryMatchesReadBinary(): void
+    {
+        $binPath = self::compileFixture();
+        $read    = BinaryCacheFile::read($binPath);
+        $mapped  = BinaryCacheFile::map($binPath);
+
+        self::assertEquals($read->metaInfo(), $mapped->metaInfo());
+        self::assertTrue($mapped->verifyChecksum());
+        self::assertSame($read->payload(), $mapped->payload());
+    }
+
+    public function testRelocationNeverReachesTheFile(): void
+    {
+        $binPath  = self::compileFixture();
+        $original = (string) file_get_contents($binPath);
+        $mapped   = BinaryCacheFile::map($binPath, self::fixturePath());
+
+        $names = array_keys($mapped->getReflection()->getFunctions());
+        self::assertContains('zengine_bin_answer', $names);
+        self::assertTrue($mapped->verifyChecksum(), 'The pristine view is not relocated');
+        self::assertSame(substr($original, CacheMetaInfo::byteSize()), $mapped->payload());
+        self::assertSame($original, file_get_contents($binPath));
+    }
+
+    public function testPatchedMappedImageIsExecutedFromCache(): void
+    {
+        $file     = BinaryCacheFile::map(self::compileFixture(), self::fixturePath());
+        $function = $file->getReflection(lazy: true)->getFunction('zengine_bin_answer');
+        foreach ($function->getLiterals() as $literal) {
+            $literal->getNativeValue($value);
+            if ($literal->getBaseType() === ReflectionValue::IS_LONG && $value === 41) {
+                $literal->setNativeValue(42);
+            }
+        }
+        $file->save();
+
+        self::assertSame('42', self::runFromCache(self::fixturePath(), 'zengine_bin_answer', self::$cacheDir));
+    }
+
+    public function testSaveNeverWritesIntoAMappedInode(): void
+    {
+        $binPath = self::compileFixture();
+        $payload = substr((string) file_get_contents($binPath), CacheMetaInfo::byteSize());
+        $mapped  = BinaryCacheFile::map($binPath);
+
+        $file = BinaryCacheFile::read($binPath);
+        self::replaceAnswer($file, 41, 42);
+        $file->save();
+
+        self::assertSame(filesize($binPath), $file->lastWrittenBytes(), 'A mapped binary is replaced by rename');
+        self::assertSame($payload, $mapped->payload(), 'The mapped views keep the inode they were taken from');
+        self::assertTrue($mapped->verifyChecksum());
+        self::assertSame('42', self::runFromCache(self::fixturePath(), 'zengine_bin_answer', self::$cacheDir));
+
+        $mapped->unmap();
+        $again = BinaryCacheFile::read($binPath);
+        self::replaceAnswer($again, 42, 43);
+        $again->save();
+        self::assertLessThan(filesize($binPath), $again->lastWrittenBytes(), 'Unmapping drops the lock');
+    }
+
+    public function testDroppedMappingsGiveTheirDescriptorsBack(): void
+    {
+        $binPath = self::compileFixture();
+        $before  = self::countOpenDescriptors();
+        for ($i = 0; $i < 256; $i++) {
+            $file = BinaryCacheFile::map($binPath);
+            self::assertTrue($file->verifyChecksum());
+            $file->getReflection(lazy: true);
+        }
+        unset($file);
+        gc_collect_cycles();
+        self::assertLessThanOrEqual($before, self::countOpenDescriptors(), 'A scan that never unmaps must not leak descriptors');
+
+        $again = BinaryCacheFile::read($binPath);
+        self::replaceAnswer($again, 41, 42);
+        $again->save();
+        self::assertLessThan(filesize($binPath), $again->lastWrittenBytes(), 'No dropped mapping keeps its lock');
+    }
+
+    public function testUnmappedBinaryIsRefused(): void
+    {
+        $file = BinaryCacheFile::map(self::compileFixture());
+        $file->unmap();
+
+        $this->expectException(OpCacheException::class);
+        $file->getReflection();
+    }
+
+    private static function countOpenDescriptors(): int
+    {
+        $directory = is_dir('/proc/self/fd') ? '/proc/self/fd' : '/dev/fd';
+
+        return count(scandir($directory) ?: []);
+    }
+
+    private static function replaceAnswer(BinaryCacheFile $file, int $from, int $to): void
+    {
+        foreach ($file->getReflection()->getFunctions()['zengine_bin_answer']->getLiterals() as $literal) {
+            $literal->getNativeValue($value);
+            if ($literal->getBaseType() === ReflectionValue::IS_LONG && $value === $from) {
+                $literal->setNativeValue($to);
+            }
+        }
+    }
+}
@@ -0,0 +1,193 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Optimizer;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\Attributes\RunInSeparateProcess;
+use PHPUnit\Framework\TestCase;
+use ZEngine\HotSwap\RedefinitionBatch;
+use ZEngine\Reflection\OpArrayRewriteException;
+use ZEngine\Reflection\ReflectionFunction;
+use ZEngine\System\OpCode;
+
+/**
+ * Call sites of eval()'d functions replaced by their callee: same results, no call oplines
+ */
+#[Group('internal')]
+final class InlinerTest extends TestCase
+{
+    private const array CALL_OPCODES = [
+        OpCode::INIT_FCALL,
+        OpCode::INIT_FCALL_BY_NAME,
+        OpCode::INIT_NS_FCALL_BY_NAME,
+        OpCode::DO_UCALL,
+        OpCode::DO_FCALL_BY_NAME,
+    ];
+
+    #[RunInSeparateProcess]
+    public function testInlinedLoopComputesTheSameResults(): void
+    {
+        $helper = self::createFunction('($a, $b = 2) { $c = $a * $b; return $c + 1; }');
+        $caller = self::createFunction("(\$n) { \$sum = 0; for (\$i = 0; \$i < \$n; \$i++) { \$sum += {$helper}(\$i) + {$helper}(\$i, 3); } return \$sum; }");
+        $this->assertSame(38, $caller(4));
+
+        $report = (new Inliner())->inline(new ReflectionFunction($caller));
+        $this->assertTrue($report->isChanged());
+        $this->assertSame(2, $report->inlinedSites);
+        $this->assertSame([$helper], $report->inlinedCallees);
+        $this->assertGreaterThan(0, $report->addedFrameSlots);
+        $this->assertSame([], array_intersect(self::CALL_OPCODES, self::opcodesOf($caller)));
+
+        $this->assertSame(38, $caller(4), 'The inlined body computes the same result');
+        $this->assertSame(0, $caller(0));
+        $this->assertTrue(Inliner::hasInlinedCalls(new ReflectionFunction($caller)));
+    }
+
+    #[RunInSeparateProcess]
+    public function testTypedParametersFallBackToTheRealCall(): void
+    {
+        $helper = self::createFunction('(int $a): int { return $a * 2; }');
+        $caller = self::createFunction("(\$value) { return {$helper}(\$value); }");
+
+        $report = (new Inliner())->inline(new ReflectionFunction($caller));
+        $this->assertSame(1, $report->inlinedSites);
+        $this->assertSame(8, $caller(4));
+        $this->assertSame(10, $caller('5'), 'Coercion happens in the real call');
+
+        $this->expectException(\TypeError::class);
+        $caller('five');
+    }
+
+    #[RunInSeparateProcess]
+    public function testCheckedReturnsAreInlinedOnlyWhenTheBodyCanRunTwice(): void
+    {
+        // An untyped $a may be an object: the CONCAT could call __toString() in both runs
+        $quoted = self::createFunction('($a): string { return "<" . $a . ">"; }');
+        $typed  = self::createFunction('(string $a): string { return "<" . $a . ">"; }');
+        $caller = self::createFunction("(\$a) { return {$quoted}(\$a) . {$typed}(\$a); }");
+
+        $report = (new Inliner())->inline(new ReflectionFunction($caller));
+        $this->assertSame([$typed], $report->inlinedCallees);
+        $this->assertStringContainsString('after a failed return check', $report->rejectedCallees[$quoted] ?? '');
+        $this->assertSame('<x><x>', $caller('x'));
+    }
+
+    #[RunInSeparateProcess]
+    public function testRedefiningTheCalleeRevertsTheCaller(): void
+    {
+        $helper = self::createFunction('($a) { return $a + 1; }');
+        $caller = self::createFunction("(\$a) { return {$helper}(\$a) * 10; }");
+        $before = self::opcodesOf($caller);
+        (new Inliner())->inline(new ReflectionFunction($caller));
+        $this->assertSame(30, $caller(2));
+
+        (new ReflectionFunction($helper))->redefine(fn($a) => $a - 1);
+        $this->assertSame($before, self::opcodesOf($caller));
+        $this->assertFalse(Inliner::hasInlinedCalls(new ReflectionFunction($caller)));
+        $this->assertSame(10, $caller(2), 'The caller calls the new body');
+    }
+
+    #[RunInSeparateProcess]
+    public function testRedefineIsRolledBackWhileAnInlinedCallerRuns(): void
+    {
+        $helper = self::createFunction('($a) { return $a + 1; }');
+        $caller = self::createFunction("(\$a, \$during) { \$b = {$helper}(\$a); \$during(); return \$b * 10; }");
+        (new Inliner())->inline(new ReflectionFunction($caller));
+
+        $refused = null;
+        $this->assertSame(30, $caller(2, static function () use ($helper, &$refused): void {
+            try {
+                (new ReflectionFunction($helper))->redefine(fn($a) => $a - 1);
+            } catch (OpArrayRewriteException $e) {
+                $refused = $e;
+            }
+        }));
+        $this->assertInstanceOf(OpArrayRewriteException::class, $refused);
+        $this->assertSame(3, $helper(2), 'The staged swap was rolled back');
+        $this->assertTrue(Inliner::hasInlinedCalls(new ReflectionFunction($caller)));
+    }
+
+    #[RunInSeparateProcess]
+    public function testBatchReplacingCallerAndCalleeKeepsBothNewBodies(): void
+    {
+        $helper = self::createFunction('($a) { return $a + 1; }');
+        $caller = self::createFunction("(\$a) { return {$helper}(\$a) * 10; }");
+        (new Inliner())->inline(new ReflectionFunction($caller));
+
+        (new RedefinitionBatch())
+            ->addFunction($caller, fn($a) => $a * 100)
+            ->addFunction($helper, fn($a) => $a - 1)
+            ->commit();
+        $this->assertSame(200, $caller(2), 'The inlined layout is not restored over the new caller body');
+        $this->assertSame(1, $helper(2));
+        $this->assertFalse(Inliner::hasInlinedCalls(new ReflectionFunction($caller)));
+    }
+
+    #[RunInSeparateProcess]
+    public function testCalleesWithCallsAreRejected(): void
+    {
+        $leaf   = self::createFunction('($a) { return $a; }');
+        $helper = self::createFunction("(\$a) { return {$leaf}(\$a) . '!'; }");
+        $caller = self::createFunction("(\$a) { return {$helper}(\$a); }");
+
+        $report = (new Inliner())->inline(new ReflectionFunction($caller));
+        $this->assertFalse($report->isChanged());
+        $this->assertArrayHasKey($helper, $report->rejectedCallees);
+        $this->assertSame('x!', $caller('x'));
+    }
+
+    #[RunInSeparateProcess]
+    public function testCallersOfTheGrownFunctionReserveTheLargerFrame(): void
+    {
+        $helper = self::createFunction('($a) { $b = $a * 3; return $b - $a; }');
+        $caller = self::createFunction("(\$a) { return {$helper}(\$a) + {$helper}(\$a + 1); }");
+        $outer  = self::createFunction("(\$a) { \$x = {$caller}(\$a); \$y = {$caller}(\$x); return [\$x, \$y]; }");
+        $this->assertSame([6, 26], $outer(1));
+
+        $report = (new Inliner())->inline(new ReflectionFunction($caller));
+        $this->assertGreaterThan(0, $report->addedFrameSlots);
+        $staticCalls = array_count_values(self::opcodesOf($outer))[OpCode::INIT_FCALL] ?? 0;
+        $this->assertGreaterThanOrEqual($staticCalls, $report->resizedCallSites);
+
+        $this->assertSame([6, 26], $outer(1), 'Nested frames do not overlap');
+        $this->assertSame([6, 26], $outer(1));
+    }
+
+    public function testInternalFunctionsAreRefused(): void
+    {
+        $this->expectException(OpArrayRewriteException::class);
+        (new Inliner())->inline(new ReflectionFunction('strlen'));
+    }
+
+    /**
+     * @return list<int>
+     */
+    private static function opcodesOf(string $name): array
+    {
+        $opcodes = [];
+        foreach ((new ReflectionFunction($name))->getOpCodes() as $opLine) {
+            $opcodes[] = $opLine->getCode();
+        }
+
+        return $opcodes;
+    }
+
+    private static function createFunction(string $signatureAndBody): string
+    {
+        $name = str_replace('.', '_', uniqid('zengine_inliner_', true));
+        eval("function {$name}{$signatureAndBody}");
+
+        return $name;
+    }
+}
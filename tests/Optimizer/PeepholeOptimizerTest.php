@@ -0,0 +1,211 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Optimizer;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\Attributes\RunInSeparateProcess;
+use PHPUnit\Framework\TestCase;
+use ZEngine\Reflection\OpArrayRewriteException;
+use ZEngine\Reflection\ReflectionFunction;
+use ZEngine\System\OpCode;
+use ZEngine\Type\OpLine;
+
+/**
+ * Peephole passes over eval()'d code (never seen by opcache): same results, fewer oplines
+ */
+#[Group('internal')]
+final class PeepholeOptimizerTest extends TestCase
+{
+    #[RunInSeparateProcess]
+    public function testJumpsOnLiteralsAreResolvedAndCompacted(): void
+    {
+        $name = self::createFunction('($a) { if (true) { return $a + 1; } while (false) { $a--; } return 0; }');
+        $this->assertSame(3, $name(2));
+
+        $report = $this->optimizeOrSkip($name);
+        $this->assertTrue($report->isChanged());
+        $this->assertGreaterThanOrEqual(1, $report->threadedJumps);
+        $this->assertLessThan($report->oplinesBefore, $report->oplinesAfter);
+
+        $opcodes = [];
+        foreach ((new ReflectionFunction($name))->getOpCodes() as $opLine) {
+            $opcodes[] = $opLine->getCode();
+        }
+        $this->assertCount($report->oplinesAfter, $opcodes);
+        $this->assertNotContains(OpCode::JMPZ, $opcodes);
+        $this->assertNotContains(OpCode::NOP, $opcodes);
+        $this->assertSame(3, $name(2), 'The optimized body computes the same result');
+        $this->assertSame(-4, $name(-5));
+    }
+
+    #[RunInSeparateProcess]
+    public function testStaticVariablesKeepTheirValuesAcrossTheSwap(): void
+    {
+        $name = self::createFunction('() { static $calls = 0; if (true) { return ++$calls; } return -1; }');
+        $this->assertSame(1, $name());
+        $this->assertSame(2, $name());
+
+        $this->assertTrue($this->optimizeOrSkip($name)->isChanged());
+        $this->assertSame(3, $name());
+    }
+
+    #[RunInSeparateProcess]
+    public function testOptimizedBodyIsStableUnderASecondRun(): void
+    {
+        $name = self::createFunction('($a) { if (false) { return 1; } return $a * 2; }');
+        $this->optimizeOrSkip($name);
+
+        $report = (new PeepholeOptimizer())->optimize(new ReflectionFunction($name));
+        $this->assertFalse($report->isChanged());
+        $this->assertSame($report->oplinesBefore, $report->oplinesAfter);
+        $this->assertSame(8, $name(4));
+    }
+
+    /**
+     * The compiler folds `2 * 3` by itself, so the literal product is spelled into the body
+     */
+    #[RunInSeparateProcess]
+    public function testLiteralProductIsFoldedIntoASingleAdd(): void
+    {
+        $name     = self::createFunction('($a) { return $a * 3 + $a; }');
+        $function = new ReflectionFunction($name);
+        $body     = OpArrayBody::fromFunction($function);
+        $multiply = self::findInstruction($body, OpCode::MUL);
+        [$multiply->op1Type, $multiply->op1] = [OpLine::IS_CONST, $body->addLiteral(2)];
+
+        $report = (new PeepholeOptimizer())->optimizeBody($body);
+        $this->assertSame(1, $report->foldedConstants);
+        $this->installOrSkip($body, $function);
+
+        $opcodes = self::opcodesOf($name);
+        $this->assertNotContains(OpCode::MUL, $opcodes);
+        $this->assertSame(1, \count(array_keys($opcodes, OpCode::ADD, true)));
+        $this->assertSame(10, $name(4), 'return 2 * 3 + $a');
+        $this->assertSame(5, $name(-1));
+    }
+
+    /**
+     * As above, `1 < 2` only survives compilation when spelled into the body
+     */
+    #[RunInSeparateProcess]
+    public function testFoldedSmartBranchLosesItsJump(): void
+    {
+        $name       = self::createFunction('($a) { if ($a < 2) { return 1; } return 0; }');
+        $function   = new ReflectionFunction($name);
+        $body       = OpArrayBody::fromFunction($function);
+        $comparison = self::findInstruction($body, OpCode::IS_SMALLER);
+        [$comparison->op1Type, $comparison->op1] = [OpLine::IS_CONST, $body->addLiteral(1)];
+
+        $report = (new PeepholeOptimizer())->optimizeBody($body);
+        $this->assertGreaterThanOrEqual(1, $report->foldedConstants);
+        $this->assertGreaterThanOrEqual(1, $report->threadedJumps);
+        $this->installOrSkip($body, $function);
+
+        $opcodes = self::opcodesOf($name);
+        $this->assertNotContains(OpCode::IS_SMALLER, $opcodes);
+        $this->assertNotContains(OpCode::JMPZ, $opcodes);
+        $this->assertSame(1, $name(5), 'if (1 < 2) { return 1; }');
+        $this->assertSame(1, $name(0));
+    }
+
+    #[RunInSeparateProcess]
+    public function testUnreadBooleanCastIsDroppedWhileAReadOneIsKept(): void
+    {
+        $name = self::createFunction('($a) { (bool) ($a + 1); $b = (bool) ($a - 1); return $b; }');
+        $this->assertFalse($name(1));
+        $this->assertSame(2, \count(array_keys(self::opcodesOf($name), OpCode::BOOL, true)));
+
+        $report = $this->optimizeOrSkip($name);
+        $this->assertGreaterThanOrEqual(1, $report->eliminatedStores);
+
+        $opcodes = self::opcodesOf($name);
+        $this->assertSame(1, \count(array_keys($opcodes, OpCode::BOOL, true)));
+        $this->assertContains(OpCode::FREE, $opcodes, 'The sum feeding the dropped cast is still released');
+        $this->assertFalse($name(1));
+        $this->assertTrue($name(2));
+    }
+
+    #[RunInSeparateProcess]
+    public function testGeneratorsAreRefused(): void
+    {
+        $name = self::createFunction('() { if (true) { yield 1; } }');
+        $this->expectException(OpArrayRewriteException::class);
+        (new PeepholeOptimizer())->optimize(new ReflectionFunction($name));
+    }
+
+    public function testInternalFunctionsAreRefused(): void
+    {
+        $this->expectException(OpArrayRewriteException::class);
+        (new PeepholeOptimizer())->optimize(new ReflectionFunction('strlen'));
+    }
+
+    /**
+     * Engine definitions generated before zend_vm_set_opcode_handler was exported cannot
+     * bake handlers for reshaped instructions
+     */
+    private function optimizeOrSkip(string $name): OptimizationReport
+    {
+        try {
+            return (new PeepholeOptimizer())->optimize(new ReflectionFunction($name));
+        } catch (\RuntimeException $e) {
+            if (!$e->getPrevious() instanceof \FFI\Exception) {
+                throw $e;
+            }
+            $this->markTestSkipped($e->getMessage());
+        }
+    }
+
+    private function installOrSkip(OpArrayBody $body, ReflectionFunction $function): void
+    {
+        try {
+            $body->install($function);
+        } catch (\RuntimeException $e) {
+            if (!$e->getPrevious() instanceof \FFI\Exception) {
+                throw $e;
+            }
+            $this->markTestSkipped($e->getMessage());
+        }
+    }
+
+    private static function findInstruction(OpArrayBody $body, int $opcode): Instruction
+    {
+        foreach ($body->instructions as $instruction) {
+            if ($instruction->opcode === $opcode) {
+                return $instruction;
+            }
+        }
+        self::fail('No ' . OpCode::name($opcode) . ' in the compiled body');
+    }
+
+    /**
+     * @return int[]
+     */
+    private static function opcodesOf(string $name): array
+    {
+        $opcodes = [];
+        foreach ((new ReflectionFunction($name))->getOpCodes() as $opLine) {
+            $opcodes[] = $opLine->getCode();
+        }
+
+        return $opcodes;
+    }
+
+    private static function createFunction(string $signatureAndBody): string
+    {
+        $name = str_replace('.', '_', uniqid('zengine_peephole_', true));
+        eval("function {$name}{$signatureAndBody}");
+
+        return $name;
+    }
+}
@@ -0,0 +1,86 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Performance;
+
+use FFI;
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\TestCase;
+use ZEngine\Core;
+use ZEngine\Generated\zval;
+
+/**
+ * Measures the cast throughput of the type-resolution cache
+ *
+ * The "uncached" series replays what every Core::cast() did before the cache, on the engine
+ * binding itself: the array-decay probe plus the same zval * cast with its target type handed
+ * over as a string, which runs the FFI C declaration parser on each call. "cast" is the
+ * cached, still probing entry point and "castPointer" the cached, non-probing one used by the
+ * frame and opline accessors. The test lives in the excluded `performance` group and is not
+ * run by the default suite.
+ */
+#[Group('performance')]
+final class CoreCastBenchmarkTest extends TestCase
+{
+    private const int ITERATIONS = 500_000;
+
+    public function testCachedCastsOutrunTheParsingProbe(): void
+    {
+        $container = Core::new(zval::class);
+        $pointer   = Core::addr($container);
+        /** @var FFI $engine */
+        $engine = (new \ReflectionProperty(Core::class, 'engine'))->getValue();
+
+        $uncached = $this->time(static function () use ($pointer, $engine): void {
+            for ($i = 0; $i < self::ITERATIONS; $i++) {
+                try {
+                    // @phpstan-ignore function.resultUnused (array-decay probe, the throw is the result)
+                    \count($pointer);
+                } catch (FFI\Exception | \TypeError) {
+                }
+                $engine->cast('zval *', $pointer);
+            }
+        });
+        $cast = $this->time(static function () use ($pointer): void {
+            for ($i = 0; $i < self::ITERATIONS; $i++) {
+                Core::cast(zval::class, $pointer);
+            }
+        });
+        $castPointer = $this->time(static function () use ($pointer): void {
+            for ($i = 0; $i < self::ITERATIONS; $i++) {
+                Core::castPointer(zval::class, $pointer);
+            }
+        });
+
+        fwrite(STDERR, sprintf(
+            "\n[core-cast] uncached=%.0f/s cast=%.0f/s castPointer=%.0f/s\n",
+            self::ITERATIONS / $uncached,
+            self::ITERATIONS / $cast,
+            self::ITERATIONS / $castPointer,
+        ));
+
+        // Same probe, same target type: the only difference is the parse the cache saves
+        $this->assertLessThan($uncached, $cast, 'The type cache should outrun parsing the type on every cast');
+        // Dropping the probe is the larger win - a thrown and caught exception per call
+        $this->assertLessThan($cast, $castPointer, 'castPointer() should outrun the probing cast()');
+        $this->assertLessThan($uncached, $castPointer, 'A cached non-probing cast should outrun the parsing probe');
+    }
+
+    private function time(callable $work): float
+    {
+        $start = hrtime(true);
+        $work();
+
+        return (hrtime(true) - $start) / 1e9;
+    }
+}
@@ -0,0 +1,104 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Performance;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\TestCase;
+use ZEngine\Core;
+use ZEngine\Reflection\ReflectionValue;
+use ZEngine\System\ExecutionData;
+use ZEngine\System\OpCode;
+
+/**
+ * Measures opcode hook hits per second with and without per-hit wrapper allocation
+ *
+ * The "allocating" series replays what every hit did before the flyweight: a fresh
+ * ExecutionData (cloned from the rebound one, which costs the same object allocation),
+ * then an OpLine and a ReflectionValue to read the first operand. The "flyweight" series
+ * reads the same operand from the rebound wrapper through the raw accessors. Both run the
+ * same libffi crossing, so the difference is the wrapper cost alone. The test lives in the
+ * excluded `performance` group and is not run by the default suite.
+ */
+#[Group('performance')]
+final class ExecutionDataFlyweightBenchmarkTest extends TestCase
+{
+    private const int ITERATIONS = 100_000;
+
+    public function testReboundScopeOutrunsAllocatingScope(): void
+    {
+        $allocating = $this->measure(static function (ExecutionData $scope): int {
+            $value = null;
+            (clone $scope)->getOpline()->getOp1()?->getNativeValue($value);
+
+            return Core::ZEND_USER_OPCODE_DISPATCH;
+        });
+        $flyweight = $this->measure(static function (ExecutionData $scope): int {
+            if ($scope->getOperandType(ExecutionData::OP1) === ReflectionValue::IS_LONG) {
+                $scope->getOperandLong(ExecutionData::OP1);
+            }
+
+            return Core::ZEND_USER_OPCODE_DISPATCH;
+        });
+
+        fwrite(STDERR, sprintf(
+            "\n[execution-data] allocating=%.0f hits/s flyweight=%.0f hits/s\n",
+            self::ITERATIONS / $allocating,
+            self::ITERATIONS / $flyweight,
+        ));
+
+        $this->assertLessThan($allocating, $flyweight, 'Raw reads from a rebound scope should outrun the wrapper chain');
+    }
+
+    /**
+     * Runs a fresh probe with the given ADD handler installed, returns the elapsed seconds
+     *
+     * The handler is resolved when the probe is compiled, so the probe is compiled under the
+     * hook; both series pay the same hit counter around their handler.
+     */
+    private function measure(\Closure $handler): float
+    {
+        $hits    = 0;
+        $counted = static function (ExecutionData $scope) use ($handler, &$hits): int {
+            $hits++;
+
+            return $handler($scope);
+        };
+
+        $hook = OpCode::setHandler(OpCode::ADD, $counted);
+        try {
+            $name = str_replace('.', '_', uniqid('zengine_flyweight_probe_', true));
+            eval("function {$name}(\$a, \$b) { return \$a + \$b; }");
+            assert(is_callable($name));
+
+            $elapsed = $this->time(static function () use ($name): void {
+                for ($i = 0; $i < self::ITERATIONS; $i++) {
+                    $name($i, 1);
+                }
+            });
+        } finally {
+            $hook->uninstall();
+        }
+        $this->assertGreaterThanOrEqual(self::ITERATIONS, $hits, 'Every probe call should go through the handler');
+
+        return $elapsed;
+    }
+
+    private function time(callable $work): float
+    {
+        $start = hrtime(true);
+        $work();
+
+        return (hrtime(true) - $start) / 1e9;
+    }
+}
@@ -0,0 +1,127 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Profiler;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\Attributes\RunInSeparateProcess;
+use PHPUnit\Framework\TestCase;
+use ZEngine\Reflection\OpArrayRewriteException;
+use ZEngine\Reflection\ReflectionFunction;
+
+/**
+ * Counters inserted into the bytecode: entry and back-edge counts, unchanged semantics
+ */
+#[Group('internal')]
+final class BytecodeCountersTest extends TestCase
+{
+    #[RunInSeparateProcess]
+    public function testEntryAndBackEdgeCountersSurviveJumpsAndExceptions(): void
+    {
+        $name = self::createLoopingFunction();
+        $this->assertSame(47, $name(10, [1, -1, 2]));
+
+        $counters = new BytecodeCounters(8);
+        $labels   = $this->instrumentOrSkip($counters, new ReflectionFunction($name));
+        $this->assertCount(3, $labels, 'One entry counter and one per loop (for, foreach)');
+
+        for ($call = 0; $call < 3; $call++) {
+            $this->assertSame(47, $name(10, [1, -1, 2]), 'Probes do not change what the function computes');
+        }
+        $values = $counters->read();
+        $this->assertSame(3, $values[$name]);
+
+        $backEdges = array_values(array_diff_key($values, [$name => true]));
+        sort($backEdges);
+        // The for condition jumps back 10 times per call, foreach once per element
+        $this->assertSame([9, 30], $backEdges);
+
+        $counters->reset();
+        $this->assertSame([0, 0, 0], $counters->readSlots());
+        $this->assertSame(3, $name(3, []));
+        $this->assertSame(1, $counters->read()[$name]);
+    }
+
+    #[RunInSeparateProcess]
+    public function testBankRefusesSecondInstrumentationAndOverflow(): void
+    {
+        $name     = self::createLoopingFunction();
+        $counters = new BytecodeCounters(2);
+        try {
+            $counters->instrument(new ReflectionFunction($name));
+            $this->fail('Three counters do not fit a bank of two');
+        } catch (ProfilerException $e) {
+            $this->assertStringContainsString('3 more counters requested', $e->getMessage());
+        }
+        $this->assertSame(47, $name(10, [1, -1, 2]), 'A refused instrumentation leaves the body untouched');
+
+        $this->instrumentOrSkip($counters, new ReflectionFunction($name), backEdges: false);
+        $this->expectException(ProfilerException::class);
+        $counters->instrument(new ReflectionFunction($name), backEdges: false);
+    }
+
+    public function testInternalFunctionsCannotBeRewritten(): void
+    {
+        $this->expectException(OpArrayRewriteException::class);
+        (new BytecodeCounters(1))->instrument(new ReflectionFunction('strlen'));
+    }
+
+    /**
+     * Engine definitions generated before zend_vm_set_opcode_handler was exported cannot
+     * bake handlers for the inserted probes
+     *
+     * @return array<string, int>
+     */
+    private function instrumentOrSkip(
+        BytecodeCounters $counters,
+        ReflectionFunction $function,
+        bool $backEdges = true,
+    ): array {
+        try {
+            return $counters->instrument($function, backEdges: $backEdges);
+        } catch (\RuntimeException $e) {
+            if (!$e->getPrevious() instanceof \FFI\Exception) {
+                throw $e;
+            }
+            $this->markTestSkipped($e->getMessage());
+        }
+    }
+
+    private static function createLoopingFunction(): string
+    {
+        $name = str_replace('.', '_', uniqid('zengine_counted_', true));
+        eval(<<<PHP
+            function {$name}(int \$n, array \$items): int
+            {
+                \$sum = 0;
+                for (\$i = 0; \$i < \$n; \$i++) {
+                    \$sum += \$i;
+                }
+                foreach (\$items as \$item) {
+                    try {
+                        if (\$item < 0) {
+                            throw new \\RuntimeException('negative');
+                        }
+                        \$sum += \$item;
+                    } catch (\\RuntimeException) {
+                        \$sum -= 1;
+                    }
+                }
+
+                return \$sum;
+            }
+            PHP);
+
+        return $name;
+    }
+}
@@ -0,0 +1,100 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Profiler;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\Attributes\RunInSeparateProcess;
+use PHPUnit\Framework\TestCase;
+use ZEngine\Core;
+use ZEngine\System\Hook\OpCodeHook;
+use ZEngine\System\OpCode;
+
+/**
+ * Opcode and function census: counts, per-call averages, CSV export and the self-ending window
+ */
+#[Group('internal')]
+final class OpcodeCensusTest extends TestCase
+{
+    #[RunInSeparateProcess]
+    public function testCountsOpcodesAndCallsOfCodeCompiledDuringTheCensus(): void
+    {
+        $census = new OpcodeCensus([OpCode::ADD, OpCode::RETURN]);
+        $census->start();
+        try {
+            $name = str_replace('.', '_', uniqid('zengine_census_probe_', true));
+            eval("function {$name}(\$a, \$b) { return \$a + \$b + 1; }");
+            for ($call = 0; $call < 5; $call++) {
+                $name($call, 1);
+            }
+        } finally {
+            $census->stop();
+        }
+        $this->assertFalse($census->isRunning());
+
+        $result = $census->getResult();
+        // Two ADDs per call; the eval()'d top-level code returns once too
+        $this->assertSame(10, $result->opcodes[OpCode::ADD]);
+        $this->assertSame(['ADD' => 10], $result->getTopOpcodes(1));
+
+        [$hottest] = $result->getHotFunctions(1);
+        $this->assertSame([$name, 15, 5], [$hottest[0], $hottest[3], $hottest[4]]);
+        $this->assertGreaterThan(0.0, $result->getAverageOplinesPerCall());
+
+        $csv = $result->toCsv();
+        $this->assertStringStartsWith(implode(',', OpcodeCensusResult::CSV_HEADER) . "\n", $csv);
+        $this->assertStringContainsString("opcode,ADD,,,10,,\n", $csv);
+        $this->assertMatchesRegularExpression("/^function,{$name},.+,15,5,3\\.0$/m", $csv);
+    }
+
+    #[RunInSeparateProcess]
+    public function testWindowUninstallsEveryHookOnTheFirstHitPastTheDeadline(): void
+    {
+        $census = OpcodeCensus::run(0.000_001, [OpCode::ADD, OpCode::MUL]);
+        $this->assertNotNull(Core::topHook(OpCodeHook::fieldKeyFor(OpCode::MUL)));
+        usleep(1000);
+
+        $name = str_replace('.', '_', uniqid('zengine_census_window_', true));
+        eval("function {$name}(\$a) { return \$a + 1; }");
+        $this->assertSame(3, $name(2));
+
+        $this->assertFalse($census->isRunning());
+        $this->assertNull(Core::topHook(OpCodeHook::fieldKeyFor(OpCode::ADD)));
+        $this->assertNull(Core::topHook(OpCodeHook::fieldKeyFor(OpCode::MUL)));
+        $this->assertSame([], $census->getResult()->opcodes, 'The expiring hit is not counted');
+    }
+
+    #[RunInSeparateProcess]
+    public function testStackedHookKeepsTheHooksButEndsTheWindow(): void
+    {
+        $census  = OpcodeCensus::run(0.000_001, [OpCode::ADD, OpCode::MUL]);
+        $stacked = OpCode::setHandler(OpCode::MUL, static fn(): int => Core::ZEND_USER_OPCODE_DISPATCH);
+        usleep(1000);
+
+        $name = str_replace('.', '_', uniqid('zengine_census_stacked_', true));
+        eval("function {$name}(\$a) { return \$a + 1; }");
+        $this->assertSame(3, $name(2));
+
+        $this->assertTrue($census->isRunning(), 'The stacked hook blocks the uninstall');
+        $this->assertInstanceOf(\LogicException::class, $census->getStopFailure());
+        $duration = $census->getResult()->durationNanos;
+        $this->assertSame(5, $name(4));
+        $this->assertSame([], $census->getResult()->opcodes, 'Hits after the window are not counted');
+        $this->assertSame($duration, $census->getResult()->durationNanos, 'The window stays closed');
+
+        $stacked->uninstall();
+        $census->stop();
+        $this->assertFalse($census->isRunning());
+        $this->assertNull($census->getStopFailure());
+    }
+}
@@ -0,0 +1,129 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Profiler;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\TestCase;
+
+/**
+ * Named sample target: requests a sample from inside its own loop, so the interrupt lands
+ * on a back-edge of this very frame
+ */
+function profiledSpinner(SamplingProfiler $profiler, int $samples): int
+{
+    $spin = 0;
+    for ($index = 0; $index < $samples * 1000; $index++) {
+        $spin += $index;
+        if ($index % 1000 === 0) {
+            $profiler->requestSample();
+        }
+    }
+
+    return $spin;
+}
+
+/**
+ * Sampling through Executor::requestInterrupt() and the interrupt hook, and both exports
+ */
+#[Group('internal')]
+final class SamplingProfilerTest extends TestCase
+{
+    public function testRequestedSamplesAggregateIntoFoldedStacks(): void
+    {
+        $profiler = new SamplingProfiler();
+        $profiler->start(armTimer: false);
+        try {
+            profiledSpinner($profiler, 10);
+        } finally {
+            $profiler->stop();
+        }
+        $this->assertFalse($profiler->isRunning());
+
+        $profile = $profiler->getProfile();
+        $this->assertSame(0, $profiler->getFailedSampleCount());
+        $this->assertSame(10, $profile->getSampleCount());
+
+        $folded = $profile->toFoldedStacks();
+        $lines  = array_filter(explode("\n", $folded));
+        // Every sample caught the spinner as its leaf, so they fold into one line
+        $this->assertCount(1, $lines);
+        $this->assertMatchesRegularExpression(
+            '/;' . preg_quote(__CLASS__ . '::testRequestedSamplesAggregateIntoFoldedStacks', '/')
+            . ';' . preg_quote(__NAMESPACE__ . '\profiledSpinner', '/') . ' 10$/',
+            reset($lines),
+        );
+    }
+
+    public function testStacksDeeperThanTheLimitAreTruncated(): void
+    {
+        $profiler = new SamplingProfiler(maxDepth: 2);
+        $profiler->start(armTimer: false);
+        try {
+            profiledSpinner($profiler, 3);
+        } finally {
+            $profiler->stop();
+        }
+
+        $profile = $profiler->getProfile();
+        $this->assertSame(3, $profile->truncatedSamples);
+        $this->assertStringStartsWith(
+            SamplingProfiler::TRUNCATED_FRAME . ';' . __CLASS__ . '::testStacksDeeperThanTheLimitAreTruncated;',
+            $profile->toFoldedStacks(),
+        );
+    }
+
+    public function testPprofExportCarriesTheSampledFunctions(): void
+    {
+        $profiler = new SamplingProfiler();
+        $profiler->start(armTimer: false);
+        try {
+            profiledSpinner($profiler, 2);
+        } finally {
+            $profiler->stop();
+        }
+
+        $pprof = $profiler->getProfile()->toPprof();
+        if (\function_exists('gzdecode')) {
+            $this->assertSame("\x1f\x8b", substr($pprof, 0, 2), 'pprof profiles are gzip-compressed');
+            $pprof = (string) gzdecode($pprof);
+        }
+        // Profile.sample_type (field 1, length-delimited) opens the message
+        $this->assertSame("\x0a", $pprof[0]);
+        $this->assertStringContainsString(__NAMESPACE__ . '\profiledSpinner', $pprof);
+        $this->assertStringContainsString('nanoseconds', $pprof);
+    }
+
+    public function testIntervalTimerDeliversSamples(): void
+    {
+        if (!IntervalTimer::isAvailable()) {
+            $this->markTestSkipped('The SIGPROF interval timer needs ext-pcntl on a POSIX platform');
+        }
+
+        $profiler = new SamplingProfiler(intervalMicroseconds: 1000);
+        $profiler->start();
+        try {
+            // ~50ms of CPU time: the timer only counts time the process spends on the CPU
+            $deadline = hrtime(true) + 50_000_000;
+            $spin     = 0;
+            while (hrtime(true) < $deadline) {
+                $spin++;
+            }
+        } finally {
+            $profiler->stop();
+        }
+
+        $this->assertGreaterThan(0, $profiler->getProfile()->getSampleCount());
+        $this->assertSame(0, $profiler->getFailedSampleCount());
+    }
+}
@@ -0,0 +1,144 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Reflection;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\Attributes\RunInSeparateProcess;
+use PHPUnit\Framework\TestCase;
+use ZEngine\ClassExtension\Hook\CompareValuesHook;
+use ZEngine\ClassExtension\Hook\CountElementsHook;
+use ZEngine\ClassExtension\Hook\DoOperationHook;
+use ZEngine\ClassExtension\Hook\GetPropertiesForHook;
+
+/**
+ * Classes sharing the multiplexed handlers block: per-class dispatch, O(1) detach, mode guards
+ */
+#[Group('internal')]
+final class ReflectionClassMultiplexedHandlersTest extends TestCase
+{
+    #[RunInSeparateProcess]
+    public function testSharedTrampolineDispatchesPerClass(): void
+    {
+        [$first, $firstClass]   = self::createMultiplexedClass();
+        [$second, $secondClass] = self::createMultiplexedClass();
+        $this->assertTrue($firstClass->isUsingMultiplexedObjectHandlers());
+
+        $firstHook = $firstClass->setDoOperationHandler(fn(DoOperationHook $hook): string => 'first');
+        $secondClass->setDoOperationHandler(fn(DoOperationHook $hook): string => 'second');
+
+        $this->assertSame('first', $first + 1);
+        $this->assertSame('second', $second * 2);
+        $this->assertSame('second', 1 + $second, 'The object operand is resolved when it comes second');
+        $this->assertSame('first', $first - $second, 'The first object operand is the one dispatched on');
+
+        // Detaching one class leaves the shared trampoline serving the other
+        $firstHook->uninstall();
+        $this->assertSame('second', $second + 1);
+        try {
+            $result = $first + 1;
+            $this->fail('A class without a route falls back to the empty standard handler');
+        } catch (\TypeError) {
+            $this->addToAssertionCount(1);
+        }
+        $firstHook->install();
+        $this->assertSame('first', $first + 1);
+    }
+
+    #[RunInSeparateProcess]
+    public function testUnroutedClassKeepsStandardComparison(): void
+    {
+        [$first, $firstClass] = self::createMultiplexedClass();
+        [$second]             = self::createMultiplexedClass();
+        [$third]              = self::createMultiplexedClass();
+        $firstClass->setCompareValuesHandler(fn(CompareValuesHook $hook): int => 0);
+
+        $this->assertTrue($first == $second, 'The class of op1 compares everything as equal');
+        $this->assertTrue($second == $first, 'An op1 without a compare route does not hide the routed op2');
+        $this->assertFalse($second == $third, 'Without any route zend_std_compare_objects decides');
+    }
+
+    #[RunInSeparateProcess]
+    public function testRoutedSecondOperandIsDispatchedAfterAnUnroutedFirst(): void
+    {
+        [$plain]                = self::createMultiplexedClass();
+        [$hooked, $hookedClass] = self::createMultiplexedClass();
+        $hookedClass->setDoOperationHandler(fn(DoOperationHook $hook): string => 'hooked');
+
+        $this->assertSame('hooked', $plain + $hooked);
+        $this->assertSame('hooked', $hooked + $plain);
+
+        $this->expectException(\TypeError::class);
+        $result = $plain + $plain;
+    }
+
+    #[RunInSeparateProcess]
+    public function testUnroutedCallsOfEmptyFieldsKeepTheEngineDefaults(): void
+    {
+        $body = 'public int $x = 1; public function count(): int { return 3; }';
+
+        [$hooked, $hookedClass] = self::createMultiplexedClass($body, \Countable::class);
+        [$plain]                = self::createMultiplexedClass($body, \Countable::class);
+        $hookedClass->setGetPropertiesForHandler(fn(GetPropertiesForHook $hook): array => ['hooked' => true]);
+        $hookedClass->setCountElementsHandler(fn(CountElementsHook $hook): int => 42);
+
+        $this->assertSame(['hooked' => true], (array) $hooked);
+        $this->assertSame(['x' => 1], (array) $plain, 'get_properties_for falls back to zend_std_get_properties_for');
+        $this->assertCount(42, $hooked);
+        $this->assertCount(3, $plain, 'count_elements falls back to Countable::count()');
+    }
+
+    #[RunInSeparateProcess]
+    public function testModeGuards(): void
+    {
+        [, $class] = self::createMultiplexedClass();
+        $class->setDoOperationHandler(fn(DoOperationHook $hook): int => 1);
+        try {
+            $class->setDoOperationHandler(fn(DoOperationHook $hook): int => 2);
+            $this->fail('A class can only have one route per multiplexed field');
+        } catch (\LogicException) {
+            $this->addToAssertionCount(1);
+        }
+
+        $name = self::declareClass();
+        $own  = new ReflectionClass($name);
+        $own->setCreateObjectHandler((new \ReflectionMethod($name, '__init'))->getClosure());
+        $this->expectException(\LogicException::class);
+        $own->useMultiplexedObjectHandlers();
+    }
+
+    /**
+     * @return array{object, ReflectionClass}
+     */
+    private static function createMultiplexedClass(string $body = '', ?string $interface = null): array
+    {
+        $name  = self::declareClass($body, $interface);
+        $class = new ReflectionClass($name);
+        $class->useMultiplexedObjectHandlers();
+        $class->setCreateObjectHandler((new \ReflectionMethod($name, '__init'))->getClosure());
+
+        return [new $name(), $class];
+    }
+
+    /**
+     * @return class-string
+     */
+    private static function declareClass(string $body = '', ?string $interface = null): string
+    {
+        $name       = str_replace('.', '_', uniqid('ZEngineMultiplexedProbe_', true));
+        $implements = $interface !== null ? " implements \\{$interface}" : '';
+        eval("final class {$name}{$implements} { use \\ZEngine\\ClassExtension\\ObjectCreateTrait; {$body} }");
+
+        return $name;
+    }
+}
@@ -0,0 +1,183 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Reflection;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\Attributes\RunInSeparateProcess;
+use PHPUnit\Framework\TestCase;
+use ZEngine\ClassExtension\Native\NativeStubs;
+use ZEngine\Core;
+use ZEngine\Type\ObjectEntry;
+
+/**
+ * Generated machine-code handlers: write-once/deny-all immutability, fixed count, no dynamic properties
+ */
+#[Group('internal')]
+final class ReflectionClassNativeStubsTest extends TestCase
+{
+    protected function setUp(): void
+    {
+        if (!NativeStubs::isAvailable()) {
+            $this->markTestSkipped('Native handler stubs are generated for linux-x64 NTS builds only');
+        }
+    }
+
+    #[RunInSeparateProcess]
+    public function testWriteOnceImmutability(): void
+    {
+        [$name, $class] = self::createHookedClass();
+        [$writeHook]    = $class->installNativeImmutability();
+        $this->assertTrue($writeHook->isInstalled());
+
+        $point = new $name(1, 2);
+        $this->assertSame(1, $point->x, 'The constructor initializes every property once');
+        $this->assertSame(2, $point->y);
+
+        foreach ([1, 2] as $attempt) {
+            try {
+                $point->x = 10 + $attempt;
+                $this->fail('An initialized property cannot be written again');
+            } catch (\Error $e) {
+                $this->assertSame('Cannot modify initialized property $x of an immutable object', $e->getMessage());
+            }
+        }
+        $this->assertSame(1, $point->x, 'A warm runtime cache does not bypass the stub');
+
+        $this->expectExceptionMessage('Cannot unset property $y of an immutable object');
+        unset($point->y);
+    }
+
+    #[RunInSeparateProcess]
+    public function testUninstallRestoresWritableObjects(): void
+    {
+        [$name, $class]          = self::createHookedClass();
+        [$writeHook, $unsetHook] = $class->installNativeImmutability(allowInitialization: false);
+
+        try {
+            new $name(1, 2);
+            $this->fail('Without initialization every write throws, the constructor included');
+        } catch (\Error $e) {
+            $this->assertSame('Cannot modify property $x of an immutable object', $e->getMessage());
+        }
+
+        $unsetHook->uninstall();
+        $writeHook->uninstall();
+        $point    = new $name(1, 2);
+        $point->x = 3;
+        $this->assertSame(3, $point->x);
+    }
+
+    #[RunInSeparateProcess]
+    public function testFixedCountAndNoDynamicProperties(): void
+    {
+        [$name, $class] = self::createHookedClass();
+        $class->installNativeCount(42);
+        $class->setNoDynamicProperties();
+
+        $point = new $name(1, 2);
+        $this->assertCount(42, $point, 'The stub answers before Countable::count() is consulted');
+
+        $this->expectException(\Error::class);
+        $point->z = 3;
+    }
+
+    #[RunInSeparateProcess]
+    public function testStubIsBuiltOnceSealedAndInstalledIntoTheHandlers(): void
+    {
+        $stubAddress = NativeStubs::fixedCount(7);
+        $this->assertSame($stubAddress, NativeStubs::fixedCount(7), 'A pattern is generated once per process');
+        $this->assertSame('r-xp', self::pagePermissions($stubAddress), 'The stub page is never left writable');
+
+        [$name, $class] = self::createHookedClass();
+        $hook           = $class->installNativeCount(7);
+        $this->assertSame($stubAddress, $hook->getStubAddress());
+
+        $point    = new $name(1, 2);
+        $handlers = ObjectEntry::weakFor($point)->getRawValue()->handlers;
+        $this->assertSame($stubAddress, Core::addressOf($handlers->count_elements));
+        $this->assertCount(7, $point);
+
+        $hook->uninstall();
+        $handler = $handlers->count_elements;
+        $this->assertTrue($handler === null || Core::addressOf($handler) !== $stubAddress);
+        $this->assertCount(0, $point, 'Countable::count() answers again');
+    }
+
+    #[RunInSeparateProcess]
+    public function testWritesCachedBeforeTheInstallReachTheStub(): void
+    {
+        [$name, $class] = self::createHookedClass();
+        $function       = str_replace('.', '_', uniqid('zengine_native_stub_write_', true));
+        eval("function {$function}(object \$point): void { \$point->x = 5; }");
+        $closure = static function (object $point): void {
+            $point->x = 6;
+        };
+
+        // Both call sites cache the property slot before any handler is installed
+        $point = new $name(1, 2);
+        $function($point);
+        $closure($point);
+        $this->assertSame(6, $point->x);
+
+        $class->installNativeImmutability();
+        foreach ([$function, $closure] as $writer) {
+            try {
+                $writer($point);
+                $this->fail('A warmed write must not skip the installed stub');
+            } catch (\Error $e) {
+                $this->assertSame('Cannot modify initialized property $x of an immutable object', $e->getMessage());
+            }
+        }
+        $this->assertSame(6, $point->x);
+    }
+
+    private static function pagePermissions(int $address): ?string
+    {
+        foreach (file('/proc/self/maps') ?: [] as $line) {
+            if (preg_match('/^([0-9a-f]+)-([0-9a-f]+) (\S+)/', $line, $match) !== 1) {
+                continue;
+            }
+            if ($address >= hexdec($match[1]) && $address < hexdec($match[2])) {
+                return $match[3];
+            }
+        }
+
+        return null;
+    }
+
+    /**
+     * @return array{class-string, ReflectionClass}
+     */
+    private static function createHookedClass(): array
+    {
+        $name = str_replace('.', '_', uniqid('ZEngineNativeStubProbe_', true));
+        eval(<<<PHP
+            final class {$name} implements \\Countable
+            {
+                use \\ZEngine\\ClassExtension\\ObjectCreateTrait;
+
+                public function __construct(public int \$x, public int \$y) {}
+
+                public function count(): int
+                {
+                    return 0;
+                }
+            }
+            PHP);
+        $class = new ReflectionClass($name);
+        $class->setCreateObjectHandler((new \ReflectionMethod($name, '__init'))->getClosure());
+
+        return [$name, $class];
+    }
+}
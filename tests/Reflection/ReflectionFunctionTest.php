@@ -154,4 +154,79 @@ class ReflectionFunctionTest extends TestCase
         // before touching any engine memory)
         ReflectionFunction::addFunction('strlen', fn(): int => 0);
     }
+
+    public function testAddFunctionsFromSourcePublishesTheWholeUnit(): void
+    {
+        $suffix = str_replace('.', '_', uniqid('', true));
+        $source = <<<PHP
+            namespace ZEngineGenerated{$suffix};
+
+            function first(\$x) { return \$x + 1; }
+            function &second(array &\$list) { return \$list; }
+            \$ignored = function () {};
+            class Holder { public function notGlobal() {} }
+            PHP;
+
+        $functions = ReflectionFunction::addFunctionsFromSource($source);
+
+        $namespace = "ZEngineGenerated{$suffix}\\";
+        $this->assertSame([$namespace . 'first', $namespace . 'second'], array_keys($functions));
+        $this->assertFalse($functions[$namespace . 'first']->isClosure());
+        // @phpstan-ignore callable.nonCallable (function is generated at runtime)
+        $this->assertSame(3, ($namespace . 'first')(2));
+    }
+
+    public function testAddFunctionsFromSourceSkipsAlternativeSyntaxBlocks(): void
+    {
+        $suffix = str_replace('.', '_', uniqid('', true));
+        $source = <<<PHP
+            namespace ZEngineGenerated{$suffix};
+
+            if (false):
+                function skipped() {}
+            elseif (\strlen('x') === 0):
+                function skippedToo() {}
+            endif;
+            foreach ([] as \$item):
+                function neverDeclared() {}
+            endforeach;
+            do { } while (false);
+            function kept(\$x) { return \$x * 2; }
+            PHP;
+
+        $functions = ReflectionFunction::addFunctionsFromSource($source);
+
+        $namespace = "ZEngineGenerated{$suffix}\\";
+        $this->assertSame([$namespace . 'kept'], array_keys($functions));
+        $this->assertFalse(function_exists($namespace . 'skipped'));
+        // @phpstan-ignore callable.nonCallable (function is generated at runtime)
+        $this->assertSame(6, ($namespace . 'kept')(3));
+    }
+
+    public function testAddFunctionsFromSourceRejectsExistingNames(): void
+    {
+        $name = str_replace('.', '_', uniqid('zengine_bulk_', true));
+
+        $this->expectException(\ReflectionException::class);
+        $this->expectExceptionMessageMatches('/already exists in the engine/');
+
+        // Refused before compiling: a redeclaration is a fatal compile error, not an exception
+        ReflectionFunction::addFunctionsFromSource("function {$name}() {} function strlen() {}");
+    }
+
+    public function testAddFunctionsFromFileUsesTheIncludePath(): void
+    {
+        $name     = str_replace('.', '_', uniqid('zengine_bulk_', true));
+        $fileName = tempnam(sys_get_temp_dir(), 'zengine_bulk');
+        file_put_contents($fileName, "<?php\nfunction {$name}() { return 'from file'; }\n");
+        try {
+            $functions = ReflectionFunction::addFunctionsFromFile($fileName);
+        } finally {
+            unlink($fileName);
+        }
+
+        $this->assertSame([$name], array_keys($functions));
+        // @phpstan-ignore callable.nonCallable (function is generated at runtime)
+        $this->assertSame('from file', $name());
+    }
 }
@@ -0,0 +1,112 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Reflection;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\Attributes\RunInSeparateProcess;
+use PHPUnit\Framework\TestCase;
+use ZEngine\Core;
+
+/**
+ * Run-time cache slots of redefined eval()'d functions, before the new body first runs
+ */
+#[Group('internal')]
+final class RunTimeCacheWarmerTest extends TestCase
+{
+    #[RunInSeparateProcess]
+    public function testColdRedefineStartsWithAnEmptyCache(): void
+    {
+        [$target, $class, $helper] = self::createFixture();
+        $target(new $class());
+
+        (new ReflectionFunction($target))->redefine(self::createClosure($helper, 2));
+        $this->assertSame(0, self::countFilledSlots($target));
+        $this->assertSame(44, $target(new $class()));
+    }
+
+    #[RunInSeparateProcess]
+    public function testCopyCarriesResolvedSlotsOver(): void
+    {
+        [$target, $class, $helper] = self::createFixture();
+        $this->assertSame(43, $target(new $class()));
+        $warmed = self::countFilledSlots($target);
+        $this->assertGreaterThanOrEqual(3, $warmed, 'Function, class and property offset are cached');
+
+        (new ReflectionFunction($target))->redefine(self::createClosure($helper, 2), RunTimeCacheWarmup::Copy);
+        $this->assertSame($warmed, self::countFilledSlots($target));
+        $this->assertSame(44, $target(new $class()), 'The copied slots resolve the same function and property');
+    }
+
+    #[RunInSeparateProcess]
+    public function testPrefillResolvesDeclaredFunctionsWithoutAPreviousRun(): void
+    {
+        [$target, $class, $helper] = self::createFixture();
+        $helper(1);
+
+        (new ReflectionFunction($target))->redefine(self::createClosure($helper, 3), RunTimeCacheWarmup::Prefill);
+        $this->assertSame(1, self::countFilledSlots($target), 'Only the function slot is resolvable by name');
+        $this->assertSame(45, $target(new $class()));
+    }
+
+    #[RunInSeparateProcess]
+    public function testUncalledUserFunctionsAreLeftToTheEngine(): void
+    {
+        [$target, $class, $helper] = self::createFixture();
+
+        (new ReflectionFunction($target))->redefine(self::createClosure($helper, 3), RunTimeCacheWarmup::CopyAndPrefill);
+        $this->assertSame(0, self::countFilledSlots($target), 'The helper has no run-time cache of its own yet');
+        $this->assertSame(45, $target(new $class()));
+    }
+
+    /**
+     * @return array{string, string, string} Target function, class and helper function names
+     */
+    private static function createFixture(): array
+    {
+        $suffix = str_replace('.', '_', uniqid('', true));
+        $helper = "zengine_rtc_helper_{$suffix}";
+        $class  = "ZEngineRtcSubject{$suffix}";
+        $target = "zengine_rtc_target_{$suffix}";
+        eval("function {$helper}(\$value) { return \$value * 2; }");
+        eval("class {$class} { public \$value = 21; }");
+        eval("function {$target}(\$subject) { return {$helper}(\$subject->value) + 1; }");
+
+        return [$target, $class, $helper];
+    }
+
+    /**
+     * Compiles the replacement body in eval()'d code, where the helper resolves to INIT_FCALL
+     */
+    private static function createClosure(string $helper, int $increment): \Closure
+    {
+        return eval("return function (\$subject) { return {$helper}(\$subject->value) + {$increment}; };");
+    }
+
+    private static function countFilledSlots(string $function): int
+    {
+        $opArray = (new ReflectionFunction($function))->getOpArrayPointer();
+        $cache   = $opArray->run_time_cache__ptr;
+        if ($cache === null) {
+            return 0;
+        }
+        $filled = 0;
+        for ($slot = 0; $slot < intdiv($opArray->cache_size, Core::sizeOfType('void *')); $slot++) {
+            if ($cache[$slot] !== null) {
+                $filled++;
+            }
+        }
+
+        return $filled;
+    }
+}
@@ -0,0 +1,63 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\System;
+
+use ArrayObject;
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\TestCase;
+use ZEngine\Core;
+use ZEngine\Reflection\ReflectionFunction;
+use ZEngine\System\Hook\OpArrayGate;
+
+/**
+ * Rebinding baked handlers attaches an opcode hook to code compiled before it, and detaches it
+ */
+#[Group('internal')]
+final class HandlerRebindTest extends TestCase
+{
+    public function testRebindingAttachesAndDetachesAnAlreadyCompiledFunction(): void
+    {
+        $name = str_replace('.', '_', uniqid('zengine_rebind_probe_', true));
+        eval("function {$name}(\$a, \$b) {\nreturn \$a + \$b;\n}");
+        $function = new ReflectionFunction($name);
+
+        $log  = new ArrayObject();
+        $gate = new OpArrayGate(functionFilter: fn(ReflectionFunction $frame): bool => $frame->getName() === $name);
+        $hook = OpCode::setHandler(OpCode::ADD, function (ExecutionData $scope) use ($log): int {
+            $log->append($scope->getOpline()->getLine());
+
+            return Core::ZEND_USER_OPCODE_DISPATCH;
+        }, $gate);
+
+        try {
+            $this->assertSame(5, $name(2, 3));
+            $this->assertCount(0, $log, 'The handler baked before the hook was installed bypasses it');
+
+            try {
+                $this->assertSame(1, $function->rebindOpcodeHandlers(OpCode::ADD));
+            } catch (\RuntimeException $e) {
+                $this->markTestSkipped($e->getMessage());
+            }
+            $this->assertSame(5, $name(2, 3));
+            $this->assertSame([2], $log->getArrayCopy(), 'The rebound opline reaches the hook');
+        } finally {
+            $hook->uninstall();
+        }
+
+        $function->rebindOpcodeHandlers(OpCode::ADD);
+        $this->assertSame(9, $name(4, 5));
+        $this->assertCount(1, $log, 'Rebinding after uninstall restores the native handler');
+        $this->assertSame(0, $function->rebindOpcodeHandlers(OpCode::MUL), 'Other opcodes are left alone');
+    }
+}
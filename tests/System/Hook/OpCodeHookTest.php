@@ -19,6 +19,8 @@ use PHPUnit\Framework\Attributes\Group;
 use PHPUnit\Framework\Attributes\RunInSeparateProcess;
 use PHPUnit\Framework\TestCase;
 use ZEngine\Core;
+use ZEngine\Reflection\ReflectionFunction;
+use ZEngine\Reflection\ReflectionValue;
 use ZEngine\System\ExecutionData;
 use ZEngine\System\OpCode;
 use ZEngine\Type\OpLine;
@@ -312,6 +314,101 @@ final class OpCodeHookTest extends TestCase
         $this->assertSame([40], $log->getArrayCopy());
     }
 
+    /**
+     * The raw accessors read both operand kinds as plain scalars, and every hit is handed
+     * the same rebound wrapper
+     */
+    public function testHandlerReadsRawOperandsFromReboundScope(): void
+    {
+        $log    = new ArrayObject();
+        $scopes = new ArrayObject();
+        $hook   = OpCode::setHandler(OpCode::ADD, static function (ExecutionData $scope) use ($log, $scopes): int {
+            try {
+                $scopes->append(spl_object_id($scope));
+                $log->append([
+                    $scope->getOperandType(ExecutionData::OP1),
+                    $scope->getOperandLong(ExecutionData::OP1),
+                    $scope->getOperandDouble(ExecutionData::OP2),
+                ]);
+            } catch (\Throwable $error) {
+                $log->append($error::class . ': ' . $error->getMessage());
+            }
+
+            return Core::ZEND_USER_OPCODE_DISPATCH;
+        });
+
+        try {
+            $probe = self::compileProbe('$a + 0.5');
+            $this->assertSame(2.5, $probe(2, 0));
+            $this->assertSame(7.5, $probe(7, 0));
+        } finally {
+            $hook->uninstall();
+        }
+
+        $this->assertSame(
+            [[ReflectionValue::IS_LONG, 2, 0.5], [ReflectionValue::IS_LONG, 7, 0.5]],
+            $log->getArrayCopy(),
+        );
+        $this->assertCount(1, array_unique($scopes->getArrayCopy()), 'One wrapper is rebound per hit');
+    }
+
+    public function testGateDecidesOncePerOpArrayAndOncePerFile(): void
+    {
+        $log       = new ArrayObject();
+        $questions = new ArrayObject();
+        $gate      = new OpArrayGate(
+            function (string $fileName) use ($questions): bool {
+                $questions->append('file');
+
+                return str_contains($fileName, "eval()'d code");
+            },
+            function (ReflectionFunction $function) use ($questions): bool {
+                $questions->append('function');
+
+                return str_contains($function->getName(), 'zengine_opcode_probe_');
+            },
+        );
+        $hook = OpCode::setHandler(OpCode::ADD, function ($scope) use ($log): int {
+            $log->append('fired');
+
+            return Core::ZEND_USER_OPCODE_DISPATCH;
+        }, $gate);
+
+        try {
+            $this->assertSame($gate, $hook->getGate());
+            $probe = self::compileProbe('$a + $b');
+            for ($i = 0; $i < 3; $i++) {
+                $this->assertSame(5, $probe(2, 3));
+            }
+        } finally {
+            $hook->uninstall();
+        }
+
+        $this->assertSame(['fired', 'fired', 'fired'], $log->getArrayCopy());
+        $this->assertSame(['file', 'function'], $questions->getArrayCopy());
+        $this->assertSame(1, $gate->getDecisionCount());
+    }
+
+    public function testGateExcludedFramesNeverReachTheHandler(): void
+    {
+        $log  = new ArrayObject();
+        $hook = OpCode::setHandler(OpCode::ADD, function ($scope) use ($log): int {
+            $log->append('fired');
+
+            return Core::ZEND_USER_OPCODE_DISPATCH;
+        }, new OpArrayGate(static fn(string $fileName): bool => false));
+
+        try {
+            $probe = self::compileProbe('$a + $b');
+            $this->assertSame(5, $probe(2, 3));
+            $this->assertSame(7, $probe(3, 4));
+        } finally {
+            $hook->uninstall();
+        }
+
+        $this->assertSame([], $log->getArrayCopy());
+    }
+
     private static function compileProbe(string $expression): Closure
     {
         $name = str_replace('.', '_', uniqid('zengine_opcode_probe_', true));
@@ -0,0 +1,107 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\System;
+
+use ArrayObject;
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\TestCase;
+use ZEngine\Core;
+use ZEngine\Reflection\ReflectionFunction;
+
+/**
+ * Stripping EXT_STMT statements to NOP and back silences and revives a statement hook
+ */
+#[Group('internal')]
+final class StatementStripTest extends TestCase
+{
+    private int $previousOptions;
+
+    protected function setUp(): void
+    {
+        $this->previousOptions = Core::$compiler->getOptions();
+        Core::$compiler->setOptions($this->previousOptions | Compiler::COMPILE_EXTENDED_STMT);
+    }
+
+    protected function tearDown(): void
+    {
+        Core::$compiler->setOptions($this->previousOptions);
+    }
+
+    public function testStrippedStatementsNoLongerReachTheHook(): void
+    {
+        $name = self::compileProbe();
+        $log  = new ArrayObject();
+        $hook = OpCode::setHandler(OpCode::EXT_STMT, function (ExecutionData $scope) use ($log): int {
+            $log->append($scope->getOpline()->getLine());
+
+            return Core::ZEND_USER_OPCODE_DISPATCH;
+        });
+
+        try {
+            $function = new ReflectionFunction($name);
+            $this->assertSame(21, $name(7));
+            $hits = count($log);
+            $this->assertGreaterThan(0, $hits);
+
+            $stripped = $this->stripOrSkip($function);
+            $this->assertSame($hits, $stripped);
+            $this->assertSame(0, $function->stripStatementHooks(), 'Stripping twice is a no-op');
+            $this->assertSame(21, $name(7));
+            $this->assertCount($hits, $log, 'Stripped statements must not reach the hook');
+
+            $this->assertSame($stripped, $function->restoreStatementHooks());
+            $this->assertSame(21, $name(7));
+            $this->assertCount(2 * $hits, $log);
+        } finally {
+            $hook->uninstall();
+        }
+    }
+
+    public function testFileLevelStripCoversEveryFunctionOfTheFile(): void
+    {
+        $name     = self::compileProbe();
+        $function = new ReflectionFunction($name);
+        $fileName = $function->getFileName();
+        $this->assertNotNull($fileName);
+
+        $this->stripOrSkip($function);
+        $function->restoreStatementHooks();
+
+        $this->assertGreaterThan(0, OpCode::stripStatements($fileName));
+        $this->assertSame(0, $function->stripStatementHooks(), 'The file-level strip reached the function');
+        $this->assertGreaterThan(0, OpCode::restoreStatements($fileName));
+        $this->assertSame(21, $name(7));
+    }
+
+    /**
+     * Engine definitions generated before zend_vm_set_opcode_handler was exported cannot
+     * re-bake opline handlers
+     */
+    private function stripOrSkip(ReflectionFunction $function): int
+    {
+        try {
+            return $function->stripStatementHooks();
+        } catch (\RuntimeException $e) {
+            $this->markTestSkipped($e->getMessage());
+        }
+    }
+
+    private static function compileProbe(): string
+    {
+        $name = str_replace('.', '_', uniqid('zengine_strip_probe_', true));
+        eval("function {$name}(\$n) {\n\$double = \$n * 2;\n\$triple = \$n * 3;\nreturn \$triple;\n}");
+
+        return $name;
+    }
+}
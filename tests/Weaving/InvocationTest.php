@@ -0,0 +1,70 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Weaving;
+
+use PHPUnit\Framework\TestCase;
+
+/**
+ * The around chain of a woven call
+ */
+final class InvocationTest extends TestCase
+{
+    /** @var list<string> */
+    public static array $calls = [];
+
+    protected function setUp(): void
+    {
+        self::$calls = [];
+    }
+
+    public function testAroundAdvicesWrapTheOriginalOutermostFirst(): void
+    {
+        $invocation = new Invocation(
+            'App\Calculator',
+            'add',
+            [1, 2],
+            null,
+            static function (int $left, int $right): int {
+                self::$calls[] = "original({$left},{$right})";
+
+                return $left + $right;
+            },
+            [self::class . '::outer', self::class . '::inner'],
+        );
+
+        self::assertSame(40, $invocation->proceed());
+        self::assertSame(['outer', 'inner', 'original(10,10)'], self::$calls);
+        self::assertSame([10, 10], $invocation->getArguments());
+    }
+
+    public function testProceedNeedsTheOriginal(): void
+    {
+        $this->expectException(\LogicException::class);
+        (new Invocation('App\Calculator', 'add', []))->proceed();
+    }
+
+    public static function outer(Invocation $invocation): mixed
+    {
+        self::$calls[] = 'outer';
+
+        return $invocation->proceed(10, 10);
+    }
+
+    public static function inner(Invocation $invocation): mixed
+    {
+        self::$calls[] = 'inner';
+
+        return $invocation->proceed() * 2;
+    }
+}
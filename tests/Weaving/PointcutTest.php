@@ -0,0 +1,53 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Weaving;
+
+use PHPUnit\Framework\TestCase;
+
+/**
+ * Pointcut matching on names and attributes, and advice references
+ */
+final class PointcutTest extends TestCase
+{
+    public function testNamesAreMatchedWithWildcardsInAnyCase(): void
+    {
+        $pointcut = Pointcut::method('\App\Service\*', 'get*');
+
+        self::assertTrue($pointcut->matches('App\Service\UserRepository', 'getById', []));
+        self::assertTrue($pointcut->matches('app\service\billing\Invoices', 'GETALL', []));
+        self::assertFalse($pointcut->matches('App\Controller\UserController', 'getById', []));
+        self::assertFalse($pointcut->matches('App\Service\UserRepository', 'save', []));
+    }
+
+    public function testAttributesOfTheMethodOrItsClassAreMatched(): void
+    {
+        $annotated = Pointcut::annotatedWith('\App\Attribute\Cached');
+        self::assertTrue($annotated->matches('App\Any', 'run', ['App\Attribute\Logged', 'app\attribute\cached']));
+        self::assertFalse($annotated->matches('App\Any', 'run', ['App\Attribute\Logged']));
+
+        $narrowed = Pointcut::method('App\Service\*')->withAttribute('App\Attribute\Cached');
+        self::assertTrue($narrowed->matches('App\Service\Users', 'find', ['App\Attribute\Cached']));
+        self::assertFalse($narrowed->matches('App\Controller\Users', 'find', ['App\Attribute\Cached']));
+        self::assertFalse($narrowed->matches('App\Service\Users', 'find', []));
+    }
+
+    public function testAdviceMustNameAStaticMethod(): void
+    {
+        $advice = new Advice(AdviceKind::Before, Pointcut::method('*'), '\App\Aspect\Logging::before');
+        self::assertSame('App\Aspect\Logging::before', $advice->method);
+
+        $this->expectException(\InvalidArgumentException::class);
+        new Advice(AdviceKind::After, Pointcut::method('*'), 'strlen');
+    }
+}
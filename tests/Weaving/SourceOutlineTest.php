@@ -0,0 +1,118 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Weaving;
+
+use PHPUnit\Framework\TestCase;
+use ZEngine\Core;
+
+/**
+ * Source outlines and the advice donors generated from them
+ */
+final class SourceOutlineTest extends TestCase
+{
+    private const string SOURCE = <<<'PHP'
+        <?php
+        declare(strict_types=1);
+
+        namespace App\Service;
+
+        use App\Model\User;
+        use function sprintf;
+
+        $factory = function () use ($container) {};
+
+        final class Users extends Repository implements \Countable
+        {
+            use Cache;
+
+            public function find(int $id, ?User $default = new User(), #[\SensitiveParameter] string &$token = '', string ...$tags): ?User
+            {
+                return array_map(fn($x) => $x, []) ? null : $default;
+            }
+
+            abstract protected function purge(): void;
+
+            public static function &shared(): array {}
+
+            public function count(): int { return 0; }
+
+            public function merge(self $other, int $limit = self::LIMIT): ?self {}
+        }
+        PHP;
+
+    public function testDeclarationsAreOutlined(): void
+    {
+        $outline = SourceOutline::parse(self::SOURCE);
+        self::assertTrue($outline->strictTypes);
+        self::assertNull($outline->getClass('App\Service\Repository'));
+
+        $class = $outline->getClass('\app\service\users');
+        self::assertNotNull($class);
+        self::assertSame('App\Service', $class['namespace']);
+        self::assertSame(['use App\Model\User;', 'use function sprintf;'], $class['imports']);
+        self::assertSame('Repository', $class['parent']);
+        self::assertSame(['find', 'purge', 'shared', 'count', 'merge'], array_keys($class['methods']));
+
+        $find = $class['methods']['find'];
+        self::assertSame('?User', $find['returnType']);
+        self::assertStringStartsWith('(int $id, ?User $default = new User()', $find['signature']);
+        self::assertStringEndsWith('string ...$tags): ?User', $find['signature']);
+        self::assertSame(
+            [
+                ['name' => 'id', 'byReference' => false, 'variadic' => false],
+                ['name' => 'default', 'byReference' => false, 'variadic' => false],
+                ['name' => 'token', 'byReference' => true, 'variadic' => false],
+                ['name' => 'tags', 'byReference' => false, 'variadic' => true],
+            ],
+            $find['parameters'],
+        );
+        self::assertSame('void', $class['methods']['purge']['returnType']);
+
+        // A self type is bound to the compiled class, the donor gets the declaring class instead
+        $merge = $class['methods']['merge'];
+        self::assertSame('(\App\Service\Users $other, int $limit = self::LIMIT): ?\App\Service\Users', $merge['signature']);
+        self::assertSame('?\App\Service\Users', $merge['returnType']);
+    }
+
+    public function testDonorWrapsTheOriginalSignature(): void
+    {
+        $joinPoint = new JoinPoint('App\Service\Users', 'find', Core::ZEND_ACC_PUBLIC, ['App\Aspect::before'], ['App\Aspect::after'], ['App\Aspect::around']);
+        $source    = AdviceDonor::generate('/app/Users.php', SourceOutline::parse(self::SOURCE), [$joinPoint]);
+
+        self::assertStringContainsString("declare(strict_types=1);\n\nnamespace App\\Service {\nuse App\\Model\\User;\n", $source);
+        self::assertStringContainsString(
+            'abstract class ' . AdviceDonor::className('/app/Users.php', 'App\Service\Users') . " extends Repository\n",
+            $source,
+        );
+        self::assertStringContainsString('public function find(int $id, ?User $default = new User()', $source);
+        self::assertStringContainsString(
+            "new \\ZEngine\\Weaving\\Invocation('App\\\\Service\\\\Users', 'find', [\$id, \$default, &\$token, ...\$tags], \$this, "
+            . "self::__zengine_woven_find(...), ['App\\\\Aspect::around'])",
+            $source,
+        );
+        self::assertStringContainsString('\App\Aspect::before($zengineInvocation);', $source);
+        self::assertStringContainsString("\$zengineResult = \$zengineInvocation->proceed();\n        \\App\\Aspect::after(\$zengineInvocation, \$zengineResult);", $source);
+        self::assertStringContainsString('private function __zengine_woven_find(): void {}', $source);
+        // The generated donor is valid PHP (a ParseError fails the test)
+        self::assertNotEmpty(\PhpToken::tokenize($source, TOKEN_PARSE));
+    }
+
+    public function testMissingMethodsAreReported(): void
+    {
+        $joinPoint = new JoinPoint('App\Service\Users', 'delete', Core::ZEND_ACC_PUBLIC, ['App\Aspect::before'], [], []);
+
+        $this->expectException(WeavingException::class);
+        AdviceDonor::generate('/app/Users.php', SourceOutline::parse(self::SOURCE), [$joinPoint]);
+    }
+}
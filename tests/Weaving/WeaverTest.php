@@ -0,0 +1,135 @@
+<?php
+
+/**
+ * Z-Engine framework
+ *
+ * @copyright Copyright 2026, Lisachenko Alexander <lisachenko.it@gmail.com>
+ *
+ * This source file is subject to the license that is bundled
+ * with this source code in the file LICENSE.
+ *
+ */
+declare(strict_types=1);
+
+namespace ZEngine\Weaving;
+
+use PHPUnit\Framework\Attributes\Group;
+use PHPUnit\Framework\TestCase;
+use ZEngine\OpCache\BinaryCacheFile;
+use ZEngine\OpCache\FileCacheFixture;
+use ZEngine\OpCache\PayloadRelocator;
+
+/**
+ * Offline weaving: advices grafted into cached methods run from the file cache, and the
+ * binaries nothing was selected in stay as they were
+ */
+#[Group('opcache')]
+#[Group('opcache-relocator')]
+final class WeaverTest extends TestCase
+{
+    use FileCacheFixture;
+
+    protected function setUp(): void
+    {
+        if (!PayloadRelocator::isSupported()) {
+            self::markTestSkipped(
+                'The file-cache relocator supports 64-bit POSIX payloads only'
+                . ' (Windows opcache support is an intentional non-goal, issue #119)',
+            );
+        }
+    }
+
+    protected function tearDown(): void
+    {
+        self::removeCacheDir();
+    }
+
+    public function testAdvicesAreExecutedFromCache(): void
+    {
+        $fixture = self::wovenFixturePath();
+        $binPath = self::compileFixture($fixture);
+
+        $report = self::weaver()->weave(self::$cacheDir, [$fixture]);
+        self::assertTrue($report->isComplete(), implode("\n", $report->failed));
+        self::assertSame(
+            [$fixture => [
+                'ZEngineWovenFixture\Calculator::add',
+                'ZEngineWovenFixture\Calculator::scale',
+                'ZEngineWovenFixture\Calculator::plus',
+                'ZEngineWovenFixture\Calculator::sum',
+                'ZEngineWovenFixture\Calculator::increment',
+                'ZEngineWovenFixture\Calculator::__helper',
+            ]],
+            $report->woven,
+        );
+        self::assertSame(6, $report->countWovenJoinPoints());
+        self::assertSame(
+            [
+                'ZEngineWovenFixture\Calculator::__construct' => 'magic method',
+                'ZEngineWovenFixture\Calculator::__toString'  => 'magic method',
+            ],
+            $report->skipped,
+        );
+
+        $woven = BinaryCacheFile::read($binPath, $fixture);
+        self::assertTrue($woven->verifyChecksum());
+        $methods = $woven->getReflection()->getClass('ZEngineWovenFixture\Calculator')->getDeclaredMethods();
+        self::assertArrayHasKey('add', $methods);
+        self::assertArrayHasKey(AdviceDonor::aliasName('add'), $methods);
+        self::assertArrayNotHasKey(AdviceDonor::aliasName('untouched'), $methods);
+
+        self::assertSame('before:add(40,2)|after:42|result:42', self::runFromCache($fixture, 'ZEngineWovenFixture\Report::traced', self::$cacheDir));
+        self::assertSame('42', self::runFromCache($fixture, 'ZEngineWovenFixture\Report::scaled', self::$cacheDir));
+        self::assertSame('5', self::runFromCache($fixture, 'ZEngineWovenFixture\Calculator::untouched', self::$cacheDir));
+        // A self type of the wrapper is the target class, not the donor it was compiled in
+        self::assertSame('before:plus(calc(2))|result:calc(3)', self::runFromCache($fixture, 'ZEngineWovenFixture\Report::plussed', self::$cacheDir));
+        // Variadic and by-reference arguments are forwarded as passed, a void method has a null result
+        self::assertSame('before:sum(1,2,3)|result:6', self::runFromCache($fixture, 'ZEngineWovenFixture\Report::summed', self::$cacheDir));
+        self::assertSame('before:increment(4)|after:NULL|result:5', self::runFromCache($fixture, 'ZEngineWovenFixture\Report::incremented', self::$cacheDir));
+        self::assertSame('before:__helper()|result:7', self::runFromCache($fixture, 'ZEngineWovenFixture\Report::helped', self::$cacheDir));
+    }
+
+    public function testWovenMethodsAreNotWovenAgain(): void
+    {
+        $fixture = self::wovenFixturePath();
+        self::compileFixture($fixture);
+        self::weaver()->weave(self::$cacheDir, [$fixture]);
+
+        $report = self::weaver()->weave(self::$cacheDir, [$fixture]);
+        self::assertSame([], $report->woven);
+        self::assertSame('already woven', $report->skipped['ZEngineWovenFixture\Calculator::add'] ?? null);
+        self::assertSame('already woven', $report->skipped['ZEngineWovenFixture\Calculator::scale'] ?? null);
+        self::assertSame('before:add(40,2)|after:42|result:42', self::runFromCache($fixture, 'ZEngineWovenFixture\Report::traced', self::$cacheDir));
+    }
+
+    public function testUnselectedAndUncachedScriptsAreReported(): void
+    {
+        $binPath = self::compileFixture();
+        $bytes   = (string) file_get_contents($binPath);
+
+        $report = self::weaver()->weave(self::$cacheDir, [self::fixturePath(), self::wovenFixturePath()]);
+        self::assertSame([self::fixturePath()], $report->untouched);
+        self::assertSame([], $report->woven);
+        self::assertSame([self::wovenFixturePath()], array_keys($report->failed));
+        self::assertFalse($report->isComplete());
+        self::assertSame($bytes, (string) file_get_contents($binPath), 'A binary without selected methods is not rewritten');
+    }
+
+    private static function weaver(): Weaver
+    {
+        return (new Weaver(workers: 1))
+            ->before(Pointcut::annotatedWith('ZEngineWovenFixture\Traced'), 'ZEngineWovenFixture\Trace::before')
+            ->after(Pointcut::method('ZEngineWovenFixture\Calc*', 'add'), 'ZEngineWovenFixture\Trace::after')
+            ->after(Pointcut::method('ZEngineWovenFixture\Calculator', 'increment'), 'ZEngineWovenFixture\Trace::after')
+            ->before(Pointcut::method('ZEngineWovenFixture\Calculator', '__*'), 'ZEngineWovenFixture\Trace::before')
+            ->around(Pointcut::method('ZEngineWovenFixture\Calculator', 'scale'), 'ZEngineWovenFixture\Trace::doubling');
+    }
+
+    private static function wovenFixturePath(): string
+    {
+        $path = realpath(__DIR__ . '/fixtures/woven.php');
+        self::assertIsString($path);
+
+        return $path;
+    }
+}
@@ -0,0 +1,138 @@
+<?php
+
+/**
+ * Fixture compiled into the opcache file cache and woven by the Weaving tests: a class with
+ * selected and unselected methods, the attribute that selects one of them, and the aspect
+ * whose advices record each call. The cache-run child has no autoloader, so the runtime
+ * Invocation class is required directly.
+ */
+declare(strict_types=1);
+
+namespace ZEngineWovenFixture;
+
+use Attribute;
+use ZEngine\Weaving\Invocation;
+
+require_once dirname(__DIR__, 3) . '/src/Weaving/Invocation.php';
+
+#[Attribute(Attribute::TARGET_METHOD)]
+final class Traced {}
+
+final class Trace
+{
+    /** @var list<string> */
+    public static array $log = [];
+
+    public static function before(Invocation $invocation): void
+    {
+        self::$log[] = "before:{$invocation->methodName}(" . implode(',', $invocation->getArguments()) . ')';
+    }
+
+    public static function after(Invocation $invocation, mixed $result): void
+    {
+        self::$log[] = 'after:' . var_export($result, true);
+    }
+
+    public static function doubling(Invocation $invocation): mixed
+    {
+        return $invocation->proceed() * 2;
+    }
+}
+
+class Calculator
+{
+    public function __construct(private readonly int $base) {}
+
+    #[Traced]
+    public static function add(int $left, int $right = 2): int
+    {
+        return $left + $right;
+    }
+
+    public function scale(int $factor): int
+    {
+        return $this->base * $factor;
+    }
+
+    public static function untouched(): int
+    {
+        return 5;
+    }
+
+    #[Traced]
+    public function plus(self $other): self
+    {
+        return new self($this->base + $other->base);
+    }
+
+    #[Traced]
+    public static function sum(int ...$values): int
+    {
+        return array_sum($values);
+    }
+
+    #[Traced]
+    public static function increment(int &$counter): void
+    {
+        $counter++;
+    }
+
+    public static function __helper(): int
+    {
+        return 7;
+    }
+
+    public function __toString(): string
+    {
+        return "calc({$this->base})";
+    }
+}
+
+final class Report
+{
+    public static function traced(): string
+    {
+        $result       = Calculator::add(40);
+        Trace::$log[] = "result:{$result}";
+
+        return implode('|', Trace::$log);
+    }
+
+    public static function scaled(): string
+    {
+        return (string) (new Calculator(3))->scale(7);
+    }
+
+    public static function summed(): string
+    {
+        $total        = Calculator::sum(1, 2, 3);
+        Trace::$log[] = "result:{$total}";
+
+        return implode('|', Trace::$log);
+    }
+
+    public static function incremented(): string
+    {
+        $counter = 4;
+        Calculator::increment($counter);
+        Trace::$log[] = "result:{$counter}";
+
+        return implode('|', Trace::$log);
+    }
+
+    public static function helped(): string
+    {
+        $result       = Calculator::__helper();
+        Trace::$log[] = "result:{$result}";
+
+        return implode('|', Trace::$log);
+    }
+
+    public static function plussed(): string
+    {
+        $sum          = (new Calculator(1))->plus(new Calculator(2));
+        Trace::$log[] = "result:{$sum}";
+
+        return implode('|', Trace::$log);
+    }
+}
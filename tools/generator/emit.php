@@ -12,8 +12,9 @@
 declare(strict_types=1);
 
 /**
- * In-image generator entry point: produces engine.h, constants.php and
- * layouts.json for the PHP build that runs this script.
+ * In-image generator entry point: produces engine.h (plus its per-subsystem
+ * engine.<slice>.h split and slices.json), constants.php and layouts.json for
+ * the PHP build that runs this script.
  *
  * The script MUST run with the exact PHP build the artifacts are meant for
  * (normally inside the official docker image driven by generate.php):
@@ -150,7 +151,7 @@ foreach ([$out, $buildDir] as $directory) {
 
 echo '[generator] Target: PHP ' . PHP_VERSION . " ({$platformKey}), debug=" . (PHP_DEBUG ? 'yes' : 'no') . "\n";
 
-/** @var array{types: list<string>, functions: list<string>, variables: list<string>, defines: list<string>, enums: list<string>, opcode_header: string, layout_structs: list<string>, opaque?: list<string>, stub_platform_fields: array<string, list<string>>} $manifest */
+/** @var array{types: list<string>, functions: list<string>, variables: list<string>, defines: list<string>, enums: list<string>, opcode_header: string, layout_structs: list<string>, opaque?: list<string>, stub_platform_fields: array<string, list<string>>, base_slices: array<string, list<string>>, slices: array<string, list<string>>} $manifest */
 $manifest = require __DIR__ . '/symbols.php';
 
 // --- 1. Supplement: slice private structs out of php-src C files -----------
@@ -302,6 +303,39 @@ if ($emitHeader) {
         . $headerBody;
     file_put_contents($buildDir . '/engine.h', $header);
 
+    // Subsystem slices: the base slices concatenated in order are a complete
+    // header, every optional slice is a fragment Core::init() appends to them.
+    // No FFI_SCOPE here - preload always goes through the full engine.h.
+    // slices.json maps every slice to the layout structs it defines.
+    $baseSlices = $manifest['base_slices'];
+    $sliceNames = [];
+    foreach ($emitter->emitSlices($baseSlices, $manifest['slices']) as $slice => $sliceBody) {
+        $boundBefore = [];
+        foreach (array_keys($baseSlices) as $baseSlice) {
+            if ($baseSlice === $slice) {
+                break;
+            }
+            $boundBefore[] = "engine.{$baseSlice}.h";
+        }
+        file_put_contents(
+            $buildDir . "/engine.{$slice}.h",
+            "/*\n"
+            . " * Generated by tools/generator for PHP {$minor} ({$os}-{$arch}-{$ts}, {$debugFlag}) - DO NOT EDIT.\n"
+            . ($boundBefore === [] ? '' : " * Slice '{$slice}': only valid appended to " . implode(' + ', $boundBefore) . ".\n")
+            . " * Regenerate with `composer gen-headers`.\n"
+            . " */\n"
+            . $sliceBody,
+        );
+        $sliceNames[] = $slice;
+    }
+    file_put_contents(
+        $buildDir . '/slices.json',
+        json_encode(
+            $emitter->sliceRecords($manifest['layout_structs']),
+            JSON_PRETTY_PRINT | JSON_UNESCAPED_SLASHES | JSON_THROW_ON_ERROR,
+        ) . "\n",
+    );
+
     // The probe source is generated alongside the header (from the same AST) so
     // that a probe-only run on another build of the same PHP minor can reuse it.
     $opcodes     = ProbeGenerator::parseOpcodes($includeDir . '/' . $manifest['opcode_header']);
@@ -326,7 +360,7 @@ if ($emitHeader) {
     }
     $probe = new ProbeGenerator($manifest['defines'], $enumMembers, $opcodes, $layoutFields, $layoutIsUnion);
     file_put_contents($buildDir . '/probe.c', $probe->generateProbeSource($buildDir . '/supplement.h'));
-    echo '[generator] Emitted engine.h (' . strlen($header) . " bytes) and probe.c\n";
+    echo '[generator] Emitted engine.h (' . strlen($header) . ' bytes), slices ' . implode(', ', $sliceNames) . " and probe.c\n";
 
     // Analysis stub classes + PhpStorm meta, from the same AST the header was
     // sliced from. Transient per-target artifacts: generate.php publishes the
@@ -395,6 +429,10 @@ if ($emitHeader) {
 $artifacts = [];
 if ($emitHeader) {
     $artifacts[] = 'engine.h';
+    foreach ($sliceNames as $slice) {
+        $artifacts[] = "engine.{$slice}.h";
+    }
+    $artifacts[] = 'slices.json';
     $artifacts[] = 'probe.c';
     $artifacts[] = 'structs.php';
     $artifacts[] = 'phpstorm.meta.php';
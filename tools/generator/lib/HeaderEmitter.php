@@ -13,6 +13,7 @@ declare(strict_types=1);
 
 namespace ZEngine\Generator;
 
+use Closure;
 use RuntimeException;
 
 /**
@@ -48,11 +49,19 @@ final class HeaderEmitter
     /** @var array<string, true> */
     private array $visited = [];
 
+    /** @var array<string, true> record tags only ever named behind a pointer (pointer-aware mode) */
+    private array $declaredRecords = [];
+
+    /** @var array<string, list<array{int, int}>> source ranges each slice defines, set by emitSlices() */
+    private array $sliceRanges = [];
+
     /**
-     * @param list<string> $types     manifest type names
-     * @param list<string> $functions manifest function names
-     * @param list<string> $variables manifest variable names
-     * @param list<string> $opaque    type names force-degraded to opaque forward declarations
+     * @param list<string> $types        manifest type names
+     * @param list<string> $functions    manifest function names
+     * @param list<string> $variables    manifest variable names
+     * @param list<string> $opaque       type names force-degraded to opaque forward declarations
+     * @param bool         $pointerAware forward-declare the types only ever named behind a pointer
+     *                                   instead of defining them (slice closures, see emitSlices())
      */
     public function __construct(
         private readonly ClangAstIndex $index,
@@ -60,9 +69,212 @@ final class HeaderEmitter
         private readonly array $functions,
         private readonly array $variables,
         private readonly array $opaque = [],
+        private readonly bool $pointerAware = false,
     ) {}
 
     public function emit(): string
+    {
+        $collected = $this->collect();
+
+        return self::assemble($collected['declarations'], $collected['functions'], $collected['variables']);
+    }
+
+    /**
+     * Emits the manifest as composable slices instead of one monolithic header
+     *
+     * $layers are always bound, in order: each layer is what the closure of its own roots and
+     * the roots of the layers before it adds on top of those layers, and the last layer also
+     * takes every symbol no slice claims. The concatenated layers are a self-contained header.
+     * An optional slice of $slices is a fragment that only holds what the layers do not
+     * already declare - appended to them (alone or together with any other optional slices,
+     * in any order) it yields a header that parses exactly like the corresponding subset of
+     * engine.h.
+     *
+     * Slice closures are pointer-aware: a type that is only ever named behind a pointer gets a
+     * forward declaration, and its definition lands in the slice that uses it by value. That
+     * is what keeps zend_object (whose ce is a zend_class_entry *) out of the classes layer.
+     *
+     * A declaration needed by two or more optional slices is hoisted into the last layer, so
+     * composing several slices never declares the same type twice. The union of
+     * dependency-closed sets is dependency-closed, which keeps the layers self-contained after
+     * the hoist.
+     *
+     * @param array<string, list<string>> $layers always-bound slice name => manifest symbols it owns
+     * @param array<string, list<string>> $slices optional slice name => manifest symbols it owns
+     *
+     * @return array<string, string> every layer in order, then every optional slice in manifest order
+     */
+    public function emitSlices(array $layers, array $slices): array
+    {
+        if ($layers === []) {
+            throw new RuntimeException('At least one always-bound slice is required');
+        }
+        $owned = [];
+        foreach ([...$layers, ...$slices] as $slice => $symbols) {
+            if (isset($layers[$slice], $slices[$slice])) {
+                throw new RuntimeException("Slice '{$slice}' is declared both always-bound and optional");
+            }
+            foreach ($symbols as $symbol) {
+                if (isset($owned[$symbol])) {
+                    throw new RuntimeException("Symbol '{$symbol}' is claimed by slices '{$owned[$symbol]}' and '{$slice}'");
+                }
+                if (!in_array($symbol, $this->types, true)
+                    && !in_array($symbol, $this->functions, true)
+                    && !in_array($symbol, $this->variables, true)
+                ) {
+                    throw new RuntimeException("Slice '{$slice}' claims '{$symbol}', which is not a manifest symbol");
+                }
+                $owned[$symbol] = $slice;
+            }
+        }
+
+        // Each layer is resolved as the layers before it + its own roots; what that closure
+        // adds on top of the earlier layers is the layer's own part
+        $lastLayer = array_key_last($layers);
+        $bound     = [];
+        $base      = ['declarations' => [], 'functions' => [], 'variables' => []];
+        $parts     = [];
+        foreach (array_keys($layers) as $layer) {
+            $bound[$layer] = true;
+            $closure       = $this->sliceClosure(
+                static fn(string $symbol): bool => isset($bound[$owned[$symbol] ?? $lastLayer]),
+            );
+            $parts[$layer] = self::delta($closure, $base);
+            foreach ($parts[$layer] as $kind => $declarations) {
+                $base[$kind] += $declarations;
+            }
+        }
+
+        // Each optional slice is resolved as every layer + its own roots
+        $deltas = [];
+        $users  = [];
+        foreach (array_keys($slices) as $slice) {
+            $deltas[$slice] = self::delta(
+                $this->sliceClosure(
+                    static fn(string $symbol): bool => !isset($owned[$symbol]) || isset($layers[$owned[$symbol]])
+                        || $owned[$symbol] === $slice,
+                ),
+                $base,
+            );
+            foreach (array_keys($deltas[$slice]['declarations']) as $key) {
+                $users[$key][] = $slice;
+            }
+        }
+
+        foreach ($users as $key => $slicesUsing) {
+            if (count($slicesUsing) < 2) {
+                continue;
+            }
+            $parts[$lastLayer]['declarations'][$key] = $deltas[$slicesUsing[0]]['declarations'][$key];
+            $base['declarations'][$key]              = $deltas[$slicesUsing[0]]['declarations'][$key];
+            foreach ($slicesUsing as $slice) {
+                unset($deltas[$slice]['declarations'][$key]);
+            }
+        }
+        uasort($parts[$lastLayer]['declarations'], static fn(array $a, array $b): int => $a['offset'] <=> $b['offset']);
+
+        $headers           = [];
+        $this->sliceRanges = [];
+        $emitted           = [];
+        foreach ([...$parts, ...$deltas] as $slice => $part) {
+            self::assertDisjoint($slice, $part['declarations'], isset($layers[$slice]) ? $emitted : $base['declarations']);
+            if (isset($layers[$slice])) {
+                $emitted += $part['declarations'];
+            }
+            $headers[$slice] = self::assemble($part['declarations'], $part['functions'], $part['variables']);
+            foreach ($part['declarations'] as $declaration) {
+                if ($declaration['offset'] !== $declaration['end']) {
+                    $this->sliceRanges[$slice][] = [$declaration['offset'], $declaration['end']];
+                }
+            }
+        }
+
+        return $headers;
+    }
+
+    /**
+     * Maps the given record types to the slice that completes each of them
+     *
+     * Callable after emitSlices(). Core::verifyEngineLayouts() reads the result (slices.json)
+     * to tell a struct of a slice the binding left out from a struct the binding lost.
+     *
+     * @param list<string> $typeNames
+     *
+     * @return array<string, list<string>> slice name => type names, in emitSlices() order
+     */
+    public function sliceRecords(array $typeNames): array
+    {
+        $records = array_fill_keys(array_keys($this->sliceRanges), []);
+        foreach ($typeNames as $typeName) {
+            $record = $this->index->resolveRecord($typeName);
+            if ($record === null) {
+                throw new RuntimeException("Record type '{$typeName}' was not found in the engine headers");
+            }
+            $offset = $this->index->startOffset($record);
+            foreach ($this->sliceRanges as $slice => $ranges) {
+                foreach ($ranges as [$start, $end]) {
+                    if ($start <= $offset && $offset < $end) {
+                        $records[$slice][] = $typeName;
+                        continue 3;
+                    }
+                }
+            }
+            throw new RuntimeException("Record type '{$typeName}' is defined by no header slice");
+        }
+
+        return $records;
+    }
+
+    /**
+     * Pointer-aware closure of the manifest symbols accepted by the filter
+     *
+     * @param Closure(string): bool $accepts
+     *
+     * @return array{
+     *     declarations: array<string, array{offset: int, end: int, text: string}>,
+     *     functions: array<string, string>,
+     *     variables: array<string, string>,
+     * }
+     */
+    private function sliceClosure(Closure $accepts): array
+    {
+        return (new self(
+            $this->index,
+            array_values(array_filter($this->types, $accepts)),
+            array_values(array_filter($this->functions, $accepts)),
+            array_values(array_filter($this->variables, $accepts)),
+            $this->opaque,
+            true,
+        ))->collect();
+    }
+
+    /**
+     * What a closure adds on top of the declarations already bound
+     *
+     * @param array{declarations: array<string, mixed>, functions: array<string, string>, variables: array<string, string>} $closure
+     * @param array{declarations: array<string, mixed>, functions: array<string, string>, variables: array<string, string>} $bound
+     *
+     * @return array{declarations: array<string, mixed>, functions: array<string, string>, variables: array<string, string>}
+     */
+    private static function delta(array $closure, array $bound): array
+    {
+        return [
+            'declarations' => array_diff_key($closure['declarations'], $bound['declarations']),
+            'functions'    => array_diff_key($closure['functions'], $bound['functions']),
+            'variables'    => array_diff_key($closure['variables'], $bound['variables']),
+        ];
+    }
+
+    /**
+     * Resolves the manifest roots into source-ordered declarations, keyed by source range
+     *
+     * @return array{
+     *     declarations: array<string, array{offset: int, end: int, text: string}>,
+     *     functions: array<string, string>,
+     *     variables: array<string, string>,
+     * }
+     */
+    private function collect(): array
     {
         foreach ($this->types as $type) {
             $this->require($type);
@@ -70,11 +282,11 @@ final class HeaderEmitter
 
         $functionDeclarations = [];
         foreach ($this->functions as $function) {
-            $functionDeclarations[] = $this->emitFunction($function);
+            $functionDeclarations[$function] = $this->emitFunction($function);
         }
         $variableDeclarations = [];
         foreach ($this->variables as $variable) {
-            $variableDeclarations[] = $this->emitVariable($variable);
+            $variableDeclarations[$variable] = $this->emitVariable($variable);
         }
 
         // Collect all needed declarations with their source order position
@@ -91,6 +303,13 @@ final class HeaderEmitter
                 $declarations[] = $declaration;
             }
         }
+        foreach (array_keys(array_diff_key($this->declaredRecords, $this->neededRecords)) as $tag) {
+            foreach ($this->recordDeclarations($tag) as $declaration) {
+                if ($declaration['offset'] === $declaration['end']) {
+                    $declarations[] = $declaration;
+                }
+            }
+        }
         foreach (array_keys($this->neededEnums) as $tag) {
             $enum = $this->index->enum($tag);
             if ($enum !== null) {
@@ -117,10 +336,22 @@ final class HeaderEmitter
                     continue 2;
                 }
             }
-            $kept[] = $declaration;
+            // Forward declarations are zero-length ranges: the text tells them apart from a
+            // synthesized opaque typedef at the same position
+            $kept["{$declaration['offset']}:{$declaration['end']}:" . md5($declaration['text'])] = $declaration;
         }
 
-        $body = implode("\n", array_map(static fn(array $declaration): string => $declaration['text'], $kept));
+        return ['declarations' => $kept, 'functions' => $functionDeclarations, 'variables' => $variableDeclarations];
+    }
+
+    /**
+     * @param array<array-key, array{offset: int, end: int, text: string}> $declarations
+     * @param array<array-key, string>                                     $functionDeclarations
+     * @param array<array-key, string>                                     $variableDeclarations
+     */
+    private static function assemble(array $declarations, array $functionDeclarations, array $variableDeclarations): string
+    {
+        $body = implode("\n", array_map(static fn(array $declaration): string => $declaration['text'], $declarations));
 
         $header = self::cleanForFfi($body)
             . "\n\n/* Imported functions */\n" . implode("\n", $functionDeclarations)
@@ -131,6 +362,33 @@ final class HeaderEmitter
         return $header;
     }
 
+    /**
+     * The containment dedup of collect() runs per closure: a slice closure may keep a
+     * declaration whose enclosing declaration only an earlier slice emits (or the other way
+     * round), and composing both would define the same record twice. Fail the generation
+     * instead; moving the enclosing typedef's symbol into the earlier slice resolves it.
+     *
+     * @param array<string, array{offset: int, end: int, text: string}> $delta
+     * @param array<string, array{offset: int, end: int, text: string}> $bound
+     */
+    private static function assertDisjoint(string $slice, array $delta, array $bound): void
+    {
+        foreach ($delta as $declaration) {
+            if ($declaration['offset'] === $declaration['end']) {
+                // Forward declarations may legitimately repeat
+                continue;
+            }
+            foreach ($bound as $other) {
+                if ($other['offset'] < $declaration['end'] && $declaration['offset'] < $other['end']) {
+                    throw new RuntimeException(
+                        "Slice '{$slice}' re-declares source already emitted by an earlier slice: "
+                        . strtok($declaration['text'], "\n"),
+                    );
+                }
+            }
+        }
+    }
+
     /**
      * Record type names (typedefs and struct/union tags) that resolved into
      * the emitted header with a full definition - the manifest roots plus
@@ -208,17 +466,63 @@ final class HeaderEmitter
         }
     }
 
+    /**
+     * Marks a type named only behind a pointer, for which a forward declaration is enough
+     *
+     * "typedef struct _x x;" is itself a forward declaration: it is kept together with the
+     * "struct _x;" it names. Any other typedef (inline record body, function pointer, scalar)
+     * and every enum is required in full.
+     */
+    private function requireDeclared(string $name): void
+    {
+        if (isset($this->visited[$name]) || in_array($name, self::FFI_BUILTIN_TYPES, true)) {
+            return;
+        }
+        $typedef = $this->index->typedef($name);
+        if ($typedef === null && $this->index->hasRecord($name) && !$this->index->hasEnum($name)) {
+            $this->declaredRecords[$name] = true;
+
+            return;
+        }
+        $tag = $this->index->typedefUnderlyingTag($name);
+        if ($typedef !== null && $tag !== null && !str_contains($this->index->sliceText($typedef), '{')) {
+            $this->neededTypedefs[$name] = true;
+            $this->declaredRecords[$tag] = true;
+
+            return;
+        }
+        $this->require($name);
+    }
+
     private function requireIdentifiersOf(string $code): void
     {
-        preg_match_all('/[A-Za-z_][A-Za-z0-9_]*+/', $code, $matches);
-        foreach (array_unique($matches[0]) as $identifier) {
-            if ($this->index->hasTypedef($identifier)
-                || $this->index->hasRecord($identifier)
-                || $this->index->hasEnum($identifier)
-            ) {
+        preg_match_all('/([A-Za-z_][A-Za-z0-9_]*+)(\s*+(?:const\b\s*+)?\*)?/', $code, $matches, PREG_SET_ORDER);
+        $complete = [];
+        $declared = [];
+        foreach ($matches as $match) {
+            if ($this->pointerAware && isset($match[2]) && $match[2] !== '') {
+                $declared[$match[1]] = true;
+            } else {
+                $complete[$match[1]] = true;
+            }
+        }
+        foreach (array_keys($complete) as $identifier) {
+            if ($this->isKnownType($identifier)) {
                 $this->require($identifier);
             }
         }
+        foreach (array_keys(array_diff_key($declared, $complete)) as $identifier) {
+            if ($this->isKnownType($identifier)) {
+                $this->requireDeclared($identifier);
+            }
+        }
+    }
+
+    private function isKnownType(string $identifier): bool
+    {
+        return $this->index->hasTypedef($identifier)
+            || $this->index->hasRecord($identifier)
+            || $this->index->hasEnum($identifier);
     }
 
     /**
@@ -33,6 +33,14 @@ declare(strict_types=1);
  *                 target, so the stub file stays byte-identical across
  *                 platforms; nothing in src/ may touch them (they are invisible
  *                 to the analyser by design). Keyed by stub class name.
+ *   - base_slices: always-bound subsystem slices of engine.h (engine.<slice>.h),
+ *                 in binding order, listing the types/functions/variables each
+ *                 one owns. The last one also takes every unclaimed symbol.
+ *   - slices:     optional subsystem slices, keyed the same way. Core::init()
+ *                 binds the base slices plus the optional ones named by
+ *                 ZENGINE_HEADER_SLICES as ONE FFI::cdef() (see
+ *                 HeaderEmitter::emitSlices()); slices.json records which slice
+ *                 defines each layout struct.
  */
 return [
     'types' => [
@@ -108,6 +116,10 @@ return [
         // Opcode API
         'zend_set_user_opcode_handler',
         'zend_get_user_opcode_handler',
+        // Re-bakes opline->handler from the opline's current opcode and operand
+        // types (zend_vm_execute.h); StatementStrip rewrites EXT_STMT <-> NOP
+        // in compiled op_arrays and the VM only ever dispatches on the handler
+        'zend_vm_set_opcode_handler',
         // Restores an opline's handler pointer from the index form the opcache
         // file-cache serializer stores (zend_file_cache.c); the CacheImageSync
         // bridge uses it to make relocated image bodies executable in-process
@@ -118,6 +130,9 @@ return [
         'zend_object_std_init',
         'object_properties_init',
         'zend_objects_store_put',
+        // Default get_properties_for behind the multiplexed handlers block when the
+        // field was empty (std_object_handlers leaves it NULL)
+        'zend_std_get_properties_for',
         // Language scanner API
         'zend_save_lexical_state',
         'zend_restore_lexical_state',
@@ -332,6 +347,58 @@ return [
         'zend_module_entry'     => ['globals_ptr', 'globals_id_ptr'],
     ],
 
+    // Subsystems every boot needs, split along the engine's own layering: values
+    // and hashtables know classes and functions only behind pointers, classes
+    // and functions know the executor only behind pointers. Core::init() itself
+    // touches EG/CG, the module registry, std_object_handlers and the
+    // inheritance-cache hooks, which are left to the executor slice.
+    'base_slices' => [
+        'values' => [
+            'zval', 'zend_refcounted', 'zend_string', 'zend_array', 'HashTable', 'Bucket',
+            'zend_object', 'zend_resource', 'zend_reference', 'zend_ast_ref', 'zend_object_handlers',
+            'zend_hash_del', 'zend_hash_index_del', 'zend_hash_find', 'zend_hash_add_or_update',
+            'zend_hash_index_add_or_update', 'zend_hash_index_find', 'zend_hash_destroy', 'zend_array_dup',
+            'zval_ptr_dtor', 'zval_add_ref', 'rc_dtor_func', 'zend_string_concat2', 'zend_string_hash_func',
+            ...(PHP_OS_FAMILY === 'Windows' ? [] : ['free']),
+        ],
+        'classes' => [
+            'zend_class_entry', 'zend_class_constant', 'zend_class_name', 'zend_property_info',
+            'zend_attribute', 'zend_attribute_arg', 'zend_function', 'zend_op_array',
+            'zend_internal_function', 'zend_arg_info', 'zend_internal_arg_info', 'zend_type_list',
+            'zend_constant', 'zend_op', 'zend_closure', 'zend_object_iterator', 'zend_object_iterator_funcs',
+            'zend_do_inheritance_ex', 'zend_objects_new', 'zend_object_std_init', 'object_properties_init',
+            'zend_std_get_properties_for', 'destroy_op_array', 'zend_destroy_static_vars',
+            'destroy_zend_class', 'zend_iterator_init', 'zend_register_constant',
+        ],
+        'executor' => [],
+    ],
+
+    // Subsystems a request can boot without: the AST/scanner machinery
+    // (Compiler::parseString(), AST process hooks), runtime module registration
+    // and the opcache file-cache structs. Declarations two of them share are
+    // emitted by the executor slice only.
+    'slices' => [
+        'compiler' => [
+            'zend_ast', 'zend_ast_decl', 'zend_ast_list', 'zend_ast_zval',
+            'zend_ast_process_t', 'zend_lex_state', 'zend_arena',
+            'zend_save_lexical_state', 'zend_restore_lexical_state',
+            'zend_prepare_string_for_scanning', 'zend_lex_tstring',
+            'zendparse', 'zend_ast_destroy', 'zend_ast_create_list_0', 'zend_ast_list_add',
+            'zend_ast_create_zval_ex', 'zend_ast_create_0', 'zend_ast_create_1',
+            'zend_ast_create_2', 'zend_ast_create_3', 'zend_ast_create_4',
+            'zend_ast_create_5', 'zend_ast_create_decl',
+            'zend_ast_process',
+        ],
+        'module' => [
+            'zend_module_entry', 'zend_module_dep',
+            'zend_register_module_ex', 'zend_startup_module_ex',
+        ],
+        'opcache' => [
+            'zend_script', 'zend_persistent_script', 'zend_file_cache_metainfo',
+            'zend_deserialize_opcode_handler',
+        ],
+    ],
+
     'opcode_header' => 'Zend/zend_vm_opcodes.h',
 
     'layout_structs' => [
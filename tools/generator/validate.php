@@ -76,33 +76,88 @@ try {
     exit(1);
 }
 
-$failures = 0;
-foreach ($layouts['structs'] as $struct => $layout) {
+/**
+ * Compares FFI's view of one struct with the C compiler's, reporting every mismatch
+ *
+ * @param array{size: int, fields: array<string, int>} $layout
+ */
+function layoutFailures(FFI $ffi, string $struct, array $layout, string $context = ''): int
+{
     try {
         $type = $ffi->type($struct);
     } catch (Throwable $error) {
-        fwrite(STDERR, "validate.php: FFI cannot resolve type {$struct}: {$error->getMessage()}\n");
-        $failures++;
-        continue;
+        fwrite(STDERR, "validate.php: {$context}FFI cannot resolve type {$struct}: {$error->getMessage()}\n");
+
+        return 1;
     }
-    $ffiSize = $type->getSize();
+    $failures = 0;
+    $ffiSize  = $type->getSize();
     if ($ffiSize !== $layout['size']) {
-        fwrite(STDERR, "validate.php: sizeof({$struct}) FFI={$ffiSize} C={$layout['size']}\n");
+        fwrite(STDERR, "validate.php: {$context}sizeof({$struct}) FFI={$ffiSize} C={$layout['size']}\n");
         $failures++;
     }
     foreach ($layout['fields'] as $field => $expectedOffset) {
         try {
             $ffiOffset = $type->getStructFieldOffset($field);
         } catch (Throwable $error) {
-            fwrite(STDERR, "validate.php: FFI cannot resolve {$struct}.{$field}: {$error->getMessage()}\n");
+            fwrite(STDERR, "validate.php: {$context}FFI cannot resolve {$struct}.{$field}: {$error->getMessage()}\n");
             $failures++;
             continue;
         }
         if ($ffiOffset !== $expectedOffset) {
-            fwrite(STDERR, "validate.php: offsetof({$struct}, {$field}) FFI={$ffiOffset} C={$expectedOffset}\n");
+            fwrite(STDERR, "validate.php: {$context}offsetof({$struct}, {$field}) FFI={$ffiOffset} C={$expectedOffset}\n");
             $failures++;
         }
     }
+
+    return $failures;
+}
+
+$failures = 0;
+foreach ($layouts['structs'] as $struct => $layout) {
+    $failures += layoutFailures($ffi, $struct, $layout);
+}
+
+// Slices: the base slices alone, base + each optional slice and base + every
+// optional slice must parse, and every struct slices.json assigns to a bound
+// slice must match the ground truth there. The last composition is what
+// catches a declaration two slices would both emit.
+$sliceMapFile = $buildDir . '/slices.json';
+$sliceCount   = 0;
+if (is_file($sliceMapFile)) {
+    /** @var array<string, list<string>> $sliceMap */
+    $sliceMap   = json_decode((string) file_get_contents($sliceMapFile), true, 16, JSON_THROW_ON_ERROR);
+    $baseSlices = array_keys((require __DIR__ . '/symbols.php')['base_slices']);
+    $optional   = array_values(array_diff(array_keys($sliceMap), $baseSlices));
+    $unassigned = array_diff(array_keys($layouts['structs']), array_merge(...array_values($sliceMap)));
+    if ($unassigned !== []) {
+        fwrite(STDERR, 'validate.php: slices.json assigns no slice to ' . implode(', ', $unassigned) . "\n");
+        exit(1);
+    }
+
+    $compositions = ['base' => $baseSlices];
+    foreach ($optional as $slice) {
+        $compositions["base+{$slice}"] = [...$baseSlices, $slice];
+    }
+    $compositions['base+all'] = [...$baseSlices, ...$optional];
+    foreach ($compositions as $composition => $slices) {
+        $sliceHeader = '';
+        foreach ($slices as $slice) {
+            $sliceHeader .= (string) file_get_contents("{$buildDir}/engine.{$slice}.h");
+        }
+        try {
+            $sliceFfi = FFI::cdef($sliceHeader, $library);
+        } catch (Throwable $error) {
+            fwrite(STDERR, "validate.php: FFI cannot parse slice composition {$composition}: {$error->getMessage()}\n");
+            exit(1);
+        }
+        foreach ($slices as $slice) {
+            foreach ($sliceMap[$slice] as $struct) {
+                $failures += layoutFailures($sliceFfi, $struct, $layouts['structs'][$struct], "{$composition}: ");
+            }
+        }
+    }
+    $sliceCount = count($sliceMap);
 }
 
 if ($failures > 0) {
@@ -111,4 +166,5 @@ if ($failures > 0) {
 }
 
 echo '[validate] engine.h parsed by FFI' . ($library === null ? '' : " and fully resolved against {$library}")
-    . '; ' . count($layouts['structs']) . ' struct layouts match the C compiler exactly';
+    . '; ' . count($layouts['structs']) . ' struct layouts match the C compiler exactly'
+    . ($sliceCount === 0 ? '' : "; {$sliceCount} header slices compose");